@@ -53,6 +53,7 @@ void Clump::add(const shared_ptr<Body>& clumpBody, const shared_ptr<Body>& subBo
 		clump->members[subId] = Se3r(); // meaningful values will be put in by Clump::updateProperties
 		subBody->clumpId      = clumpBody->id;
 	}
+	clump->invalidateMembersCache();
 	clumpBody->clumpId = clumpBody->id; // just to make sure
 	clumpBody->setBounded(false);       // disallow collisions with the clump itself
 	if (subBody->isStandalone()) { LOG_DEBUG("Added body #" << subBody->id << " to clump #" << clumpBody->id); }
@@ -66,22 +67,42 @@ void Clump::del(const shared_ptr<Body>& clumpBody, const shared_ptr<Body>& subBo
 		throw std::invalid_argument(("Body #" + boost::lexical_cast<string>(subBody->id) + " not part of clump #"
 		                             + boost::lexical_cast<string>(clumpBody->id) + "; not removing.")
 		                                    .c_str());
+	clump->invalidateMembersCache();
 	subBody->clumpId = Body::ID_NONE;
 	LOG_DEBUG("Removed body #" << subBody->id << " from clump #" << clumpBody->id);
 }
 
-void Clump::addForceTorqueFromMembers(const State* clumpState, Scene* scene, Vector3r& F, Vector3r& T)
+void Clump::updateMembersCache()
 {
+	memberIds.clear();
+	memberPos.clear();
+	memberOri.clear();
+	memberIds.reserve(members.size());
+	memberPos.reserve(members.size());
+	memberOri.reserve(members.size());
 	for (const auto& mm : members) {
-		const Body::id_t&       memberId = mm.first;
-		const shared_ptr<Body>& member   = Body::byId(memberId, scene);
+		memberIds.push_back(mm.first);
+		memberPos.push_back(mm.second.position);
+		memberOri.push_back(mm.second.orientation);
+	}
+	membersCacheValid = true;
+}
+
+void Clump::addForceTorqueFromMembers(const State* clumpState, Scene* scene, Vector3r& F, Vector3r& T)
+{
+	checkMembersCache();
+	// lever arms from the actual member positions: the clump or its members may have been moved (from python, by an engine) since the last moveMembers
+	Vector3r     sumF(Vector3r::Zero()), sumT(Vector3r::Zero());
+	const size_t n = memberIds.size();
+	for (size_t k = 0; k < n; k++) {
+		const shared_ptr<Body>& member = Body::byId(memberIds[k], scene);
 		assert(member->isClumpMember());
-		State*          memberState = member->state.get();
-		const Vector3r& f           = scene->forces.getForce(memberId);
-		const Vector3r& t           = scene->forces.getTorque(memberId);
-		F += f;
-		T += t + (memberState->pos - clumpState->pos).cross(f);
+		const Vector3r& f = scene->forces.getForce(memberIds[k]);
+		sumF += f;
+		sumT += scene->forces.getTorque(memberIds[k]) + (member->state->pos - clumpState->pos).cross(f);
 	}
+	F += sumF;
+	T += sumT;
 }
 
 /*! Clump's se3 will be updated (origin at centroid and axes coincident with principal inertia axes) and subSe3 modified in such a way that members positions in world coordinates will not change.
@@ -109,6 +130,7 @@ void Clump::updateProperties(const shared_ptr<Body>& clumpBody, unsigned int dis
 	LOG_DEBUG("Updating clump #" << clumpBody->id << " parameters");
 	const shared_ptr<State> state(clumpBody->state);
 	const shared_ptr<Clump> clump(YADE_PTR_CAST<Clump>(clumpBody->shape));
+	clump->invalidateMembersCache(); // local Se3r of members are recomputed below
 
 	if (clump->members.empty()) { throw std::runtime_error("Clump::updateProperties: clump has zero members."); }
 	// trivial case
@@ -286,6 +308,7 @@ void Clump::updatePropertiesNonSpherical(const shared_ptr<Body>& clumpBody, bool
 	//assert(members.size()>0);
 	const shared_ptr<State> state(clumpBody->state);
 	const shared_ptr<Clump> clump(YADE_PTR_CAST<Clump>(clumpBody->shape));
+	clump->invalidateMembersCache();
 
 	// trivial case
 	if (clump->members.size() == 1) {
@@ -382,6 +405,7 @@ void Clump::updatePropertiesNonSpherical(const shared_ptr<Body>& clumpBody, bool
 	//assert(members.size()>0);
 	const shared_ptr<State> state(clumpBody->state);
 	const shared_ptr<Clump> clump(YADE_PTR_CAST<Clump>(clumpBody->shape));
+	clump->invalidateMembersCache();
 
 	// trivial case
 	if (clump->members.size() == 1) {
@@ -499,8 +523,9 @@ void Clump::addNonSpherical(const shared_ptr<Body>& clumpBody, const shared_ptr<
 		                .c_str());
 
 	clump->members[subId] = Se3r(); // meaningful values will be put in by Clump::updateProperties
-	subBody->clumpId      = clumpBody->id;
-	clumpBody->clumpId    = clumpBody->id; // just to make sure
+	clump->invalidateMembersCache();
+	subBody->clumpId   = clumpBody->id;
+	clumpBody->clumpId = clumpBody->id; // just to make sure
 	clumpBody->setBounded(false);          // disallow collisions with the clump itself
 	                                       //LOG_DEBUG("Added body #"<<subId<<" to clump #"<<getId());
 }
@@ -66,19 +66,20 @@ public:
 	// done as template to avoid cross-dependency between clump and newton (not necessary if all plugins are linked together)
 	template <class IntegratorT> static void moveMembers(const shared_ptr<Body>& clumpBody, Scene* scene, IntegratorT* integrator = NULL)
 	{
-		const shared_ptr<Clump>& clump      = YADE_PTR_CAST<Clump>(clumpBody->shape);
-		const shared_ptr<State>& clumpState = clumpBody->state;
-		for (const auto& B : clump->members) {
-			// B.first is Body::id_t, B.second is local Se3r of that body in the clump
-			const shared_ptr<Body>&  b        = Body::byId(B.first, scene);
-			const shared_ptr<State>& subState = b->state;
-			const Vector3r&          subPos(B.second.position);
-			const Quaternionr&       subOri(B.second.orientation);
+		Clump*       clump      = static_cast<Clump*>(clumpBody->shape.get());
+		const State* clumpState = clumpBody->state.get();
+		clump->checkMembersCache();
+		const Matrix3r R(clumpState->ori.toRotationMatrix()); // one rotation matrix for all members
+		const size_t   n = clump->memberIds.size();
+		for (size_t k = 0; k < n; k++) {
+			const shared_ptr<Body>& b        = Body::byId(clump->memberIds[k], scene);
+			State*                  subState = b->state.get();
+			const Vector3r          arm(R * clump->memberPos[k]);
 			// position update
-			subState->pos = clumpState->pos + clumpState->ori * subPos;
-			subState->ori = clumpState->ori * subOri;
+			subState->pos = clumpState->pos + arm;
+			subState->ori = clumpState->ori * clump->memberOri[k];
 			// velocity update
-			subState->vel    = clumpState->vel + clumpState->angVel.cross(subState->pos - clumpState->pos);
+			subState->vel    = clumpState->vel + clumpState->angVel.cross(arm);
 			subState->angVel = clumpState->angVel;
 			if (integrator) integrator->saveMaximaDisplacement(b);
 		}
@@ -94,6 +95,23 @@ public:
 	//! get force and torque on the clump itself, from forces/torques on members; does not include force on clump itself
 	void addForceTorqueFromMembers(const State* clumpState, Scene* scene, Vector3r& F, Vector3r& T);
 
+	//! Contiguous copy of members (ids and local Se3r), used by moveMembers and addForceTorqueFromMembers; to be called whenever members change.
+	void invalidateMembersCache() { membersCacheValid = false; }
+	//! Rebuild the contiguous copy of members if needed.
+	void checkMembersCache()
+	{
+		if (!membersCacheValid || memberIds.size() != members.size()) updateMembersCache();
+	}
+
+private:
+	void                updateMembersCache();
+	bool                membersCacheValid;
+	vector<Body::id_t>  memberIds; // in the order of members
+	vector<Vector3r>    memberPos; // local position of members
+	vector<Quaternionr> memberOri; // local orientation of members
+
+public:
+
 
 	//! Recalculates inertia tensor of a body after translation away from (default) or towards its centroid.
 	static Matrix3r inertiaTensorTranslate(const Matrix3r& I, const Real m, const Vector3r& off);
@@ -108,7 +126,7 @@ public:
 	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(Clump,Shape,"Rigid aggregate of bodies whose usage is detailed :ref:`here<ClumpSection>`",
 		((MemberMap,members,,Attr::hidden,"Ids and relative positions+orientations of members of the clump (should not be accessed directly)"))
 		 ((vector<int>,ids,,Attr::readonly,"Ids of constituent particles (only informative; direct modifications will have no effect).")) //FIXME
-		,/*ctor*/ createIndex();
+		,/*ctor*/ createIndex(); membersCacheValid=false;
 		,/*py*/ .add_property("members",&Clump::members_get,"Return clump members as {'id1':(relPos,relOri),...}")
 	);
 	// clang-format on
@@ -117,6 +117,7 @@ void Scene::moveToNextTimeStep()
 		for (const auto& e : engines) {
 			e->scene = this;
 			if (e->dead || !e->isActivated()) continue;
+			stateGeneration++;
 			e->action();
 			if (TimingInfo_enabled) {
 				TimingInfo::delta now = TimingInfo::getNow();
@@ -170,7 +171,10 @@ void Scene::moveToNextTimeStep()
 			else if (subs >= 0 && subs < (int)engines.size()) {
 				const shared_ptr<Engine>& e(engines[subs]);
 				e->scene = this;
-				if (!e->dead && e->isActivated()) e->action();
+				if (!e->dead && e->isActivated()) {
+					stateGeneration++;
+					e->action();
+				}
 			}
 			// ** 3. ** epilogue
 			else if (subs == (int)engines.size()) {
@@ -19,6 +19,7 @@
 #include <core/ForceContainer.hpp>
 #include <core/InteractionContainer.hpp>
 #include <core/Material.hpp>
+#include <atomic>
 #ifdef YADE_MPI
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
@@ -36,6 +37,7 @@
 namespace yade { // Cannot have #include directive inside.
 class Shape;
 class Bound;
+struct GlobalStats;
 #ifdef YADE_OPENGL
 class OpenGLRenderer;
 #endif
@@ -58,6 +60,11 @@ public:
 
 	// neither serialized, nor accessible from python (at least not directly)
 	ForceContainer forces;
+	// incremented by the simulation loop before each engine; values cached for the scene are valid for one generation
+	std::atomic<unsigned long> stateGeneration { 0 };
+	// reductions of Shop::globalStats at the generation they store; read and replaced with boost::atomic_load/atomic_store, since python may
+	// call globalStats while the simulation runs
+	shared_ptr<const GlobalStats> globalStatsCache;
 
 	// initialize tags (author, date, time)
 	void fillDefaultTags();
@@ -293,6 +293,29 @@ public:
 template <typename T> using OpenMPVector = std::vector<T>;
 #endif
 
+/* Reduction of the indices 0…n-1 which does not depend on the number of threads: accumulate(part,i) is called for the indices of one block of
+ * blockSize indices into part (initialized to zero), blocks are processed in parallel, then combine(result,part) is called for each block in
+ * order. Floating point sums (and the first maximum found) are thus the same with any number of threads, and the same as a serial loop if n
+ * is not larger than blockSize. */
+template <typename T, typename Accumulate, typename Combine>
+T orderedReduce(long n, const T& zero, const Accumulate& accumulate, const Combine& combine, long blockSize = 4096)
+{
+	const long     nBlocks = (n + blockSize - 1) / blockSize;
+	std::vector<T> parts(nBlocks, zero);
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+	for (long blk = 0; blk < nBlocks; blk++) {
+		const long end = std::min(n, (blk + 1) * blockSize);
+		for (long i = blk * blockSize; i < end; i++)
+			accumulate(parts[blk], i);
+	}
+	T ret = zero;
+	for (const T& part : parts)
+		combine(ret, part);
+	return ret;
+}
+
 }; // namespace yade
 
 // boost serialization
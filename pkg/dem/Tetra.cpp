@@ -51,6 +51,41 @@ void Bo1_Tetra_Aabb::go(const shared_ptr<Shape>& ig, shared_ptr<Bound>& bv, cons
 #undef __VOP
 }
 
+namespace {
+	Matrix3r tetrahedronInertiaTensor(const Vector3r* v);
+
+	/*! Separating axis test between the tetrahedra a and b (vertices in global coordinates).
+	 * Axes 0-3 are face normals of a, 4-7 face normals of b, 8-43 cross products of an edge of a and an edge of b.
+	 * The axis cached (from the previous step) is tested first. Returns the index of a separating axis, or -1 if the tetrahedra overlap. */
+	int tetraSeparatingAxis(const Vector3r a[4], const Vector3r b[4], int cached)
+	{
+		static const int edges[6][2] = { { 0, 1 }, { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 }, { 2, 3 } };
+		static const int faces[4][3] = { { 0, 1, 2 }, { 0, 1, 3 }, { 0, 2, 3 }, { 1, 2, 3 } };
+		auto             axis        = [&](int k) -> Vector3r {
+                        if (k < 4) return (a[faces[k][1]] - a[faces[k][0]]).cross(a[faces[k][2]] - a[faces[k][0]]);
+                        if (k < 8) return (b[faces[k - 4][1]] - b[faces[k - 4][0]]).cross(b[faces[k - 4][2]] - b[faces[k - 4][0]]);
+                        const int ea = (k - 8) / 6, eb = (k - 8) % 6;
+                        return (a[edges[ea][1]] - a[edges[ea][0]]).cross(b[edges[eb][1]] - b[edges[eb][0]]);
+		};
+		// parallel edges give a null axis, on which the projections coincide and never separate
+		auto separates = [&](const Vector3r& n) {
+			Real minA = a[0].dot(n), maxA = minA, minB = b[0].dot(n), maxB = minB;
+			for (int i = 1; i < 4; i++) {
+				const Real pa = a[i].dot(n), pb = b[i].dot(n);
+				minA          = math::min(minA, pa);
+				maxA          = math::max(maxA, pa);
+				minB          = math::min(minB, pb);
+				maxB          = math::max(maxB, pb);
+			}
+			return maxA < minB || maxB < minA;
+		};
+		if (cached >= 0 && cached < 44 && separates(axis(cached))) return cached;
+		for (int k = 0; k < 44; k++)
+			if (k != cached && separates(axis(k))) return k;
+		return -1;
+	}
+}
+
 
 #ifdef YADE_CGAL
 const int Ig2_Tetra_Tetra_TTetraSimpleGeom::psMap[4][3] = { // segments of point
@@ -497,13 +532,24 @@ bool Ig2_Tetra_Tetra_TTetraSimpleGeom::go(
 	Tetra*      shape2 = static_cast<Tetra*>(cm2.get());
 
 	Point    p1[4], p2[4];
-	Vector3r vTemp;
+	Vector3r v1[4], v2[4];
 	// vertices in global coordinates
 	for (int i = 0; i < 4; i++) {
-		vTemp = se31.position + se31.orientation * shape1->v[i];
-		p1[i] = Point(vTemp[0], vTemp[1], vTemp[2]);
-		vTemp = se32.position + se32.orientation * shape2->v[i] + shift2;
-		p2[i] = Point(vTemp[0], vTemp[1], vTemp[2]);
+		v1[i] = se31.position + se31.orientation * shape1->v[i];
+		p1[i] = Point(v1[i][0], v1[i][1], v1[i][2]);
+		v2[i] = se32.position + se32.orientation * shape2->v[i] + shift2;
+		p2[i] = Point(v2[i][0], v2[i][1], v2[i][2]);
+	}
+
+	// cheap rejection before the CGAL predicates; separated tetrahedra cannot match any of the cases below
+	TTetraSimpleGeom* cachedGeom = static_cast<TTetraSimpleGeom*>(interaction->geom.get());
+	const int         sepAxis    = tetraSeparatingAxis(v1, v2, cachedGeom ? cachedGeom->separatingAxis : -1);
+	if (sepAxis >= 0) {
+		if (!cachedGeom) return false;
+		cachedGeom->separatingAxis    = sepAxis;
+		cachedGeom->penetrationVolume = (Real)-1.;
+		cachedGeom->flag              = 0;
+		return true;
 	}
 
 // Faces (CGAL triangles) of each tetra
@@ -666,25 +712,23 @@ bool Ig2_Tetra_Tetra_TTetraGeom::go(
 		}
 #endif
 
-	// transform to global coordinates, build Tetra objects
-	Tetra tA(
-	        se31.orientation * A->v[0] + se31.position,
-	        se31.orientation * A->v[1] + se31.position,
-	        se31.orientation * A->v[2] + se31.position,
-	        se31.orientation * A->v[3] + se31.position);
-	Tetra tB(
-	        se32.orientation * B->v[0] + se32.position + shift2,
-	        se32.orientation * B->v[1] + se32.position + shift2,
-	        se32.orientation * B->v[2] + se32.position + shift2,
-	        se32.orientation * B->v[3] + se32.position + shift2);
-// calculate intersection
-#if 0
-		tB=Tetra(Vector3r(0,0,0),Vector3r(1.5,1,1),Vector3r(0.5,1,1),Vector3r(1,1,.5));
-		tA=Tetra(Vector3r(0,0,0),Vector3r(1,0,0),Vector3r(0,1,0),Vector3r(0,0,1));
-#endif
-	std::list<Tetra> tAB = Tetra2TetraIntersection(tA, tB);
+	// transform to global coordinates
+	Vector3r tA[4], tB[4];
+	for (int i = 0; i < 4; i++) {
+		tA[i] = se31.orientation * A->v[i] + se31.position;
+		tB[i] = se32.orientation * B->v[i] + se32.position + shift2;
+	}
+	// separating axis pre-test, the full intersection is only computed for pairs which may overlap
+	const int sepAxis = tetraSeparatingAxis(tA, tB, bang->separatingAxis);
+	if (sepAxis >= 0) {
+		bang->separatingAxis = sepAxis;
+		if (!interaction->isReal() && !force) return false;
+	}
+	// calculate intersection
+	TetraPiece tAB[maxPieces];
+	const int  nPieces = Tetra2TetraIntersection(tA, tB, tAB);
 	if (!interaction->isReal() && !force) {
-		if (tAB.size() == 0) { /* LOG_DEBUG("No intersection."); */
+		if (nPieces == 0) { /* LOG_DEBUG("No intersection."); */
 			return false;
 		} //no intersecting volume
 	}
@@ -692,14 +736,10 @@ bool Ig2_Tetra_Tetra_TTetraGeom::go(
 	Real     V(0);        // volume of intersection (cummulative)
 	Vector3r Sg(0, 0, 0); // static moment of intersection
 
-	Vector3r tt[4];
-	for (int i = 0; i < 4; i++)
-		tt[i] = tA.v[i];
-
-	for (std::list<Tetra>::iterator II = tAB.begin(); II != tAB.end(); II++) {
-		Real dV = TetrahedronVolume(II->v);
+	for (int p = 0; p < nPieces; p++) {
+		Real dV = TetrahedronVolume(tAB[p].v);
 		V += dV;
-		Sg += dV * (II->v[0] + II->v[1] + II->v[2] + II->v[3]) * .25;
+		Sg += dV * (tAB[p].v[0] + tAB[p].v[1] + tAB[p].v[2] + tAB[p].v[3]) * .25;
 	}
 	Vector3r centroid = Sg / V;
 	Matrix3r I(Matrix3r::Zero()); // inertia tensor for the composition; zero matrix initially
@@ -707,18 +747,19 @@ bool Ig2_Tetra_Tetra_TTetraGeom::go(
 
 	// get total
 	Vector3r dist;
-	for (std::list<Tetra>::iterator II = tAB.begin(); II != tAB.end(); II++) {
-		II->v[0] -= centroid;
-		II->v[1] -= centroid;
-		II->v[2] -= centroid;
-		II->v[3] -= centroid;
-		dist = (II->v[0] + II->v[1] + II->v[2] + II->v[3]) * .25 - centroid;
+	for (int p = 0; p < nPieces; p++) {
+		Vector3r* v = tAB[p].v;
+		v[0] -= centroid;
+		v[1] -= centroid;
+		v[2] -= centroid;
+		v[3] -= centroid;
+		dist = (v[0] + v[1] + v[2] + v[3]) * .25 - centroid;
 		/* use parallel axis theorem */
 		Matrix3r distSq(Matrix3r::Zero());
 		distSq(0, 0) = dist[0] * dist[0];
 		distSq(1, 1) = dist[1] * dist[1];
 		distSq(2, 2) = dist[2] * dist[2]; // could be done more intelligently with eigen
-		I += TetrahedronInertiaTensor(II->v) + TetrahedronVolume(II->v) * distSq;
+		I += tetrahedronInertiaTensor(v) + TetrahedronVolume(v) * distSq;
 	}
 
 	/* Now, we have the collision volumetrically described by intersection volume (V), its inertia tensor (I) and centroid (centroid; contact point).
@@ -809,39 +850,37 @@ bool Ig2_Tetra_Tetra_TTetraGeom::go(
  * return S
  *
  */
-std::list<Tetra> Ig2_Tetra_Tetra_TTetraGeom::Tetra2TetraIntersection(const Tetra& A, const Tetra& B)
+int Ig2_Tetra_Tetra_TTetraGeom::Tetra2TetraIntersection(const Vector3r A[4], const Vector3r B[4], TetraPiece* out)
 {
-	// list of 4hedra to split; initially A
-	std::list<Tetra> ret;
-	ret.push_back(A);
+	// pieces to split; initially A. Clipping by one face gives at most 3 pieces per piece, hence 3^4=maxPieces after the 4 faces of B.
+	TetraPiece  buf[maxPieces];
+	TetraPiece* cur  = out;
+	TetraPiece* next = buf;
+	int         nCur = 1;
+	for (int k = 0; k < 4; k++)
+		cur[0].v[k] = A[k];
 	/* I is vertex index at B;
 	 * clipping face is [i i1 i2], normal points away from i3 */
 	int      i, i1, i2, i3;
 	Vector3r normal;
-	/* LOG_TRACE("===========================================================================================")
-	LOG_TRACE("===========================================================================================")
-	LOG_TRACE(ret.size());
-	LOG_TRACE("DUMP A and B:"); A.dump(); B.dump(); */
-	for (i = 0; i < 4; i++) {
+	for (i = 0; i < 4 && nCur > 0; i++) {
 		i1 = (i + 1) % 4;
 		i2 = (i + 2) % 4;
 		i3 = (i + 3) % 4;
-		const Vector3r& P(B.v[i]); // reference point on the plane
-		normal = (B.v[i1] - P).cross(B.v[i2] - P);
-		normal.normalize();                              // normal
-		if ((B.v[i3] - P).dot(normal) > 0) normal *= -1; // outer normal
-		for (std::list<Tetra>::iterator I = ret.begin(); I != ret.end(); /* I++ */) {
-			std::list<Tetra> splitDecomposition = TetraClipByPlane(*I, P, normal);
-			// replace current list element by the result of decomposition;
-			// I points after the erased one, so decomposed 4hedra will not be touched in this iteration, just as we want.
-			// Since it will be incremented by I++ at the end of the cycle, compensate for that by I--;
-			I = ret.erase(I);
-			ret.insert(I, splitDecomposition.begin(), splitDecomposition.end()); /* I--; */
-			/* LOG_TRACE("DUMP current tetrahedron list:"); for(list<Tetra>::iterator I=ret.begin(); I!=ret.end(); I++) (*I).dump();*/
-		}
+		const Vector3r& P(B[i]); // reference point on the plane
+		normal = (B[i1] - P).cross(B[i2] - P);
+		normal.normalize();                            // normal
+		if ((B[i3] - P).dot(normal) > 0) normal *= -1; // outer normal
+		// replace every piece by the result of its decomposition
+		int nNext = 0;
+		for (int t = 0; t < nCur; t++)
+			nNext += TetraClipByPlane(cur[t], P, normal, next + nNext);
+		std::swap(cur, next);
+		nCur = nNext;
 	}
-	//exit(0);
-	return ret;
+	// after an odd number of swaps the result is in the local buffer
+	if (cur != out) std::copy(cur, cur + nCur, out);
+	return nCur;
 }
 
 /*! Clip Tetra T by plane give by point P and outer normal n.
@@ -872,47 +911,47 @@ std::list<Tetra> Ig2_Tetra_Tetra_TTetraGeom::Tetra2TetraIntersection(const Tetra
  *
  * http://members.tripod.com/~Paul_Kirby/vector/Vplanelineint.html
  */
-std::list<Tetra> Ig2_Tetra_Tetra_TTetraGeom::TetraClipByPlane(const Tetra& T, const Vector3r& P, const Vector3r& normal)
+int Ig2_Tetra_Tetra_TTetraGeom::TetraClipByPlane(const TetraPiece& T, const Vector3r& P, const Vector3r& normal, TetraPiece* out)
 {
-	std::list<Tetra> ret;
 	// scaling factor for Mathr::EPSILON: average edge length
 	Real scaledEPSILON = Mathr::EPSILON * (1 / 6.)
 	        * ((T.v[1] - T.v[0]) + (T.v[2] - T.v[0]) + (T.v[3] - T.v[0]) + (T.v[2] - T.v[1]) + (T.v[3] - T.v[1]) + (T.v[3] - T.v[2])).norm();
 
-	vector<size_t> pos, neg, zer;
-	Real           dist[4];
-	for (size_t i = 0; i < 4; i++) {
+	int  pos[4], neg[4], zer[4];
+	int  nPos = 0, nNeg = 0, nZer = 0;
+	Real dist[4];
+	for (int i = 0; i < 4; i++) {
 		dist[i] = (T.v[i] - P).dot(normal);
-		if (dist[i] > scaledEPSILON) pos.push_back(i);
+		if (dist[i] > scaledEPSILON) pos[nPos++] = i;
 		else if (dist[i] < -scaledEPSILON)
-			neg.push_back(i);
+			neg[nNeg++] = i;
 		else
-			zer.push_back(i);
+			zer[nZer++] = i;
 	}
 /* LOG_TRACE("dist[i]=["<<dist[0]<<","<<dist[1]<<","<<dist[2]<<","<<dist[3]<<"]"); */
-#define NEG neg.size()
-#define POS pos.size()
-#define ZER zer.size()
+#define NEG nNeg
+#define POS nPos
+#define ZER nZer
 #define PTPT(i, j) PtPtPlaneIntr(v[i], v[j], P, normal)
 	assert(NEG + POS + ZER == 4);
 
 	// HOMOGENEOUS CASES
 	// ++++, +++0, ++00, +000, 0000 (degenerate (planar) tetrahedron)
 	if (POS == 4 || (POS == 3 && ZER == 1) || (POS == 2 && ZER == 2) || (POS == 1 && ZER == 3) || ZER == 4)
-		return ret; // ∅
-		            // ----, ---0, --00, -000 :
+		return 0; // ∅
+		          // ----, ---0, --00, -000 :
 	if (NEG == 4 || (NEG == 3 && ZER == 1) || (NEG == 2 && ZER == 2) || (NEG == 1 && ZER == 3)) {
-		ret.push_back(T);
-		return ret;
+		out[0] = T;
+		return 1;
 	}
 	// HETEROGENEOUS CASES
 	// points are ordered -+0
 	Vector3r v[4];
-	for (size_t i = 0; i < NEG; i++)
+	for (int i = 0; i < NEG; i++)
 		v[i + 0 + 0] = T.v[neg[i]];
-	for (size_t i = 0; i < POS; i++)
+	for (int i = 0; i < POS; i++)
 		v[i + 0 + NEG] = T.v[pos[i]];
-	for (size_t i = 0; i < ZER; i++)
+	for (int i = 0; i < ZER; i++)
 		v[i + POS + NEG] = T.v[zer[i]];
 
 #define _A v[0]
@@ -927,46 +966,46 @@ std::list<Tetra> Ig2_Tetra_Tetra_TTetraGeom::TetraClipByPlane(const Tetra& T, co
 #define _CD PTPT(2, 3)
 	// -+++ → 1Δ [A AB AC AD]
 	if (NEG == 1 && POS == 3) {
-		ret.push_back(Tetra(_A, _AB, _AC, _AD));
-		return ret;
+		out[0] = TetraPiece { { _A, _AB, _AC, _AD } };
+		return 1;
 	}
 	// -++0 → 1Δ [A AB AC D]
 	if (NEG == 1 && POS == 2 && ZER == 1) {
-		ret.push_back(Tetra(_A, _AB, _AC, _D));
-		return ret;
+		out[0] = TetraPiece { { _A, _AB, _AC, _D } };
+		return 1;
 	}
 	//	-+00 → 1Δ [A AB C D]
 	if (NEG == 1 && POS == 1 && ZER == 2) {
-		ret.push_back(Tetra(_A, _AB, _C, _D));
-		return ret;
+		out[0] = TetraPiece { { _A, _AB, _C, _D } };
+		return 1;
 	}
 	// --++ → 3Δ [A AC AD B BC BD] ⇒ (e.g.) [A AC AD B] [B BC BD AD] [B AD AC BC]
 	if (NEG == 2 && POS == 2) {
 		// [A AC AD B]
-		ret.push_back(Tetra(_A, _AC, _AD, _B));
+		out[0] = TetraPiece { { _A, _AC, _AD, _B } };
 		// [B BC BD AD]
-		ret.push_back(Tetra(_B, _BC, _BD, _AD));
+		out[1] = TetraPiece { { _B, _BC, _BD, _AD } };
 		// [B AD AC BC]
-		ret.push_back(Tetra(_B, _AD, _AC, _BC));
-		return ret;
+		out[2] = TetraPiece { { _B, _AD, _AC, _BC } };
+		return 3;
 	}
 	// --+0 → 2Δ [A B AC BC D] ⇒ (e.g.) [A AC BC D] [B BC A D]
 	if (NEG == 2 && POS == 1 && ZER == 1) {
 		// [A AC BC D]
-		ret.push_back(Tetra(_A, _AC, _BC, _D));
+		out[0] = TetraPiece { { _A, _AC, _BC, _D } };
 		// [B BC A D]
-		ret.push_back(Tetra(_B, _BC, _A, _D));
-		return ret;
+		out[1] = TetraPiece { { _B, _BC, _A, _D } };
+		return 2;
 	}
 	// ---+ → 3Δ [A B C AD BD CD] ⇒ (e.g.) [A B C AD] [AD BD CD B] [AD C B BD]
 	if (NEG == 3 && POS == 1) {
 		//[A B C AD]
-		ret.push_back(Tetra(_A, _B, _C, _AD));
+		out[0] = TetraPiece { { _A, _B, _C, _AD } };
 		//[AD BD CD B]
-		ret.push_back(Tetra(_AD, _BD, _CD, _B));
+		out[1] = TetraPiece { { _AD, _BD, _CD, _B } };
 		//[AD C B BD]
-		ret.push_back(Tetra(_AD, _C, _B, _BD));
-		return ret;
+		out[2] = TetraPiece { { _AD, _C, _B, _BD } };
+		return 3;
 	}
 #undef _A
 #undef _B
@@ -985,7 +1024,7 @@ std::list<Tetra> Ig2_Tetra_Tetra_TTetraGeom::TetraClipByPlane(const Tetra& T, co
 #undef ZER
 	// unreachable
 	assert(false);
-	return (ret); // prevent warning
+	return 0; // prevent warning
 }
 
 
@@ -1095,9 +1134,16 @@ The numerical testcase (in TetraTestGen::generate) is exact as in the article fo
 11996.2
 
 */
-//Matrix3r TetrahedronInertiaTensor(const Vector3r v[4]){
 Matrix3r TetrahedronInertiaTensor(const vector<Vector3r>& v)
 {
+	assert(v.size() == 4);
+	return tetrahedronInertiaTensor(v.data());
+}
+
+namespace {
+	// same as TetrahedronInertiaTensor, on 4 vertices stored contiguously
+	Matrix3r tetrahedronInertiaTensor(const Vector3r* v)
+	{
 #define x1 v[0][0]
 #define y1 v[0][1]
 #define z1 v[0][2]
@@ -1111,8 +1157,6 @@ Matrix3r TetrahedronInertiaTensor(const vector<Vector3r>& v)
 #define y4 v[3][1]
 #define z4 v[3][2]
 
-	assert(v.size() == 4);
-
 	// Jacobian of transformation to the reference 4hedron
 	Real detJ = (x2 - x1) * (y3 - y1) * (z4 - z1) + (x3 - x1) * (y4 - y1) * (z2 - z1) + (x4 - x1) * (y2 - y1) * (z3 - z1)
 	        - (x2 - x1) * (y4 - y1) * (z3 - z1) - (x3 - x1) * (y2 - y1) * (z4 - z1) - (x4 - x1) * (y3 - y1) * (z2 - z1);
@@ -1159,6 +1203,7 @@ Matrix3r TetrahedronInertiaTensor(const vector<Vector3r>& v)
 #undef x4
 #undef y4
 #undef z4
+	}
 }
 
 /*! Caluclate tetrahedron's central inertia tensor */
@@ -1237,6 +1282,24 @@ Real TetrahedronSignedVolume(const Vector3r v[4])
 Real TetrahedronVolume(const Vector3r v[4]) { return math::abs(TetrahedronSignedVolume(v)); }
 Real TetrahedronSignedVolume(const vector<Vector3r>& v) { return Vector3r(v[1] - v[0]).dot(Vector3r(v[2] - v[0]).cross(v[3] - v[0])) / 6.; }
 Real TetrahedronVolume(const vector<Vector3r>& v) { return math::abs(TetrahedronSignedVolume(v)); }
+
+int TetraSeparatingAxis(const vector<Vector3r>& a, const vector<Vector3r>& b, int cached)
+{
+	if (a.size() != 4 || b.size() != 4) throw std::invalid_argument("TetraSeparatingAxis: tetrahedra must have 4 vertices.");
+	return tetraSeparatingAxis(a.data(), b.data(), cached);
+}
+
+Real TetraIntersectionVolume(const vector<Vector3r>& a, const vector<Vector3r>& b)
+{
+	if (a.size() != 4 || b.size() != 4) throw std::invalid_argument("TetraIntersectionVolume: tetrahedra must have 4 vertices.");
+	Ig2_Tetra_Tetra_TTetraGeom             ig2;
+	Ig2_Tetra_Tetra_TTetraGeom::TetraPiece pieces[Ig2_Tetra_Tetra_TTetraGeom::maxPieces];
+	const int                              nPieces = ig2.Tetra2TetraIntersection(a.data(), b.data(), pieces);
+	Real                                   V(0);
+	for (int p = 0; p < nPieces; p++)
+		V += TetrahedronVolume(pieces[p].v);
+	return V;
+}
 #ifdef YADE_CGAL
 Real TetrahedronVolume(const CGAL::Point_3<CGAL::Cartesian<Real>>* v[4])
 {
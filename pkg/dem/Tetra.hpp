@@ -63,7 +63,8 @@ public:
 		((Real,maxPenetrationDepthB,NaN,,"??"))
 		((Real,equivalentPenetrationDepth,NaN,,"??"))
 		((Vector3r,contactPoint,,,"Contact point (global coords)"))
-		((Vector3r,normal,,,"Normal of the interaction, directed in the sense of least inertia of the overlap volume")),
+		((Vector3r,normal,,,"Normal of the interaction, directed in the sense of least inertia of the overlap volume"))
+		((int,separatingAxis,-1,Attr::readonly,"Index of the last axis found to separate the tetrahedra (-1 if none), tested first at the next step.")),
 		createIndex();
 	);
 	// clang-format on
@@ -80,7 +81,8 @@ public:
 		((Real,penetrationVolume,NaN,,"Volume of overlap [m³]"))
 		((Vector3r,contactPoint,,,"Contact point (global coords)"))
 		((Vector3r,normal,,,"Normal of the interaction TODO"))
-		((int,flag,0,,"TODO")),
+		((int,flag,0,,"TODO"))
+		((int,separatingAxis,-1,Attr::readonly,"Index of the last axis found to separate the tetrahedra (-1 if none), tested first at the next step.")),
 		createIndex();
 	);
 	// clang-format on
@@ -157,13 +159,22 @@ public:
 	FUNCTOR2D(Tetra, Tetra);
 	DEFINE_FUNCTOR_ORDER_2D(Tetra, Tetra);
 	// clang-format off
-		YADE_CLASS_BASE_DOC(Ig2_Tetra_Tetra_TTetraGeom,IGeomFunctor,"Create/update geometry of collision between 2 :yref:`tetrahedra<Tetra>` (:yref:`TTetraGeom` instance)");
+		YADE_CLASS_BASE_DOC(Ig2_Tetra_Tetra_TTetraGeom,IGeomFunctor,"Create/update geometry of collision between 2 :yref:`tetrahedra<Tetra>` (:yref:`TTetraGeom` instance). Candidate pairs are first tested for a separating axis (face normals and cross products of edges, starting with the :yref:`last separating axis<TTetraGeom.separatingAxis>`), the intersection volume is only computed for pairs which pass this test.");
 	// clang-format on
 	DECLARE_LOGGER;
 
+	//! Vertices of a piece of the intersection volume; plain struct, so that pieces live in stack buffers.
+	struct TetraPiece {
+		Vector3r v[4];
+	};
+	//! Clipping by the 4 faces of B splits a tetrahedron in at most 3 pieces each time.
+	static const int maxPieces = 81;
+	//! Intersection of A and B as pieces written to out (maxPieces at most), returns the number of pieces.
+	int Tetra2TetraIntersection(const Vector3r A[4], const Vector3r B[4], TetraPiece* out);
+
 private:
-	std::list<Tetra> Tetra2TetraIntersection(const Tetra& A, const Tetra& B);
-	std::list<Tetra> TetraClipByPlane(const Tetra& T, const Vector3r& P, const Vector3r& n);
+	//! Clip T by a plane, writing 0 to 3 pieces to out, returns their number.
+	int TetraClipByPlane(const TetraPiece& T, const Vector3r& P, const Vector3r& n, TetraPiece* out);
 	//! Intersection of line given by points A, B and plane given by P and its normal.
 	Vector3r PtPtPlaneIntr(const Vector3r& A, const Vector3r& B, const Vector3r& P, const Vector3r& normal)
 	{
@@ -279,6 +290,10 @@ Real TetrahedronVolume(const CGAL::Point_3<CGAL::Cartesian<Real>>* v[4]);
 Real TetrahedronVolume(const CGAL::Point_3<CGAL::Cartesian<Real>> v[4]);
 #endif
 Matrix3r TetrahedronInertiaTensor(const vector<Vector3r>& v);
+//! Index of an axis separating the tetrahedra a and b, as tested by the Tetra functors (cached axis first); -1 if none.
+int TetraSeparatingAxis(const vector<Vector3r>& a, const vector<Vector3r>& b, int cached = -1);
+//! Volume of the intersection of the tetrahedra a and b, as computed by Ig2_Tetra_Tetra_TTetraGeom but without the separating axis test.
+Real TetraIntersectionVolume(const vector<Vector3r>& a, const vector<Vector3r>& b);
 //Matrix3r TetrahedronInertiaTensor(const Vector3r v[4]);
 Matrix3r TetrahedronCentralInertiaTensor(const vector<Vector3r>& v);
 //Matrix3r TetrahedronCentralInertiaTensor(const Vector3r v[4]);
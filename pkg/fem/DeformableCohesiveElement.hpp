@@ -64,6 +64,14 @@ public:
 
 	void addPair(const shared_ptr<Body>& node1, const shared_ptr<Body>& node2);
 	void delPair(const shared_ptr<Body>& node1, const shared_ptr<Body>& node2);
+	void getNodeIds(std::vector<Body::id_t>& ids) const override
+	{
+		ids.clear();
+		for (const auto& p : nodepairs) {
+			ids.push_back(p.first.node1->getId());
+			ids.push_back(p.first.node2->getId());
+		}
+	}
 
 	// clang-format off
 		YADE_CLASS_BASE_DOC_ATTRS_INIT_CTOR_PY(DeformableCohesiveElement,DeformableElement,"Tetrahedral Deformable Element Composed of Nodes",
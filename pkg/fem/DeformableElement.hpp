@@ -61,6 +61,13 @@ public:
 	boost::python::dict localmap_get();
 
 	virtual Real getVolume() const { return -1; }
+	//! Ids of the nodes whose forces are updated by the internal force functor of this element.
+	virtual void getNodeIds(std::vector<Body::id_t>& ids) const
+	{
+		ids.clear();
+		for (const auto& n : localmap)
+			ids.push_back(n.first->getId());
+	}
 	// clang-format off
 		YADE_CLASS_BASE_DOC_ATTRS_INIT_CTOR_PY(DeformableElement,Shape,"Deformable aggregate of nodes",
 		((NodeMap,localmap,,,"Ids and relative positions+orientations of members of the deformable element (should not be accessed directly)"))
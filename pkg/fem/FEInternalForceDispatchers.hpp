@@ -30,6 +30,22 @@ class InternalForceFunctor : public Functor2D<
                                      /*return type*/ void,
                                      /*argument types*/ TYPELIST_3(const shared_ptr<Shape>&, const shared_ptr<Material>&, const shared_ptr<Body>&)> {
 public:
+	vector<Vector3r>* nodeForces = nullptr; // set by FEInternalForceEngine when elements are processed in coloured batches
+	//! Add force f to node id, either in the nodeForces buffer (no two elements of a batch share a node) or in the force container.
+	void addNodeForce(Body::id_t id, const Vector3r& f)
+	{
+		if (nodeForces) (*nodeForces)[id] += f;
+		else
+			scene->forces.addForce(id, f);
+	}
+	/*! For elements with a constant linear operator: the nodal forces are f=-A*(x-x0)-D*v, x0 being the reference positions of the nodes ids
+	 * and x, v their current positions and velocities (3 rows per node). A and D are the operators of the force law of the functor, not
+	 * necessarily stiffness and damping matrices. Returns false if the element is not linear (the default). */
+	virtual bool linearOperator(
+	        const shared_ptr<Shape>&, const shared_ptr<Material>&, vector<Body::id_t>& /*ids*/, vector<Vector3r>& /*x0*/, MatrixXr& /*A*/, MatrixXr& /*D*/)
+	{
+		return false;
+	}
 	virtual ~InternalForceFunctor();
 	// clang-format off
 	YADE_CLASS_BASE_DOC(InternalForceFunctor,Functor,"Functor for creating/updating :yref:`Body::bound`.");
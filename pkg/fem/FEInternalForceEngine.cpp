@@ -10,6 +10,7 @@
 #include <pkg/fem/DeformableElement.hpp>
 #include <pkg/fem/FEInternalForceDispatchers.hpp>
 #include <pkg/fem/FEInternalForceEngine.hpp>
+#include <algorithm>
 
 namespace yade { // Cannot have #include directive inside.
 
@@ -37,6 +38,140 @@ void FEInternalForceEngine::pyHandleCustomCtorArgs(boost::python::tuple& t, boos
 }
 
 
+//! Find (once) the internal force functor of body b, returns false if b is not an element handled by the dispatcher.
+bool FEInternalForceEngine::getElementFunctor(const shared_ptr<Body>& b)
+{
+	if (!b->shape) return false;
+	if (!b->shape->internalforcefunctor) b->shape->internalforcefunctor = internalforcedispatcher->getFunctor(b->shape, b->material);
+	return b->shape->internalforcefunctor.get() != 0;
+}
+
+void FEInternalForceEngine::colourElements()
+{
+	const size_t size = scene->bodies->size();
+	batches.clear();
+	touchedNodes.clear();
+	dofNodes.clear();
+	linearElements.clear();
+	nodeForce.assign(size, Vector3r::Zero());
+	vector<vector<int>>           nodeColours(colouredBatches ? size : 0); // colours of the elements sharing each node
+	vector<long>                  forbidden;                               // forbidden[c]==elementIdx if colour c is used by a node of the element
+	vector<char>                  touched(size, 0);
+	vector<int>                   dofOf(size, -1);
+	vector<Eigen::Triplet<Real>>  aTriplets, dTriplets;
+	vector<Real>                  ref;
+	vector<Body::id_t>            ids;
+	vector<Vector3r>              x0;
+	MatrixXr                      A, D;
+	long                          elementIdx = 0;
+
+	for (const auto& b : *scene->bodies) {
+		if (!b || !getElementFunctor(b)) continue;
+		InternalForceFunctor* functor = b->shape->internalforcefunctor.get();
+		// an element with a node out of the scene is left to the element-by-element evaluation, as without assembly
+		if (assembled && functor->linearOperator(b->shape, b->material, ids, x0, A, D)
+		    && std::all_of(ids.begin(), ids.end(), [this](Body::id_t id) { return scene->bodies->exists(id); })) {
+			vector<int> dofs;
+			for (Body::id_t id : ids) {
+				if (dofOf[id] < 0) {
+					dofOf[id] = dofNodes.size();
+					dofNodes.push_back(id);
+					ref.resize(3 * dofNodes.size(), 0.);
+				}
+				dofs.push_back(dofOf[id]);
+			}
+			VectorXr x0e(3 * ids.size());
+			for (size_t a = 0; a < ids.size(); a++)
+				x0e.segment<3>(3 * a) = x0[a];
+			const VectorXr Ax0 = A * x0e;
+			for (size_t a = 0; a < ids.size(); a++)
+				for (int ia = 0; ia < 3; ia++) {
+					ref[3 * dofs[a] + ia] += Ax0[3 * a + ia];
+					for (size_t c = 0; c < ids.size(); c++)
+						for (int ic = 0; ic < 3; ic++) {
+							aTriplets.push_back(Eigen::Triplet<Real>(3 * dofs[a] + ia, 3 * dofs[c] + ic, A(3 * a + ia, 3 * c + ic)));
+							dTriplets.push_back(Eigen::Triplet<Real>(3 * dofs[a] + ia, 3 * dofs[c] + ic, D(3 * a + ia, 3 * c + ic)));
+						}
+				}
+			linearElements.push_back({ b->getId(), b->shape.get() });
+			continue;
+		}
+		static_cast<const DeformableElement*>(b->shape.get())->getNodeIds(ids);
+		size_t colour = 0;
+		if (colouredBatches) { // greedy colouring, in the order of the ids
+			elementIdx++;
+			for (Body::id_t id : ids)
+				for (int c : nodeColours[id]) {
+					if (size_t(c) >= forbidden.size()) forbidden.resize(c + 1, 0);
+					forbidden[c] = elementIdx;
+				}
+			while (colour < forbidden.size() && forbidden[colour] == elementIdx)
+				colour++;
+			for (Body::id_t id : ids)
+				nodeColours[id].push_back(colour);
+		}
+		if (colour >= batches.size()) batches.resize(colour + 1);
+		batches[colour].push_back({ b->getId(), b->shape.get() });
+		for (Body::id_t id : ids)
+			if (!touched[id]) {
+				touched[id] = 1;
+				touchedNodes.push_back(id);
+			}
+	}
+
+	const long nDofs = 3 * dofNodes.size();
+	globalA.resize(nDofs, nDofs);
+	globalD.resize(nDofs, nDofs);
+	globalA.setFromTriplets(aTriplets.begin(), aTriplets.end());
+	globalD.setFromTriplets(dTriplets.begin(), dTriplets.end());
+	globalRef = Eigen::Map<VectorXr>(ref.data(), nDofs);
+	dofPos.resize(nDofs);
+	dofVel.resize(nDofs);
+	dofForce.resize(nDofs);
+
+	nColours     = batches.size();
+	nAssembled   = linearElements.size();
+	colouredSize        = size;
+	colouredAssembled   = assembled;
+	colouredWithBatches = colouredBatches;
+	recolour            = false;
+	LOG_DEBUG(touchedNodes.size() << " nodes, " << nColours << " colours, " << nAssembled << " assembled elements");
+}
+
+//! True if the assembled elements and their nodes are still in the scene.
+bool FEInternalForceEngine::assemblyValid() const
+{
+	for (const auto& e : linearElements) {
+		if (!scene->bodies->exists(e.id) || Body::byId(e.id, scene)->shape.get() != e.shape) return false;
+	}
+	for (Body::id_t id : dofNodes)
+		if (!scene->bodies->exists(id)) return false;
+	return true;
+}
+
+//! Forces of the assembled elements: f=-(A*x-A*x0)-D*v.
+void FEInternalForceEngine::assembledForces()
+{
+	const long size = dofNodes.size();
+	if (size == 0) return;
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(ompThreads > 0 ? ompThreads : omp_get_max_threads())
+#endif
+	for (long k = 0; k < size; k++) {
+		const State* st          = Body::byId(dofNodes[k], scene)->state.get();
+		dofPos.segment<3>(3 * k) = st->pos;
+		dofVel.segment<3>(3 * k) = st->vel;
+	}
+	dofForce.noalias() = globalD * dofVel;
+	dofForce.noalias() += globalA * dofPos;
+	dofForce = globalRef - dofForce;
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(ompThreads > 0 ? ompThreads : omp_get_max_threads())
+#endif
+	for (long k = 0; k < size; k++)
+		scene->forces.addForce(dofNodes[k], dofForce.segment<3>(3 * k));
+}
+
 void FEInternalForceEngine::action()
 {
 	// update Scene* of the dispatcher
@@ -44,52 +179,58 @@ void FEInternalForceEngine::action()
 	// ask dispatcher to update Scene* of their functors
 	internalforcedispatcher->updateScenePtr();
 
-	// call InternalForceFunctor::preStep
-	//FOREACH(const shared_ptr<InternalForceFunctor>& iff, internalforcedispatcher->functors) iff->preStep();
-
-	/*
-		initialize callbacks; they return pointer (used only in this timestep) to the function to be called
-		returning NULL deactivates the callback in this timestep
-	*/
-	//	// pair of callback object and pointer to the function to be called
-	//	vector<IntrCallback::FuncPtr> callbackPtrs;
-	//	FOREACH(const shared_ptr<IntrCallback> cb, callbacks){
-	//		cb->scene=scene;
-	//		callbackPtrs.push_back(cb->stepInit());
-	//	}
-	//	assert(callbackPtrs.size()==callbacks.size());
-	//	size_t callbacksSize=callbacks.size();
-
-	// cache transformed cell size
-	//	Matrix3r cellHsize; if(scene->isPeriodic) cellHsize=scene->cell->hSize;
+	// the global matrices must not refer to erased elements or nodes, they are rebuilt before use
+	if (recolour || scene->bodies->size() != colouredSize || assembled != colouredAssembled || colouredBatches != colouredWithBatches
+	    || !assemblyValid())
+		colourElements();
+	if (assembled) assembledForces();
 
+	for (const auto& f : internalforcedispatcher->functors)
+		f->nodeForces = colouredBatches ? &nodeForce : nullptr;
 
+	bool stale = false;
+	for (const auto& batch : batches) {
+		const long size = batch.size();
 #ifdef YADE_OPENMP
-	const long size = scene->bodies->size();
-#pragma omp parallel for schedule(guided) num_threads(ompThreads > 0 ? ompThreads : omp_get_max_threads())
-	for (long i = 0; i < size; i++) {
-		shared_ptr<Body>& bdy = (*scene->bodies)[i];
-#else
-	FOREACH(const shared_ptr<Body>& bdy, *scene->bodies)
-	{
+#pragma omp parallel for schedule(guided) num_threads(ompThreads > 0 ? ompThreads : omp_get_max_threads()) reduction(|| : stale)
 #endif
-
-		//Try to get internal functor
-		if (bdy->shape->internalforcefunctor.get() == 0) {
-			//If there isn't any internalforcefunctor; try to get one
-			bdy->shape->internalforcefunctor = internalforcedispatcher->getFunctor(bdy->shape, bdy->material);
-			//İf we found any of them that is suitable to this element???
-			if (bdy->shape->internalforcefunctor != 0) {
-				//If yes try to apply internal force functor
-				shared_ptr<DeformableElement> deformableElement = YADE_PTR_CAST<DeformableElement>(bdy->shape);
-				bdy->shape->internalforcefunctor->go(deformableElement, bdy->material, bdy);
+		for (long k = 0; k < size; k++) {
+			const shared_ptr<Body>& b = Body::byId(batch[k].id, scene);
+			if (!b || b->shape.get() != batch[k].shape) {
+				stale = true;
+				continue;
 			}
-		} else {
-			//Take functor from cache and call it's go functor
-			shared_ptr<DeformableElement> deformableElement = YADE_PTR_CAST<DeformableElement>(bdy->shape);
-			bdy->shape->internalforcefunctor->go(deformableElement, bdy->material, bdy);
+			b->shape->internalforcefunctor->go(b->shape, b->material, b);
 		}
 	}
+	if (stale) recolour = true;
+
+	if (colouredBatches) {
+		const long size = touchedNodes.size();
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(ompThreads > 0 ? ompThreads : omp_get_max_threads())
+#endif
+		for (long k = 0; k < size; k++) {
+			const Body::id_t id = touchedNodes[k];
+			scene->forces.addForce(id, nodeForce[id]);
+			nodeForce[id] = Vector3r::Zero();
+		}
+	}
+}
+
+boost::python::tuple FEInternalForceEngine::getAssembledMatrix() const
+{
+	boost::python::list ids, A, D, Ax0;
+	for (Body::id_t id : dofNodes)
+		ids.append(id);
+	for (int r = 0; r < globalA.outerSize(); r++) {
+		for (Eigen::SparseMatrix<Real, Eigen::RowMajor>::InnerIterator it(globalA, r); it; ++it)
+			A.append(boost::python::make_tuple(it.row(), it.col(), it.value()));
+		for (Eigen::SparseMatrix<Real, Eigen::RowMajor>::InnerIterator it(globalD, r); it; ++it)
+			D.append(boost::python::make_tuple(it.row(), it.col(), it.value()));
+		Ax0.append(globalRef[r]);
+	}
+	return boost::python::make_tuple(ids, A, D, Ax0);
 }
 
 } // namespace yade
@@ -9,6 +9,7 @@
 #include <core/Callbacks.hpp>
 #include <core/GlobalEngine.hpp>
 #include <pkg/fem/FEInternalForceDispatchers.hpp>
+#include <Eigen/Sparse>
 
 namespace yade { // Cannot have #include directive inside.
 
@@ -28,16 +29,46 @@ class FEInternalForceEngine : public GlobalEngine {
 	//		list<idPair> eraseAfterLoopIds;
 	//		void eraseAfterLoop(Body::id_t id1,Body::id_t id2){ eraseAfterLoopIds.push_back(idPair(id1,id2)); }
 	//	#endif
+private:
+	struct ElementRef {
+		Body::id_t   id;
+		const Shape* shape; // to detect a body replaced since the last colouring
+	};
+	vector<vector<ElementRef>>     batches;             // elements of each colour, no two elements of a batch share a node
+	vector<Body::id_t>             touchedNodes;        // nodes of the coloured elements
+	vector<Vector3r>               nodeForce;           // nodal forces of the coloured elements, indexed by body id
+	size_t                         colouredSize;        // bodies->size() at the last colouring
+	bool                           colouredAssembled;   // assembled at the last colouring
+	bool                           colouredWithBatches; // colouredBatches at the last colouring
+	bool                           recolour;            // an element was replaced or removed since the last colouring
+	vector<Body::id_t>             dofNodes;            // nodes of the assembled elements, 3 rows each in the global matrices
+	Eigen::SparseMatrix<Real, Eigen::RowMajor> globalA, globalD; // assembled operators of the linear elements, f=-A*(x-x0)-D*v
+	VectorXr                                   globalRef;        // globalA times the reference positions, element by element
+	VectorXr                                   dofPos, dofVel, dofForce;
+	vector<ElementRef>                         linearElements;   // the elements in the global matrices
+
+	void colourElements();
+	bool getElementFunctor(const shared_ptr<Body>& b);
+	bool assemblyValid() const;
+	void assembledForces();
+
 public:
-	void pyHandleCustomCtorArgs(boost::python::tuple& t, boost::python::dict& d) override;
-	void action() override;
+	void               pyHandleCustomCtorArgs(boost::python::tuple& t, boost::python::dict& d) override;
+	void               action() override;
+	boost::python::tuple getAssembledMatrix() const;
 	// clang-format off
 		YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(FEInternalForceEngine,GlobalEngine,"Unified dispatcher for handling Finite Element internal force loop at every step, for parallel performance reasons.\n\n.. admonition:: Special constructor\n\n\tConstructs from 3 lists of :yref:`Ig2<IGeomFunctor>`, :yref:`Ip2<IPhysFunctor>`, :yref:`Law<LawFunctor>` functors respectively; they will be passed to interal dispatchers, which you might retrieve.",
 			((shared_ptr<InternalForceDispatcher>,internalforcedispatcher,new InternalForceDispatcher,Attr::readonly,":yref:`InternalForceDispatcher` object that is used for dispatching of element types."))
+			((bool,colouredBatches,true,,"Process the elements in batches (colours) in which no two elements share a node: the elements of a batch are evaluated in parallel and their nodal forces are summed in a buffer without synchronization, then added once per node to the force container. The colouring is computed at the first step and again after elements are inserted or removed. The summation order, hence the result, does not depend on the number of threads. If false, every element adds its forces to the force container directly."))
+			((bool,assembled,false,,"Assemble the elements with a constant linear operator (:yref:`If2_Lin4NodeTetra_LinIsoRayleighDampElast`) in global sparse matrices, once, and compute their nodal forces with sparse matrix-vector products, the other elements being processed one by one. The matrices are rebuilt when an element or a node is inserted, replaced or erased, and are available through :yref:`getAssembledMatrix<FEInternalForceEngine.getAssembledMatrix>`."))
+			((int,nColours,0,Attr::readonly,"Number of colours (batches) of the last colouring."))
+			((int,nAssembled,0,Attr::readonly,"Number of elements in the global matrices (see :yref:`assembled<FEInternalForceEngine.assembled>`)."))
 			,
 			/*ctor*/
+			colouredSize=0; colouredAssembled=false; colouredWithBatches=false; recolour=true;
 			,
 			/*py*/
+			.def("getAssembledMatrix",&FEInternalForceEngine::getAssembledMatrix,"Return the operators assembled with :yref:`assembled<FEInternalForceEngine.assembled>` as a tuple (ids,A,D,Ax0): ids lists the nodes (three rows each, x,y,z), A and D are the operators of the internal force law of the elements as lists of (row,column,value) triplets and Ax0 is the list of the rows of A times the reference positions, so that the internal forces are -(A*x-Ax0)-D*v for the node positions x and velocities v. For :yref:`If2_Lin4NodeTetra_LinIsoRayleighDampElast`, A is the element by element product of the inverse (lumped) mass matrix and the stiffness matrix, and D=alpha*I+beta*A: these are not the stiffness and damping matrices, which the functor does not use.")
 		);
 	// clang-format on
 	DECLARE_LOGGER;
@@ -59,12 +59,12 @@ void If2_2xLin4NodeTetra_LinCohesiveStiffPropDampElastMat::go(
 
 	//cout<<"forces are \n"<<f1<<"\n"<<f2<<"\n"<<f3<<"\n";
 
-	scene->forces.addForce(node11->getId(), -f1);
-	scene->forces.addForce(node12->getId(), f1);
-	scene->forces.addForce(node21->getId(), -f2);
-	scene->forces.addForce(node22->getId(), f2);
-	scene->forces.addForce(node31->getId(), -f3);
-	scene->forces.addForce(node32->getId(), f3);
+	addNodeForce(node11->getId(), -f1);
+	addNodeForce(node12->getId(), f1);
+	addNodeForce(node21->getId(), -f2);
+	addNodeForce(node22->getId(), f2);
+	addNodeForce(node31->getId(), -f3);
+	addNodeForce(node32->getId(), f3);
 
 
 	return;
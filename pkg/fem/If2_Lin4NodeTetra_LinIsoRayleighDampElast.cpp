@@ -21,35 +21,45 @@ If2_Lin4NodeTetra_LinIsoRayleighDampElast::~If2_Lin4NodeTetra_LinIsoRayleighDamp
 *********************************************************************/
 
 typedef DeformableElement::NodeMap NodeMap;
-#define VECTOR12_TEMPLATE(Scalar) Eigen::Matrix<Scalar, 12, 1>
-typedef VECTOR12_TEMPLATE(Real) Vector12r;
 
 CREATE_LOGGER(If2_Lin4NodeTetra_LinIsoRayleighDampElast);
 
+void If2_Lin4NodeTetra_LinIsoRayleighDampElast::cacheOperator(Lin4NodeTetra& tetel, const LinIsoRayleighDampElastMat& mat) const
+{
+	NodeMap::const_iterator i0(tetel.localmap.cbegin());
+	NodeMap::const_iterator i1(i0);
+	NodeMap::const_iterator i2(i0);
+	NodeMap::const_iterator i3(i0);
+
+	std::advance(i1, 1);
+	std::advance(i2, 2);
+	std::advance(i3, 3);
+
+	Vector3r node0relpos = Vector3r(0, 0, 0);
+	Vector3r node1relpos = i1->second.position - i0->second.position;
+	Vector3r node2relpos = i2->second.position - i0->second.position;
+	Vector3r node3relpos = i3->second.position - i0->second.position;
+	// I dont know wheter this is optimum or not
+	tetel.massMatrixInvProductstiffnessMatrix = tetel.calculateMassMatrix(mat.density, mat.poissonratio).inverse()
+	        * tetel.calculateStiffness(mat.youngmodulus, mat.poissonratio, node0relpos, node1relpos, node2relpos, node3relpos);
+	tetel.operatorCached = true;
+}
+
 void If2_Lin4NodeTetra_LinIsoRayleighDampElast::go(const shared_ptr<Shape>& element, const shared_ptr<Material>& material, const shared_ptr<Body>& /*bdy*/)
 {
-	shared_ptr<Lin4NodeTetra>              tetel = YADE_PTR_CAST<Lin4NodeTetra>(element);
-	shared_ptr<LinIsoRayleighDampElastMat> mat   = YADE_PTR_CAST<LinIsoRayleighDampElastMat>(material);
+	Lin4NodeTetra*                    tetel = static_cast<Lin4NodeTetra*>(element.get());
+	const LinIsoRayleighDampElastMat* mat   = static_cast<const LinIsoRayleighDampElastMat*>(material.get());
 
-	DeformableElement::NodeMap::iterator i0(tetel->localmap.begin());
-	DeformableElement::NodeMap::iterator i1(i0);
-	DeformableElement::NodeMap::iterator i2(i0);
-	DeformableElement::NodeMap::iterator i3(i0);
+	NodeMap::const_iterator i0(tetel->localmap.cbegin());
+	NodeMap::const_iterator i1(i0);
+	NodeMap::const_iterator i2(i0);
+	NodeMap::const_iterator i3(i0);
 
 	std::advance(i1, 1);
 	std::advance(i2, 2);
 	std::advance(i3, 3);
 
-	if (tetel->massMatrixInvProductstiffnessMatrix == 0) {
-		Vector3r node0relpos = Vector3r(0, 0, 0);
-		Vector3r node1relpos = i1->second.position - i0->second.position;
-		Vector3r node2relpos = i2->second.position - i0->second.position;
-		Vector3r node3relpos = i3->second.position - i0->second.position;
-		// I dont know wheter this is optimum or not
-		tetel->massMatrixInvProductstiffnessMatrix = shared_ptr<MatrixXr>(new MatrixXr(
-		        tetel->calculateMassMatrix(mat->density, mat->poissonratio).inverse()
-		        * tetel->calculateStiffness(mat->youngmodulus, mat->poissonratio, node0relpos, node1relpos, node2relpos, node3relpos)));
-	}
+	if (!tetel->operatorCached) cacheOperator(*tetel, *mat);
 
 	//apply internal forces to the tetrahedron
 	//Calculate displacements
@@ -60,19 +70,36 @@ void If2_Lin4NodeTetra_LinIsoRayleighDampElast::go(const shared_ptr<Shape>& elem
 	        i3->first->state->pos - i3->second.position;
 	displacementvelocity << i0->first->state->vel, i1->first->state->vel, i2->first->state->vel, i3->first->state->vel;
 
+	//Now calculate the forces, -A*u-(alpha*I+beta*A)*v with A the mass-inverse times stiffness, in one product
+	const Vector12r forces
+	        = -(tetel->massMatrixInvProductstiffnessMatrix * (displacements + mat->beta * displacementvelocity)) - mat->alpha * displacementvelocity;
 
-	//Now calculate the forces
-	Vector12r forces = -(*tetel->massMatrixInvProductstiffnessMatrix) * displacements
-	        - (mat->alpha * MatrixXr::Identity(12, 12) + (*tetel->massMatrixInvProductstiffnessMatrix) * (mat->beta)) * displacementvelocity;
-
-	scene->forces.addForce(i0->first->getId(), forces.segment(0, 3));
-	scene->forces.addForce(i1->first->getId(), forces.segment(3, 3));
-	scene->forces.addForce(i2->first->getId(), forces.segment(6, 3));
-	scene->forces.addForce(i3->first->getId(), forces.segment(9, 3));
+	addNodeForce(i0->first->getId(), forces.segment<3>(0));
+	addNodeForce(i1->first->getId(), forces.segment<3>(3));
+	addNodeForce(i2->first->getId(), forces.segment<3>(6));
+	addNodeForce(i3->first->getId(), forces.segment<3>(9));
 
 	return;
 }
 
+bool If2_Lin4NodeTetra_LinIsoRayleighDampElast::linearOperator(
+        const shared_ptr<Shape>& element, const shared_ptr<Material>& material, vector<Body::id_t>& ids, vector<Vector3r>& x0, MatrixXr& A, MatrixXr& D)
+{
+	Lin4NodeTetra*                    tetel = static_cast<Lin4NodeTetra*>(element.get());
+	const LinIsoRayleighDampElastMat* mat   = static_cast<const LinIsoRayleighDampElastMat*>(material.get());
+	if (!tetel->operatorCached) cacheOperator(*tetel, *mat);
+	ids.clear();
+	x0.clear();
+	for (const auto& n : tetel->localmap) {
+		ids.push_back(n.first->getId());
+		x0.push_back(n.second.position);
+	}
+	// the operators of go(), inverse mass times stiffness, not the stiffness matrix
+	A = tetel->massMatrixInvProductstiffnessMatrix;
+	D = mat->alpha * MatrixXr::Identity(12, 12) + mat->beta * tetel->massMatrixInvProductstiffnessMatrix;
+	return true;
+}
+
 } // namespace yade
 
 #endif //YADE_FEM
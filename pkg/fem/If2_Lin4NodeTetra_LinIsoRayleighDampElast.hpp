@@ -27,11 +27,13 @@ namespace yade { // Cannot have #include directive inside.
 class If2_Lin4NodeTetra_LinIsoRayleighDampElast : public InternalForceFunctor {
 public:
 	void go(const shared_ptr<Shape>&, const shared_ptr<Material>&, const shared_ptr<Body>&) override;
+	bool linearOperator(const shared_ptr<Shape>&, const shared_ptr<Material>&, vector<Body::id_t>&, vector<Vector3r>&, MatrixXr&, MatrixXr&) override;
+	void cacheOperator(Lin4NodeTetra& tetel, const LinIsoRayleighDampElastMat& mat) const;
 	virtual ~If2_Lin4NodeTetra_LinIsoRayleighDampElast();
 	FUNCTOR2D(Lin4NodeTetra, LinIsoRayleighDampElastMat);
 
 	// clang-format off
-		YADE_CLASS_BASE_DOC(If2_Lin4NodeTetra_LinIsoRayleighDampElast,InternalForceFunctor,"Apply internal forces of the tetrahedral element using lumped mass theory")
+		YADE_CLASS_BASE_DOC(If2_Lin4NodeTetra_LinIsoRayleighDampElast,InternalForceFunctor,"Apply internal forces of the tetrahedral element using lumped mass theory. The product of the inverse mass matrix and the stiffness matrix is computed once per element and kept in a fixed size matrix, the forces being evaluated with a single 12x12 matrix-vector product.")
 	// clang-format on
 
 	DECLARE_LOGGER;
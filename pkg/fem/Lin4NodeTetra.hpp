@@ -20,10 +20,14 @@ class NewtonIntegrator;
 namespace yade { // Cannot have #include directive inside.
 
 
+typedef Eigen::Matrix<Real, 12, 12> Matrix12r;
+typedef Eigen::Matrix<Real, 12, 1>  Vector12r;
+
 class Lin4NodeTetra : public DeformableElement {
 public:
 	friend class If2_Lin4NodeTetra_LinIsoRayleighDampElast;
-	shared_ptr<MatrixXr> massMatrixInvProductstiffnessMatrix;
+	Matrix12r massMatrixInvProductstiffnessMatrix; // cached by the internal force functor at the first step, fixed size so that the force kernel never allocates
+	bool      operatorCached = false;
 	MatrixXr             calculateStiffness(Real, Real, Vector3r, Vector3r, Vector3r, Vector3r);
 	MatrixXr             calculateMassMatrix(Real, Real);
 	virtual ~Lin4NodeTetra();
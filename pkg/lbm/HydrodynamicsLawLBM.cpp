@@ -25,6 +25,7 @@
 
 #include "HydrodynamicsLawLBM.hpp"
 #include <lib/base/AliasNamespaces.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <lib/high-precision/Constants.hpp>
 #include <core/Omega.hpp>
 #include <core/Scene.hpp>
@@ -546,7 +547,6 @@ void HydrodynamicsLawLBM::action()
 	/*************************************************************************/
 	/*                     SOLID OBSTACLES SET-UP                            */
 	/*************************************************************************/
-	Real Rmin                    = 1000.;
 	int  newFluidCells_couter    = 0;
 	int  newObstacleCells_couter = 0;
 
@@ -557,65 +557,27 @@ void HydrodynamicsLawLBM::action()
 	State* sWallZp = Body::byId(WallZp_id, scene)->state.get();
 	State* sWallZm = Body::byId(WallZm_id, scene)->state.get();
 
+	State* const walls[6]    = { sWallXp, sWallXm, sWallYp, sWallYm, sWallZp, sWallZm };
+	const bool   fullMapping = firstRun or remapThreshold <= 0 or wallsMoved(walls);
+
 	timingDeltas->checkpoint("Reinit:Nodes0");
+	if (fullMapping) {
+		if (remapThreshold > 0 and not firstRun) { // links persist between calls with the incremental mapping
+			for (auto& link : links)
+				link.ReinitDynamicalProperties();
+		}
+		int nbWallNodes = 0;
 #ifdef YADE_OPENMP
-#pragma omp parallel for
+#pragma omp parallel for reduction(+ : nbWallNodes)
 #endif
-	for (int nidx = 0; nidx < Nx * Ny; nidx++) {
-		/*------------------------------------------*/
-		/* Reinitialization:                        */
-		/*------------------------------------------*/
-		nodes[nidx].body_id = -1;
-		nodes[nidx].setAsFluid();
-		nodes[nidx].isObstacleBoundary = false;
-		nodes[nidx].isFluidBoundary    = false;
-		nodes[nidx].isNewObstacle      = false;
-		nodes[nidx].isNewFluid         = false;
-
-		/*--- according to X+ ---*/
-		if (useWallXp && (nodes[nidx].i >= invdx * (sWallXp->se3.position.x() - halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallXp_id;
-			NbSolidNodes++;
-		}
-		/*--- according to X- ---*/
-		else if (useWallXm && (nodes[nidx].i <= invdx * (sWallXm->se3.position.x() + halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallXm_id;
-			NbSolidNodes++;
-		}
-		/*--- according to Y+ ---*/
-		else if (useWallYp && (nodes[nidx].j >= invdx * (sWallYp->se3.position.y() - halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallYp_id;
-			NbSolidNodes++;
-		}
-		/*--- according to Y- ---*/
-		else if (useWallYm && (nodes[nidx].j <= invdx * (sWallYm->se3.position.y() + halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallYm_id;
-			NbSolidNodes++;
-		}
-		/*--- according to Z+ ---*/
-		else if (useWallZp && (nodes[nidx].k >= invdx * (sWallZp->se3.position.z() - halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallZp_id;
-			NbSolidNodes++;
-		}
-		/*--- according to Z- ---*/
-		else if (useWallZm && (nodes[nidx].k <= invdx * (sWallZm->se3.position.z() + halfWallthickness))) {
-			nodes[nidx].setAsObstacle();
-			nodes[nidx].isObstacleBoundary = true;
-			nodes[nidx].body_id            = WallZm_id;
-			NbSolidNodes++;
+		for (int nidx = 0; nidx < Nx * Ny; nidx++) {
+			if (resetNode(nidx, walls)) nbWallNodes++;
+			if (firstRun) { nodes[nidx].wasObstacle = nodes[nidx].isObstacle; }
 		}
-
-		if (firstRun) { nodes[nidx].wasObstacle = nodes[nidx].isObstacle; }
+		NbSolidNodes += nbWallNodes;
+		mappedWallPos.resize(6);
+		for (int w = 0; w < 6; w++)
+			mappedWallPos[w] = invdx * walls[w]->se3.position;
 	}
 
 	/*---------------------------------------------------------------*/
@@ -639,25 +601,7 @@ void HydrodynamicsLawLBM::action()
 			CurMinVelOfPtc = min(CurMinVelOfPtc, state->vel.norm());
 			CurMaxVelOfPtc = max(CurMaxVelOfPtc, state->vel.norm());
 
-			Vector3r posMax = LBbodies[id].pos + Vector3r(LBbodies[id].radius, LBbodies[id].radius, LBbodies[id].radius);
-			Vector3r posMin = LBbodies[id].pos - Vector3r(LBbodies[id].radius, LBbodies[id].radius, LBbodies[id].radius);
-
-			Vector3r dist = Vector3r::Zero();
-			for (int ii = int(math::round(posMin[0])) - 1; ii <= int(math::round(posMax[0])) + 1; ii++)
-				for (int jj = int(math::round(posMin[1])) - 1; jj <= int(math::round(posMax[1])) + 1; jj++) {
-					if ((ii == -1) || (ii == Nx) || (jj == -1) || (jj == Ny)) continue;
-					if ((ii < -1) || (ii > Nx) || (jj < -1) || (jj > Ny)) continue;
-					if (LBbodies[id].radius < Rmin) Rmin = LBbodies[id].radius;
-					int nidx = ii + jj * Nx;
-					dist     = nodes[nidx].posb - LBbodies[id].pos;
-					if (dist.norm() < LBbodies[id].radius) {
-						nodes[nidx].body_id = id;
-						nodes[nidx].setAsObstacle();
-						NbSolidNodes++;
-						NbParticleNodes++;
-					}
-					if (firstRun) { nodes[nidx].wasObstacle = nodes[nidx].isObstacle; }
-				}
+			if (fullMapping) mapSphereNodes(id, LBbodies[id].pos, LBbodies[id].radius, false);
 			/*-------------------------------------------------------------------*/
 			/* ///NOTE : this should be removed since it can be done with python */
 			///Fck: pas en MODE 1
@@ -691,48 +635,40 @@ void HydrodynamicsLawLBM::action()
 	}
 
 
+	if (fullMapping) {
 /*------------------------------------------------------------------*/
 /*------------------ detection of boundary nodes -------------------*/
 /*------------------------------------------------------------------*/
 #ifdef YADE_OPENMP
 #pragma omp parallel for
 #endif
-	for (int nidx = 0; nidx < Nx * Ny; nidx++)
-		if (nodes[nidx].isObstacle) {
-			for (unsigned int n = 0; n < nodes[nidx].neighbour_id.size(); n++) {
-				if (nodes[nidx].neighbour_id[n] != -1) {
-					int nidx2 = nodes[nidx].neighbour_id[n];
-					if (nodes[nidx].isObstacle != nodes[nidx2].isObstacle) {
-						nodes[nidx].isObstacleBoundary = true;
-						nodes[nidx2].isFluidBoundary   = true;
-						int BodyId                     = nodes[nidx].body_id;
-						int lid                        = nodes[nidx].links_id[n];
-						links[lid].isBd                = true;
-						links[lid].sid                 = nidx;
-						links[lid].fid                 = nidx2;
-						links[lid].idx_sigma_i         = opp[n];
-						if (LBbodies[BodyId].isPtc()) {
-							links[lid].DistMid = nodes[nidx].posb - 0.5 * eib[links[lid].idx_sigma_i] - LBbodies[BodyId].pos;
-							links[lid].VbMid   = LBbodies[BodyId].vel + LBbodies[BodyId].AVel.cross(links[lid].DistMid);
-							if (links[lid].VbMid.norm() < VbCutOff) links[lid].VbMid = Vector3r::Zero();
-						}
-						if (LBbodies[BodyId].isBox()) {
-							links[lid].DistMid = Vector3r::Zero();
-							links[lid].VbMid   = Vector3r::Zero();
-						}
+		for (int nidx = 0; nidx < Nx * Ny; nidx++)
+			if (nodes[nidx].isObstacle) {
+				for (unsigned int n = 0; n < nodes[nidx].neighbour_id.size(); n++) {
+					if (nodes[nidx].neighbour_id[n] != -1) {
+						int nidx2 = nodes[nidx].neighbour_id[n];
+						if (nodes[nidx].isObstacle != nodes[nidx2].isObstacle) setBoundaryLink(nidx, nidx2, n);
 					}
 				}
 			}
-		}
+		int nbInnerNodes = 0;
 #ifdef YADE_OPENMP
-#pragma omp parallel for
+#pragma omp parallel for reduction(+ : nbInnerNodes)
 #endif
-	for (int nidx = 0; nidx < Nx * Ny; nidx++)
-		if ((nodes[nidx].isObstacle) && (!nodes[nidx].isObstacleBoundary)) {
-			nodes[nidx].setAsFluid();
-			NbSolidNodes--;
-			if (firstRun) nodes[nidx].wasObstacle = nodes[nidx].isObstacle;
-		}
+		for (int nidx = 0; nidx < Nx * Ny; nidx++)
+			if ((nodes[nidx].isObstacle) && (!nodes[nidx].isObstacleBoundary)) {
+				nodes[nidx].setAsFluid();
+				nbInnerNodes++;
+				if (firstRun) nodes[nidx].wasObstacle = nodes[nidx].isObstacle;
+			}
+		NbSolidNodes -= nbInnerNodes;
+		NbSolidNodesMapped = NbSolidNodes;
+		nRemapped          = 0;
+		for (auto& lbb : LBbodies)
+			if (lbb.isPtc() and lbb.mappedRadius >= 0) nRemapped++;
+	} else {
+		incrementalMapping(walls);
+	}
 
 	NbFluidNodes = NbNodes - NbSolidNodes;
 	/*----------------------------------------------------------------------*/
@@ -823,6 +759,15 @@ void HydrodynamicsLawLBM::action()
 		RhomaxC     = -1000000.;
 		RhominC     = 1000000.;
 		RhoTot      = 0.;
+		if (partialSaturation) {
+#ifdef YADE_OPENMP
+			const size_t nThreads = omp_get_max_threads();
+#else
+			const size_t nThreads = 1;
+#endif
+			psmThreadForce.assign(nThreads, vector<Vector3r>(LBbodies.size(), Vector3r::Zero()));
+			psmThreadMomentum.assign(nThreads, vector<Vector3r>(LBbodies.size(), Vector3r::Zero()));
+		}
 /*------------------------------------------------------------------*/
 /*                          Loop on nodes                           */
 /*------------------------------------------------------------------*/
@@ -976,10 +921,28 @@ void HydrodynamicsLawLBM::action()
 			}
 			nodes[nidx].velb /= nodes[nidx].rhob;
 
-			Real temp0 = 1.5 * ((nodes[nidx].velb.x() * nodes[nidx].velb.x()) + (nodes[nidx].velb.y() * nodes[nidx].velb.y()));
-			Real cub0  = 3.0 * eib[0].dot(nodes[nidx].velb);
-			nodes[nidx].fpostcol[0]
-			        = nodes[nidx].f[0] - omega * (nodes[nidx].f[0] - (nodes[nidx].rhob * w[0] * (1. + cub0 + 0.5 * (cub0 * cub0) - temp0)));
+			if (partialSaturation and nodes[nidx].psmB > 0) {
+				/*--- force of the partially saturated node on the covering sphere [Noble1998] ---*/
+				const int id = nodes[nidx].psmBody;
+				Vector3r  Fn = Vector3r::Zero();
+				for (int dndx = 1; dndx < NbDir; dndx++)
+					Fn -= nodes[nidx].psmB * psmSolidTerm(nodes[nidx], dndx) * eib[dndx];
+#ifdef YADE_OPENMP
+				const int thread = omp_get_thread_num();
+#else
+				const int thread = 0;
+#endif
+				// LBbodies[].force holds half of the exchanged momentum (see the boundary links below, and the
+				// 2*Rho*c2*dx factor of the conversion to Fh), the 0.5 keeps Fn in the same convention
+				psmThreadForce[thread][id] += 0.5 * Fn;
+				psmThreadMomentum[thread][id] += 0.5 * (nodes[nidx].posb - LBbodies[id].pos).cross(Fn);
+				nodes[nidx].fpostcol[0] = psmCollision(nodes[nidx], 0);
+			} else {
+				Real temp0 = 1.5 * ((nodes[nidx].velb.x() * nodes[nidx].velb.x()) + (nodes[nidx].velb.y() * nodes[nidx].velb.y()));
+				Real cub0  = 3.0 * eib[0].dot(nodes[nidx].velb);
+				nodes[nidx].fpostcol[0]
+				        = nodes[nidx].f[0] - omega * (nodes[nidx].f[0] - (nodes[nidx].rhob * w[0] * (1. + cub0 + 0.5 * (cub0 * cub0) - temp0)));
+			}
 
 
 			nodes[nidx].fpostcol[0] = nodes[nidx].fpostcol[0] + (nodes[nidx].rhob * w[0]) / c2 * eib[0].dot(CstBodyForce);
@@ -992,6 +955,13 @@ void HydrodynamicsLawLBM::action()
 			if (RhominC > Rho * nodes[nidx].rhob) RhominC = Rho * nodes[nidx].rhob;
 			if (!nodes[nidx].isObstacle) VmeanFluidC += c * nodes[nidx].velb.norm();
 		}
+		if (partialSaturation) {
+			for (size_t t = 0; t < psmThreadForce.size(); t++)
+				for (size_t id = 0; id < LBbodies.size(); id++) {
+					LBbodies[id].force += psmThreadForce[t][id];
+					LBbodies[id].momentum += psmThreadMomentum[t][id];
+				}
+		}
 
 #ifdef YADE_OPENMP
 #pragma omp parallel for
@@ -1005,16 +975,24 @@ void HydrodynamicsLawLBM::action()
 			/*-------------------------------------------------- ---------------*/
 			/* equilibrium functions and collisions                             */
 			/*------------------------------------------------------------------*/
-			Real temp1 = 1.5 * ((nodes[nidx1].velb.x() * nodes[nidx1].velb.x()) + (nodes[nidx1].velb.y() * nodes[nidx1].velb.y()));
-			Real cub1  = 3.0 * eib[dndx1].dot(nodes[nidx1].velb);
-			nodes[nidx1].fpostcol[dndx1] = nodes[nidx1].fprecol[dndx1]
-			        - omega * (nodes[nidx1].fprecol[dndx1] - (nodes[nidx1].rhob * w[dndx1] * (1. + cub1 + 0.5 * (cub1 * cub1) - temp1)));
+			if (partialSaturation and nodes[nidx1].psmB > 0) {
+				nodes[nidx1].fpostcol[dndx1] = psmCollision(nodes[nidx1], dndx1);
+			} else {
+				Real temp1 = 1.5 * ((nodes[nidx1].velb.x() * nodes[nidx1].velb.x()) + (nodes[nidx1].velb.y() * nodes[nidx1].velb.y()));
+				Real cub1  = 3.0 * eib[dndx1].dot(nodes[nidx1].velb);
+				nodes[nidx1].fpostcol[dndx1] = nodes[nidx1].fprecol[dndx1]
+				        - omega * (nodes[nidx1].fprecol[dndx1] - (nodes[nidx1].rhob * w[dndx1] * (1. + cub1 + 0.5 * (cub1 * cub1) - temp1)));
+			}
 			nodes[nidx1].fpostcol[dndx1] = nodes[nidx1].fpostcol[dndx1] + (nodes[nidx1].rhob * w[dndx1]) / c2 * eib[dndx1].dot(CstBodyForce);
 			if (!links[lid].PointingOutside) {
-				Real temp2 = 1.5 * ((nodes[nidx2].velb.x() * nodes[nidx2].velb.x()) + (nodes[nidx2].velb.y() * nodes[nidx2].velb.y()));
-				Real cub2  = 3.0 * eib[dndx2].dot(nodes[nidx2].velb);
-				nodes[nidx2].fpostcol[dndx2] = nodes[nidx2].fprecol[dndx2]
-				        - omega * (nodes[nidx2].fprecol[dndx2] - (nodes[nidx2].rhob * w[dndx2] * (1. + cub2 + 0.5 * (cub2 * cub2) - temp2)));
+				if (partialSaturation and nodes[nidx2].psmB > 0) {
+					nodes[nidx2].fpostcol[dndx2] = psmCollision(nodes[nidx2], dndx2);
+				} else {
+					Real temp2 = 1.5 * ((nodes[nidx2].velb.x() * nodes[nidx2].velb.x()) + (nodes[nidx2].velb.y() * nodes[nidx2].velb.y()));
+					Real cub2  = 3.0 * eib[dndx2].dot(nodes[nidx2].velb);
+					nodes[nidx2].fpostcol[dndx2] = nodes[nidx2].fprecol[dndx2]
+					        - omega * (nodes[nidx2].fprecol[dndx2] - (nodes[nidx2].rhob * w[dndx2] * (1. + cub2 + 0.5 * (cub2 * cub2) - temp2)));
+				}
 				nodes[nidx2].fpostcol[dndx2]
 				        = nodes[nidx2].fpostcol[dndx2] + (nodes[nidx2].rhob * w[dndx2]) / c2 * eib[dndx2].dot(CstBodyForce);
 			}
@@ -1060,6 +1038,13 @@ void HydrodynamicsLawLBM::action()
 			int BodyId      = nodes[sid].body_id;
 
 
+			if (remapThreshold > 0 and LBbodies[BodyId].isPtc()) {
+				/*--- links persist between mappings, the wall velocity follows the sphere ---*/
+				links[lid].DistMid = nodes[sid].posb - 0.5 * eib[idx_sigma_i] - LBbodies[BodyId].pos;
+				links[lid].VbMid   = LBbodies[BodyId].vel + LBbodies[BodyId].AVel.cross(links[lid].DistMid);
+				if (links[lid].VbMid.norm() < VbCutOff) links[lid].VbMid = Vector3r::Zero();
+			}
+
 			/*--- forces and momenta for this boundary link ---*/
 			links[lid].ct             = 3.0 * w[idx_sigma_i] * nodes[sid].rhob * eib[links[lid].idx_sigma_i].dot(links[lid].VbMid);
 			Vector3r force_ij         = eib[links[lid].idx_sigma_i] * (nodes[fid].fpostcol[idx_sigma_i] - links[lid].ct);
@@ -1079,7 +1064,7 @@ void HydrodynamicsLawLBM::action()
 			}
 			nodes[fid].f[opp[idx_sigma_i]] = nodes[fid].fpostcol[idx_sigma_i] - 2.0 * links[lid].ct;
 			nodes[sid].f[idx_sigma_i]      = nodes[sid].fpostcol[opp[idx_sigma_i]] + 2.0 * links[lid].ct;
-			if ((MODE == 2) || ((MODE == 3) && (IterMax == 1))) { links[lid].ReinitDynamicalProperties(); }
+			if ((remapThreshold <= 0) && ((MODE == 2) || ((MODE == 3) && (IterMax == 1)))) { links[lid].ReinitDynamicalProperties(); }
 		}
 		VmeanFluidC = VmeanFluidC / NbFluidNodes;
 
@@ -1702,6 +1687,238 @@ void HydrodynamicsLawLBM::CalculateAndApplyForcesAndTorquesOnBodies(bool mean, b
 	}
 	return;
 }
+/*! Reset node nidx to its state without any sphere, i.e. fluid or inside a wall. Returns true if the node is inside a wall. */
+bool HydrodynamicsLawLBM::resetNode(int nidx, State* const walls[6])
+{
+	LBMnode& node = nodes[nidx];
+	node.body_id  = -1;
+	node.setAsFluid();
+	node.isObstacleBoundary = false;
+	node.isFluidBoundary    = false;
+	node.isNewObstacle      = false;
+	node.isNewFluid         = false;
+	node.psmB               = 0.;
+	node.psmBody            = -1;
+
+	int wallId = -1;
+	/*--- according to X+ ---*/
+	if (useWallXp && (node.i >= invdx * (walls[0]->se3.position.x() - halfWallthickness))) wallId = WallXp_id;
+	/*--- according to X- ---*/
+	else if (useWallXm && (node.i <= invdx * (walls[1]->se3.position.x() + halfWallthickness)))
+		wallId = WallXm_id;
+	/*--- according to Y+ ---*/
+	else if (useWallYp && (node.j >= invdx * (walls[2]->se3.position.y() - halfWallthickness)))
+		wallId = WallYp_id;
+	/*--- according to Y- ---*/
+	else if (useWallYm && (node.j <= invdx * (walls[3]->se3.position.y() + halfWallthickness)))
+		wallId = WallYm_id;
+	/*--- according to Z+ ---*/
+	else if (useWallZp && (node.k >= invdx * (walls[4]->se3.position.z() - halfWallthickness)))
+		wallId = WallZp_id;
+	/*--- according to Z- ---*/
+	else if (useWallZm && (node.k <= invdx * (walls[5]->se3.position.z() + halfWallthickness)))
+		wallId = WallZm_id;
+
+	if (wallId == -1) return false;
+	node.setAsObstacle();
+	node.isObstacleBoundary = true;
+	node.body_id            = wallId;
+	return true;
+}
+
+/*! Map the nodes covered by sphere id, centered at pos with the given radius (LB units). With onlyDirty, nodes outside the region being remapped are left untouched. */
+void HydrodynamicsLawLBM::mapSphereNodes(int id, const Vector3r& pos, Real radius, bool onlyDirty)
+{
+	const Vector3r posMax = pos + Vector3r(radius, radius, radius);
+	const Vector3r posMin = pos - Vector3r(radius, radius, radius);
+	for (int ii = int(math::round(posMin[0])) - 1; ii <= int(math::round(posMax[0])) + 1; ii++)
+		for (int jj = int(math::round(posMin[1])) - 1; jj <= int(math::round(posMax[1])) + 1; jj++) {
+			if ((ii < 0) || (ii >= Nx) || (jj < 0) || (jj >= Ny)) continue;
+			int nidx = ii + jj * Nx;
+			if (onlyDirty && !dirtyNode[nidx]) continue;
+			const Real dist = (nodes[nidx].posb - pos).norm();
+			if (partialSaturation) {
+				/*--- solid fraction from the distance to the surface, weighting of [Noble1998] ---*/
+				const Real eps = math::min(math::max(radius - dist + 0.5, Real(0.)), Real(1.));
+				if (eps > 0.) {
+					const Real B = eps * (tau - 0.5) / ((1. - eps) + (tau - 0.5));
+					if (B > nodes[nidx].psmB) {
+						nodes[nidx].psmB    = B;
+						nodes[nidx].psmBody = id;
+					}
+				}
+			} else if (dist < radius) {
+				nodes[nidx].body_id = id;
+				nodes[nidx].setAsObstacle();
+				if (!onlyDirty) {
+					NbSolidNodes++;
+					NbParticleNodes++;
+				}
+			}
+			if (firstRun) { nodes[nidx].wasObstacle = nodes[nidx].isObstacle; }
+		}
+	LBbodies[id].mappedPos    = pos;
+	LBbodies[id].mappedRadius = radius;
+}
+
+/*! Link between the solid node sid and the fluid node fid, n being the direction from sid to fid. */
+void HydrodynamicsLawLBM::setBoundaryLink(int sid, int fid, int n)
+{
+	nodes[sid].isObstacleBoundary = true;
+	nodes[fid].isFluidBoundary    = true;
+	int BodyId                    = nodes[sid].body_id;
+	int lid                       = nodes[sid].links_id[n];
+	links[lid].isBd               = true;
+	links[lid].sid                = sid;
+	links[lid].fid                = fid;
+	links[lid].idx_sigma_i        = opp[n];
+	if (LBbodies[BodyId].isPtc()) {
+		links[lid].DistMid = nodes[sid].posb - 0.5 * eib[links[lid].idx_sigma_i] - LBbodies[BodyId].pos;
+		links[lid].VbMid   = LBbodies[BodyId].vel + LBbodies[BodyId].AVel.cross(links[lid].DistMid);
+		if (links[lid].VbMid.norm() < VbCutOff) links[lid].VbMid = Vector3r::Zero();
+	}
+	if (LBbodies[BodyId].isBox()) {
+		links[lid].DistMid = Vector3r::Zero();
+		links[lid].VbMid   = Vector3r::Zero();
+	}
+}
+
+boost::python::list HydrodynamicsLawLBM::getNodeStates() const
+{
+	boost::python::list ret;
+	for (const auto& node : nodes)
+		ret.append(boost::python::make_tuple(node.isObstacle, node.isObstacleBoundary, node.isFluidBoundary, node.body_id, node.psmB, node.psmBody));
+	return ret;
+}
+
+/*! True if a wall moved by more than remapThreshold since the last full mapping. */
+bool HydrodynamicsLawLBM::wallsMoved(State* const walls[6])
+{
+	if (mappedWallPos.size() != 6) return true;
+	for (int w = 0; w < 6; w++)
+		if ((invdx * walls[w]->se3.position - mappedWallPos[w]).norm() > remapThreshold) return true;
+	return false;
+}
+
+/*! Remap the nodes and links around the spheres which moved by more than remapThreshold since they were last mapped.
+ * Each such sphere dirties the nodes of the box bounding its old and new positions, with a margin of two nodes so that the nodes
+ * left untouched keep valid flags. The dirty nodes are reset, then remapped with all the spheres overlapping them (at the position
+ * they were mapped with, so that a sphere stays consistent across the dirty boundary). */
+void HydrodynamicsLawLBM::incrementalMapping(State* const walls[6])
+{
+	dirtyNode.resize(Nx * Ny, 0);
+	vector<int>        dirty;
+	vector<Vector2i>   boxMin, boxMax;
+	vector<Body::id_t> spheres;
+	for (const auto& b : *scene->bodies) {
+		if (!b || b->shape->getClassName() != "Sphere") continue;
+		const int id = b->getId();
+		spheres.push_back(id);
+		const LBMbody& lbb   = LBbodies[id];
+		const bool     moved = (lbb.mappedRadius < 0) || ((lbb.pos - lbb.mappedPos).norm() > remapThreshold)
+		        || (math::abs(lbb.radius - lbb.mappedRadius) > remapThreshold);
+		if (!moved) continue;
+		Vector3r lo = lbb.pos - Vector3r::Constant(lbb.radius), hi = lbb.pos + Vector3r::Constant(lbb.radius);
+		if (lbb.mappedRadius >= 0) {
+			lo = lo.cwiseMin(lbb.mappedPos - Vector3r::Constant(lbb.mappedRadius));
+			hi = hi.cwiseMax(lbb.mappedPos + Vector3r::Constant(lbb.mappedRadius));
+		}
+		const Vector2i bMin(math::max(int(math::floor(lo[0])) - 2, 0), math::max(int(math::floor(lo[1])) - 2, 0));
+		const Vector2i bMax(math::min(int(math::ceil(hi[0])) + 2, Nx - 1), math::min(int(math::ceil(hi[1])) + 2, Ny - 1));
+		if (bMin[0] > bMax[0] || bMin[1] > bMax[1]) continue;
+		boxMin.push_back(bMin);
+		boxMax.push_back(bMax);
+		for (int jj = bMin[1]; jj <= bMax[1]; jj++)
+			for (int ii = bMin[0]; ii <= bMax[0]; ii++) {
+				const int nidx = ii + jj * Nx;
+				if (!dirtyNode[nidx]) {
+					dirtyNode[nidx] = 1;
+					dirty.push_back(nidx);
+				}
+			}
+	}
+	nRemapped    = boxMin.size();
+	NbSolidNodes = NbSolidNodesMapped;
+	if (dirty.empty()) return;
+
+	/*--- reset of the dirty nodes and of their links ---*/
+	int before = 0;
+	for (int nidx : dirty) {
+		if (nodes[nidx].isObstacle) before++;
+		resetNode(nidx, walls);
+		for (int lid : nodes[nidx].links_id)
+			if (lid != -1) links[lid].ReinitDynamicalProperties();
+	}
+
+	/*--- spheres overlapping the dirty boxes ---*/
+	for (Body::id_t id : spheres) {
+		LBMbody&   lbb   = LBbodies[id];
+		const bool moved = (lbb.mappedRadius < 0) || ((lbb.pos - lbb.mappedPos).norm() > remapThreshold)
+		        || (math::abs(lbb.radius - lbb.mappedRadius) > remapThreshold);
+		const Vector3r pos    = moved ? lbb.pos : lbb.mappedPos;
+		const Real     radius = moved ? lbb.radius : lbb.mappedRadius;
+		const int      iMin = int(math::round(pos[0] - radius)) - 1, iMax = int(math::round(pos[0] + radius)) + 1;
+		const int      jMin = int(math::round(pos[1] - radius)) - 1, jMax = int(math::round(pos[1] + radius)) + 1;
+		for (size_t bx = 0; bx < boxMin.size(); bx++)
+			if (iMin <= boxMax[bx][0] && iMax >= boxMin[bx][0] && jMin <= boxMax[bx][1] && jMax >= boxMin[bx][1]) {
+				mapSphereNodes(id, pos, radius, true);
+				break;
+			}
+	}
+
+	/*--- boundary links: the nodes covered by a body (walls, spheres) keep their body_id even when they are inside the body ---*/
+	int extra = 0;
+	for (int nidx : dirty) {
+		const bool covered = (nodes[nidx].body_id != -1);
+		for (unsigned int n = 0; n < nodes[nidx].neighbour_id.size(); n++) {
+			const int m = nodes[nidx].neighbour_id[n];
+			if (m == -1 || covered == (nodes[m].body_id != -1)) continue;
+			if (covered) setBoundaryLink(nidx, m, n);
+			else if (!dirtyNode[m]) {
+				if (!nodes[m].isObstacle) { // inner node of a sphere which now lies on its surface
+					nodes[m].setAsObstacle();
+					extra++;
+				}
+				setBoundaryLink(m, nidx, opp[n]);
+			}
+		}
+	}
+	int after = 0;
+	for (int nidx : dirty) {
+		if ((nodes[nidx].isObstacle) && (!nodes[nidx].isObstacleBoundary)) nodes[nidx].setAsFluid();
+		if (nodes[nidx].isObstacle) after++;
+		dirtyNode[nidx] = 0;
+	}
+	NbSolidNodes       = NbSolidNodesMapped - before + after + extra;
+	NbSolidNodesMapped = NbSolidNodes;
+}
+
+/*! Difference between the solid and fluid collision terms of direction dndx at a partially saturated node: the bounce-back of the
+ * non-equilibrium part around the velocity of the sphere, as in [Noble1998]. */
+Real HydrodynamicsLawLBM::psmSolidTerm(const LBMnode& node, int dndx) const
+{
+	const LBMbody& lbb   = LBbodies[node.psmBody];
+	const Vector3r us    = lbb.vel + lbb.AVel.cross(node.posb - lbb.pos);
+	const int      o     = opp[dndx];
+	const Real     uu    = 1.5 * (node.velb.x() * node.velb.x() + node.velb.y() * node.velb.y());
+	const Real     usus  = 1.5 * (us.x() * us.x() + us.y() * us.y());
+	const Real     cuo   = 3.0 * eib[o].dot(node.velb);
+	const Real     cusd  = 3.0 * eib[dndx].dot(us);
+	const Real     feqO  = w[o] * node.rhob * (1. + cuo + 0.5 * cuo * cuo - uu);
+	const Real     feqSD = w[dndx] * node.rhob * (1. + cusd + 0.5 * cusd * cusd - usus);
+	return node.fprecol[o] - feqO + feqSD - node.fprecol[dndx];
+}
+
+/*! Post-collision population of direction dndx at a partially saturated node. */
+Real HydrodynamicsLawLBM::psmCollision(const LBMnode& node, int dndx) const
+{
+	const Real uu   = 1.5 * (node.velb.x() * node.velb.x() + node.velb.y() * node.velb.y());
+	const Real cu   = 3.0 * eib[dndx].dot(node.velb);
+	const Real feq  = w[dndx] * node.rhob * (1. + cu + 0.5 * cu * cu - uu);
+	const Real fpre = node.fprecol[dndx];
+	return fpre - (1. - node.psmB) * omega * (fpre - feq) + node.psmB * psmSolidTerm(node, dndx);
+}
+
 YADE_PLUGIN((HydrodynamicsLawLBM));
 
 } // namespace yade
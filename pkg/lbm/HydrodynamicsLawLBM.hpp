@@ -25,6 +25,7 @@
 
 #pragma once
 #include <core/GlobalEngine.hpp>
+#include <core/State.hpp>
 #include <pkg/lbm/LBMbody.hpp>
 #include <pkg/lbm/LBMlink.hpp>
 #include <pkg/lbm/LBMnode.hpp>
@@ -148,6 +149,19 @@ public:
 
 	Vector3r FhTotale; ///Total hydrodynamic force
 
+	vector<Vector3r>         mappedWallPos;                    /*! wall positions (LB unit) at the last full mapping*/
+	int                      NbSolidNodesMapped;               /*! NbSolidNodes after the last mapping*/
+	vector<char>             dirtyNode;                        /*! nodes to remap in the incremental mapping*/
+	vector<vector<Vector3r>> psmThreadForce, psmThreadMomentum; /*! per-thread hydrodynamic force and momentum of partially saturated cells*/
+
+	bool resetNode(int nidx, State* const walls[6]);
+	void mapSphereNodes(int id, const Vector3r& pos, Real radius, bool onlyDirty);
+	bool wallsMoved(State* const walls[6]);
+	void incrementalMapping(State* const walls[6]);
+	void setBoundaryLink(int sid, int fid, int n);
+	Real psmSolidTerm(const LBMnode& node, int dndx) const;
+	Real psmCollision(const LBMnode& node, int dndx) const;
+
 	virtual ~HydrodynamicsLawLBM();
 	bool isActivated() override;
 	void action() override;
@@ -164,9 +178,10 @@ public:
 	void modeTransition();
 	void LbmEnd();
 	void CalculateAndApplyForcesAndTorquesOnBodies(bool mean, bool apply);
+	boost::python::list getNodeStates() const;
 
 	// clang-format off
-	YADE_CLASS_BASE_DOC_ATTRS_CTOR(HydrodynamicsLawLBM,GlobalEngine,"Engine to simulate fluid flow (with the lattice Boltzmann method) with a coupling with the discrete element method.\n If you use this Engine, please cite and refer to F. Lominé et al. International Journal For Numerical and Analytical Method in Geomechanics, 2012, doi: 10.1002/nag.1109",
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(HydrodynamicsLawLBM,GlobalEngine,"Engine to simulate fluid flow (with the lattice Boltzmann method) with a coupling with the discrete element method.\n If you use this Engine, please cite and refer to F. Lominé et al. International Journal For Numerical and Analytical Method in Geomechanics, 2012, doi: 10.1002/nag.1109",
 
 				((int,WallYm_id,0,,"Identifier of the Y- wall"))
 				((bool,useWallYm,true,,"Set true if you want that the LBM see the wall in Ym"))
@@ -236,6 +251,9 @@ public:
 				((Real,EndTime,-1,,"the time to stop the simulation"))
                 ((Vector3r,CstBodyForce,Vector3r::Zero(),,"A constant body force (=that does not vary in time or space, otherwise the implementation introduces errors)"))
 				((Real,VbCutOff,-1,,"the minimum boundary velocity that is taken into account"))
+				((Real,remapThreshold,0,,"If >0, lattice nodes and links are remapped only around the spheres which moved by more than remapThreshold lattice spacings (or whose radius changed by as much) since they were last mapped, instead of around all bodies at each call. The wall velocity of the links is then evaluated with the current velocities of the spheres. A displacement of the walls larger than remapThreshold triggers a full mapping. If 0, all the nodes are remapped at each call."))
+				((bool,partialSaturation,false,,"Couple the spheres with the partially saturated cells method of [Noble1998]_ instead of bounce-back links: each node covered by a sphere gets a solid fraction from its distance to the sphere surface, the collision blends the fluid and solid operators accordingly, and the hydrodynamic force is the sum of the solid collision terms. No link is built for the spheres, walls still use bounce-back links."))
+				((int,nRemapped,0,Attr::readonly,"Number of spheres whose nodes were remapped at the last call."))
                                 ,
     			firstRun  = true;
     			omega = 1.0/tau;
@@ -290,8 +308,10 @@ public:
     			LBM_ITER=0;
     			DEM_ITER=0;
                 IdFirstSphere=-1;
+                NbSolidNodesMapped=0;
                 timingDeltas=shared_ptr<TimingDeltas>(new TimingDeltas);
-
+				,
+				.def("getNodeStates",&HydrodynamicsLawLBM::getNodeStates,"The solid mapping of the nodes, node i+j*Nx giving the tuple (isObstacle, isObstacleBoundary, isFluidBoundary, body id, solid weight of the partially saturated cell, body covering the partially saturated cell). The body ids are -1 for no body. Empty before the first iteration.")
 				);
 	// clang-format on
 	DECLARE_LOGGER;
@@ -0,0 +1,461 @@
+/*************************************************************************
+*  This program is free software; it is licensed under the terms of the  *
+*  GNU General Public License v2 or later. See file LICENSE for details. *
+*************************************************************************/
+#ifdef LBM_ENGINE
+
+#include "HydrodynamicsLawLBM3D.hpp"
+#include <lib/base/openmp-accu.hpp>
+#include <core/Scene.hpp>
+#include <pkg/common/Sphere.hpp>
+#include <chrono>
+
+namespace yade { // Cannot have #include directive inside.
+
+YADE_PLUGIN((HydrodynamicsLawLBM3D));
+CREATE_LOGGER(HydrodynamicsLawLBM3D);
+
+namespace {
+	/* D3Q19 velocities: rest, 6 faces, 12 edges, opposite directions paired */
+	constexpr int CX[19]  = { 0, 1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0 };
+	constexpr int CY[19]  = { 0, 0, 0, 1, -1, 0, 0, 1, -1, -1, 1, 0, 0, 0, 0, 1, -1, 1, -1 };
+	constexpr int CZ[19]  = { 0, 0, 0, 0, 0, 1, -1, 0, 0, 0, 0, 1, -1, -1, 1, 1, -1, -1, 1 };
+	constexpr int OPP[19] = { 0, 2, 1, 4, 3, 6, 5, 8, 7, 10, 9, 12, 11, 14, 13, 16, 15, 18, 17 };
+	const Real    W[19]   = { 1. / 3.,  1. / 18., 1. / 18., 1. / 18., 1. / 18., 1. / 18., 1. / 18., 1. / 36., 1. / 36., 1. / 36.,
+                          1. / 36., 1. / 36., 1. / 36., 1. / 36., 1. / 36., 1. / 36., 1. / 36., 1. / 36., 1. / 36. };
+
+	// BGK collision with Guo's forcing (acceleration g in lattice units), fq holds the incoming populations and receives the outgoing ones
+	inline Real collide(Real* fq, Real omega, Real gx, Real gy, Real gz)
+	{
+		Real density = 0, jx = 0, jy = 0, jz = 0;
+		for (int q = 0; q < 19; q++) {
+			density += fq[q];
+			jx += CX[q] * fq[q];
+			jy += CY[q] * fq[q];
+			jz += CZ[q] * fq[q];
+		}
+		const Real ux = jx / density + 0.5 * gx, uy = jy / density + 0.5 * gy, uz = jz / density + 0.5 * gz;
+		const Real usq = 1.5 * (ux * ux + uy * uy + uz * uz);
+		for (int q = 0; q < 19; q++) {
+			const Real cu  = CX[q] * ux + CY[q] * uy + CZ[q] * uz;
+			const Real feq = W[q] * density * (1. + 3. * cu + 4.5 * cu * cu - usq);
+			const Real fg  = (1. - 0.5 * omega) * W[q] * density
+			        * (3. * ((CX[q] - ux) * gx + (CY[q] - uy) * gy + (CZ[q] - uz) * gz) + 9. * cu * (CX[q] * gx + CY[q] * gy + CZ[q] * gz));
+			fq[q] = fq[q] - omega * (fq[q] - feq) + fg;
+		}
+		return density;
+	}
+
+	/* Fused stream-and-collide on a run [n0,n1) of bulk nodes, where all the read and write locations are at constant offsets.
+	The run is processed by blocks of nodes copied to a small SoA buffer, so that every loop below is a unit-stride loop over the nodes of the block. */
+	template <bool odd> void bulkRun(Real* f, Real* rho, long N, const long* offset, long n0, long n1, Real omega, Real gx, Real gy, Real gz)
+	{
+		const int B = 64;
+		Real      fq[19][B], rh[B], ux[B], uy[B], uz[B], usq[B];
+		for (long nb = n0; nb < n1; nb += B) {
+			const int len = int(std::min(long(B), n1 - nb));
+			for (int q = 0; q < 19; q++) {
+				const Real* src = odd ? f + OPP[q] * N + nb - offset[q] : f + q * N + nb;
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+				for (int l = 0; l < len; l++)
+					fq[q][l] = src[l];
+			}
+			for (int l = 0; l < len; l++)
+				rh[l] = ux[l] = uy[l] = uz[l] = 0;
+			for (int q = 0; q < 19; q++) {
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+				for (int l = 0; l < len; l++) {
+					rh[l] += fq[q][l];
+					ux[l] += CX[q] * fq[q][l];
+					uy[l] += CY[q] * fq[q][l];
+					uz[l] += CZ[q] * fq[q][l];
+				}
+			}
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+			for (int l = 0; l < len; l++) {
+				const Real inv = 1. / rh[l];
+				ux[l]          = ux[l] * inv + 0.5 * gx;
+				uy[l]          = uy[l] * inv + 0.5 * gy;
+				uz[l]          = uz[l] * inv + 0.5 * gz;
+				usq[l]         = 1.5 * (ux[l] * ux[l] + uy[l] * uy[l] + uz[l] * uz[l]);
+			}
+			for (int q = 0; q < 19; q++) {
+				const Real wf = (1. - 0.5 * omega) * W[q], cg = CX[q] * gx + CY[q] * gy + CZ[q] * gz;
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+				for (int l = 0; l < len; l++) {
+					const Real cu  = CX[q] * ux[l] + CY[q] * uy[l] + CZ[q] * uz[l];
+					const Real feq = W[q] * rh[l] * (1. + 3. * cu + 4.5 * cu * cu - usq[l]);
+					const Real fg  = wf * rh[l] * (3. * (cg - ux[l] * gx - uy[l] * gy - uz[l] * gz) + 9. * cu * cg);
+					fq[q][l]       = fq[q][l] - omega * (fq[q][l] - feq) + fg;
+				}
+			}
+			for (int q = 0; q < 19; q++) {
+				Real* dst = odd ? f + q * N + nb + offset[q] : f + OPP[q] * N + nb;
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+				for (int l = 0; l < len; l++)
+					dst[l] = fq[q][l];
+			}
+			std::copy(rh, rh + len, rho + nb);
+		}
+	}
+}
+
+HydrodynamicsLawLBM3D::~HydrodynamicsLawLBM3D() { }
+
+long HydrodynamicsLawLBM3D::neighbour(long n, int q) const
+{
+	int i = int(n % sx), j = int((n / sx) % sy), k = int(n / (long(sx) * sy));
+	// no wrap is needed in non-periodic directions, since the ghost layer separates fluid nodes from the storage boundary
+	i = (i + CX[q] + sx) % sx;
+	j = (j + CY[q] + sy) % sy;
+	k = (k + CZ[q] + sz) % sz;
+	return i + sx * (j + long(sy) * k);
+}
+
+long HydrodynamicsLawLBM3D::readLocation(long n, int q, bool odd) const
+{
+	const long s = neighbour(n, OPP[q]); // upstream node x-c_q
+	if (obst[s] == -1) return odd ? OPP[q] * nodesCount + s : q * nodesCount + n;
+	else
+		return odd ? q * nodesCount + n : OPP[q] * nodesCount + s; // where x stored f*_opp(q) at the previous step, for bounce-back
+}
+
+Vector3r HydrodynamicsLawLBM3D::armOf(const Vector3r& x, int b) const
+{
+	Vector3r  d       = x - sphPos[b];
+	const int dims[3] = { sx, sy, sz };
+	for (int a = 0; a < 3; a++)
+		if (periodic[a]) d[a] -= dims[a] * math::round(d[a] / dims[a]); // closest periodic image of the sphere
+	return d;
+}
+
+void HydrodynamicsLawLBM3D::equilibrium(Real density, const Vector3r& u, Real* feq) const
+{
+	const Real usq = 1.5 * u.squaredNorm();
+	for (int q = 0; q < Q; q++) {
+		const Real cu = CX[q] * u[0] + CY[q] * u[1] + CZ[q] * u[2];
+		feq[q]        = W[q] * density * (1. + 3. * cu + 4.5 * cu * cu - usq);
+	}
+}
+
+void HydrodynamicsLawLBM3D::initLattice()
+{
+	if (dx <= 0 or (upperCorner - lowerCorner).minCoeff() <= 0) throw std::runtime_error("HydrodynamicsLawLBM3D: define dx>0 and upperCorner>lowerCorner.");
+	if (tau <= 0.5) throw std::runtime_error("HydrodynamicsLawLBM3D: tau must be larger than 0.5.");
+	for (int d = 0; d < 3; d++)
+		nCells[d] = std::max(1, int(math::round((upperCorner[d] - lowerCorner[d]) / dx)));
+	gx = periodic[0] ? 0 : 1;
+	gy = periodic[1] ? 0 : 1;
+	gz = periodic[2] ? 0 : 1;
+	sx = nCells[0] + 2 * gx;
+	sy = nCells[1] + 2 * gy;
+	sz = nCells[2] + 2 * gz;
+	nodesCount = long(sx) * sy * sz;
+	for (int q = 0; q < Q; q++)
+		offset[q] = CX[q] + sx * (CY[q] + long(sy) * CZ[q]);
+
+	omega   = 1. / tau;
+	dt      = (tau - 0.5) / 3. * dx * dx / Nu;
+	lbmDt   = dt;
+	lbmTime = scene->time;
+
+	Real feq[Q];
+	equilibrium(1., initVel * dt / dx, feq);
+	f.resize(Q * nodesCount);
+	for (int q = 0; q < Q; q++)
+		std::fill(f.begin() + q * nodesCount, f.begin() + (q + 1) * nodesCount, feq[q]);
+	rho.assign(nodesCount, 1.);
+	obst.assign(nodesCount, -1);
+	bulk.assign(nodesCount, 0);
+	LOG_INFO(
+	        "D3Q19 lattice of " << nCells[0] << "x" << nCells[1] << "x" << nCells[2] << " nodes, dt=" << dt << ", "
+	                            << Real(sizeof(Real) * (Q + 1) * nodesCount) / (1 << 20) << " MB of populations");
+}
+
+void HydrodynamicsLawLBM3D::collectSpheres()
+{
+	sphId.clear();
+	sphPos.clear();
+	sphVel.clear();
+	sphAngVel.clear();
+	sphRad.clear();
+	const Vector3r shift(gx - 0.5, gy - 0.5, gz - 0.5); // lattice coordinates: storage node (i,j,k) is at (i,j,k)
+	for (const auto& b : *scene->bodies) {
+		if (!b) continue;
+		const Sphere* sphere = dynamic_cast<Sphere*>(b->shape.get());
+		if (!sphere) continue;
+		sphId.push_back(b->getId());
+		sphPos.push_back((b->state->pos - lowerCorner) / dx + shift);
+		sphVel.push_back(b->state->vel * dt / dx);
+		sphAngVel.push_back(b->state->angVel * dt);
+		sphRad.push_back(RadFactor * sphere->radius / dx);
+	}
+	sphForce.assign(sphId.size(), Vector3r::Zero());
+	sphTorque.assign(sphId.size(), Vector3r::Zero());
+}
+
+void HydrodynamicsLawLBM3D::mapSolids()
+{
+	const bool first = prevObst.empty();
+	prevObst.swap(obst);
+	obst.resize(nodesCount);
+	// walls of the ghost layer, fluid elsewhere
+#ifdef YADE_OPENMP
+#pragma omp parallel for
+#endif
+	for (long n = 0; n < nodesCount; n++) {
+		const int i = int(n % sx), j = int((n / sx) % sy), k = int(n / (long(sx) * sy));
+		obst[n]     = (gx and (i == 0 or i == sx - 1)) or (gy and (j == 0 or j == sy - 1)) or (gz and (k == 0 or k == sz - 1)) ? -2 : -1;
+	}
+	// nodes inside spheres, plane by plane so that overlapping spheres do not race (the last sphere wins, as in a serial loop)
+	const int                            dims[3] = { sx, sy, sz }, ghosts[3] = { gx, gy, gz };
+	vector<vector<std::pair<int, int>>> planes(sz); // (sphere, unwrapped plane index)
+	auto range = [&](int d, Real c, Real h, int& lo, int& hi) {
+		lo = int(math::ceil(c - h));
+		hi = int(math::floor(c + h));
+		if (not periodic[d]) {
+			lo = std::max(lo, ghosts[d]);
+			hi = std::min(hi, dims[d] - 1 - ghosts[d]);
+		}
+	};
+	auto wrap = [&](int d, int i) { return ((i % dims[d]) + dims[d]) % dims[d]; };
+	for (int b = 0; b < int(sphId.size()); b++) {
+		int lo, hi;
+		range(2, sphPos[b][2], sphRad[b], lo, hi);
+		for (int kk = lo; kk <= hi; kk++)
+			planes[wrap(2, kk)].push_back(std::make_pair(b, kk));
+	}
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int k = 0; k < sz; k++) {
+		for (const auto& p : planes[k]) {
+			const int      b  = p.first;
+			const Vector3r c  = sphPos[b];
+			const Real     dz = p.second - c[2];
+			const Real     h2 = sphRad[b] * sphRad[b] - dz * dz;
+			if (h2 < 0) continue;
+			int jlo, jhi;
+			range(1, c[1], sqrt(h2), jlo, jhi);
+			for (int jj = jlo; jj <= jhi; jj++) {
+				const Real dy = jj - c[1];
+				if (h2 - dy * dy < 0) continue;
+				int ilo, ihi;
+				range(0, c[0], sqrt(h2 - dy * dy), ilo, ihi);
+				const long row = sx * (wrap(1, jj) + long(sy) * k);
+				for (int ii = ilo; ii <= ihi; ii++)
+					obst[row + wrap(0, ii)] = b;
+			}
+		}
+	}
+	if (first) prevObst = obst;
+	else
+		refillNewFluid();
+	// bulk nodes and fluid count
+	vector<long> fluidCount(1, 0);
+#ifdef YADE_OPENMP
+	fluidCount.resize(omp_get_max_threads(), 0);
+#pragma omp parallel for
+#endif
+	for (long n = 0; n < nodesCount; n++) {
+		bulk[n] = 0;
+		if (obst[n] != -1) continue;
+#ifdef YADE_OPENMP
+		fluidCount[omp_get_thread_num()]++;
+#else
+		fluidCount[0]++;
+#endif
+		const int i = int(n % sx), j = int((n / sx) % sy), k = int(n / (long(sx) * sy));
+		if (i == 0 or i == sx - 1 or j == 0 or j == sy - 1 or k == 0 or k == sz - 1) continue;
+		bool allFluid = true;
+		for (int q = 1; q < Q and allFluid; q++)
+			allFluid = obst[n + offset[q]] == -1;
+		bulk[n] = allFluid;
+	}
+	nFluid = 0;
+	for (long c : fluidCount)
+		nFluid += c;
+}
+
+void HydrodynamicsLawLBM3D::refillNewFluid()
+{
+	// Nodes uncovered by a sphere get equilibrium populations at the local wall velocity, as incoming populations for themselves and as
+	// outgoing populations for their old fluid neighbours (new fluid neighbours fill their incoming slots themselves, so that each slot has one writer).
+	const bool odd = lbmIter % 2;
+#ifdef YADE_OPENMP
+#pragma omp parallel for
+#endif
+	for (long n = 0; n < nodesCount; n++) {
+		if (obst[n] != -1 or prevObst[n] == -1) continue;
+		Real density = 0;
+		int  count   = 0;
+		for (int q = 1; q < Q; q++) {
+			const long m = neighbour(n, q);
+			if (obst[m] == -1 and prevObst[m] == -1) {
+				density += rho[m];
+				count++;
+			}
+		}
+		density      = count ? density / count : 1.;
+		Vector3r u   = Vector3r::Zero();
+		const int b = prevObst[n];
+		if (b >= 0 and b < int(sphPos.size())) { // the sphere that uncovered that node, unless bodies were inserted or erased since the last mapping
+			u = sphVel[b] + sphAngVel[b].cross(armOf(Vector3r(n % sx, (n / sx) % sy, n / (long(sx) * sy)), b));
+		}
+		Real feq[Q];
+		equilibrium(density, u, feq);
+		rho[n] = density;
+		for (int q = 0; q < Q; q++) {
+			f[readLocation(n, q, odd)] = feq[q];
+			const long m               = neighbour(n, q);
+			if (q and obst[m] == -1 and prevObst[m] == -1) f[readLocation(m, q, odd)] = feq[q];
+		}
+	}
+}
+
+void HydrodynamicsLawLBM3D::streamCollide(bool odd)
+{
+	const Real     dx2dt2 = dt * dt / dx;
+	const Vector3r g      = bodyForce * dx2dt2;
+	const long     N      = nodesCount;
+	Real*          F      = f.data();
+	Real*          R      = rho.data();
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long row = 0; row < long(sy) * sz; row++) {
+		const int j = int(row % sy), k = int(row / sy);
+		if ((gy and (j == 0 or j == sy - 1)) or (gz and (k == 0 or k == sz - 1))) continue;
+#ifdef YADE_OPENMP
+		const int tid = omp_get_thread_num();
+#else
+		const int tid = 0;
+#endif
+		const long rowStart = row * sx;
+		for (int i = gx; i < sx - gx;) {
+			long n = rowStart + i;
+			if (bulk[n]) { // longest run of bulk nodes
+				int i1 = i + 1;
+				while (i1 < sx - gx and bulk[rowStart + i1])
+					i1++;
+				if (odd) bulkRun<true>(F, R, N, offset, n, rowStart + i1, omega, g[0], g[1], g[2]);
+				else
+					bulkRun<false>(F, R, N, offset, n, rowStart + i1, omega, g[0], g[1], g[2]);
+				i = i1;
+				continue;
+			}
+			const int ci = i++;
+			if (obst[n] != -1) continue;
+			// fluid node next to a solid or to the storage boundary
+			Real fq[Q];
+			for (int q = 0; q < Q; q++) {
+				const long s = neighbour(n, OPP[q]);
+				fq[q]        = F[readLocation(n, q, odd)];
+				if (obst[s] < 0) continue;
+				// moving bounce-back on the link of direction q from sphere b, momentum exchange as in HydrodynamicsLawLBM
+				const int      b    = obst[s];
+				const Vector3r d    = armOf(Vector3r(ci - 0.5 * CX[q], j - 0.5 * CY[q], k - 0.5 * CZ[q]), b); // from the sphere center to the link midpoint
+				const Vector3r vb   = sphVel[b] + sphAngVel[b].cross(d);
+				const Real     fs   = fq[q];
+				fq[q]               = fs + 6. * W[q] * R[n] * (CX[q] * vb[0] + CY[q] * vb[1] + CZ[q] * vb[2]);
+				const Vector3r dmom = -(fs + fq[q]) * Vector3r(CX[q], CY[q], CZ[q]);
+				threadForce[tid][b] += dmom;
+				threadTorque[tid][b] += d.cross(dmom);
+			}
+			R[n] = collide(fq, omega, g[0], g[1], g[2]);
+			for (int q = 0; q < Q; q++)
+				F[odd ? q * N + neighbour(n, q) : OPP[q] * N + n] = fq[q];
+		}
+	}
+}
+
+void HydrodynamicsLawLBM3D::action()
+{
+	timingDeltas->start();
+	if (firstRun) {
+		initLattice();
+		firstRun = false;
+	}
+	const long nSteps = long(math::floor((scene->time + scene->dt - lbmTime) / dt + 0.5));
+	if (nSteps > 0) {
+		collectSpheres();
+		mapSolids();
+		timingDeltas->checkpoint("solidMapping");
+#ifdef YADE_OPENMP
+		const int nThreads = omp_get_max_threads();
+#else
+		const int nThreads = 1;
+#endif
+		threadForce.assign(nThreads, vector<Vector3r>(sphId.size(), Vector3r::Zero()));
+		threadTorque.assign(nThreads, vector<Vector3r>(sphId.size(), Vector3r::Zero()));
+		auto t0 = std::chrono::steady_clock::now();
+		for (long s = 0; s < nSteps; s++) {
+			streamCollide(lbmIter % 2);
+			lbmIter++;
+		}
+		const Real elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		lbmTime += nSteps * dt;
+		updateTime += elapsed;
+		mlups = elapsed > 0 ? Real(nFluid) * nSteps / elapsed / 1e6 : 0;
+		timingDeltas->checkpoint("streamCollide");
+		// mean momentum exchange over the LBM steps, in physical units
+		const Real forceUnit = Rho * math::pow(dx, 4) / (dt * dt) / nSteps;
+		for (size_t b = 0; b < sphId.size(); b++) {
+			for (int t = 0; t < nThreads; t++) {
+				sphForce[b] += threadForce[t][b];
+				sphTorque[b] += threadTorque[t][b];
+			}
+			sphForce[b] *= forceUnit;
+			sphTorque[b] *= forceUnit * dx;
+		}
+	}
+	if (applyForcesAndTorques) {
+		for (size_t b = 0; b < sphId.size(); b++) {
+			if (not Body::byId(sphId[b], scene)) continue;
+			scene->forces.addForce(sphId[b], sphForce[b]);
+			scene->forces.addTorque(sphId[b], sphTorque[b]);
+		}
+	}
+	timingDeltas->checkpoint("forces");
+}
+
+Vector3r HydrodynamicsLawLBM3D::getVel(int i, int j, int k) const
+{
+	if (firstRun or i < 0 or j < 0 or k < 0 or i >= nCells[0] or j >= nCells[1] or k >= nCells[2]) return Vector3r::Zero();
+	const long n = i + gx + sx * (j + gy + long(sy) * (k + gz));
+	if (obst[n] != -1) return Vector3r::Zero();
+	Real     density = 0;
+	Vector3r mom     = Vector3r::Zero();
+	for (int q = 0; q < Q; q++) {
+		const Real fq = f[readLocation(n, q, lbmIter % 2)];
+		density += fq;
+		mom += fq * Vector3r(CX[q], CY[q], CZ[q]);
+	}
+	return (mom / density + 0.5 * bodyForce * dt * dt / dx) * dx / dt;
+}
+
+Real HydrodynamicsLawLBM3D::getRho(int i, int j, int k) const
+{
+	if (firstRun or i < 0 or j < 0 or k < 0 or i >= nCells[0] or j >= nCells[1] or k >= nCells[2]) return 0;
+	return Rho * rho[i + gx + sx * (j + gy + long(sy) * (k + gz))];
+}
+
+bool HydrodynamicsLawLBM3D::isSolid(int i, int j, int k) const
+{
+	if (firstRun or i < 0 or j < 0 or k < 0 or i >= nCells[0] or j >= nCells[1] or k >= nCells[2]) return false;
+	return obst[i + gx + sx * (j + gy + long(sy) * (k + gz))] >= 0;
+}
+
+} // namespace yade
+
+#endif //LBM_ENGINE
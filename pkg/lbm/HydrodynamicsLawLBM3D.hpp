@@ -0,0 +1,98 @@
+/*************************************************************************
+*  This program is free software; it is licensed under the terms of the  *
+*  GNU General Public License v2 or later. See file LICENSE for details. *
+*************************************************************************/
+#ifdef LBM_ENGINE
+
+#pragma once
+#include <core/Body.hpp>
+#include <core/GlobalEngine.hpp>
+
+namespace yade { // Cannot have #include directive inside.
+
+/* D3Q19 lattice Boltzmann engine coupled to spheres.
+
+Populations are stored as a structure of arrays, f[q*nNodes+n], and updated in place with the AA pattern (Bailey et al. 2009):
+- even steps read f_q(x) at (q,x), collide, and write f*_q(x) at (opp(q),x),
+- odd steps read f_q(x) at (opp(q),x-c_q), collide, and write f*_q(x) at (q,x+c_q),
+so that streaming and collision are fused in one pass over a single array, every slot being read and written by one node only.
+Halfway bounce-back on a link x->s=x-c_q with s solid replaces the read location by the one where x itself stored f*_opp(q) at the previous step,
+i.e. (q,x) at odd steps and (opp(q),s) at even steps, with the moving wall correction of HydrodynamicsLawLBM (Ladd's rule).
+*/
+class HydrodynamicsLawLBM3D : public GlobalEngine {
+private:
+	static const int Q = 19;
+
+	bool        firstRun;
+	long        nodesCount;        // storage size, ghost layers included
+	int         sx, sy, sz;        // storage dimensions
+	int         gx, gy, gz;        // ghost layer thickness (0 in periodic directions, 1 otherwise)
+	long        offset[Q];         // index offset of the neighbour in direction q for nodes away from the storage boundary
+	Real        dt;                // LBM timestep
+	Real        omega;             // 1/tau
+	Real        lbmTime;           // physical time reached by the LBM
+	vector<Real> f;                // populations, f[q*nodesCount+n]
+	vector<Real> rho;              // density at the last step
+	vector<int>  obst;             // -1: fluid, -2: wall (ghost layer), >=0: index in the sphere arrays below
+	vector<int>  prevObst;         // obst before the last solid mapping
+	vector<char> bulk;             // fluid node with fluid neighbours only, away from the storage boundary (no wrap needed)
+	vector<Body::id_t> sphId;      // the spheres seen by the LBM, and their state in lattice units
+	vector<Vector3r>   sphPos, sphVel, sphAngVel;
+	vector<Real>       sphRad;
+	vector<Vector3r>   sphForce, sphTorque; // hydrodynamic force and torque in physical units, applied at every DEM step
+	vector<vector<Vector3r>> threadForce, threadTorque; // per-thread momentum exchange, summed over the LBM steps of a DEM step
+
+	void initLattice();
+	void collectSpheres();
+	void mapSolids();
+	void refillNewFluid();
+	void streamCollide(bool odd);
+	long neighbour(long n, int q) const;
+	long readLocation(long n, int q, bool odd) const;
+	Vector3r armOf(const Vector3r& x, int b) const; // x-center of sphere b in lattice coordinates, closest periodic image
+	void equilibrium(Real density, const Vector3r& u, Real* feq) const;
+
+public:
+	Vector3r getVel(int i, int j, int k) const;
+	Real     getRho(int i, int j, int k) const;
+	bool     isSolid(int i, int j, int k) const;
+	void     action() override;
+	virtual ~HydrodynamicsLawLBM3D();
+
+	// clang-format off
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(HydrodynamicsLawLBM3D,GlobalEngine,"Engine to simulate fluid flow with a three-dimensional lattice Boltzmann method (D3Q19, BGK collision) coupled to spheres, as a 3D counterpart of :yref:`HydrodynamicsLawLBM`. Populations are stored as contiguous arrays per direction and updated in place by a fused stream-and-collide pass (AA pattern), parallelized with OpenMP and vectorized in the bulk of the fluid. The fluid fills the box from :yref:`lowerCorner<HydrodynamicsLawLBM3D.lowerCorner>` to :yref:`upperCorner<HydrodynamicsLawLBM3D.upperCorner>`, bounded by fixed no-slip walls in the non-periodic directions. Lattice nodes inside spheres (with radius scaled by :yref:`RadFactor<HydrodynamicsLawLBM3D.RadFactor>`) are solid, the fluid-solid links follow the moving bounce-back rule of :yref:`HydrodynamicsLawLBM` and the exchanged momentum gives the hydrodynamic forces and torques on the spheres. The LBM timestep follows from :yref:`tau<HydrodynamicsLawLBM3D.tau>`, :yref:`dx<HydrodynamicsLawLBM3D.dx>` and :yref:`Nu<HydrodynamicsLawLBM3D.Nu>`; the engine runs as many LBM steps as needed to follow the DEM time, and applies the last computed forces at every DEM step.",
+		((Vector3r,lowerCorner,Vector3r::Zero(),,"Lower corner of the fluid domain."))
+		((Vector3r,upperCorner,Vector3r::Zero(),,"Upper corner of the fluid domain."))
+		((Real,dx,0,,"Lattice spacing. The domain size is rounded to a whole number of lattice nodes in each direction."))
+		((Vector3i,periodic,Vector3i::Zero(),,"Periodicity of the fluid domain in the x, y and z directions (non-zero for periodic), otherwise the corresponding faces are no-slip walls."))
+		((Real,Rho,1000.,,"Fluid density."))
+		((Real,Nu,1e-6,,"Fluid kinematic viscosity."))
+		((Real,tau,0.6,,"Relaxation time (>0.5)."))
+		((Vector3r,bodyForce,Vector3r::Zero(),,"Body force per unit mass (acceleration) applied to the fluid, e.g. gravity or a mean pressure gradient divided by :yref:`Rho<HydrodynamicsLawLBM3D.Rho>`."))
+		((Vector3r,initVel,Vector3r::Zero(),,"Initial fluid velocity."))
+		((Real,RadFactor,1.0,,"The radius of spheres seen by the LBM is their radius times RadFactor."))
+		((bool,applyForcesAndTorques,true,,"Apply the hydrodynamic forces and torques to the spheres."))
+		((Vector3i,nCells,Vector3i::Zero(),Attr::readonly,"Number of lattice nodes in each direction (ghost nodes excluded)."))
+		((Real,lbmDt,0,Attr::readonly,"LBM timestep, computed at the first run."))
+		((long,lbmIter,0,Attr::readonly,"Number of LBM steps done."))
+		((long,nFluid,0,Attr::readonly,"Number of fluid nodes at the last solid mapping."))
+		((Real,mlups,0,Attr::readonly,"Performance of the stream-and-collide steps run by the last call of the engine, in million fluid lattice updates per second."))
+		((Real,updateTime,0,Attr::readonly,"Cumulated wall time of the stream-and-collide steps (s), totalMlups=lbmIter*nFluid/updateTime/1e6 for a constant nFluid."))
+		,
+		/*ctor*/
+		firstRun = true; nodesCount = 0; sx = sy = sz = 0; gx = gy = gz = 1; dt = 0; omega = 0; lbmTime = 0;
+		timingDeltas = shared_ptr<TimingDeltas>(new TimingDeltas);
+		,
+		/*py*/
+		.def("getVel",&HydrodynamicsLawLBM3D::getVel,(boost::python::arg("i"),boost::python::arg("j"),boost::python::arg("k")),"Fluid velocity at lattice node (i,j,k), in physical units (zero at solid nodes).")
+		.def("getRho",&HydrodynamicsLawLBM3D::getRho,(boost::python::arg("i"),boost::python::arg("j"),boost::python::arg("k")),"Fluid density at lattice node (i,j,k) at the last step, in physical units.")
+		.def("isSolid",&HydrodynamicsLawLBM3D::isSolid,(boost::python::arg("i"),boost::python::arg("j"),boost::python::arg("k")),"Whether lattice node (i,j,k) is inside a sphere.")
+	);
+	// clang-format on
+	DECLARE_LOGGER;
+};
+REGISTER_SERIALIZABLE(HydrodynamicsLawLBM3D);
+
+} // namespace yade
+
+#endif //LBM_ENGINE
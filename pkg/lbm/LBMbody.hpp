@@ -48,6 +48,8 @@ public:
         ((Vector3r,Fh,Vector3r::Zero(),,"Hydrodynamical force on body"))
         ((Vector3r,Mh,Vector3r::Zero(),,"Hydrodynamical momentum on body"))
         ((Real,radius,-1000.,,"Radius of body (for sphere)"))
+        ((Vector3r,mappedPos,Vector3r::Zero(),,"Position of body (LB unit) when its lattice nodes were last mapped"))
+        ((Real,mappedRadius,-1.,,"Radius of body (LB unit) when its lattice nodes were last mapped, <0 if never mapped"))
         ((bool,isEroded,false,,"Hydrodynamical force on body"))
         ((bool,saveProperties,false,,"To save properties of the body"))
         ((short int,type,-1,," "))
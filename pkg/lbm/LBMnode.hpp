@@ -45,6 +45,8 @@ public:
 	        velb;  /*! the node velocity  */
 
 	Real         rhob; /*! the node density  */ /*! the node density  */
+	Real         psmB;    /*! weighting of the solid collision term (partially saturated cells), 0 for a fluid node */
+	int          psmBody; /*! the sphere covering the node (partially saturated cells), -1 if none */
 	vector<int>  neighbour_id;                  /*! list of adjacent nodes  */
 	vector<int>  links_id;                      /*! list of links  */
 	vector<Real> f;
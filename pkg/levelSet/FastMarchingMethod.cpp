@@ -5,14 +5,20 @@
 
 #ifdef YADE_LS_DEM
 
+#include <lib/base/openmp-accu.hpp>
+#include <lib/high-precision/Constants.hpp>
 #include <pkg/levelSet/FastMarchingMethod.hpp>
 #include <pkg/levelSet/ShopLS.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace yade { // Cannot have #include directive inside.
 
 CREATE_LOGGER(FastMarchingMethod);
 YADE_PLUGIN((FastMarchingMethod));
 
+std::list<FastMarchingMethod::CacheEntry> FastMarchingMethod::cache;
+const size_t                              FastMarchingMethod::cacheCapacity;
+
 void FastMarchingMethod::iniStates()
 {
 	// initializes all states to far
@@ -272,29 +278,164 @@ Real FastMarchingMethod::phiFromEik(Real m0, Real m1, Real m2, Real disc, bool e
 vector<vector<vector<Real>>> FastMarchingMethod::phi()
 {
 	// computes and returns phiField.  To check what happens for repeated executions..
-	iniStates(); // gpStates has now a correct format and is full of farState
 	if (phiIni.size() == 0) LOG_FATAL("Empty (none given ?) phiIni in FastMarchingMethod");
-	phiField = phiIni;
-	for (int side = 0; side < 2; side++) {
-		iniFront(side); // known now has the initial front, with correct values and states
-		LOG_INFO("After iniFront on the " << (side ? "exterior" : "interior") << ", we now have: " << knownTmp.size() << " known gp to propagate from");
-		for (unsigned int gpKnown = 0; gpKnown < knownTmp.size(); gpKnown++) {
-			Vector3i idxOfKnown(knownTmp[gpKnown]);
-			trializeFromKnown(
-			        knownTmp[gpKnown][0],
-			        knownTmp[gpKnown][1],
-			        knownTmp[gpKnown][2],
-			        side); // this time we define some narrow band with trial gridpoints.
+	size_t key(0);
+	if (useCache) {
+		key = phiIniHash();
+		for (auto entry = cache.begin(); entry != cache.end(); entry++)
+			if (sameProblem(*entry, key)) {
+				cache.splice(cache.begin(), cache, entry); // most recently used first
+				phiField = entry->phiField;
+				known    = entry->known;
+				sweeps   = entry->sweeps;
+				return phiField;
+			}
+	}
+	if (fastSweeping) phiField = phiFastSweeping();
+	else {
+		iniStates(); // gpStates has now a correct format and is full of farState
+		phiField = phiIni;
+		for (int side = 0; side < 2; side++) {
+			iniFront(side); // known now has the initial front, with correct values and states
+			LOG_INFO("After iniFront on the " << (side ? "exterior" : "interior") << ", we now have: " << knownTmp.size() << " known gp to propagate from");
+			for (unsigned int gpKnown = 0; gpKnown < knownTmp.size(); gpKnown++) {
+				Vector3i idxOfKnown(knownTmp[gpKnown]);
+				trializeFromKnown(
+				        knownTmp[gpKnown][0],
+				        knownTmp[gpKnown][1],
+				        knownTmp[gpKnown][2],
+				        side); // this time we define some narrow band with trial gridpoints.
+			}
+			LOG_INFO("And just after, we have " << trials.size() << " in a neighbour narrowband");
+			loopTrials(side);
+			known.insert(known.end(), knownTmp.begin(), knownTmp.end());
+			knownTmp.clear(); // we need to start from a fresh known on side #2, but there is no real need to touch to the states, on the other hand
+			LOG_INFO((side ? "Exterior" : "Interior") << " just completed, we now have " << known.size() << " known gp in total");
 		}
-		LOG_INFO("And just after, we have " << trials.size() << " in a neighbour narrowband");
-		loopTrials(side);
-		known.insert(known.end(), knownTmp.begin(), knownTmp.end());
-		knownTmp.clear(); // we need to start from a fresh known on side #2, but there is no real need to touch to the states, on the other hand
-		LOG_INFO((side ? "Exterior" : "Interior") << " just completed, we now have " << known.size() << " known gp in total");
+	}
+	if (useCache) {
+		cache.push_front(CacheEntry { key, grid->min, grid->nGP, grid->spacing, speed, fastSweeping, phiIni, phiField, known, sweeps });
+		if (cache.size() > cacheCapacity) cache.pop_back();
 	}
 	return phiField;
 }
 
+bool FastMarchingMethod::sameProblem(const CacheEntry& entry, size_t hash) const
+{
+	// the hash only rules out most entries, a hit needs all the data to be equal
+	return entry.hash == hash and entry.gridMin == grid->min and entry.nGP == grid->nGP and entry.spacing == grid->spacing and entry.speed == speed
+	        and entry.fastSweeping == fastSweeping and entry.phiIni == phiIni;
+}
+
+size_t FastMarchingMethod::phiIniHash() const
+{
+	size_t seed(0);
+	for (int axis = 0; axis < 3; axis++) {
+		boost::hash_combine(seed, double(grid->min[axis]));
+		boost::hash_combine(seed, grid->nGP[axis]);
+	}
+	boost::hash_combine(seed, double(grid->spacing));
+	boost::hash_combine(seed, double(speed));
+	boost::hash_combine(seed, fastSweeping);
+	for (const auto& plane : phiIni)
+		for (const auto& line : plane)
+			for (const Real& val : line)
+				boost::hash_combine(seed, double(val));
+	return seed;
+}
+
+vector<vector<vector<Real>>> FastMarchingMethod::phiFastSweeping()
+{
+	// Same upwind discretization as updateFastMarchingMethod(), each side of the interface being fed by itself (gridpoints of the same sign, and zeros) and finite phiIni values being the boundary condition. Instead of the ordered FMM propagation, the update is applied everywhere in Gauss-Seidel sweeps along the 8 diagonal directions until nothing changes. For one direction, a gridpoint only depends on its upwind neighbours, that are on the previous plane i+j+k = cst: all gridpoints of a plane are updated in parallel [Detrixhe2013]_
+	const int    nGPx(grid->nGP[0]), nGPy(grid->nGP[1]), nGPz(grid->nGP[2]), nYZ(nGPy * nGPz);
+	const size_t nTot(size_t(nGPx) * nYZ);
+	vector<Real> phiFlat(nTot), spacFlat(speed != 1 ? nTot : 0);
+	vector<char> frozen(nTot);
+	for (int xInd = 0; xInd < nGPx; xInd++) {
+		for (int yInd = 0; yInd < nGPy; yInd++) {
+			for (int zInd = 0; zInd < nGPz; zInd++) {
+				const size_t idx = size_t(xInd) * nYZ + yInd * nGPz + zInd;
+				phiFlat[idx]     = phiIni[xInd][yInd][zInd];
+				frozen[idx]      = math::isfinite(phiFlat[idx]);
+				if (speed != 1) spacFlat[idx] = grid->spacing * ShopLS::grad_fioRose(grid->gridPoint(xInd, yInd, zInd)).norm();
+			}
+		}
+	}
+	const Real inf(std::numeric_limits<Real>::infinity()), changeTol(Mathr::EPSILON * grid->spacing);
+	// |phi| at a neighbour when on the given side, infinity otherwise:
+	auto sideAbs = [&](size_t idx, bool exterior) { return (exterior ? phiFlat[idx] >= 0 : phiFlat[idx] <= 0) ? math::abs(phiFlat[idx]) : inf; };
+	// the update of one gridpoint, returning true if |phi| decreased:
+	auto update = [&](int i, int j, int k) {
+		const size_t idx = size_t(i) * nYZ + j * nGPz + k;
+		if (frozen[idx]) return false;
+		const bool exterior(phiFlat[idx] > 0);
+		Real       a[3] = { math::min(i > 0 ? sideAbs(idx - nYZ, exterior) : inf, i < nGPx - 1 ? sideAbs(idx + nYZ, exterior) : inf),
+                                  math::min(j > 0 ? sideAbs(idx - nGPz, exterior) : inf, j < nGPy - 1 ? sideAbs(idx + nGPz, exterior) : inf),
+                                  math::min(k > 0 ? sideAbs(idx - 1, exterior) : inf, k < nGPz - 1 ? sideAbs(idx + 1, exterior) : inf) };
+		std::sort(a, a + 3);
+		if (!math::isfinite(a[0])) return false;
+		const Real spac(speed != 1 ? spacFlat[idx] : grid->spacing);
+		Real       u(a[0] + spac); // 1D propagation
+		if (u > a[1]) {             // 2D, see phiFromEik()
+			u = (a[0] + a[1] + sqrt(eikDiscr(spac, a[0], a[1]))) / 2;
+			if (u > a[2]) u = (a[0] + a[1] + a[2] + sqrt(math::max(Real(0), eikDiscr(spac, a[0], a[1], a[2])))) / 3; // 3D
+		}
+		if (u < math::abs(phiFlat[idx]) - changeTol) {
+			phiFlat[idx] = exterior ? u : -u;
+			return true;
+		}
+		return false;
+	};
+#ifdef YADE_OPENMP
+	vector<char> threadChanged(omp_get_max_threads());
+#else
+	vector<char> threadChanged(1);
+#endif
+	const int nLevels(nGPx + nGPy + nGPz - 2);
+	bool      changed(true);
+	sweeps = 0;
+	while (changed) {
+		changed = false;
+		for (int dir = 0; dir < 8; dir++) {
+			const bool flipX(dir & 1), flipY(dir & 2), flipZ(dir & 4);
+			std::fill(threadChanged.begin(), threadChanged.end(), 0);
+#ifdef YADE_OPENMP
+#pragma omp parallel
+#endif
+			{
+#ifdef YADE_OPENMP
+				char& thrChanged = threadChanged[omp_get_thread_num()];
+#else
+				char& thrChanged = threadChanged[0];
+#endif
+				for (int level = 0; level < nLevels; level++) {
+					const int iMin(math::max(0, level - (nGPy - 1) - (nGPz - 1))), iMax(math::min(nGPx - 1, level));
+#ifdef YADE_OPENMP
+#pragma omp for schedule(static)
+#endif
+					for (int iS = iMin; iS <= iMax; iS++) { // an implicit barrier ends each plane
+						const int jMin(math::max(0, level - iS - (nGPz - 1))), jMax(math::min(nGPy - 1, level - iS));
+						for (int jS = jMin; jS <= jMax; jS++) {
+							const int kS(level - iS - jS);
+							if (update(flipX ? nGPx - 1 - iS : iS, flipY ? nGPy - 1 - jS : jS, flipZ ? nGPz - 1 - kS : kS)) thrChanged = 1;
+						}
+					}
+				}
+			}
+			sweeps++;
+			for (char thrChanged : threadChanged)
+				changed = changed || thrChanged;
+		}
+	}
+	LOG_INFO("Fast sweeping converged after " << sweeps << " sweeps");
+	vector<vector<vector<Real>>> ret(nGPx, vector<vector<Real>>(nGPy, vector<Real>(nGPz)));
+	for (int xInd = 0; xInd < nGPx; xInd++)
+		for (int yInd = 0; yInd < nGPy; yInd++)
+			for (int zInd = 0; zInd < nGPz; zInd++)
+				ret[xInd][yInd][zInd] = phiFlat[size_t(xInd) * nYZ + yInd * nGPz + zInd];
+	return ret;
+}
+
 //bool FastMarchingMethod::compFnOut(vector<vector<vector<Real>>>& FastMarchingMethod::phiField,Vector3i gp1,Vector3i gp2){
 //	// shall return true when gp1 is closest to the front, for the purpose of std::sort the narrowband
 //	Real phi1( FastMarchingMethod::phiField[gp1[0]][gp1[1]][gp1[2]]) , phi2( FastMarchingMethod::phiField[gp2[0]][gp2[1]][gp2[2]]);
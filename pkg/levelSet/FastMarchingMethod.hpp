@@ -9,6 +9,7 @@
 #include <lib/base/Logging.hpp>
 #include <lib/serialization/Serializable.hpp>
 #include <pkg/levelSet/RegularGrid.hpp>
+#include <list>
 
 namespace yade {
 
@@ -39,6 +40,21 @@ private:
 	void                          trializeFromKnown(int xInd, int yInd, int zInd, bool); // indices here refer to some known gridpoint
 	void                          trialize(int xInd, int yInd, int zInd, bool);          // indices here refer to the actual trial-to-be gridpoint
 	void                          confirm(int xInd, int yInd, int zInd, Real phiVal, bool, bool checkState);
+	vector<vector<vector<Real>>>  phiFastSweeping(); // the alternative to the FMM, see fastSweeping
+	size_t                        phiIniHash() const; // a hash of grid, speed, fastSweeping and phiIni, to skip most of the cache entries at once
+	struct CacheEntry { // one problem (all the data phi() depends on) and its solution
+		size_t                       hash;
+		Vector3r                     gridMin;
+		Vector3i                     nGP;
+		Real                         spacing, speed;
+		bool                         fastSweeping;
+		vector<vector<vector<Real>>> phiIni, phiField;
+		vector<Vector3i>             known;
+		int                          sweeps;
+	};
+	bool                         sameProblem(const CacheEntry&, size_t hash) const;
+	static std::list<CacheEntry> cache; // the last solutions, most recently used first, see useCache
+	static const size_t          cacheCapacity = 16;
 	//	see https://stackoverflow.com/questions/1902311/problem-sorting-using-member-function-as-comparator for the use of struct below
 	struct downwindSort { // will give a sorted items with the 1st element being the closest
 		downwindSort(const FastMarchingMethod& info)
@@ -68,14 +84,19 @@ private:
 public:
 	DECLARE_LOGGER;                     // see https://yade-dem.org/doc/prog.html#debug-macros
 	vector<vector<vector<Real>>> phi(); // kind-of the "main"
+	static void                  clearCache() { cache.clear(); }
 	// clang-format off
 	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(FastMarchingMethod,Serializable,"Executes a Fast Marching Method (FMM) to solve $||\\vec \\nabla \\phi|| = c$ for a discrete field $\\phi$ defined on :yref:`grid<FastMarchingMethod.grid>`, with :yref:`phiIni<FastMarchingMethod.phiIni>` serving as boundary condition. Typically, $c=1$ (see :yref:`speed<FastMarchingMethod.speed>`) and $\\phi$ is a distance field. Note that the minimum search inherent to the FMM is not yet optimal in terms of execution speed and faster implementations of the FMM may be found elsewhere. See [Duriez2021b]_ for more details, where the class was coined DistFMM.",
 		((vector<Vector3i>,known,,Attr::readonly,"Gridpoints (indices) with distance known for good: they have been at some point the shortest gp to the surface while executing the FMM."))
 		((vector<vector<vector<Real>>>,phiIni,,,"Initial discrete field defined on the :yref:`grid<FastMarchingMethod.grid>` that will serve as a boundary condition for the FMM. Field values have to be - inf (resp. inf) for points being far inside (resp. outside) and correct (finite) on each side of the interface. Built-in functions *distIniSE* (for superellipsoids), *phiIniCppPy* (for a Python user function, through a mixed C++-Py internal implementation) or *phiIniPy* (for a Python user function through a pure Py internal implementation) may be used for such a purpose."))
 		((shared_ptr<RegularGrid>,grid,,,"The underlying :yref:`regular grid<RegularGrid>`."))
 		((Real,speed,1,,"Keep to 1 for a true distance, 2 for the flake-like rose verification of [Duriez2021b]_."))
+		((bool,fastSweeping,false,,"If True, :yref:`phi<FastMarchingMethod.phi>` solves the same discrete Eikonal equation with a fast sweeping method instead of the FMM: Gauss-Seidel sweeps along the 8 diagonal directions, where the gridpoints of each plane $i+j+k=cst$ are updated in parallel [Detrixhe2013]_, on contiguous arrays. :yref:`known<FastMarchingMethod.known>` is not filled in that case."))
+		((int,sweeps,0,Attr::readonly,"Number of sweeps (along one direction each) of the last fast sweeping solve."))
+		((bool,useCache,false,,"If True, the solution of :yref:`phi<FastMarchingMethod.phi>` (with :yref:`known<FastMarchingMethod.known>` and :yref:`sweeps<FastMarchingMethod.sweeps>`) is stored together with :yref:`grid<FastMarchingMethod.grid>`, :yref:`phiIni<FastMarchingMethod.phiIni>`, :yref:`speed<FastMarchingMethod.speed>` and :yref:`fastSweeping<FastMarchingMethod.fastSweeping>`, and returned without solving again for an identical problem (e.g. identical grains). The cache is shared by all instances and keeps the 16 most recently used solutions, see also :yref:`clearCache<FastMarchingMethod.clearCache>`."))
 		,
 		,.def("phi",&FastMarchingMethod::phi,"Executes the FMM and returns its solution as a list of list of list, with the [i][j][k] element corresponding to grid.gridPoint(i,j,k)")
+		.def("clearCache",&FastMarchingMethod::clearCache,"Empties the cache of solutions shared by all instances, see :yref:`useCache<FastMarchingMethod.useCache>`.").staticmethod("clearCache")
 		)
 	// clang-format on
 };
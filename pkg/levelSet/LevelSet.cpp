@@ -11,14 +11,25 @@
 #include <pkg/levelSet/ShopLS.hpp>
 #include <boost/math/tools/roots.hpp>
 #include <preprocessing/dem/Shop.hpp>
+#include <mutex>
 
 namespace yade {
 YADE_PLUGIN((LevelSet));
 CREATE_LOGGER(LevelSet);
 
+static std::mutex initMutex; // a LevelSet instance may be shared by several bodies, whose functors may ask for it at the same time
+
+void LevelSet::lazyInit()
+{
+	// double-checked: initDone is only published (release) by init() once all the data it computes are set
+	if (initDone.load(std::memory_order_acquire)) return;
+	std::lock_guard<std::mutex> lock(initMutex);
+	if (!initDone.load(std::memory_order_relaxed)) init();
+}
+
 Vector3r LevelSet::getCenter()
 {
-	if (!initDone) init();
+	lazyInit();
 	return center;
 }
 
@@ -232,11 +243,13 @@ Vector3r LevelSet::normal(const Vector3r& pt) const
 	Real     xRed((pt[0] - corner[0]) / spac), yRed((pt[1] - corner[1]) / spac),
 	        zRed((pt[2] - corner[2]) / spac); // dimensionless x,y,z in [0;1] in one cell (3., top p. 4 Kawamoto2016)
 	Real nx(0), ny(0), nz(0);                 // x, y, z components of normal
+	const int nY(lsGrid->nGP[1]), nZ(lsGrid->nGP[2]);
 	// Computing normal as the gradient of trilinear interpolation (e.g. Eq. (2) Kawamoto2016):
 	for (int indA = 0; indA < 2; indA++) {
 		for (int indB = 0; indB < 2; indB++) {
 			for (int indC = 0; indC < 2; indC++) {
-				Real lsVal = distField[xInd + indA][yInd + indB][zInd + indC];
+				Real lsVal = flatField.size() ? flatField[((xInd + indA) * nY + yInd + indB) * nZ + zInd + indC]
+				                              : distField[xInd + indA][yInd + indB][zInd + indC];
 				nx += lsVal * (2 * indA - 1) * ((1 - indB) * (1 - yRed) + indB * yRed) * ((1 - indC) * (1 - zRed) + indC * zRed);
 				ny += lsVal * (2 * indB - 1) * ((1 - indA) * (1 - xRed) + indA * xRed) * ((1 - indC) * (1 - zRed) + indC * zRed);
 				nz += lsVal * (2 * indC - 1) * ((1 - indA) * (1 - xRed) + indA * xRed) * ((1 - indB) * (1 - yRed) + indB * yRed);
@@ -302,9 +315,11 @@ void LevelSet::init() // computes stuff (nVoxInside, center, volume, inertia, bo
 	if (!distField.size()) LOG_ERROR("You are interested into center/volume before that distField has been defined");
 	Vector3i gpPerAxis = lsGrid->nGP;
 	int      nGPx(gpPerAxis[0]), nGPy(gpPerAxis[1]), nGPz(gpPerAxis[2]);
-	if ((int(distField.size()) != nGPx) or (int((distField[0][0]).size()) != nGPz))
+	if ((int(distField.size()) != nGPx) or (int((distField[0][0]).size()) != nGPz)) {
 		LOG_ERROR("There is a size-inconsistency between the current level set grid and shape.distField for this body! The level set grid has changed "
 		          "since the creation of this body, this is not supported.");
+	} else
+		initFlatField();
 	Real spac  = lsGrid->spacing;
 	Real Vcell = pow(spac, 3);
 	Real phiRef(0.);
@@ -404,7 +419,42 @@ void LevelSet::init() // computes stuff (nVoxInside, center, volume, inertia, bo
 		initSurfNodes();
 		sphericity = maxRad / minRad;
 	} // note that sphericity is always saved (but maxRad, minRad are not and are meaningfull only after initSurfNodes())
-	initDone = true;
+	if (corners.size() != 8) initCorners();
+	initDone.store(true, std::memory_order_release);
+}
+
+void LevelSet::initCorners()
+{
+	// The 8 corners of the Aabb of the inside gridpoints, enlarged by one spacing, for Bo1_LevelSet_Aabb
+	corners.clear();
+	Real inf = std::numeric_limits<Real>::infinity();
+	int  nGPx(lsGrid->nGP[0]), nGPy(lsGrid->nGP[1]), nGPz(lsGrid->nGP[2]);
+	Real xMin(inf), xMax(-inf), yMin(inf), yMax(-inf), zMin(inf), zMax(-inf); // extrema values for the "inside" gridpoints
+	for (int xInd = 0; xInd < nGPx; xInd++) {
+		for (int yInd = 0; yInd < nGPy; yInd++) {
+			for (int zInd = 0; zInd < nGPz; zInd++) {
+				if (distField[xInd][yInd][zInd] <= 0) {
+					Vector3r gp = lsGrid->gridPoint(xInd, yInd, zInd);
+					xMin        = math::min(xMin, gp[0]);
+					xMax        = math::max(xMax, gp[0]);
+					yMin        = math::min(yMin, gp[1]);
+					yMax        = math::max(yMax, gp[1]);
+					zMin        = math::min(zMin, gp[2]);
+					zMax        = math::max(zMax, gp[2]);
+				}
+			}
+		}
+	}
+	if ((xMin == xMax) or (yMin == yMax) or (zMin == zMax))
+		LOG_WARN("One flat LevelSet body, as detected by shape.corners computation, was that expected ? (is the grid too coarse ?)");
+	// right now, our *Min, *Max define a downwards-rounded Aabb (smaller than true surface), let's make it upwards-rounded below:
+	Real g(lsGrid->spacing);
+	for (int iInd = 0; iInd < 2; iInd++) {
+		for (int jInd = 0; jInd < 2; jInd++) {
+			for (int kInd = 0; kInd < 2; kInd++)
+				corners.push_back(Vector3r(iInd == 0 ? xMin - g : xMax + g, jInd == 0 ? yMin - g : yMax + g, kInd == 0 ? zMin - g : zMax + g));
+		}
+	}
 }
 
 Real LevelSet::distance(const Vector3r& pt) const
@@ -420,16 +470,18 @@ Real LevelSet::distance(const Vector3r& pt) const
 	std::array<Real, 2>                yzCoord = { pt[1], pt[2] };
 	std::array<Real, 2>                yExtr   = { lsGrid->gridPoint(xInd, yInd, zInd)[1], lsGrid->gridPoint(xInd, yInd + 1, zInd)[1] };
 	std::array<Real, 2>                zExtr   = { lsGrid->gridPoint(xInd, yInd, zInd)[2], lsGrid->gridPoint(xInd, yInd, zInd + 1)[2] };
+	const int                          nY(lsGrid->nGP[1]), nZ(lsGrid->nGP[2]);
+	auto                               val = [&](int i, int j, int k) { return flatField.size() ? flatField[(i * nY + j) * nZ + k] : distField[i][j][k]; };
 	std::array<std::array<Real, 2>, 2> knownValx0;
-	knownValx0[0][0] = distField[xInd][yInd][zInd];
-	knownValx0[0][1] = distField[xInd][yInd][zInd + 1];
-	knownValx0[1][0] = distField[xInd][yInd + 1][zInd];
-	knownValx0[1][1] = distField[xInd][yInd + 1][zInd + 1];
+	knownValx0[0][0] = val(xInd, yInd, zInd);
+	knownValx0[0][1] = val(xInd, yInd, zInd + 1);
+	knownValx0[1][0] = val(xInd, yInd + 1, zInd);
+	knownValx0[1][1] = val(xInd, yInd + 1, zInd + 1);
 	std::array<std::array<Real, 2>, 2> knownValx1;
-	knownValx1[0][0] = distField[xInd + 1][yInd][zInd];
-	knownValx1[0][1] = distField[xInd + 1][yInd][zInd + 1];
-	knownValx1[1][0] = distField[xInd + 1][yInd + 1][zInd];
-	knownValx1[1][1] = distField[xInd + 1][yInd + 1][zInd + 1];
+	knownValx1[0][0] = val(xInd + 1, yInd, zInd);
+	knownValx1[0][1] = val(xInd + 1, yInd, zInd + 1);
+	knownValx1[1][0] = val(xInd + 1, yInd + 1, zInd);
+	knownValx1[1][1] = val(xInd + 1, yInd + 1, zInd + 1);
 	f0yz             = ShopLS::biInterpolate(yzCoord, yExtr, zExtr, knownValx0);
 	f1yz             = ShopLS::biInterpolate(yzCoord, yExtr, zExtr, knownValx1);
 	return (pt[0] - lsGrid->gridPoint(xInd, yInd, zInd)[0]) / lsGrid->spacing * (f1yz - f0yz) + f0yz;
@@ -437,16 +489,126 @@ Real LevelSet::distance(const Vector3r& pt) const
 
 Real LevelSet::getVolume()
 {
-	if (!initDone) init();
+	lazyInit();
 	return volume;
 }
 
 Vector3r LevelSet::getInertia()
 {
-	if (!initDone) init();
+	lazyInit();
 	return inertia;
 }
 
+const vector<Vector3r>& LevelSet::getCorners()
+{
+	lazyInit(); // corners included, and not read before init() is over (they may have been loaded, but init() is due anyway)
+	return corners;
+}
+
+Real LevelSet::getBoundingRadius()
+{
+	lazyInit();
+	return boundingRadius;
+}
+
+void LevelSet::postLoad(LevelSet&)
+{
+	// called after a deserialization, and after distField was set from Python (constructor, updateAttrs): only the latter may happen after init()
+	std::lock_guard<std::mutex> lock(initMutex);
+	if (!initDone) return; // init() will build flatField
+	const Vector3i nGP(lsGrid->nGP);
+	if (int(distField.size()) == nGP[0] and nGP[0] > 0 and int(distField[0].size()) == nGP[1] and int(distField[0][0].size()) == nGP[2]) initFlatField();
+	else { // distanceBatch() then goes point by point through distance()
+		flatField.clear();
+		flatFieldF.clear();
+	}
+}
+
+void LevelSet::initFlatField()
+{
+	const int    nX(lsGrid->nGP[0]), nY(lsGrid->nGP[1]), nZ(lsGrid->nGP[2]);
+	const size_t size(size_t(nX) * nY * nZ);
+	// only one copy, distance() and normal() reading distField when flatField is empty
+	flatField.clear();
+	flatFieldF.clear();
+	if (singlePrecisionField) flatFieldF.resize(size);
+	else
+		flatField.resize(size);
+	// boundingRadius: any point with a negative (interpolated) distance lies in a cell with at least one negative gridpoint
+	Real maxRadNeg(0);
+	bool anyNeg(false);
+	for (int xInd = 0; xInd < nX; xInd++) {
+		for (int yInd = 0; yInd < nY; yInd++) {
+			for (int zInd = 0; zInd < nZ; zInd++) {
+				const size_t idx   = (size_t(xInd) * nY + yInd) * nZ + zInd;
+				const Real   phi   = distField[xInd][yInd][zInd];
+				if (singlePrecisionField) flatFieldF[idx] = float(phi);
+				else
+					flatField[idx] = phi;
+				if (phi <= 0) {
+					maxRadNeg = math::max(maxRadNeg, lsGrid->gridPoint(xInd, yInd, zInd).norm());
+					anyNeg    = true;
+				}
+			}
+		}
+	}
+	boundingRadius = anyNeg ? maxRadNeg + sqrt(3.) * lsGrid->spacing : 0;
+}
+
+template <typename T> void LevelSet::trilinearBatch(const T* field, const Vector3r* pts, int n, Real* dist, Vector3r* grad) const
+{
+	const int  nY(lsGrid->nGP[1]), nZ(lsGrid->nGP[2]), nYZ(nY * nZ);
+	const int  maxX(lsGrid->nGP[0] - 2), maxY(nY - 2), maxZ(nZ - 2);
+	const Real x0(lsGrid->min[0]), y0(lsGrid->min[1]), z0(lsGrid->min[2]), invSpac(1. / lsGrid->spacing);
+	// No branch in the loop body, so that the 8 values of each point are gathered for several points at once when vectorized. The cell indices are clamped the same way closestCorner() does (points on the max boundary belong to the last cell)
+#ifdef YADE_OPENMP
+#pragma omp simd
+#endif
+	for (int p = 0; p < n; p++) {
+		const Real xs((pts[p][0] - x0) * invSpac), ys((pts[p][1] - y0) * invSpac), zs((pts[p][2] - z0) * invSpac);
+		const int  i(std::max(0, std::min(maxX, int(xs)))), j(std::max(0, std::min(maxY, int(ys)))), k(std::max(0, std::min(maxZ, int(zs))));
+		const Real u(xs - i), v(ys - j), w(zs - k);
+		const T*   f(field + i * nYZ + j * nZ + k);
+		const Real f000(f[0]), f001(f[1]), f010(f[nZ]), f011(f[nZ + 1]), f100(f[nYZ]), f101(f[nYZ + 1]), f110(f[nYZ + nZ]), f111(f[nYZ + nZ + 1]);
+		// interpolation along z, then y, then x
+		const Real f00(f000 + w * (f001 - f000)), f01(f010 + w * (f011 - f010)), f10(f100 + w * (f101 - f100)), f11(f110 + w * (f111 - f110));
+		const Real f0(f00 + v * (f01 - f00)), f1(f10 + v * (f11 - f10));
+		dist[p] = f0 + u * (f1 - f0);
+		if (grad) {
+			grad[p] = Vector3r(
+			        (f1 - f0) * invSpac,
+			        ((1 - u) * (f01 - f00) + u * (f11 - f10)) * invSpac,
+			        ((1 - u) * ((1 - v) * (f001 - f000) + v * (f011 - f010)) + u * ((1 - v) * (f101 - f100) + v * (f111 - f110))) * invSpac);
+		}
+	}
+}
+
+void LevelSet::distanceBatch(const Vector3r* pts, int n, Real* dist, Vector3r* grad) const
+{
+	// Same trilinear interpolation as distance() (and, not normalized, as normal() for grad) for n points at once, reading the contiguous copy of distField. The points have to be inside lsGrid (not checked, contrary to distance()) and the shape initialized
+	if (flatFieldF.size()) trilinearBatch(flatFieldF.data(), pts, n, dist, grad);
+	else if (flatField.size())
+		trilinearBatch(flatField.data(), pts, n, dist, grad);
+	else { // init() not done (or failed): point by point, with a normalized grad
+		for (int p = 0; p < n; p++) {
+			dist[p] = distance(pts[p]);
+			if (grad) grad[p] = normal(pts[p]);
+		}
+	}
+}
+
+boost::python::tuple LevelSet::pyDistanceBatch(const vector<Vector3r>& pts) const
+{
+	const Vector3r gridMax(lsGrid->max());
+	for (const auto& pt : pts)
+		if ((pt.array() < lsGrid->min.array()).any() or (pt.array() > gridMax.array()).any())
+			throw std::invalid_argument("LevelSet.distanceBatch: point " + boost::lexical_cast<string>(pt.transpose()) + " is outside lsGrid");
+	vector<Real>     dist(pts.size());
+	vector<Vector3r> grad(pts.size());
+	distanceBatch(pts.data(), int(pts.size()), dist.data(), grad.data());
+	return boost::python::make_tuple(dist, grad);
+}
+
 Real LevelSet::getSurface() const
 {
 	Real nbrAngles(sqrt(surfNodes.size() - 2));
@@ -494,21 +656,21 @@ void LevelSet::computeMarchingCubes()
 
 vector<Vector3r> LevelSet::getMarchingCubeTriangles()
 {
-	if (!initDone) init();
+	lazyInit();
 	if (!initDoneMarchingCubes) computeMarchingCubes();
 	return marchingCubesData.triangles;
 }
 
 vector<Vector3r> LevelSet::getMarchingCubeNormals()
 {
-	if (!initDone) init();
+	lazyInit();
 	if (!initDoneMarchingCubes) computeMarchingCubes();
 	return marchingCubesData.normals;
 }
 
 int LevelSet::getMarchingCubeNbTriangles()
 {
-	if (!initDone) init();
+	lazyInit();
 	if (!initDoneMarchingCubes) computeMarchingCubes();
 	return marchingCubesData.nbTriangles;
 }
@@ -8,6 +8,7 @@
 #include <lib/computational-geometry/MarchingCube.hpp>
 #include <core/Shape.hpp>
 #include <pkg/levelSet/RegularGrid.hpp>
+#include <atomic>
 
 namespace yade {
 
@@ -17,10 +18,20 @@ private:
 	Vector3r center;
 	Real     volume, lengthChar;
 	Vector3r inertia; // the eigenvalues of the inertia matrix: its diagonal expression in localAxes basis (in a Vector3r form here)
-	bool     initDone;
+	std::atomic<bool> initDone; // set (release) at the end of init(), read (acquire) by lazyInit() without lock
 	bool     initDoneMarchingCubes;
 	int      nVoxInside;
+	Real     boundingRadius; // radius of a sphere centered at the origin (local axes) that contains the whole negative domain of distField
+	// distField stays the reference (serialized, set and read from Python, read by ShopLS, VTKRecorder and the marching cubes), but its nested
+	// vectors are scattered in memory: the contact loop reads one contiguous copy instead, either flatField or, if singlePrecisionField, flatFieldF.
+	// The shape then holds the field twice (1.5 times in single precision), a fraction of the memory of the grids of a typical simulation.
+	vector<Real>  flatField; // distField as one contiguous array, with the value at gridpoint (i,j,k) at (i*nGP[1] + j)*nGP[2] + k. Rebuilt by postLoad(), which C++ code changing distField after init() has to call
+	vector<float> flatFieldF; // the same, in single precision, instead of flatField if singlePrecisionField
+	void          initFlatField(); // fills flatField or flatFieldF from distField
+	template <typename T> void trilinearBatch(const T*, const Vector3r*, int, Real*, Vector3r*) const;
 	void     init();          // compute nVoxInside, center, volume, and inertia and calls initSurfNodes
+	void     lazyInit();      // init() under a lock, for the getters below
+	void     initCorners();   // fills corners
 	void     initSurfNodes(); // fills surfNodes
 	bool rayTraceInCell(const Vector3r&, const Vector3r&, const Vector3r&, const Vector3i&); // handles the ray tracing from a given point in a given cell
 	void rayTrace(const Vector3r&); // recursively calls rayTraceInCell, walking accross the whole grid along a ray starting from center
@@ -34,19 +45,24 @@ private:
 public:
 	Real             distance(const Vector3r&) const; // gives through interpolation the distance from a point to the surface
 	Vector3r         normal(const Vector3r&) const;   // gives the outwards normal at some point
+	void             distanceBatch(const Vector3r*, int, Real*, Vector3r* grad = nullptr) const; // distance (and gradient) at n points inside lsGrid, see .cpp
+	boost::python::tuple pyDistanceBatch(const vector<Vector3r>&) const; // distanceBatch() for Python, checking that the points are inside lsGrid
 	Real             getVolume();                     // these 3 get*() may call init() if not already done, they can not be const-declared
 	Vector3r         getCenter();
 	Vector3r         getInertia();
+	Real             getBoundingRadius();
+	const vector<Vector3r>& getCorners(); // corners, possibly calling init()
 	Real             getSurface() const;           // this one can be const-declared
 	void             computeMarchingCubes();       // Compute the marching cube triangulation for the LS shape
 	vector<Vector3r> getMarchingCubeTriangles();   // Retrieve marching cube triangles
 	vector<Vector3r> getMarchingCubeNormals();     // Retrieve marching cube normals
 	int              getMarchingCubeNbTriangles(); // Retrieve marching cube number of triangles
+	void             postLoad(LevelSet&);          // keeps flatField in line with distField when the latter is changed from Python
 	virtual ~LevelSet() {};
 	// clang-format off
   YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(LevelSet,Shape,"A level set description of particle shape based on a :yref:`discrete distance field<LevelSet.distField>` and :yref:`surface nodes<LevelSet.surfNodes>` [Duriez2021a]_ [Duriez2021b]_. See :ysrc:`examples/levelSet` for example scripts.",
 		((vector< vector< vector<Real> > >,distField,,Attr::readonly,"The signed (< 0 when inside) distance-to-surface function as a discrete scalar field on :yref:`lsGrid<LevelSet.lsGrid>`, with `distField[i][j][k]` corresponding to `lsGrid.gridPoint(i,j,k)`. From Python, slice this multi-dimensional list with care: while `distField[i][:][:]` corresponds to values on a x-cst plane, `distField[:][:][k]` is not at z-constant (use `[[distField[i][j][k] for j in ..] for i in ..]` instead)"))
-		((vector<Vector3r>,corners,,Attr::readonly,"The 8 corners of an axis-aligned bounding box, in local axes. It is computed once for all by :yref:`Bo1_LevelSet_Aabb` and used by the same Functor to get :yref:`Body.bound`."))
+		((vector<Vector3r>,corners,,Attr::readonly,"The 8 corners of an axis-aligned bounding box, in local axes. It is computed once for all at shape initialization and used by :yref:`Bo1_LevelSet_Aabb` to get :yref:`Body.bound`."))
 		((vector<Vector3r>,surfNodes,,Attr::readonly,"Surface discretization nodes (the list of) used for exact contact treatment in :yref:`Ig2_LevelSet_LevelSet_ScGeom`, previously coined boundNodes in [Duriez2021b]_. Expressed in local frame. Getting them back after a save/load cycle requires to launch one iteration or to first ask for shape.center.")) // NB: just nodes as a name would "conflict" with many PFacet variables
 		((int,nSurfNodes,100,,"The number of boundary nodes in :yref:`surfNodes<LevelSet.surfNodes>`, previously coined nNodes in [Duriez2021b]_. Usually set through utils `levelSetBody()` function (has to be set at instantiation in all cases). Please use a perfect square + 2 if not :yref:`twoD<LevelSet.twoD>` and if :yref:`nodesPath<LevelSet.nodesPath>` = 1."))
 		((int,nodesPath,2,,"Defines how the space of spherical coordinates $(\\theta \\in [0;\\pi] ,\\varphi\\in [0;2 \\pi])$ is discretized when ray tracing the boundary nodes: 1 gives a rectangular partition of that space, plus two nodes at $\\theta = 0 [\\pi]$; 2 locates the nodes along a spiral path [Duriez2021a]_")) // Elias'polyhedralBall code; and Rakhmanov1994
@@ -54,6 +70,7 @@ public:
 		((Real,sphericity,-1,Attr::readonly,"Shape sphericity computed from boundary nodes and assuming both largest inscribed sphere and smallest circumscribed sphere have the origin (of local axes) as center."))
 		((shared_ptr<RegularGrid>,lsGrid,new RegularGrid,Attr::readonly,"The :yref:`regular grid<RegularGrid>` carrying :yref:`distField<LevelSet.distField>`, in local axes."))
 		((bool,twoD,false,Attr::readonly,"True for z-invariant shapes. Serves to restrict the definition of :yref:`surfNodes<LevelSet.surfNodes>` in the (x,y) plane."))
+		((bool,singlePrecisionField,false,,"If true, :yref:`distField<LevelSet.distField>` is also stored in single precision and the latter is used by :yref:`Ig2_LevelSet_LevelSet_ScGeom` (half the memory traffic, distances then accurate to about 1e-7 relative to the grid extents). To be set before the shape is initialized (first iteration, or first call to e.g. :yref:`volume<LevelSet.volume>`)."))
 		((Real,smearCoeff,1.5,,"Rules the smearing coefficient $\\varepsilon > 0$ of the Heaviside step function for a smooth integration of the particle's volume close to its surface (the higher $\\varepsilon$ the smoother, i.e. the more diffuse the surface in terms of volume integration). Given in reciprocal multiples of $R_{cell}$ the half diagonal of the cells of the :yref:`lsGrid<LevelSet.lsGrid>`: $\\varepsilon = R_{cell}\\times 1/$ *smearCoeff* (smearing is deactivated if negative)."))
 
 		,
@@ -64,6 +81,7 @@ public:
 		initDoneMarchingCubes = false;
 		lengthChar = -1;
 		volume = -1;
+		boundingRadius = -1;
 		nVoxInside = -1;
 		center = Vector3r(std::numeric_limits<Real>::infinity(),std::numeric_limits<Real>::infinity(),std::numeric_limits<Real>::infinity());
 		createIndex(); // necessary for such a Shape-derived class, see https://yade-dem.org/doc/prog.html#indexing-dispatch-types
@@ -73,6 +91,7 @@ public:
  		.def("inertia",&LevelSet::getInertia,"The eigenvalues of the geometric inertia matrix (the one considering the infinitesimal volume as the integrand, instead of infinitesimal mass) as a Vector3r.")
 // 		.def("nodesInCell",&LevelSet::getNodesInCellCube,(boost::python::args("i", "j", "k")),"Which boundary nodes belong to a given grid cube (given by its i,j,k indices)")
 		.def("distance",&LevelSet::distance,(boost::python::arg("pt")),"Distance to surface value at pt, pt being expressed in local frame.")
+		.def("distanceBatch",&LevelSet::pyDistanceBatch,(boost::python::arg("pts")),"The distances and (not normalized) gradients of the distance function at a list of points inside :yref:`lsGrid<LevelSet.lsGrid>`, as a tuple of two lists. This is the batched trilinear interpolation used by :yref:`Ig2_LevelSet_LevelSet_ScGeom`, which reads :yref:`distField<LevelSet.distField>` in single precision if :yref:`singlePrecisionField<LevelSet.singlePrecisionField>`, and gives otherwise the same values as :yref:`distance<LevelSet.distance>` up to round-off. Local frame applies.")
 		.def("normal",&LevelSet::normal,(boost::python::arg("pt")),"Normal vector to the surface, at some pt. Local frame applies to both output normal and input pt.")
 		.def("rayTrace",&LevelSet::rayTrace,(boost::python::arg("ray")),"Performs one ray tracing, possibly modifying :yref:`surfNodes<LevelSet.surfNodes>`. Provided for debugging purposes")
 		.def("getSurface",&LevelSet::getSurface,"Returns particle surface as computed from numeric integration over the :yref:`surface nodes<LevelSet.surfNodes>`. Requires :yref:`nodesPath<LevelSet.nodesPath>` = 1.")
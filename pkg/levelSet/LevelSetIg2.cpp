@@ -219,30 +219,51 @@ bool Ig2_LevelSet_LevelSet_ScGeom::go(
 	        nodeOfSinB // mapped into initial configuration of larger Body
 	        ,
 	        normal, contactNode;
+	const Real radB(shB->getBoundingRadius()); // nodes farther than radB from centrBend can not be inside B
+	// buffers for the nodes that go through the culling below, reused from one call to the other:
+	thread_local vector<Vector3r> nodesInB; // the nodes mapped into the big Body's local frame
+	thread_local vector<int>      nodesIdx; // their indices in shS->surfNodes
+	thread_local vector<Real>     nodesDist;
+	nodesInB.clear();
+	nodesIdx.clear();
 
-	// 2.2 Actual loop over surface nodes:
+	// 2.2 Actual loop over surface nodes, first culling them and mapping the remaining ones into the big Body's local frame:
 	for (int node = 0; node < nNodes; node++) {
 		nodeOfS = ShopLS::rigidMapping(shS->surfNodes[node], centrSini, centrSend, rotS); // current position of this boundary node
 		if (!Shop::isInBB(nodeOfS, minBoOverlap, maxBoOverlap)) continue;
+		if ((nodeOfS - centrBend).squaredNorm() > radB * radB) continue;
 		nodeOfSinB = ShopLS::rigidMapping(nodeOfS, centrBend, centrBini, rotB); // mapping this node into the big Body's local frame
 		if (!Shop::isInBB(
 		            nodeOfSinB,
 		            minLSgrid,
 		            maxLSgrid)) // possible when bodies (and their shape.corners) rotate, leading their bounds to possibly "inflate" (think of a sphere)
 			continue;
-		distToNode = shB->distance(nodeOfSinB);
+		nodesInB.push_back(nodeOfSinB);
+		nodesIdx.push_back(node);
+	}
+	// then evaluating the distances of all these nodes at once, and taking the deepest one:
+	const int nIn(nodesInB.size());
+	nodesDist.resize(nIn);
+	shB->distanceBatch(nodesInB.data(), nIn, nodesDist.data());
+	int contactIdx(-1);
+	for (int idx = 0; idx < nIn; idx++) {
+		distToNode = nodesDist[idx];
 		if (distToNode < 0 and distToNode < prevDistToNode) {
-			maxOverlap = -distToNode;
-			normal     = rotS
-			        * shS->normal(
-			                shS->surfNodes
-			                        [node]); // shS->surfNodes[..] (and normal() to itself) refers to the initial shape, current normal is obtained with rotS *. It is for now the outward normal to the small particle
-			if (id1isBigger)                 // if necessary, we make the normal from 1 to 2, as expected
-				normal *= -1;
-			contactNode    = nodeOfS;
+			maxOverlap     = -distToNode;
+			contactIdx     = idx;
 			prevDistToNode = distToNode;
 		}
 	}
+	if (contactIdx >= 0) {
+		const int node = nodesIdx[contactIdx];
+		normal         = rotS
+		        * shS->normal(
+		                shS->surfNodes
+		                        [node]); // shS->surfNodes[..] (and normal() to itself) refers to the initial shape, current normal is obtained with rotS *. It is for now the outward normal to the small particle
+		if (id1isBigger) // if necessary, we make the normal from 1 to 2, as expected
+			normal *= -1;
+		contactNode = ShopLS::rigidMapping(shS->surfNodes[node], centrSini, centrSend, rotS);
+	}
 
 	// 2.3 Finishing the work:
 	if (!c->isReal() && !force && maxOverlap < 0)
@@ -14,6 +14,15 @@ namespace yade { // Cannot have #include directive inside.
 
 CREATE_LOGGER(ShopLS);
 
+std::list<ShopLS::LsShapeCacheEntry> ShopLS::lsShapeCache;
+const size_t                        ShopLS::lsShapeCacheCapacity;
+
+void ShopLS::clearLsCache()
+{
+	lsShapeCache.clear();
+	FastMarchingMethod::clearCache();
+}
+
 // Reminder: we re dealing with static functions here, there would be no point to const-qualify functions themselves
 
 Real ShopLS::biInterpolate(std::array<Real, 2> pt, std::array<Real, 2> xExtr, std::array<Real, 2> yExtr, std::array<std::array<Real, 2>, 2> knownVal)
@@ -178,13 +187,36 @@ vector<vector<vector<Real>>> ShopLS::distIniSE(const Vector3r& radii, const Vect
 }
 
 shared_ptr<LevelSet>
-ShopLS::lsSimpleShape(int shape, const AlignedBox3r& aabb, const Real& step, const Real& smearCoeff, const Vector2r& epsilons, shared_ptr<Clump> clump)
+ShopLS::lsSimpleShape(
+        int                 shape,
+        const AlignedBox3r& aabb,
+        const Real&         step,
+        const Real&         smearCoeff,
+        const Vector2r&     epsilons,
+        shared_ptr<Clump>   clump,
+        bool                fastSweeping,
+        bool                useCache)
 {
 	Vector3r minBod(aabb.min()), maxBod(aabb.max()), dimAabb(maxBod - minBod);
 	if ((dimAabb[0] < 0) || (dimAabb[1] < 0) || (dimAabb[2] < 0)) LOG_ERROR("You specified negative extents for aabb, this is not expected.");
 
 	shared_ptr<LevelSet> lsShape(new LevelSet);
 	lsShape->smearCoeff = smearCoeff;
+	// ***** 0. Identical shapes (except clumps, that depend on their members) share one grid and distance field, computed once *******
+	// epsilons and fastSweeping only matter for superellipsoids
+	const Vector2r keyEpsilons(shape == 3 ? epsilons : Vector2r::Zero());
+	const bool     keySweeping(shape == 3 and fastSweeping);
+	if (useCache && shape < 4) {
+		for (auto entry = lsShapeCache.begin(); entry != lsShapeCache.end(); entry++)
+			if (entry->shape == shape and entry->min == minBod and entry->max == maxBod and entry->step == step and entry->epsilons == keyEpsilons
+			    and entry->fastSweeping == keySweeping) {
+				lsShapeCache.splice(lsShapeCache.begin(), lsShapeCache, entry);
+				lsShape->lsGrid    = entry->grid;
+				lsShape->twoD      = (shape == 0);
+				lsShape->distField = entry->distField;
+				return lsShape;
+			}
+	}
 	Vector3r maxGrid,
 	        minGrid; // [minGrid,maxGrid] will be LevelSet->lsGrid. It may be different (bigger) than [minBod,maxBod] for the grid to go a little beyond the surface
 	                 // clang-format off
@@ -243,19 +275,27 @@ ShopLS::lsSimpleShape(int shape, const AlignedBox3r& aabb, const Real& step, con
 	} else if (shape == 3) // FMM for se, with the whole distance field at once
 	{
 		FastMarchingMethod distFMM;
-		distFMM.grid   = lsShape->lsGrid;
-		distFMM.phiIni = distIniSE((maxBod - minBod) / 2., epsilons, lsShape->lsGrid);
-		distanceVal    = distFMM.phi();
+		distFMM.grid         = lsShape->lsGrid;
+		distFMM.phiIni       = distIniSE((maxBod - minBod) / 2., epsilons, lsShape->lsGrid);
+		distFMM.fastSweeping = fastSweeping;
+		distFMM.useCache     = false; // lsShapeCache does the job
+		distanceVal          = distFMM.phi();
 	} else if (shape == 4) {
 		vector<int>        ids(clump->ids);
 		FastMarchingMethod distFMM;
-		distFMM.grid   = lsShape->lsGrid;
-		distFMM.phiIni = distIniClump(clump, lsShape->lsGrid);
-		distanceVal    = distFMM.phi();
+		distFMM.grid         = lsShape->lsGrid;
+		distFMM.phiIni       = distIniClump(clump, lsShape->lsGrid);
+		distFMM.fastSweeping = fastSweeping;
+		distFMM.useCache     = useCache;
+		distanceVal          = distFMM.phi();
 	}
 	if (!distanceVal.size()) // eg because there was no level set grid
 		LOG_ERROR("We computed an empty level set... This is not expected and may crash e.g. when exposed to Python.")
 	lsShape->distField = distanceVal;
+	if (useCache && shape < 4) {
+		lsShapeCache.push_front(LsShapeCacheEntry { shape, minBod, maxBod, step, keyEpsilons, keySweeping, lsShape->lsGrid, distanceVal });
+		if (lsShapeCache.size() > lsShapeCacheCapacity) lsShapeCache.pop_back();
+	}
 	return lsShape;
 }
 
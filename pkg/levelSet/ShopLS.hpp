@@ -11,6 +11,7 @@
 #include <core/Clump.hpp>
 #include <pkg/dem/ScGeom.hpp>
 #include <pkg/levelSet/LevelSet.hpp>
+#include <list>
 
 namespace yade { // Cannot have #include directive inside.
 class ShopLS {
@@ -31,8 +32,21 @@ public:
 	        const Real&,
 	        const Real&,
 	        const Vector2r&,
-	        shared_ptr<
-	                Clump>); // will be passed to Python in eg levelSetBody() and "returning shared_ptr<…> objects is the preferred way of passing objects from c++ to python" according to https://yade-dem.org/doc/prog.html#reference-counting
+	        shared_ptr<Clump>,
+	        bool fastSweeping,
+	        bool useCache); // will be passed to Python in eg levelSetBody() and "returning shared_ptr<…> objects is the preferred way of passing objects from c++ to python" according to https://yade-dem.org/doc/prog.html#reference-counting
+	struct LsShapeCacheEntry { // the parameters of one lsSimpleShape() call and its grid and distField
+		int                          shape;
+		Vector3r                     min, max;
+		Real                         step;
+		Vector2r                     epsilons;
+		bool                         fastSweeping;
+		shared_ptr<RegularGrid>      grid;
+		vector<vector<vector<Real>>> distField;
+	};
+	static std::list<LsShapeCacheEntry> lsShapeCache; // the last shapes of lsSimpleShape(), most recently used first
+	static const size_t                 lsShapeCacheCapacity = 16;
+	static void clearLsCache(); // empties lsShapeCache and FastMarchingMethod's cache
 	static Real
 	distApproxSE(const Vector3r& pt, const Vector3r& extents, const Vector2r& epsilons); // the approximated distance function to a superellipsoid
 	static vector<vector<vector<Real>>>
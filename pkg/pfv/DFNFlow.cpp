@@ -160,6 +160,7 @@ REGISTER_SERIALIZABLE(DFNFlowEngineT);
 YADE_PLUGIN((DFNFlowEngineT));
 class DFNFlowEngine : public DFNFlowEngineT {
 public:
+	virtual ~DFNFlowEngine() { stopBackground(); }
 	void trickPermeability(Solver* flow);
 	void interpolateCrack(Tesselation& Tes, Tesselation& NewTes);
 	void trickPermeability(RTriangulation::Facet_circulator& facet, Real aperture, RTriangulation::Finite_edges_iterator& edge);
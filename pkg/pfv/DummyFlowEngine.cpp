@@ -36,6 +36,7 @@ YADE_PLUGIN((DummyFlowEngineT));
 
 class DummyFlowEngine : public DummyFlowEngineT {
 public:
+	virtual ~DummyFlowEngine() { stopBackground(); }
 	//We can overload every functions of the base engine to make it behave differently
 	//if we overload action() like this, this engine is doing nothing in a standard timestep, it can still have useful functions
 	virtual void action() {};
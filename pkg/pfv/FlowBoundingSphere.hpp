@@ -19,6 +19,40 @@ typedef pair<pair<int, int>, vector<Real>> Constriction;
 
 namespace CGT {
 
+	/// Flattened copy of the pore network, rebuilt after each remesh (see FlowBoundingSphere::buildFlatNetwork).
+	/// Cells are stored along a Morton curve of their circumcenters so that per-step kernels stream through contiguous arrays
+	/// instead of jumping around the CGAL compact container. Neighbours and vertex->cell force contributions are in CSR form.
+	struct FlatNetwork {
+		std::vector<int>     cellIds;   // index in cellHandles (i.e. cell->info().id) of each flat cell
+		std::vector<int>     flatIds;   // inverse of cellIds
+		std::vector<int>     nbrPtr;    // CSR row pointers (size()+1) into nbrIdx, nbrFacet and facetArea
+		std::vector<int>     nbrIdx;    // flat index of each finite neighbour
+		std::vector<char>    nbrFacet;  // facet index (0-3) of the owner cell shared with that neighbour
+		std::vector<Real>    facetArea; // area of the same facet
+		std::vector<int>     forcePtr;  // CSR row pointers (maxId+2) indexed by vertex id into forceCell and unitForce
+		std::vector<int>     forceCell; // flat index of each cell contributing to the vertex force
+		std::vector<CVector> unitForce; // cached unitForceVectors of that cell for that vertex
+		std::vector<Real>    pressure;  // cell pressures gathered in flat order before evaluating forces
+		bool                 built = false;
+		bool                 forcesBuilt = false;
+
+		int  size() const { return int(cellIds.size()); }
+		void clear()
+		{
+			cellIds.clear();
+			flatIds.clear();
+			nbrPtr.clear();
+			nbrIdx.clear();
+			nbrFacet.clear();
+			facetArea.clear();
+			forcePtr.clear();
+			forceCell.clear();
+			unitForce.clear();
+			pressure.clear();
+			built = forcesBuilt = false;
+		}
+	};
+
 	template <class _Tesselation> class FlowBoundingSphere : public Network<_Tesselation> {
 	public:
 		typedef _Tesselation         Tesselation;
@@ -134,7 +168,7 @@ namespace CGT {
 		vector<CellHandle> blockedCells;
 		//Pointers to vectors used for user defined boundary pressure
 		vector<Real>*pxpos, *ppval;
-		void         initNewTri() { noCache = true; /*isLinearSystemSet=false; areCellsOrdered=false;*/ } //set flags after retriangulation
+		void         initNewTri() { noCache = true; flat.forcesBuilt = false; /*isLinearSystemSet=false; areCellsOrdered=false;*/ } //set flags after retriangulation
 		bool         permeabilityMap;
 
 		bool computeAllCells; //exececute computeHydraulicRadius for all facets and all spheres (Real cpu time but needed for now in order to define crossSections correctly)
@@ -155,6 +189,8 @@ namespace CGT {
 		vector<vector<const CVector*>> perVertexUnitForce;
 		vector<vector<const Real*>>    perVertexPressure;
 #endif
+		FlatNetwork                                        flat;
+		bool                                               useFlatNetwork; //build and use the flat arrays above in per-step loops
 		vector<Real>                                       edgeSurfaces;
 		vector<pair<const VertexInfo*, const VertexInfo*>> edgeIds;
 		vector<Real>                                       edgeNormalLubF;
@@ -202,6 +238,9 @@ namespace CGT {
 		void         initializeTemperatures(Real tZero);
 		bool         reApplyBoundaryConditions();
 		virtual void computeFacetForcesWithCache(bool onlyCache = false);
+		void         buildFlatNetwork();     //fill flat topology/facet areas from the current tesselation, after cellHandles are defined
+		void         buildFlatForceCache();  //copy the unitForceVectors cache in CSR form, done after the cache is (re)computed
+		void         gatherFlatPressures();  //copy cell pressures in flat order
 		void         saveVtk(const char* folder, bool withBoundaries);
 		//write vertices, cells, return ids and no. of fictious neighbors, allIds is an ordered list of cell ids (from begin() to end(), for vtk table lookup),
 		// some ids will appear multiple times if withBoundaries==true since boundary cells are splitted into multiple tetrahedra
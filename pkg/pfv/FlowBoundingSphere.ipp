@@ -87,15 +87,21 @@ namespace CGT {
 		ompThreads = 1;
 		errorCode = 0;
 		pxpos = ppval = NULL;
+		useFlatNetwork = true;
 	}
 
 	template <class Tesselation> void FlowBoundingSphere<Tesselation>::resetNetwork()
 	{
 		T[currentTes].Clear();
+		flat.clear();
 		this->resetLinearSystem();
 	}
 
-	template <class Tesselation> void FlowBoundingSphere<Tesselation>::resetLinearSystem() { noCache = true; }
+	template <class Tesselation> void FlowBoundingSphere<Tesselation>::resetLinearSystem()
+	{
+		noCache          = true;
+		flat.forcesBuilt = false; // its unitForce copies go stale with the cached unitForceVectors
+	}
 
 	template <class Tesselation> void FlowBoundingSphere<Tesselation>::averageRelativeCellVelocity()
 	{
@@ -316,6 +322,125 @@ namespace CGT {
 	}
 
 
+	//! interleave the lower 21 bits of three integers, giving the position of a point along a Morton (Z-order) curve
+	inline uint64_t mortonCode3(uint64_t x, uint64_t y, uint64_t z)
+	{
+		auto spread = [](uint64_t v) {
+			v &= 0x1fffff;
+			v = (v | v << 32) & 0x1f00000000ffff;
+			v = (v | v << 16) & 0x1f0000ff0000ff;
+			v = (v | v << 8) & 0x100f00f00f00f00f;
+			v = (v | v << 4) & 0x10c30c30c30c30c3;
+			v = (v | v << 2) & 0x1249249249249249;
+			return v;
+		};
+		return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+	}
+
+	template <class Tesselation> void FlowBoundingSphere<Tesselation>::buildFlatNetwork()
+	{
+		flat.clear();
+		if (!useFlatNetwork) return;
+		RTriangulation&   Tri = T[currentTes].Triangulation();
+		const VectorCell& cells = T[currentTes].cellHandles;
+		const int         n = cells.size();
+		if (n == 0) return;
+		// the flat numbering relies on cell ids being positions in cellHandles, don't build anything if a derived engine numbers cells differently
+		for (int i = 0; i < n; i++)
+			if (cells[i]->info().id != (unsigned)i) return;
+
+		// sort cells along a Morton curve of their circumcenters
+		Real lo[3] = { cells[0]->info().x(), cells[0]->info().y(), cells[0]->info().z() };
+		Real hi[3] = { lo[0], lo[1], lo[2] };
+		for (int i = 1; i < n; i++)
+			for (int d = 0; d < 3; d++) {
+				lo[d] = math::min(lo[d], Real(cells[i]->info()[d]));
+				hi[d] = math::max(hi[d], Real(cells[i]->info()[d]));
+			}
+		Real scale[3];
+		for (int d = 0; d < 3; d++)
+			scale[d] = (hi[d] > lo[d]) ? Real(0x1fffff) / (hi[d] - lo[d]) : 0;
+		vector<pair<uint64_t, int>> keys(n);
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads)
+#endif
+		for (int i = 0; i < n; i++) {
+			const Point& c = cells[i]->info();
+			keys[i]        = pair<uint64_t, int>(
+                                mortonCode3(
+                                        uint64_t((c.x() - lo[0]) * scale[0]), uint64_t((c.y() - lo[1]) * scale[1]), uint64_t((c.z() - lo[2]) * scale[2])),
+                                i);
+		}
+		std::sort(keys.begin(), keys.end());
+
+		flat.cellIds.resize(n);
+		flat.flatIds.resize(n);
+		for (int k = 0; k < n; k++) {
+			flat.cellIds[k]              = keys[k].second;
+			flat.flatIds[keys[k].second] = k;
+		}
+		flat.pressure.resize(n);
+		flat.nbrPtr.resize(n + 1);
+		flat.nbrIdx.reserve(4 * n);
+		flat.nbrFacet.reserve(4 * n);
+		flat.facetArea.reserve(4 * n);
+		for (int k = 0; k < n; k++) {
+			const CellHandle& cell = cells[flat.cellIds[k]];
+			flat.nbrPtr[k]         = flat.nbrIdx.size();
+			for (int j = 0; j < 4; j++) {
+				if (Tri.is_infinite(cell->neighbor(j))) continue;
+				flat.nbrIdx.push_back(flat.flatIds[cell->neighbor(j)->info().id]);
+				flat.nbrFacet.push_back(j);
+				flat.facetArea.push_back(sqrt(cell->info().facetSurfaces[j].squared_length()));
+			}
+		}
+		flat.nbrPtr[n] = flat.nbrIdx.size();
+		flat.built     = true;
+	}
+
+	template <class Tesselation> void FlowBoundingSphere<Tesselation>::buildFlatForceCache()
+	{
+		flat.forcesBuilt = false;
+		if (!flat.built) return;
+		RTriangulation&   Tri = T[currentTes].Triangulation();
+		const VectorCell& cells = T[currentTes].cellHandles;
+		const int         n = flat.size();
+		const int         nVertices = T[currentTes].maxId + 1;
+		// same contributions as in perVertexUnitForce: vertex j of each cell, if facet j is finite
+		flat.forcePtr.assign(nVertices + 1, 0);
+		for (int k = 0; k < n; k++) {
+			const CellHandle& cell = cells[flat.cellIds[k]];
+			for (int j = 0; j < 4; j++)
+				if (!Tri.is_infinite(cell->neighbor(j))) ++flat.forcePtr[cell->vertex(j)->info().id() + 1];
+		}
+		for (int v = 0; v < nVertices; v++)
+			flat.forcePtr[v + 1] += flat.forcePtr[v];
+		flat.forceCell.resize(flat.forcePtr[nVertices]);
+		flat.unitForce.resize(flat.forcePtr[nVertices]);
+		vector<int> fill(flat.forcePtr.begin(), flat.forcePtr.end() - 1);
+		for (int k = 0; k < n; k++) {
+			const CellHandle& cell = cells[flat.cellIds[k]];
+			for (int j = 0; j < 4; j++) {
+				if (Tri.is_infinite(cell->neighbor(j))) continue;
+				const int e       = fill[cell->vertex(j)->info().id()]++;
+				flat.forceCell[e] = k;
+				flat.unitForce[e] = cell->info().unitForceVectors[j];
+			}
+		}
+		flat.forcesBuilt = true;
+	}
+
+	template <class Tesselation> void FlowBoundingSphere<Tesselation>::gatherFlatPressures()
+	{
+		const VectorCell& cells = T[currentTes].cellHandles;
+		const int         n = flat.size();
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads)
+#endif
+		for (int k = 0; k < n; k++)
+			flat.pressure[k] = cells[flat.cellIds[k]]->info().p();
+	}
+
 	template <class Tesselation> void FlowBoundingSphere<Tesselation>::computeFacetForcesWithCache(bool onlyCache)
 	{
 		RTriangulation& Tri = T[currentTes].Triangulation();
@@ -395,6 +520,7 @@ namespace CGT {
 					}
 			}
 			noCache = false; //cache should always be defined after execution of this function
+			buildFlatForceCache();
 			if (onlyCache) return;
 		}
 
@@ -407,6 +533,19 @@ namespace CGT {
 		}
 
 #else
+		if (flat.forcesBuilt) {
+			gatherFlatPressures();
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads)
+#endif
+			for (int vn = 0; vn <= T[currentTes].maxId; vn++) {
+				if (T[currentTes].vertexHandles[vn] == NULL) continue;
+				CVector tf(0, 0, 0);
+				for (int e = flat.forcePtr[vn]; e < flat.forcePtr[vn + 1]; e++)
+					tf = tf + flat.unitForce[e] * flat.pressure[flat.forceCell[e]];
+				T[currentTes].vertexHandles[vn]->info().forces = tf;
+			}
+		} else
 #ifdef YADE_OPENMP
 #pragma omp parallel for num_threads(ompThreads)
 #endif
@@ -118,6 +118,7 @@ namespace CGT {
 		Eigen::CholmodDecomposition<Eigen::SparseMatrix<double>, Eigen::Lower> eSolver;
 		// #endif
 		bool factorizedEigenSolver;
+		bool analyzedEigenSolver; //eSolver holds the symbolic analysis of the current sparsity pattern, only the numerical factorization is needed if reuseOrdering
 		void exportMatrix(const char* filename)
 		{
 			std::ofstream f;
@@ -102,6 +102,7 @@ namespace CGT {
 		pTime2 = 0;
 #ifdef LINSOLV
 		factorizedEigenSolver = false;
+		analyzedEigenSolver = false;
 		numFactorizeThreads = 1;
 		numSolveThreads = 1;
 #endif
@@ -169,6 +170,7 @@ namespace CGT {
 #endif
 #ifdef LINSOLV
 		factorizedEigenSolver = false;
+		analyzedEigenSolver = false;
 #endif
 #ifdef PARDISO
 		if (pardisoInitialized) {
@@ -680,14 +682,20 @@ namespace CGT {
 		for (int k = 0; k < ncols; k++)
 			eb[k] = T_bv[k];
 		if (!factorizedEigenSolver) {
-			eSolver.setMode(Eigen::CholmodSupernodalLLt);
 			openblas_set_num_threads(numFactorizeThreads);
-			eSolver.compute(A);
+			// same triangulation with updated permeabilities (see updateLinearSystem), skip the ordering and symbolic analysis
+			if (reuseOrdering && analyzedEigenSolver && eSolver.cols() == A.cols()) eSolver.factorize(A);
+			else {
+				eSolver.setMode(Eigen::CholmodSupernodalLLt);
+				eSolver.compute(A);
+			}
+			analyzedEigenSolver = true;
 			//Check result
 			if (eSolver.cholmod().status > 0) {
 				cerr << "something went wrong in Cholesky factorization, use LDLt as fallback this time" << eSolver.cholmod().status << endl;
 				eSolver.setMode(Eigen::CholmodLDLt);
 				eSolver.compute(A);
+				analyzedEigenSolver = false;
 			}
 			factorizedEigenSolver = true;
 		}
@@ -44,7 +44,7 @@ namespace yade { // Cannot have #include directive inside.
 CREATE_LOGGER(PartialSatClayEngine);
 YADE_PLUGIN((PartialSatClayEngineT)(PartialSatClayEngine)(PartialSatMat)(PartialSatState)(Ip2_PartialSatMat_PartialSatMat_MindlinPhys));
 
-PartialSatClayEngine::~PartialSatClayEngine() { }
+PartialSatClayEngine::~PartialSatClayEngine() { stopBackground(); }
 
 // clang-format off
 void PartialSatClayEngine::action()
@@ -72,8 +72,8 @@ void PartialSatClayEngine::action()
 		if (alphaBound >= 0) addAlphaToPositionsBuffer(true);
 		if (debug) cout << "about to initializevolumes" << endl;
 		initializeVolumes(*solver);
-		backgroundSolver    = solver;
-		backgroundCompleted = true;
+		backgroundSolver = solver;
+		backgroundCompleted.store(true, std::memory_order_release);
 		if (partialSatEngine) {
 			cout << "setting initial porosity" << endl;
 			if (imageryFilePath.compare("none") == 0)
@@ -139,6 +139,13 @@ void PartialSatClayEngine::action()
 #endif
 		if (partialSatEngine) setCellsDSDP(*solver);
 		timeDimension = viscosity / maxDSDPj ;
+		timingDeltas->checkpoint("Cells dsdp");
+#ifdef LINSOLV
+		if (storageRefactorTolerance >= 0 and homogeneousSuctionValue == 0
+		    and solver->updateStorageTerms(partialSatDT == 0 ? scene->dt : solverDT, storageRefactorTolerance))
+			storageRefactors++;
+		timingDeltas->checkpoint("Storage terms refactorization");
+#endif
 		if (homogeneousSuctionValue==0) solver->gaussSeidel(partialSatDT == 0 ? scene->dt : solverDT);
 		else setHomogeneousSuction(*solver);
 		timingDeltas->checkpoint("Factorize + Solve");
@@ -147,6 +154,7 @@ void PartialSatClayEngine::action()
 			if (!freezeSaturation) updateSaturation(*solver);
 			if (debug) cout << "finished initializing saturations" << endl;
 		}
+		timingDeltas->checkpoint("Update saturation");
 		if (!decoupleForces) solver->computeFacetForcesWithCache();
 		if (debug) cout << "finished computing facet forces" << endl;
 	}
@@ -175,15 +183,10 @@ void PartialSatClayEngine::action()
 	if (debug) cout << "finished computing forces and applying" << endl;
 ///End compute flow and forces
 #ifdef LINSOLV
-	int sleeping = 0;
 	if (multithread && !first) {
-		while (updateTriangulation && !backgroundCompleted) { /*cout<<"sleeping..."<<sleeping++<<endl;*/
-			sleeping++;
-			boost::this_thread::sleep(boost::posix_time::microseconds(1000));
-		}
-		if (debug && sleeping)
-			cerr << "sleeping..." << sleeping << endl;
-		if (updateTriangulation || ((meshUpdateInterval > 0 && ellapsedIter > (0.5 * meshUpdateInterval)) && backgroundCompleted)) {
+		bool swapSolvers = backgroundSwapDue();
+		timingDeltas->checkpoint("Background stall");
+		if (swapSolvers) {
 			if (debug) cerr << "switch flow solver" << endl;
 			if (useSolver == 0) LOG_ERROR("background calculations not available for Gauss-Seidel");
 			if (!fluxChanged) {
@@ -208,14 +211,11 @@ void PartialSatClayEngine::action()
 			backgroundSolver->imposedF = vector<pair<CGT::Point, Real>>(solver->imposedF);
 			if (debug)
 				cerr << "switched" << endl;
-			setPositionsBuffer(false); //set "parallel" buffer for background calculation
-			backgroundCompleted     = false;
 			retriangulationLastIter = ellapsedIter;
 			updateTriangulation     = false;
 			epsVolCumulative        = 0;
 			ellapsedIter            = 0;
-			boost::thread workerThread(&PartialSatClayEngine::backgroundAction, this);
-			workerThread.detach();
+			postBackgroundJob();
 			if (debug) cerr << "backgrounded" << endl;
 			initializeVolumes(*solver);
 			//computeViscousForces(*solver);
@@ -614,16 +614,24 @@ Real PartialSatClayEngine::laplaceDeviate(Real mu, Real b2)
 void PartialSatClayEngine::setCellsDSDP(FlowSolver& flow)
 {
 	Tesselation& Tes = flow.T[flow.currentTes];
-	//	#ifdef YADE_OPENMP
-	maxDSDPj = 0;
 	const long size = Tes.cellHandles.size();
+#ifdef YADE_OPENMP
+	vector<Real> maxDSDP(omp_get_max_threads(), 0); // one slot per thread, maxDSDPj was a shared write
 #pragma omp parallel for num_threads(ompThreads>0 ? ompThreads : 1)
+#else
+	vector<Real> maxDSDP(1, 0);
+#endif
 	for (long i = 0; i < size; i++) {
 		CellHandle& cell = Tes.cellHandles[i];
 		Real        deriv;
 		if (cell->info().isAlpha) continue;
 		deriv = dsdp(cell);
-		if ( deriv > maxDSDPj ) maxDSDPj = deriv;
+#ifdef YADE_OPENMP
+		Real& threadMax = maxDSDP[omp_get_thread_num()];
+#else
+		Real& threadMax = maxDSDP[0];
+#endif
+		if ( deriv > threadMax ) threadMax = deriv;
 		if (freezeSaturation) deriv = 0;
 		if (!math::isnan(deriv)) cell->info().dsdp = deriv;
 		else cell->info().dsdp = 0;
@@ -631,6 +639,7 @@ void PartialSatClayEngine::setCellsDSDP(FlowSolver& flow)
 		// use this value to determine critical timestep
 		//cout << "dsdp " << deriv << endl;
 	}
+	maxDSDPj = *std::max_element(maxDSDP.begin(), maxDSDP.end());
 }
 
 Real PartialSatClayEngine::dsdp(CellHandle& cell)
@@ -754,9 +763,8 @@ void PartialSatClayEngine::updateSaturation(FlowSolver& flow)
 
 
 	Tesselation& Tes = flow.T[flow.currentTes];
-	//	#ifdef YADE_OPENMP
 	const long size = Tes.cellHandles.size();
-	//	#pragma omp parallel for num_threads(ompThreads>0 ? ompThreads : 1)
+#pragma omp parallel for num_threads(ompThreads>0 ? ompThreads : 1)
 	for (long i = 0; i < size; i++) {
 		CellHandle& cell = Tes.cellHandles[i];
 		if (cell->info().Pcondition or cell->info().isAlpha or cell->info().blocked)
@@ -339,6 +339,8 @@ public:
 	((Real,timeDimension,0,,"Used to determine stability of system, partialSatEngine computes this value automatically."))
 	((bool,useForceForCracks,0,,"Cracks are only considered if a normal force of 0 is encountered between two particles."))
 	((Real,homogeneousSuctionValue,0,,"Will override the pressure solver and set all cells to the user provided value. Meant for testing non transient swelling conditions."))
+	((Real,storageRefactorTolerance,-1,,"If >=0, the storage terms of the matrix diagonal (dsdp and fluid compressibility) are updated before each solve, and the matrix is refactorized numerically (reusing the ordering and symbolic analysis) when one of them changed by more than this fraction of the diagonal. If negative, these terms are only updated when the linear system is rebuilt (remeshing or :yref:`FlowEngine::fixTriUpdatePermInt`). Needs useSolver=3 or 4."))
+	((long,storageRefactors,0,Attr::readonly,"Number of refactorizations triggered by :yref:`PartialSatClayEngine::storageRefactorTolerance`."))
 
 	,/*PartialSatClayEngineT()*/,
 	solver = shared_ptr<FlowSolver> (new FlowSolver);
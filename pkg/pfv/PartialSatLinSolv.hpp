@@ -75,6 +75,7 @@ namespace CGT {
 		using _N::tesselation;
 
 		using BaseFlowSolver::bIntrinsicPerm;
+		using BaseFlowSolver::buildFlatForceCache;
 		using BaseFlowSolver::checkSphereFacetOverlap;
 		using BaseFlowSolver::clampKValues;
 		using BaseFlowSolver::computeAllCells;
@@ -167,12 +168,24 @@ namespace CGT {
 
 		// vector<int> indices; //redirection vector containing the rank of cell so that T_cells[indices[cell->info().index]]=cell
 		Real averageK = 0;
+		// the storage (compressibility) terms are the only part of the matrix changing between assemblies, they are kept apart to refactorize in place
+		vector<Real>  diagConductance; // diagonal without storage term, by unknown
+		vector<Real>  diagStorage;     // storage term currently in the matrix, by unknown
+		vector<Real>  newDiagStorage;
+		vector<Real*> diagValues; // diagonal entries of A (useSolver=3) or Achol (useSolver=4)
+#ifdef PFV_GPU
+		typedef long CholIndex;
+#else
+		typedef int CholIndex;
+#endif
 		virtual ~PartialSatLinSolv();
 		PartialSatLinSolv();
 
 		///Linear system solve
 		int               setLinearSystem(Real dt = 0) override;
 		void              copyCellsToLin(Real dt = 0) override;
+		Real              storageTerm(const CellHandle& cell, Real dt) const;
+		bool              updateStorageTerms(Real dt, Real tolerance); // refactorize if a storage term changed by more than tolerance (relative to the diagonal), true if done
 		void              interpolate(Tesselation& Tes, Tesselation& NewTes) override;
 		void              computeFacetForcesWithCache(bool onlyCache = false) override;
 		void              computePermeability() override;
@@ -120,6 +120,9 @@ namespace CGT {
 			//gsB.resize(ncols+1);
 			T_cells.resize(ncols + 1);
 			T_cells.shrink_to_fit();
+			diagConductance.assign(ncols, 0);
+			diagStorage.assign(ncols, 0);
+			diagValues.clear();
 			T_nnz = 0;
 		}
 		for (int kk = 0; kk < ncols; kk++)
@@ -145,11 +148,9 @@ namespace CGT {
 					for (int j = 0; j < 4; j++)
 						if (!cell->neighbor(j)->info().blocked) vs[T_nnz] += (cell->info().kNorm())[j];
 					// 				vs[T_nnz] = (cell->info().kNorm())[0]+ (cell->info().kNorm())[1]+ (cell->info().kNorm())[2]+ (cell->info().kNorm())[3];
-					if (fluidBulkModulus > 0) vs[T_nnz] += (1.f / (dt * fluidBulkModulus * cell->info().invVoidVolume()));
-					if (!freezeSaturation && partialSatEngine && !math::isnan(cell->info().dsdp)) {
-						vs[T_nnz] += cell->info().dsdp / (cell->info().invVoidVolume() * dt);
-						//if (useKeq) vs[T_nnz] += 1./(dt*cell->info().equivalentBulkModulus*cell->info().invVoidVolume());
-					}
+					diagConductance[index - 1] = vs[T_nnz];
+					diagStorage[index - 1] = storageTerm(cell, dt);
+					vs[T_nnz] += diagStorage[index - 1];
 					++T_nnz;
 				}
 				for (int j = 0; j < 4; j++) {
@@ -193,6 +194,9 @@ namespace CGT {
 				A.resize(ncols, ncols);
 				A.data().squeeze();
 				A.setFromTriplets(tripletList.begin(), tripletList.end());
+				diagValues.resize(ncols);
+				for (int k = 0; k < ncols; k++)
+					diagValues[k] = &A.coeffRef(k, k);
 #endif
 #ifdef SUITESPARSE_VERSION_4
 			} else if (useSolver == 4) {
@@ -209,6 +213,11 @@ namespace CGT {
 				}
 				Achol = CHOLMOD(triplet_to_sparse)(trip, trip->nnz, &com);
 				CHOLMOD(free_triplet)(&trip, &com);
+				diagValues.resize(ncols);
+				for (int k = 0; k < ncols; k++) {
+					for (long p = ((CholIndex*)Achol->p)[k]; p < ((CholIndex*)Achol->p)[k + 1]; p++)
+						if (((CholIndex*)Achol->i)[p] == k) diagValues[k] = ((Real*)Achol->x) + p;
+				}
 				//trip=0;
 				if (getCHOLMODPerfTimings) {
 					CHOLMOD(print_sparse)(Achol, "Achol", &com);
@@ -223,6 +232,65 @@ namespace CGT {
 		return ncols;
 	}
 
+	template <class _Tesselation> Real PartialSatLinSolv<_Tesselation>::storageTerm(const CellHandle& cell, Real dt) const
+	{
+		Real storage = 0;
+		if (fluidBulkModulus > 0) storage += (1.f / (dt * fluidBulkModulus * cell->info().invVoidVolume()));
+		if (!freezeSaturation && partialSatEngine && !math::isnan(cell->info().dsdp)) {
+			storage += cell->info().dsdp / (cell->info().invVoidVolume() * dt);
+			//if (useKeq) storage += 1./(dt*cell->info().equivalentBulkModulus*cell->info().invVoidVolume());
+		}
+		return storage;
+	}
+
+	template <class _Tesselation> bool PartialSatLinSolv<_Tesselation>::updateStorageTerms(Real dt, Real tolerance)
+	{
+#ifdef LINSOLV
+		// nothing factorized yet or a new system is due, the next solve will assemble the current terms anyway
+		if (!isLinearSystemSet || !factorizedEigenSolver || int(diagValues.size()) != ncols) return false;
+		if (useSolver != 3 && useSolver != 4) return false;
+		newDiagStorage.resize(ncols);
+#ifdef YADE_OPENMP
+		vector<Real> maxChange(omp_get_max_threads(), 0);
+#pragma omp parallel for num_threads(ompThreads > 0 ? ompThreads : 1)
+#else
+		vector<Real> maxChange(1, 0);
+#endif
+		for (int k = 0; k < ncols; k++) {
+			newDiagStorage[k] = storageTerm(T_cells[k + 1], dt);
+#ifdef YADE_OPENMP
+			Real& threadMax = maxChange[omp_get_thread_num()];
+#else
+			Real& threadMax = maxChange[0];
+#endif
+			threadMax = math::max(threadMax, math::abs(newDiagStorage[k] - diagStorage[k]) / (diagConductance[k] + diagStorage[k]));
+		}
+		if (*std::max_element(maxChange.begin(), maxChange.end()) <= tolerance) return false;
+		// the pattern and the off-diagonal terms are unchanged, only the numerical factorization is redone
+		diagStorage.swap(newDiagStorage);
+		for (int k = 0; k < ncols; k++)
+			*diagValues[k] = diagConductance[k] + diagStorage[k];
+		if (getCHOLMODPerfTimings) gettimeofday(&start, NULL);
+		openblas_set_num_threads(numFactorizeThreads);
+		if (useSolver == 3) {
+			eSolver.factorize(A);
+			if (eSolver.cholmod().status > 0) factorizedEigenSolver = false; //let eigenSolve() redo the full factorization with its fallback
+		} else {
+#ifdef SUITESPARSE_VERSION_4
+			CHOLMOD(factorize)(Achol, L, &com);
+#endif
+		}
+		if (getCHOLMODPerfTimings) {
+			gettimeofday(&end, NULL);
+			cout << "Time to refactorize with new storage terms " << ((end.tv_sec * 1000000 + end.tv_usec) - (start.tv_sec * 1000000 + start.tv_usec))
+			     << endl;
+		}
+		return true;
+#else
+		return false;
+#endif
+	}
+
 	// clang-format off
 	template <class _Tesselation> void PartialSatLinSolv<_Tesselation>::copyCellsToLin(Real dt)
 	{
@@ -416,6 +484,7 @@ namespace CGT {
 					}
 			}
 			noCache = false; //cache should always be defined after execution of this function
+			buildFlatForceCache(); // keep the flat copies of unitForceVectors in sync
 			if (onlyCache)
 				return;
 		} else { //use cached values
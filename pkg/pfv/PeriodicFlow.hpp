@@ -78,6 +78,7 @@ namespace CGT {
 		using BaseFlowSolver::minKdivKmean;
 		using BaseFlowSolver::minPermLength;
 		using BaseFlowSolver::noCache;
+		using BaseFlowSolver::ompThreads;
 		using BaseFlowSolver::permeabilityMap;
 		using BaseFlowSolver::rAverage;
 		using BaseFlowSolver::relax;
@@ -97,6 +98,15 @@ namespace CGT {
 		void computePermeability() override;
 		void gaussSeidel(Real dt = 0) override;
 		void displayStatistics();
+
+		//Per-vertex lists of the cached unit forces (CSR), so that forces are gathered by vertex in parallel instead of scattered by cell
+		//Each entry keeps the period of the vertex seen from the cell, to translate the cell pressure like in the scattered loop
+		vector<int>     forcePtr;
+		vector<int>     forceCell;
+		vector<int>     forcePeriod;
+		vector<CVector> forceVector;
+		vector<Real>    forceCellP;
+		void            buildForceGather();
 #ifdef EIGENSPARSE_LIB
 		//Eigen's sparse matrix for forces computation
 		// 		Eigen::SparseMatrix<Real> FIntegral;
@@ -204,6 +214,7 @@ namespace CGT {
 			}
 
 			noCache = false; //cache should always be defined after execution of this function
+			buildForceGather();
 			if (onlyCache) return;
 		} // end if(noCache)
 
@@ -212,17 +223,27 @@ namespace CGT {
 		Real pDeltas[3];
 		for (unsigned int k = 0; k < 3; k++)
 			pDeltas[k] = CellInfo::hSize[k] * CellInfo::gradP;
-		//Then compute the forces
-		for (VCellIterator cellIt = T[currentTes].cellHandles.begin(); cellIt != T[currentTes].cellHandles.end(); cellIt++) {
-			const CellHandle& cell = *cellIt;
-			for (int yy = 0; yy < 4; yy++) {
-				VertexInfo& vhi = cell->vertex(yy)->info();
-				Real        unshiftedP = cell->info().p();
+		//Then compute the forces, vertex by vertex
+		const VectorCell& cellHandles = T[currentTes].cellHandles;
+		const int         nCells = cellHandles.size();
+		const int         nVertices = forcePtr.size() - 1;
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads > 0 ? ompThreads : 1)
+#endif
+		for (int c = 0; c < nCells; c++)
+			forceCellP[c] = cellHandles[c]->info().p();
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads > 0 ? ompThreads : 1)
+#endif
+		for (int vn = 0; vn < nVertices; vn++) {
+			if (forcePtr[vn] == forcePtr[vn + 1]) continue;
+			CVector tf(0, 0, 0);
+			for (int e = forcePtr[vn]; e < forcePtr[vn + 1]; e++) {
 				//the pressure translated to a ghost cell adjacent to the non-ghost vertex
-				unshiftedP -= pDeltas[0] * vhi.period[0] + pDeltas[1] * vhi.period[1] + pDeltas[2] * vhi.period[2];
-				T[currentTes].vertexHandles[vhi.id()]->info().forces
-				        = T[currentTes].vertexHandles[vhi.id()]->info().forces + cell->info().unitForceVectors[yy] * unshiftedP;
+				const int* period = &forcePeriod[3 * e];
+				tf = tf + forceVector[e] * (forceCellP[forceCell[e]] - pDeltas[0] * period[0] - pDeltas[1] * period[1] - pDeltas[2] * period[2]);
 			}
+			T[currentTes].vertexHandles[vn]->info().forces = T[currentTes].vertexHandles[vn]->info().forces + tf;
 		}
 		if (debugOut) {
 			CVector totalForce = nullVect;
@@ -237,6 +258,36 @@ namespace CGT {
 		}
 	}
 
+	template <class _Tesselation> void PeriodicFlow<_Tesselation>::buildForceGather()
+	{
+		const Tesselation& Tes = T[currentTes];
+		const int          nCells = Tes.cellHandles.size();
+		const int          nVertices = Tes.maxId + 1;
+		forcePtr.assign(nVertices + 1, 0);
+		for (int c = 0; c < nCells; c++)
+			for (int yy = 0; yy < 4; yy++)
+				forcePtr[Tes.cellHandles[c]->vertex(yy)->info().id() + 1]++;
+		for (int vn = 0; vn < nVertices; vn++)
+			forcePtr[vn + 1] += forcePtr[vn];
+		const int nEntries = forcePtr[nVertices];
+		forceCell.resize(nEntries);
+		forcePeriod.resize(3 * nEntries);
+		forceVector.resize(nEntries);
+		forceCellP.resize(nCells);
+		vector<int> next(forcePtr.begin(), forcePtr.end() - 1);
+		for (int c = 0; c < nCells; c++) {
+			const CellHandle& cell = Tes.cellHandles[c];
+			for (int yy = 0; yy < 4; yy++) {
+				const VertexInfo& vhi = cell->vertex(yy)->info();
+				const int         e = next[vhi.id()]++;
+				forceCell[e] = c;
+				forceVector[e] = cell->info().unitForceVectors[yy];
+				for (int k = 0; k < 3; k++)
+					forcePeriod[3 * e + k] = vhi.period[k];
+			}
+		}
+	}
+
 	template <class _Tesselation> void PeriodicFlow<_Tesselation>::computePermeability()
 	{
 		if (debugOut) cout << "----Computing_Permeability (Periodic)------" << endl;
@@ -251,6 +302,8 @@ namespace CGT {
 		Real        infiniteK = 1e3;
 		Real        volume_sub_pore = 0.f;
 		VectorCell& cellHandles = T[currentTes].cellHandles;
+		// Serial: the Network helpers below keep facet scratch data (facetNFictious, facetF1...) and the running volume/surface
+		// totals (vPoral, sSolidTot...) in solver members, and each facet also writes the mirror kNorm of its neighbour.
 		for (VCellIterator cellIt = T[currentTes].cellHandles.begin(); cellIt != T[currentTes].cellHandles.end(); cellIt++) {
 			CellHandle& cell = *cellIt;
 			Point&      p1 = cell->info();
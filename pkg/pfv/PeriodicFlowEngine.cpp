@@ -122,6 +122,7 @@ public:
 		YADE_CLASS_BASE_DOC_ATTRS_INIT_CTOR_PY(PeriodicFlowEngine,FlowEngine_PeriodicInfo,"A variant of :yref:`FlowEngine` implementing periodic boundary conditions. The API is very similar.",
 		((Real,duplicateThreshold, 0.06,,"distance from cell borders that will triger periodic duplication in the triangulation |yupdate|"))
 		((Vector3r, gradP, Vector3r::Zero(),,"Macroscopic pressure gradient"))
+		((bool, spatialOrder, true,,"Number the cells, i.e. the unknowns of the linear system, along a Morton curve of their Voronoi centers in the period, for the locality of the solver. If false the cells keep the order of the triangulation. Applies at the next triangulation."))
 		,,
 		wallIds=vector<int>(6,-1);
 		solver = shared_ptr<FlowSolver> (new FlowSolver);
@@ -144,7 +145,7 @@ CVector PeriodicCellInfo::gradP = CVector();
 
 CREATE_LOGGER(PeriodicFlowEngine);
 
-PeriodicFlowEngine::~PeriodicFlowEngine() { }
+PeriodicFlowEngine::~PeriodicFlowEngine() { stopBackground(); }
 
 void PeriodicFlowEngine::action()
 {
@@ -163,9 +164,12 @@ void PeriodicFlowEngine::action()
 		}
 		initializeVolumes(*solver);
 		backgroundSolver = solver;
-		backgroundCompleted = true;
+		backgroundCompleted.store(true, std::memory_order_release);
 	}
 	//         if ( first ) {buildTriangulation ( pZero ); updateTriangulation = false; initializeVolumes();}
+#ifdef YADE_OPENMP
+	solver->ompThreads = ompThreads > 0 ? ompThreads : omp_get_max_threads();
+#endif
 
 	timingDeltas->checkpoint("Triangulating");
 	updateVolumes(*solver);
@@ -211,10 +215,9 @@ void PeriodicFlowEngine::action()
 	///End Compute flow and forces
 	timingDeltas->checkpoint("Applying Forces");
 	if (multithread && !first) {
-		while (updateTriangulation && !backgroundCompleted) { /*cout<<"sleeping..."<<sleeping++<<endl;*/
-			boost::this_thread::sleep(boost::posix_time::microseconds(1000));
-		}
-		if (updateTriangulation || (meshUpdateInterval > 0 && ellapsedIter > (0.5 * meshUpdateInterval))) {
+		bool swapSolvers = backgroundSwapDue();
+		timingDeltas->checkpoint("Background stall");
+		if (swapSolvers) {
 			if (useSolver == 0) LOG_ERROR("background calculations not available for Gauss-Seidel");
 			if (fluidBulkModulus > 0 || doInterpolate)
 				solver->interpolate(solver->T[solver->currentTes], backgroundSolver->T[backgroundSolver->currentTes]);
@@ -223,14 +226,11 @@ void PeriodicFlowEngine::action()
 			//Copy imposed pressures/flow from the old solver
 			backgroundSolver->imposedP = vector<pair<CGT::Point, Real>>(solver->imposedP);
 			backgroundSolver->imposedF = vector<pair<CGT::Point, Real>>(solver->imposedF);
-			setPositionsBuffer(false);
 			cachedCell = Cell(*(scene->cell));
-			backgroundCompleted = false;
 			retriangulationLastIter = ellapsedIter;
 			ellapsedIter = 0;
 			epsVolCumulative = 0;
-			boost::thread workerThread(&PeriodicFlowEngine::backgroundAction, this);
-			workerThread.detach();
+			postBackgroundJob();
 			initializeVolumes(*solver);
 			computeViscousForces(*solver);
 		} else if (debug && !first) {
@@ -552,8 +552,25 @@ void PeriodicFlowEngine::buildTriangulation(Real pZero2, FlowSolver& flow)
 	int                      baseIndex = -1;
 	FlowSolver::Tesselation& Tes = flow.tesselation();
 	Tes.cellHandles.resize(Tes.Triangulation().number_of_finite_cells());
+	// visit the cells along a space-filling curve of the period, so that indices (rows of the linear system) and cellHandles are spatially ordered
+	const Vector3r                                   cellSize(cachedCell.getSize());
+	vector<std::pair<uint64_t, FiniteCellsIterator>> sortedCells;
+	sortedCells.reserve(Tes.Triangulation().number_of_finite_cells());
 	const FiniteCellsIterator cellend = Tes.Triangulation().finite_cells_end();
 	for (FiniteCellsIterator cell = Tes.Triangulation().finite_cells_begin(); cell != cellend; cell++) {
+		uint64_t q[3];
+		for (int k = 0; k < 3; k++) {
+			Real u = cell->info()[k] / cellSize[k]; // voronoi center, cells out of the period are ghosts and are clamped to the border
+			q[k] = (u > 0) ? uint64_t((u < 1 ? u : 1) * 0x1fffff) : 0;
+		}
+		sortedCells.push_back(std::make_pair(CGT::mortonCode3(q[0], q[1], q[2]), cell));
+	}
+	if (spatialOrder)
+		std::sort(sortedCells.begin(), sortedCells.end(), [](const std::pair<uint64_t, FiniteCellsIterator>& a, const std::pair<uint64_t, FiniteCellsIterator>& b) {
+			return a.first < b.first;
+		});
+	for (const auto& sorted : sortedCells) {
+		const FiniteCellsIterator& cell = sorted.second;
 		locateCell(cell, index, baseIndex, flow);
 		if (flow.errorCode > 0) {
 			LOG_ERROR("problem here, flow.errorCode>0");
@@ -81,11 +81,14 @@ namespace CGT {
 		using BaseFlowSolver::meanKStat;
 		using BaseFlowSolver::minKdivKmean;
 		using BaseFlowSolver::minPermLength;
+		using BaseFlowSolver::multithread;
 		using BaseFlowSolver::noCache;
+		using BaseFlowSolver::ompThreads;
 		using BaseFlowSolver::permeabilityMap;
 		using BaseFlowSolver::rAverage;
 		using BaseFlowSolver::relax;
 		using BaseFlowSolver::resetRHS;
+		using BaseFlowSolver::reuseOrdering;
 		using BaseFlowSolver::tolerance;
 		using BaseFlowSolver::viscosity;
 		/// More members from LinSolv variant
@@ -111,6 +114,13 @@ namespace CGT {
 		using BaseFlowSolver::tripletList;
 		using BaseFlowSolver::useSolver;
 		using BaseFlowSolver::xodv;
+#ifdef SUITESPARSE_VERSION_4
+		using BaseFlowSolver::Achol;
+		using BaseFlowSolver::add_T_entry;
+		using BaseFlowSolver::com;
+		using BaseFlowSolver::factorExists;
+		using BaseFlowSolver::L;
+#endif
 
 		vector<int> indices; //redirection vector containing the rank of cell so that T_cells[indices[cell->info().index]]=cell
 
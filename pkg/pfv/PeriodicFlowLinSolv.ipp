@@ -57,7 +57,6 @@ namespace CGT {
 
 		//WARNING : boundary conditions (Pcondition, p values) must have been set for a correct definition of
 		RTriangulation& Tri = T[currentTes].Triangulation();
-		vector<int>     clen;
 		vector<int>     is;
 		vector<int>     js;
 		vector<Real>    vs;
@@ -81,16 +80,29 @@ namespace CGT {
 				T_cells[cell->info().index] = cell;
 				maxindex = max(maxindex, cell->info().index);
 			}
-			// 		spatial_sort(orderedCells.begin(),orderedCells.end(), CellTraits_for_spatial_sort());//FIXME: ordering will not work with the new "indices", which needs reordering to
+			// indices are already spatially ordered, see PeriodicFlowEngine::buildTriangulation
 			T_cells.resize(ncols + 1);
 			isLinearSystemSet = false;
 			areCellsOrdered = true;
 		}
 		if (!isLinearSystemSet) {
-			int n = 3 * (ncols + 1); //number of non-zero in triangular matrix
-			is.resize(n);
-			js.resize(n);
-			vs.resize(n);
+#ifdef SUITESPARSE_VERSION_4
+			if (!multithread && factorExists && useSolver == 4) { // same as the non-periodic solver, free the previous matrix (and factor)
+				CHOLMOD(free_sparse)(&Achol, &com);
+				if (!reuseOrdering) {
+					CHOLMOD(free_factor)(&L, &com);
+					CHOLMOD(finish)(&com);
+					CHOLMOD(start)(&com);
+				}
+				com.nmethods = 1;
+				com.method[0].ordering = CHOLMOD_METIS;
+				factorExists = false;
+			}
+#endif
+			// at most 5 non-zeros per row in the lower triangle (diagonal + 4 neighbours), each cell fills its own slots below
+			is.assign(5 * ncols, 0);
+			js.resize(5 * ncols);
+			vs.resize(5 * ncols);
 			T_x.resize(ncols);
 			T_b.resize(ncols);
 			T_bv.resize(ncols);
@@ -99,52 +111,78 @@ namespace CGT {
 			T_cells.resize(ncols + 1);
 			T_nnz = 0;
 		}
-		for (int kk = 0; kk < ncols; kk++)
-			T_b[kk] = 0;
-		///Ordered cells
-		int        nIndex = 0;
-		CellHandle neighbourCell;
+		// a cell only writes its own row of T_b and its own slots in is/js/vs, hence no conflict between threads; the errors are counted per thread
+		// (reduction) and reported after the loop
+		const bool setMatrix = !isLinearSystemSet;
+		int        negativeDiagonal = 0, positiveOffDiagonal = 0, selfNeighbours = 0, selfNeighbour = 0;
+#ifdef YADE_OPENMP
+#pragma omp parallel for num_threads(ompThreads) reduction(+ : negativeDiagonal, positiveOffDiagonal, selfNeighbours) reduction(max : selfNeighbour)
+#endif
 		for (int i2 = 0; i2 < ncols; i2++) {
-			FiniteCellsIterator& cell = orderedCells[i2];
-			///Non-ordered cells
-			{
-				const int&      index = cell->info().index;
-				const CellInfo& cInfo = cell->info();
-				if (!isLinearSystemSet) {
-					//Add diagonal term
-					is[T_nnz] = index;
-					js[T_nnz] = index;
-					vs[T_nnz] = (cInfo.kNorm())[0] + (cInfo.kNorm())[1] + (cInfo.kNorm())[2] + (cInfo.kNorm())[3];
-					if (vs[T_nnz] < 0) cerr << "!!!! WTF !!!" << endl;
-					if (fluidBulkModulus > 0) vs[T_nnz] += (1.f / (dt * fluidBulkModulus * cInfo.invVoidVolume()));
-					T_nnz++;
+			const FiniteCellsIterator& cell = orderedCells[i2];
+			const int&                 index = cell->info().index;
+			const CellInfo&            cInfo = cell->info();
+			int                        slot = 5 * i2;
+			Real                       rhs = 0;
+			if (setMatrix) {
+				//Add diagonal term
+				is[slot] = index;
+				js[slot] = index;
+				vs[slot] = (cInfo.kNorm())[0] + (cInfo.kNorm())[1] + (cInfo.kNorm())[2] + (cInfo.kNorm())[3];
+				if (vs[slot] < 0) negativeDiagonal++;
+				if (fluidBulkModulus > 0) vs[slot] += (1.f / (dt * fluidBulkModulus * cInfo.invVoidVolume()));
+				slot++;
+			}
+			for (int j = 0; j < 4; j++) {
+				const CellHandle neighbourCell = cell->neighbor(j);
+				if (Tri.is_infinite(neighbourCell)) continue;
+				const CellInfo& nInfo = neighbourCell->info();
+				const int       nIndex = nInfo.index;
+				if (nIndex == index) {
+					selfNeighbours++;
+					selfNeighbour = max(selfNeighbour, index);
 				}
-				for (int j = 0; j < 4; j++) {
-					neighbourCell = cell->neighbor(j);
-					if (Tri.is_infinite(neighbourCell)) continue;
-					CellInfo& nInfo = neighbourCell->info();
-					nIndex = nInfo.index;
-					if (nIndex == index) {
-						cerr << "ERROR: nIndex==index, the cell is neighbour to itself" << index << endl;
-						errorCode = 3;
-					}
 
-					if (nInfo.Pcondition) T_b[index - 1] += cInfo.kNorm()[j] * nInfo.shiftedP();
-					else {
-						if (!isLinearSystemSet && index > nIndex) {
-							is[T_nnz] = index;
-							js[T_nnz] = nIndex;
-							vs[T_nnz] = -(cInfo.kNorm())[j];
-							if (vs[T_nnz] > 0) cerr << "!!!! WTF2 !!!" << endl;
-							T_nnz++;
-						}
-						if (nInfo.isGhost) T_b[index - 1] += cInfo.kNorm()[j] * nInfo.pShift();
+				if (nInfo.Pcondition) rhs += cInfo.kNorm()[j] * nInfo.shiftedP();
+				else {
+					if (setMatrix && index > nIndex) {
+						is[slot] = index;
+						js[slot] = nIndex;
+						vs[slot] = -(cInfo.kNorm())[j];
+						if (vs[slot] > 0) positiveOffDiagonal++;
+						slot++;
 					}
+					if (nInfo.isGhost) rhs += cInfo.kNorm()[j] * nInfo.pShift();
 				}
 			}
+			T_b[index - 1] = rhs;
+		}
+		if (negativeDiagonal > 0) cerr << "!!!! WTF !!! " << negativeDiagonal << " negative diagonal terms" << endl;
+		if (positiveOffDiagonal > 0) cerr << "!!!! WTF2 !!! " << positiveOffDiagonal << " positive off-diagonal terms" << endl;
+		if (selfNeighbours > 0) {
+			cerr << "ERROR: nIndex==index, " << selfNeighbours << " cells are neighbour to themselves, e.g. " << selfNeighbour << endl;
+			errorCode = 3;
 		}
 		if (!isLinearSystemSet) {
-			if (useSolver > 0) {
+			// compact the used slots
+			for (int k = 0; k < 5 * ncols; k++)
+				if (is[k] > 0) {
+					is[T_nnz] = is[k];
+					js[T_nnz] = js[k];
+					vs[T_nnz] = vs[k];
+					T_nnz++;
+				}
+			if (useSolver == 4) {
+#ifdef SUITESPARSE_VERSION_4
+				cholmod_triplet* trip = CHOLMOD(allocate_triplet)(ncols, ncols, T_nnz, 1, CHOLMOD_REAL, &com);
+				for (int k = 0; k < T_nnz; k++)
+					add_T_entry(trip, is[k] - 1, js[k] - 1, vs[k]);
+				Achol = CHOLMOD(triplet_to_sparse)(trip, trip->nnz, &com);
+				CHOLMOD(free_triplet)(&trip, &com);
+#else
+				cerr << "yade compiled without CHOLMOD, FlowEngine.useSolver=" << useSolver << " not supported" << endl;
+#endif
+			} else if (useSolver > 0) {
 #ifdef LINSOLV
 				tripletList.clear();
 				tripletList.resize(T_nnz);
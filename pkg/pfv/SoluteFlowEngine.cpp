@@ -40,6 +40,7 @@ YADE_PLUGIN((SoluteFlowEngineT));
 
 class SoluteFlowEngine : public SoluteFlowEngineT {
 public:
+	virtual ~SoluteFlowEngine() { stopBackground(); }
 	void   initializeSoluteTransport();
 	void   soluteTransport();
 	double getConcentration(unsigned int id) { return solver->T[solver->currentTes].cellHandles[id]->info().solute(); }
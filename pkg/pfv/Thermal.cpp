@@ -22,6 +22,7 @@ Caulk, R. and Chareyre, B. (2019) An open framework for the simulation of therma
 #ifdef YADE_OPENMP
 #include <core/Omega.hpp>
 #include <core/Scene.hpp>
+#include <omp.h>
 #include <pkg/common/Sphere.hpp>
 #include <pkg/dem/FrictPhys.hpp>
 #include <pkg/pfv/Thermal.hpp>
@@ -81,8 +82,10 @@ void ThermalEngine::action()
 	}
 	if (debug) cout << "advection done" << endl;
 	if (conduction && runConduction) {
+		gatherBodyTemperatures();
 		computeSolidSolidFluxes();
 		if (advection) computeSolidFluidFluxes();
+		reduceBodyFluxes();
 	}
 	if (unboundCavityBodies) unboundCavityParticles();
 	if (advection && fluidConduction) { // need to avoid duplicating energy, so reinitializing pore energy before conduction
@@ -218,7 +221,12 @@ void ThermalEngine::timeStepEstimate()
 	if (debug) cout << "body steps done" << endl;
 	timeStepEstimated = true;
 	// estimate the conduction iterperiod based on current mechanical/fluid timestep
-	conductionIterPeriod = int(tsSafetyFactor * maxTimeStep / scene->dt);
+	// with implicitConduction and no explicit term the stability coefficients are 0 and maxTimeStep is not finite: keep the previous period
+	// then, and saturate periods too large for an int instead of converting them (undefined behaviour)
+	const Real period = tsSafetyFactor * maxTimeStep / scene->dt;
+	if (math::isfinite(period)) conductionIterPeriod = period < std::numeric_limits<int>::max() ? int(period) : std::numeric_limits<int>::max();
+	else
+		LOG_DEBUG("No conduction term limits the thermal time step, conductionIterPeriod kept at " << conductionIterPeriod);
 	if (debug) cout << "conduction iter period set" << conductionIterPeriod << endl;
 	elapsedIters = 0;
 	elapsedTime = 0;
@@ -399,21 +407,61 @@ void ThermalEngine::computeFlux(CellHandle& cell, const shared_ptr<Body>& b, con
 	auto*         thState = static_cast<ThermalState*>(b->state.get());
 	const Real    h = cell->info().NutimesFluidK / (2. * sphere->radius);
 	//const Real h = cell->info().NutimesFluidK / (2.*sphere->radius); // heat transfer coeff assuming Re<<1 (stokes flow)
-	const Real flux = h * surfaceArea * (cell->info().temp() - thState->temp);
+	const Real flux = h * surfaceArea * (cell->info().temp() - bodyTemp[b->id]);
+	// cells are split between threads but bodies are shared, hence the accumulators
 	if (runConduction && tsSafetyFactor > 0) {
-		thState->stabilityCoefficient += h * surfaceArea; // for auto time step estimation
+		bodyStab.add(b->id, h * surfaceArea); // for auto time step estimation
 		cell->info().stabilityCoefficient += h * surfaceArea;
 	}
 	if (!cell->info().Tcondition && !cell->info().isFictious && !cell->info().blocked) cell->info().internalEnergy -= flux * thermalDT;
-	if (!thState->Tcondition) thState->stepFlux += flux;
+	if (!thState->Tcondition) bodyFlux.add(b->id, flux);
 }
 
+void ThermalEngine::gatherBodyTemperatures()
+{
+	const long nBodies = scene->bodies->size();
+	bodyTemp.resize(nBodies);
+	bodyFlux.resize(nBodies);
+	bodyStab.resize(nBodies);
+	bndFlux.resize(6);
+	for (int k = 0; k < 6; k++)
+		bndFlux.reset(k);
+#pragma omp parallel for
+	for (long id = 0; id < nBodies; id++) {
+		const shared_ptr<Body>& b = (*scene->bodies)[id];
+		bodyTemp[id] = (b && b->shape && b->shape->getClassIndex() == Sphere::getClassIndexStatic()) ? static_cast<ThermalState*>(b->state.get())->temp
+		                                                                                              : 0;
+		bodyFlux.reset(id);
+		bodyStab.reset(id);
+	}
+}
+
+void ThermalEngine::reduceBodyFluxes()
+{
+	const long nBodies = bodyTemp.size();
+#pragma omp parallel for
+	for (long id = 0; id < nBodies; id++) {
+		const Real flux = bodyFlux.get(id);
+		const Real stab = bodyStab.get(id);
+		if (flux == 0 && stab == 0) continue;
+		auto* thState = static_cast<ThermalState*>((*scene->bodies)[id]->state.get());
+		thState->stepFlux += flux;
+		thState->stabilityCoefficient += stab;
+	}
+	for (int k = 0; k < 6; k++)
+		thermalBndFlux[k] += bndFlux.get(k);
+}
 
 void ThermalEngine::computeSolidSolidFluxes()
 {
 	//	#ifdef YADE_OPENMP
 	const shared_ptr<InteractionContainer>& interactions = scene->interactions;
 	const long                              size = interactions->size();
+	if (implicitConduction) {
+		ssId1.assign(size, -1);
+		ssId2.resize(size);
+		ssG.resize(size);
+	}
 #pragma omp parallel for
 	for (long i = 0; i < size; i++) {
 		const shared_ptr<Interaction>& I = (*interactions)[i];
@@ -445,8 +493,8 @@ void ThermalEngine::computeSolidSolidFluxes()
 			const Real k2 = thState2->k;
 			const Real r1 = sphere1->radius;
 			const Real r2 = sphere2->radius;
-			const Real T1 = thState1->temp;
-			const Real T2 = thState2->temp;
+			const Real T1 = bodyTemp[b1_->id];
+			const Real T2 = bodyTemp[b2_->id];
 			const Real d = r1 + r2 - pd;
 			const Real E1 = mat1->young;
 			const Real E2 = mat1->young;
@@ -494,103 +542,166 @@ void ThermalEngine::computeSolidSolidFluxes()
 			} else {
 				thermalResist = 2. * (k1 + k2) * r1 * r2 / (r1 + r2 - pd);
 			}
+			if (implicitConduction) { // fluxes are obtained with the end-of-step temperatures in solveImplicitConduction()
+				ssId1[i] = b1_->id;
+				ssId2[i] = b2_->id;
+				ssG[i] = thermalResist;
+				continue;
+			}
 			const Real fluxij = thermalResist * (T1 - T2);
 
 			//cout << "Flux b/w "<< b1_->id << " & "<< b2_->id << " fluxij " << fluxij << endl;
 			if (runConduction && tsSafetyFactor > 0) {
-				thState1->stabilityCoefficient += thermalResist;
-				thState2->stabilityCoefficient += thermalResist;
+				bodyStab.add(b1_->id, thermalResist);
+				bodyStab.add(b2_->id, thermalResist);
 			}
-			if (!thState1->Tcondition) thState1->stepFlux -= fluxij; //U1 -= fluxij*dt;
+			if (!thState1->Tcondition) bodyFlux.add(b1_->id, -fluxij); //U1 -= fluxij*dt;
 			else
-				thermalBndFlux[thState1->boundaryId] -= fluxij;
-			if (!thState2->Tcondition) thState2->stepFlux += fluxij; // U2 += fluxij*dt;
+				bndFlux.add(thState1->boundaryId, -fluxij);
+			if (!thState2->Tcondition) bodyFlux.add(b2_->id, fluxij); // U2 += fluxij*dt;
 			else
-				thermalBndFlux[thState2->boundaryId] += fluxij;
+				bndFlux.add(thState2->boundaryId, fluxij);
 		}
 	}
 }
 
-void ThermalEngine::computeFluidFluidConduction()
+void ThermalEngine::solveImplicitConduction()
 {
-	//CVector fluidSurfK; CVector poreVector; Real distance; Real area; Real conductionEnergy;
-	// cycle through facets instead of cells to avoid duplicate math
+	// backward Euler on the contact network: C_i (T_i - T0_i)/dt = Q_i + sum_j G_ij (T_j - T_i), with Q_i the explicit solid-fluid flux (stepFlux).
+	// Jacobi iterations, the neighbour sums use the same per-thread accumulators as the explicit kernels
+	const long   nBodies = bodyTemp.size();
+	const long   nEdges = ssG.size();
+	vector<Real> capacity(nBodies, 0), rhs(nBodies, 0), temp(bodyTemp), sumG(nBodies, 0);
+#pragma omp parallel for
+	for (long id = 0; id < nBodies; id++) {
+		bodyStab.reset(id);
+		const shared_ptr<Body>& b = (*scene->bodies)[id];
+		if (!b || b->shape->getClassIndex() != Sphere::getClassIndexStatic()) continue;
+		auto* thState = static_cast<ThermalState*>(b->state.get());
+		if ((!first && thState->isCavity) || thState->Tcondition) continue; // fixed temperature in the linear system
+		const Real density = (particleDensity > 0 ? particleDensity : b->material->density);
+		const Real volume = 4. / 3. * M_PI * pow(static_cast<Sphere*>(b->shape.get())->radius, 3);
+		capacity[id] = thState->Cp * density * volume / thermalDT;
+		rhs[id] = capacity[id] * bodyTemp[id] + thState->stepFlux;
+	}
+#pragma omp parallel for
+	for (long e = 0; e < nEdges; e++) {
+		if (ssId1[e] < 0) continue;
+		bodyStab.add(ssId1[e], ssG[e]);
+		bodyStab.add(ssId2[e], ssG[e]);
+	}
+#pragma omp parallel for
+	for (long id = 0; id < nBodies; id++)
+		sumG[id] = bodyStab.get(id);
 
-	/* Parallel version */
-	Tesselation& Tes = flow->solver->T[flow->solver->currentTes];
-	const long   sizeFacets = Tes.facetCells.size();
-	//	#ifdef YADE_OPENMP
-	//	#pragma omp parallel for
-	//	#endif
-	for (long i = 0; i < sizeFacets; i++) {
-		CVector                    fluidSurfK;
-		CVector                    poreVector;
-		Real                       distance;
-		Real                       area;
-		Real                       conductionEnergy;
-		std::pair<CellHandle, int> facetPair = Tes.facetCells[i];
-		const CellHandle&          cell = facetPair.first;
-		const CellHandle&          neighborCell = cell->neighbor(facetPair.second);
-		if (cell->info().isFictious || neighborCell->info().isFictious || cell->info().blocked || neighborCell->info().blocked) continue;
-		const Real deltaT = cell->info().temp() - neighborCell->info().temp();
-		Real       fluidToSolidRatio;
-		if (cell->info().isCavity && neighborCell->info().isCavity) fluidToSolidRatio = 1.;
-		else
-			fluidToSolidRatio = cell->info().facetFluidSurfacesRatio[facetPair.second];
-		//if (flow->thermalPorosity>0) fluidConductionAreaFactor=flow->thermalPorosity;
-		area = fluidConductionAreaFactor * sqrt(cell->info().facetSurfaces[facetPair.second].squared_length()) * fluidToSolidRatio;
-		//area = sqrt(fluidSurfK.squared_length());
-		//poreVector = cell->info() - neighborCell->info();
-		poreVector = cellBarycenter(cell) - cellBarycenter(neighborCell); // voronoi was breaking for hexagonal packings
-		distance = sqrt(poreVector.squared_length());
-		if (distance < minimumFluidCondDist) distance = minimumFluidCondDist;
-		//cout << "conduction distance" << distance << endl;
-		//if (distance < area) continue;  // hexagonal packings result in extremely small distances that blow up the simulation
-		const Real thermalResist = fluidK * area / distance;
-		conductionEnergy = thermalResist * deltaT * thermalDT;
-		if (math::isnan(conductionEnergy)) conductionEnergy = 0;
-		cell->info().stabilityCoefficient += thermalResist;
-		//cout << "conduction distance" << distance << endl;
-		if (!cell->info().Tcondition && !math::isnan(conductionEnergy)) {
-			//#ifdef YADE_OPENMP
-			//#pragma omp atomic
-			//#endif
-			cell->info().internalEnergy -= conductionEnergy;
+	vector<Real> next(temp);
+	vector<Real> maxChange(omp_get_max_threads());
+	for (implicitIters = 0; implicitIters < implicitMaxIter;) {
+#pragma omp parallel for
+		for (long id = 0; id < nBodies; id++)
+			bodyFlux.reset(id);
+#pragma omp parallel for
+		for (long e = 0; e < nEdges; e++) {
+			if (ssId1[e] < 0) continue;
+			bodyFlux.add(ssId1[e], ssG[e] * temp[ssId2[e]]);
+			bodyFlux.add(ssId2[e], ssG[e] * temp[ssId1[e]]);
 		}
-		if (!neighborCell->info().Tcondition && !math::isnan(conductionEnergy)) {
-			//#ifdef YADE_OPENMP
-			//#pragma omp atomic
-			//#endif
-			neighborCell->info().internalEnergy += conductionEnergy;
+		std::fill(maxChange.begin(), maxChange.end(), 0);
+#pragma omp parallel for
+		for (long id = 0; id < nBodies; id++) {
+			if (capacity[id] == 0) continue;
+			next[id] = (rhs[id] + bodyFlux.get(id)) / (capacity[id] + sumG[id]);
+			Real& threadMax = maxChange[omp_get_thread_num()];
+			threadMax = math::max(threadMax, math::abs(next[id] - temp[id]));
+		}
+		temp.swap(next);
+		implicitIters++;
+		if (*std::max_element(maxChange.begin(), maxChange.end()) < implicitTolerance) break;
+	}
+	if (implicitIters >= implicitMaxIter) LOG_WARN("implicit conduction did not converge in " << implicitMaxIter << " iterations");
+
+	// flux through the thermal boundaries, from the end-of-step temperatures
+	for (long e = 0; e < nEdges; e++) {
+		if (ssId1[e] < 0) continue;
+		const Real fluxij = ssG[e] * (temp[ssId1[e]] - temp[ssId2[e]]);
+		auto*      thState1 = static_cast<ThermalState*>((*scene->bodies)[ssId1[e]]->state.get());
+		auto*      thState2 = static_cast<ThermalState*>((*scene->bodies)[ssId2[e]]->state.get());
+		if (thState1->Tcondition) thermalBndFlux[thState1->boundaryId] -= fluxij;
+		if (thState2->Tcondition) thermalBndFlux[thState2->boundaryId] += fluxij;
+	}
+#pragma omp parallel for
+	for (long id = 0; id < nBodies; id++) {
+		if (capacity[id] == 0) continue;
+		auto* thState = static_cast<ThermalState*>((*scene->bodies)[id]->state.get());
+		thState->oldTemp = thState->temp;
+		thState->temp = temp[id];
+		thState->stepFlux = 0;
+	}
+}
+
+void ThermalEngine::computeFluidFluidConduction()
+{
+	// cycle through facets instead of cells to avoid duplicate math, the cell sums go through per-thread accumulators
+	Tesselation&            Tes = flow->solver->T[flow->solver->currentTes];
+	const CGT::FlatNetwork& net = flow->solver->flat;
+	const long              nCells = Tes.cellHandles.size();
+	cellEnergy.resize(nCells);
+	cellStab.resize(nCells);
+#pragma omp parallel for
+	for (long i = 0; i < nCells; i++) {
+		cellEnergy.reset(i);
+		cellStab.reset(i);
+	}
+	if (net.built) {
+		// walk the spatially ordered CSR adjacency; each facet is visited once from the cell with the lowest id, as in facetCells, since
+		// computeFacetConduction credits the stability term to that cell
+		const int nFlat = net.size();
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int k = 0; k < nFlat; k++) {
+			const CellHandle& cell = Tes.cellHandles[net.cellIds[k]];
+			for (int e = net.nbrPtr[k]; e < net.nbrPtr[k + 1]; e++) {
+				if (net.cellIds[net.nbrIdx[e]] < net.cellIds[k]) continue;
+				computeFacetConduction(cell, Tes.cellHandles[net.cellIds[net.nbrIdx[e]]], net.nbrFacet[e], net.facetArea[e]);
+			}
 		}
+	} else {
+		const long sizeFacets = Tes.facetCells.size();
+#pragma omp parallel for
+		for (long i = 0; i < sizeFacets; i++) {
+			const std::pair<CellHandle, int>& facetPair = Tes.facetCells[i];
+			const CellHandle&                 cell = facetPair.first;
+			computeFacetConduction(
+			        cell, cell->neighbor(facetPair.second), facetPair.second, sqrt(cell->info().facetSurfaces[facetPair.second].squared_length()));
+		}
+	}
+#pragma omp parallel for
+	for (long i = 0; i < nCells; i++) {
+		Tes.cellHandles[i]->info().internalEnergy += cellEnergy.get(i);
+		Tes.cellHandles[i]->info().stabilityCoefficient += cellStab.get(i);
 	}
+}
 
-	/* non parallel version */
-	//	RTriangulation& Tri = flow->solver->T[flow->solver->currentTes].Triangulation();
-	//	for (FiniteFacetsIterator f_it=Tri.finite_facets_begin(); f_it != Tri.finite_facets_end();f_it++){
-	//		const CellHandle& cell = f_it->first;
-	//		const CellHandle& neighborCell = f_it->first->neighbor(f_it->second);
-	//		if (cell->info().isFictious || neighborCell->info().isFictious || cell->info().blocked || neighborCell->info().blocked) continue;
-	//		delT = cell->info().temp() - neighborCell->info().temp();
-	//		Real fluidToSolidRatio;
-	//		if (cell->info().isCavity && neighborCell->info().isCavity) fluidToSolidRatio = 1.;
-	//		else fluidToSolidRatio = cell->info().facetFluidSurfacesRatio[f_it->second];
-	//		area = fluidConductionAreaFactor * math::sqrt(cell->info().facetSurfaces[f_it->second].squared_length())*fluidToSolidRatio;
-	//		//area = math::sqrt(fluidSurfK.squared_length());
-	//		//poreVector = cell->info() - neighborCell->info();
-	//		poreVector = cellBarycenter(cell) - cellBarycenter(neighborCell);  // voronoi was breaking for hexagonal packings
-	//		distance = math::sqrt(poreVector.squared_length());
-	//		//cout << "conduction distance" << distance << endl;
-	//		//if (distance < area) continue;  // hexagonal packings result in extremely small distances that blow up the simulation
-	//		const Real thermalResist = fluidK*area/distance;
-	//		conductionEnergy = thermalResist * delT * thermalDT;
-	//		if (isnan(conductionEnergy)) conductionEnergy=0;
-	//		cell->info().stabilityCoefficient+=thermalResist;
-	//		//cout << "conduction distance" << distance << endl;
-	//		if (!cell->info().Tcondition && !isnan(conductionEnergy)) cell->info().internalEnergy -= conductionEnergy;
-	//		if (!neighborCell->info().Tcondition && !isnan(conductionEnergy)) neighborCell->info().internalEnergy += conductionEnergy;
-	//		//cout << "added conduction energy"<< conductionEnergy << endl;
-	//	}
+void ThermalEngine::computeFacetConduction(const CellHandle& cell, const CellHandle& neighborCell, const int facet, const Real facetArea)
+{
+	if (cell->info().isFictious || neighborCell->info().isFictious || cell->info().blocked || neighborCell->info().blocked) return;
+	const Real deltaT = cell->info().temp() - neighborCell->info().temp();
+	Real       fluidToSolidRatio;
+	if (cell->info().isCavity && neighborCell->info().isCavity) fluidToSolidRatio = 1.;
+	else
+		fluidToSolidRatio = cell->info().facetFluidSurfacesRatio[facet];
+	//if (flow->thermalPorosity>0) fluidConductionAreaFactor=flow->thermalPorosity;
+	const Real area = fluidConductionAreaFactor * facetArea * fluidToSolidRatio;
+	//poreVector = cell->info() - neighborCell->info();
+	const CVector poreVector = cellBarycenter(cell) - cellBarycenter(neighborCell); // voronoi was breaking for hexagonal packings
+	Real          distance = sqrt(poreVector.squared_length());
+	if (distance < minimumFluidCondDist) distance = minimumFluidCondDist;
+	//if (distance < area) continue;  // hexagonal packings result in extremely small distances that blow up the simulation
+	const Real thermalResist = fluidK * area / distance;
+	Real       conductionEnergy = thermalResist * deltaT * thermalDT;
+	if (math::isnan(conductionEnergy)) conductionEnergy = 0;
+	cellStab.add(cell->info().id, thermalResist);
+	if (!cell->info().Tcondition && !math::isnan(conductionEnergy)) cellEnergy.add(cell->info().id, -conductionEnergy);
+	if (!neighborCell->info().Tcondition && !math::isnan(conductionEnergy)) cellEnergy.add(neighborCell->info().id, conductionEnergy);
 }
 
 CVector ThermalEngine::cellBarycenter(const CellHandle& cell)
@@ -610,7 +721,10 @@ void ThermalEngine::computeNewPoreTemperatures()
 void ThermalEngine::computeNewParticleTemperatures()
 {
 	//applyBoundaryHeatFluxes(); // FIXME: buggy commenting out for now
-
+	if (implicitConduction) {
+		solveImplicitConduction();
+		return;
+	}
 	YADE_PARALLEL_FOREACH_BODY_BEGIN(const shared_ptr<Body>& b, scene->bodies)
 	{
 		if (b->shape->getClassIndex() != Sphere::getClassIndexStatic() || !b) continue;
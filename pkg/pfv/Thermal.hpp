@@ -23,6 +23,7 @@ Caulk, R. and Chareyre, B. (2019) An open framework for the simulation of therma
 #include <core/Dispatching.hpp>
 #include <core/PartialEngine.hpp>
 #include <core/State.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <pkg/dem/JointedCohesiveFrictionalPM.hpp>
 #include <pkg/dem/ScGeom.hpp>
 
@@ -68,6 +69,15 @@ public:
 	Real         cavitySolidVolumeChange;
 	Real         cavityVolume;
 	Real         cavityDtemp;
+	// per-thread accumulators for the conduction kernels, so that the parallel loops never write to shared bodies or cells
+	vector<Real>                 bodyTemp;   // particle temperatures by body id, gathered once per conduction step
+	OpenMPArrayAccumulator<Real> bodyFlux;   // summed into ThermalState::stepFlux
+	OpenMPArrayAccumulator<Real> bodyStab;   // summed into ThermalState::stabilityCoefficient
+	OpenMPArrayAccumulator<Real> bndFlux;    // summed into thermalBndFlux
+	OpenMPArrayAccumulator<Real> cellEnergy; // summed into CellInfo::internalEnergy
+	OpenMPArrayAccumulator<Real> cellStab;   // summed into CellInfo::stabilityCoefficient
+	vector<Body::id_t>           ssId1, ssId2; // solid-solid conductances for the implicit step, one slot per interaction (id1<0 if no conduction)
+	vector<Real>                 ssG;
 
 	virtual ~ThermalEngine();
 	void    action() override;
@@ -83,10 +93,14 @@ public:
 	void    computeNewParticleTemperatures();
 	void    computeSolidFluidFluxes();
 	void    computeFluidFluidConduction();
+	void    computeFacetConduction(const CellHandle& cell, const CellHandle& neighborCell, const int facet, const Real facetArea);
 	void    updateForces();
 	void    computeVertexSphericalArea();
 	void    computeFlux(CellHandle& cell, const shared_ptr<Body>& b, const Real surfaceArea);
 	void    computeSolidSolidFluxes();
+	void    gatherBodyTemperatures();
+	void    reduceBodyFluxes();
+	void    solveImplicitConduction();
 	void    timeStepEstimate();
 	CVector cellBarycenter(const CellHandle& cell);
 	void    computeCellVolumeChangeFromDeltaTemp(CellHandle& cell, Real cavDens);
@@ -136,6 +150,10 @@ public:
         	((Real,porosityFactor,0,,"If >0, factors the fluid thermal expansion. Useful for simulating low porosity matrices."))
         	((bool,tempDependentFluidBeta,false,,"If true, fluid volumetric thermal expansion coefficient, :yref:`ThermalEngine::fluidBeta`, is temperature dependent (linear model between 20-70 degC)"))
         	((Real,minimumFluidCondDist,0,,"Useful for maintaining stability despite poor external triangulations involving flat tetrahedrals. Consider setting to minimum particle diameter to keep scale."))
+		((bool,implicitConduction,false,,"If true, solid-solid conduction is integrated with a backward Euler step (parallel Jacobi iterations on the contact network) instead of the explicit forward difference. Solid-solid conductances then no longer limit the estimated thermal timestep (see :yref:`ThermalEngine::tsSafetyFactor`), solid-fluid and fluid-fluid terms stay explicit. If no explicit term is left to bound the thermal timestep, the conduction period (see :yref:`ThermalEngine::getConductionIterPeriod`) is not changed by the estimate."))
+		((int,implicitMaxIter,500,,"Maximum number of Jacobi iterations of the implicit conduction step."))
+		((Real,implicitTolerance,1e-8,,"The implicit conduction step stops when the largest temperature change of an iteration is below this value (in degrees)."))
+		((int,implicitIters,0,Attr::readonly,"Number of Jacobi iterations in the last implicit conduction step."))
             ((unsigned,lenBodies,0,,"cache the number of thermal bodies to perform checks and raise warnings if newly inserted bodies are not thermal"))
 		,
 		/* extra initializers */
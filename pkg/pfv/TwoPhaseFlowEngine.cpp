@@ -9,7 +9,9 @@
 
 #ifdef TWOPHASEFLOW
 #include "TwoPhaseFlowEngine.hpp"
+#include <boost/pending/disjoint_sets.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
+#include <queue>
 
 namespace yade { // Cannot have #include directive inside.
 
@@ -30,22 +32,15 @@ PhaseCluster::~PhaseCluster()
 
 #define INFT(cell0) solver->T[solver->currentTes].Triangulation().is_infinite(cell0)
 
-void PhaseCluster::solvePressure()
+#ifdef LINSOLV
+void PhaseCluster::assembleSystem()
 {
-	if (pores.size() == 0) {
-		LOG_WARN("nothing to solve for cluster " << label);
-		return;
-	}
-	vector<int>  clen;
 	vector<int>  is;
 	vector<int>  js;
 	int          ncols = 0; //number of unknown
 	vector<Real> vs;
-	vector<Real> RHS;
-	vector<Real> RHSvol;
 
-	vector<CellHandle> pCells; //the pores in which pressure will be solved
-#ifdef LINSOLV
+	pCells.clear();
 	for (vector<CellHandle>::iterator cellIt = pores.begin(); cellIt != pores.end(); cellIt++) {
 		CellHandle cell = *cellIt;
 		if ((!cell->info().Pcondition) && !cell->info().blocked) {
@@ -57,8 +52,7 @@ void PhaseCluster::solvePressure()
 	is.reserve(ncols * 3);
 	js.reserve(ncols * 3);
 	vs.reserve(ncols * 3);
-	RHS.resize(ncols, 0);
-	RHSvol.resize(ncols, 0);
+	fixedRHS.assign(ncols, 0);
 	unsigned T_nnz = 0;
 	for (auto cellIt = pCells.begin(); cellIt != pCells.end(); cellIt++) {
 		CellHandle cell = *cellIt;
@@ -84,7 +78,7 @@ void PhaseCluster::solvePressure()
 					}
 				} else { //imposed pressure can be in the W-phase or the NW-phase but capillary pressure will be added in another loop
 					// for the moment add neighbor pressure regadless of the phase
-					RHS[cell->info().index] += (cell->info().kNorm())[j] * cell->neighbor(j)->info().p();
+					fixedRHS[cell->info().index] += (cell->info().kNorm())[j] * cell->neighbor(j)->info().p();
 				}
 			} else {
 				if (tes->Triangulation().is_infinite(cell->neighbor(j))) LOG_WARN("infinite neighbour");
@@ -98,13 +92,7 @@ void PhaseCluster::solvePressure()
 		}
 
 		// source term from volume change, to be updated later
-		RHSvol[cell->info().index] -= cell->info().dv();
-	}
-	for (vector<Interface>::iterator it = interfaces.begin(); it != interfaces.end(); it++) {
-		if (not tes) LOG_WARN("no tes!!");
-		const CellHandle& innerCell = tes->cellHandles[it->first.first];
-		if (innerCell->info().Pcondition) continue;
-		RHS[innerCell->info().index] -= innerCell->info().kNorm()[it->outerIndex] * it->capillaryP;
+		fixedRHS[cell->info().index] -= cell->info().dv();
 	}
 	//comC.useGPU=useGPU; //useGPU;
 	//FIXME: is it safe to share "comC" among parallel cluster resolution?
@@ -118,6 +106,7 @@ void PhaseCluster::solvePressure()
 		T->nnz = T_nnz;
 		// convert triplet list into a cholmod sparse matrix, then factorize it
 		cholmod_sparse* AcholC = cholmod_l_triplet_to_sparse(T, T->nnz, &(comC));
+		if (LC) cholmod_l_free_factor(&LC, &comC);
 		LC = cholmod_l_analyze(AcholC, &(comC));
 		cholmod_l_factorize(AcholC, LC, &(comC));
 		// clean
@@ -125,22 +114,81 @@ void PhaseCluster::solvePressure()
 		cholmod_l_free_sparse(&AcholC, &(comC));
 		factorized = true;
 	}
-	cholmod_dense* B = cholmod_l_zeros(ncols, 1, LC->xtype, &(comC));
-	Real*          B_x = (Real*)B->x;
-	for (int k = 0; k < ncols; k++)
-		B_x[k] = RHS[k] + RHSvol[k];
+}
 
-	ex = cholmod_l_solve(CHOLMOD_A, LC, B, &(comC));
+cholmod_dense* PhaseCluster::solveBatch(const vector<vector<Real>>& capPressures)
+{
+	const size_t   ncols = pCells.size();
+	cholmod_dense* B = cholmod_l_zeros(ncols, capPressures.size(), LC->xtype, &(comC));
+	for (size_t c = 0; c < capPressures.size(); c++) {
+		Real* B_x = (Real*)B->x + c * B->d;
+		std::copy(fixedRHS.begin(), fixedRHS.end(), B_x);
+		for (size_t nf = 0; nf < interfaces.size(); nf++) {
+			const CellHandle& innerCell = tes->cellHandles[interfaces[nf].first.first];
+			if (innerCell->info().Pcondition or innerCell->info().index >= ncols) continue; // index is -1 (wrapped) if not an unknown
+			B_x[innerCell->info().index] -= innerCell->info().kNorm()[interfaces[nf].outerIndex] * capPressures[c][nf];
+		}
+	}
+	// all the columns go through the triangular solves together
+	cholmod_dense* X = cholmod_l_solve(CHOLMOD_A, LC, B, &(comC));
+	cholmod_l_free_dense(&B, &(comC));
+	return X;
+}
+#endif
+
+void PhaseCluster::solvePressure()
+{
+	if (pores.size() == 0) {
+		LOG_WARN("nothing to solve for cluster " << label);
+		return;
+	}
+#ifdef LINSOLV
+	assembleSystem();
+	vector<vector<Real>> capPressures(1, vector<Real>(interfaces.size()));
+	for (size_t nf = 0; nf < interfaces.size(); nf++)
+		capPressures[0][nf] = interfaces[nf].capillaryP;
+	if (ex) cholmod_l_free_dense(&ex, &(comC));
+	ex = solveBatch(capPressures);
 	Real* e_x = (Real*)ex->x;
 
 	for (auto cellIt = pCells.begin(); cellIt != pCells.end(); cellIt++) {
 		const CellHandle& cell = *cellIt;
 		cell->info().p() = e_x[cell->info().index];
 	}
-	//clean
-	cholmod_l_free_dense(&B, &(comC));
+#endif
+}
 
+boost::python::list PhaseCluster::solvePressures(const boost::python::list& capPressures)
+{
+	boost::python::list res;
+	if (pores.size() == 0) {
+		LOG_WARN("nothing to solve for cluster " << label);
+		return res;
+	}
+#ifdef LINSOLV
+	const int            nrhs = boost::python::len(capPressures);
+	vector<vector<Real>> pcs(nrhs, vector<Real>(interfaces.size()));
+	for (int c = 0; c < nrhs; c++) {
+		boost::python::list pc = boost::python::extract<boost::python::list>(capPressures[c]);
+		if (size_t(boost::python::len(pc)) != interfaces.size()) {
+			LOG_ERROR("expected " << interfaces.size() << " capillary pressures (one per interface) in set " << c << ", got " << boost::python::len(pc));
+			return res;
+		}
+		for (size_t nf = 0; nf < interfaces.size(); nf++)
+			pcs[c][nf] = boost::python::extract<Real>(pc[nf]);
+	}
+	assembleSystem();
+	cholmod_dense* X = solveBatch(pcs);
+	for (int c = 0; c < nrhs; c++) {
+		const Real*         x = (Real*)X->x + c * X->d;
+		boost::python::list pressures;
+		for (auto cellIt = pores.begin(); cellIt != pores.end(); cellIt++)
+			pressures.append((*cellIt)->info().index < pCells.size() ? x[(*cellIt)->info().index] : (*cellIt)->info().p());
+		res.append(pressures);
+	}
+	cholmod_l_free_dense(&X, &(comC));
 #endif
+	return res;
 }
 
 void TwoPhaseFlowEngine::initialization()
@@ -2205,9 +2253,17 @@ void TwoPhaseFlowEngine::solvePressure()
 
 	//Solve Matrix
 	aMatrix.setFromTriplets(tripletList.begin(), tripletList.end());
-	eSolver.analyzePattern(aMatrix);
+	// the pattern only changes with the pore network, the ordering is kept for the next steps and only the numerical factorization is repeated
+	const int* outer = aMatrix.outerIndexPtr();
+	const int* inner = aMatrix.innerIndexPtr();
+	const bool samePattern = size_t(aMatrix.outerSize() + 1) == analyzedOuter.size() && size_t(aMatrix.nonZeros()) == analyzedInner.size()
+	        && std::equal(analyzedOuter.begin(), analyzedOuter.end(), outer) && std::equal(analyzedInner.begin(), analyzedInner.end(), inner);
+	if ((deformation && remesh) || firstDynTPF || !samePattern) {
+		eSolver.analyzePattern(aMatrix);
+		analyzedOuter.assign(outer, outer + aMatrix.outerSize() + 1);
+		analyzedInner.assign(inner, inner + aMatrix.nonZeros());
+	}
 	eSolver.factorize(aMatrix);
-	eSolver.compute(aMatrix);
 
 
 	//Solve for pressure: FIXME: add check for quality of matrix, if problematic, skip all below.
@@ -3555,6 +3611,179 @@ void TwoPhaseFlowEngine::updateReservoirs2()
 	}
 }
 
+///event-driven drainage, same result as a sequence of invasion() calls at increasing capillary pressures
+vector<Real> TwoPhaseFlowEngine::drainageCurve(const vector<Real>& capPressures)
+{
+	// the settings of invasion() that the event-driven algorithm can not reproduce
+	if (!isDrainageActivated or isImbibitionActivated)
+		throw std::invalid_argument(
+		        "TwoPhaseFlowEngine.drainageCurve: only drainage is handled, isDrainageActivated=True and isImbibitionActivated=False are required");
+	if (!recursiveInvasion)
+		throw std::invalid_argument("TwoPhaseFlowEngine.drainageCurve: pores are always invaded recursively, recursiveInvasion=True is required");
+	if (useFastInvasion)
+		throw std::invalid_argument("TwoPhaseFlowEngine.drainageCurve: the clusters are not updated pore by pore, useFastInvasion=False is required");
+	vector<Real> saturations;
+	if (capPressures.empty()) return saturations;
+	RTriangulation&           tri = solver->T[solver->currentTes].Triangulation();
+	const vector<CellHandle>& cells = solver->tesselation().cellHandles;
+	const unsigned            n = cells.size();
+	const unsigned            nSteps = capPressures.size();
+	const Real                inf = std::numeric_limits<Real>::infinity();
+	// drainage never goes back, the capillary pressure reached at step k is the max of the previous ones
+	vector<Real> pcMax(capPressures);
+	for (unsigned k = 1; k < nSteps; k++)
+		pcMax[k] = max(pcMax[k - 1], pcMax[k]);
+
+	// 1. invasion percolation from the NW-reservoir: minimal capillary pressure to reach each W-pore (the largest entry pressure along the best path)
+	typedef std::pair<Real, unsigned> Event;
+	std::priority_queue<Event, vector<Event>, std::greater<Event>> front;
+	vector<Real>                                                   pcInvade(n, inf);
+	vector<bool>                                                   reached(n, false);
+	auto                                                           pushThroats = [&](const CellHandle& cell, Real level) {
+		for (int facet = 0; facet < 4; facet++) {
+			const CellHandle& nCell = cell->neighbor(facet);
+			if (tri.is_infinite(nCell) or nCell->info().Pcondition or cell->info().poreThroatRadius[facet] < 0) continue;
+			if (!nCell->info().isWRes or nCell->info().saturation != 1.0 or reached[nCell->info().id]) continue;
+			Real entry = max(surfaceTension / cell->info().poreThroatRadius[facet], surfaceTension / nCell->info().poreBodyRadius);
+			front.push(Event(max(level, entry), nCell->info().id));
+		}
+	};
+	for (unsigned id = 0; id < n; id++)
+		if (cells[id]->info().isNWRes) {
+			reached[id] = true;
+			pushThroats(cells[id], -inf);
+		}
+	while (!front.empty()) {
+		Event event = front.top();
+		front.pop();
+		if (reached[event.second]) continue; //already reached through a lower throat
+		reached[event.second] = true;
+		pcInvade[event.second] = event.first;
+		pushThroats(cells[event.second], event.first);
+	}
+
+	// 2. step of invasion of each W-pore if trapping is ignored (nSteps: never), pcMax[k]>pcInvade is the condition of invasionSingleCell()
+	vector<unsigned> invadedAt(n, nSteps);
+	vector<bool>     isW(n, false);
+	for (unsigned id = 0; id < n; id++) {
+		isW[id] = cells[id]->info().saturation == 1.0 and !cells[id]->info().Pcondition;
+		if (isW[id] and cells[id]->info().isWRes and pcInvade[id] < inf)
+			invadedAt[id] = std::upper_bound(pcMax.begin(), pcMax.end(), pcInvade[id]) - pcMax.begin();
+	}
+
+	// 3. trapping: the W-phase only splits during drainage, so connectivity to the W-reservoir is tracked by merging W-pores back step by step in reverse order
+	vector<int> lastConnected(n, -1); //last step at which a pore still belongs to the W-reservoir
+	if (isPhaseTrapped) {
+		vector<bool> wBound(n, false);
+		for (FlowSolver::VCellIterator it = solver->boundingCells[2].begin(); it != solver->boundingCells[2].end(); it++)
+			if ((*it) != NULL) wBound[(*it)->info().id] = true;
+		vector<vector<unsigned>> addedAt(nSteps + 1);
+		for (unsigned id = 0; id < n; id++)
+			if (isW[id]) addedAt[invadedAt[id]].push_back(id);
+		boost::disjoint_sets_with_storage<> sets(n + 1);
+		const unsigned                      reservoir = n;
+		vector<vector<unsigned>>            members(n); //pores of the clusters not yet connected, by representative
+		for (int k = nSteps - 1; k >= 0; k--) {
+			auto join = [&](std::size_t a, std::size_t b) {
+				std::size_t ra = sets.find_set(a), rb = sets.find_set(b), rRes = sets.find_set(reservoir);
+				if (ra == rb) return;
+				if (ra == rRes or rb == rRes) { //the cluster is connected to the reservoir at this step and all previous ones
+					std::size_t other = (ra == rRes) ? rb : ra;
+					for (unsigned id : members[other])
+						lastConnected[id] = k;
+					vector<unsigned>().swap(members[other]);
+					sets.link(ra, rb);
+					return;
+				}
+				sets.link(ra, rb);
+				std::size_t root = sets.find_set(ra), merged = (root == ra) ? rb : ra;
+				if (members[root].size() < members[merged].size()) members[root].swap(members[merged]);
+				members[root].insert(members[root].end(), members[merged].begin(), members[merged].end());
+				vector<unsigned>().swap(members[merged]);
+			};
+			for (unsigned id : addedAt[k + 1]) {
+				members[id].push_back(id);
+				for (int facet = 0; facet < 4; facet++) {
+					const CellHandle& nCell = cells[id]->neighbor(facet);
+					if (tri.is_infinite(nCell)) continue;
+					const unsigned nId = nCell->info().id;
+					if (wBound[nId]) join(id, reservoir);
+					else if (isW[nId] and invadedAt[nId] > unsigned(k))
+						join(id, nId);
+				}
+			}
+		}
+	}
+
+	// 4. apply the state of the last step and integrate the saturation curve
+	Real         poresVolume = 0, wVolume = 0;
+	vector<Real> drainedVolume(nSteps, 0);
+	for (unsigned id = 0; id < n; id++) {
+		TwoPhaseCellInfo& info = cells[id]->info();
+		if (info.Pcondition) continue;
+		if (!info.isFictious) {
+			poresVolume += info.poreBodyVolume;
+			if (info.saturation > 0.0) wVolume += info.poreBodyVolume * info.saturation;
+		}
+		if (!isW[id]) continue;
+		const unsigned trappedAt = isPhaseTrapped ? unsigned(lastConnected[id] + 1) : nSteps;
+		if (trappedAt < invadedAt[id]) {
+			if (!info.isWRes) continue; //trapped before this call
+			info.isWRes = false;
+			info.isTrapW = true;
+			info.trapCapP = capPressures[trappedAt];
+		} else if (invadedAt[id] < nSteps) {
+			info.saturation = 0;
+			info.hasInterface = false;
+			info.isWRes = false;
+			info.isNWRes = true;
+			if (!info.isFictious) drainedVolume[invadedAt[id]] += info.poreBodyVolume;
+		}
+	}
+	saturations.resize(nSteps);
+	for (unsigned k = 0; k < nSteps; k++) {
+		wVolume -= drainedVolume[k];
+		saturations[k] = wVolume / poresVolume;
+	}
+	bndCondValue[2] = bndCondValue[3] - capPressures.back();
+	updatePressure();
+
+	// 5. clusters of the final state, without the recursion of updateCellLabel()
+	if (isCellLabelActivated) {
+		updateReservoirLabel();
+		boost::disjoint_sets_with_storage<> sets(n);
+		for (unsigned id = 0; id < n; id++) {
+			if (cells[id]->info().label != -1) continue;
+			for (int facet = 0; facet < 4; facet++) {
+				const CellHandle& nCell = cells[id]->neighbor(facet);
+				if (!tri.is_infinite(nCell) and nCell->info().label == -1 and nCell->info().saturation == cells[id]->info().saturation)
+					sets.union_set(std::size_t(id), std::size_t(nCell->info().id));
+			}
+		}
+		vector<int>      clusterOf(n, -1);
+		vector<unsigned> labelled;
+		for (unsigned id = 0; id < n; id++) {
+			if (cells[id]->info().label != -1) continue;
+			std::size_t root = sets.find_set(std::size_t(id));
+			if (clusterOf[root] < 0) {
+				clusterOf[root] = clusters.size();
+				clusters.push_back(shared_ptr<PhaseCluster>(new PhaseCluster(solver->tesselation())));
+				clusters.back()->label = clusterOf[root];
+			}
+			labelled.push_back(id);
+		}
+		for (unsigned id : labelled)
+			clusterGetPore(clusters[clusterOf[sets.find_set(std::size_t(id))]].get(), cells[id]);
+		for (unsigned id : labelled)
+			for (int facet = 0; facet < 4; facet++) {
+				const CellHandle& nCell = cells[id]->neighbor(facet);
+				if (!tri.is_infinite(nCell) and nCell->info().isNWRes)
+					clusterGetFacet(clusters[cells[id]->info().label].get(), cells[id], facet);
+			}
+	}
+	return saturations;
+}
+
 Real TwoPhaseFlowEngine::getMinDrainagePc() const
 {
 	Real                nextEntry = 1e50;
@@ -3701,6 +3930,7 @@ void TwoPhaseFlowEngine::computeFacetPoreForcesWithCache(bool onlyCache)
 				}
 		}
 		solver->noCache = false; //cache should always be defined after execution of this function
+		solver->buildFlatForceCache(); // keep the flat copies of unitForceVectors in sync
 		if (onlyCache) return;
 	} else { //use cached values when triangulation doesn't change
 		 // 		#ifndef parallel_forces
@@ -185,7 +185,12 @@ public:
 	cholmod_common* pComC;
 	// 		cholmod_dense** pEx = &ex;
 	// 		cholmod_l_start(&comC);
-	void solvePressure();
+	vector<CellHandle>  pCells;   //the pores in which pressure is solved, in the order of the unknowns
+	vector<Real>        fixedRHS; //the part of the RHS independent of the capillary pressures (imposed pressures, volume changes)
+	void                assembleSystem();
+	cholmod_dense*      solveBatch(const vector<vector<Real>>& capPressures); //one RHS column per set of interface capillary pressures
+	void                solvePressure();
+	boost::python::list solvePressures(const boost::python::list& capPressures);
 	void resetSolver()
 	{
 		if (LC) cholmod_l_free_factor(&LC, &comC);
@@ -284,6 +289,7 @@ public:
 		.def("updateCapVol",&PhaseCluster::updateCapVol,(boost::python::arg("numf"),boost::python::arg("dt")),"increments throat's volume of given interface by flux*dt")
 		.def("updateCapVolList",&PhaseCluster::updateCapVolList,(boost::python::arg("dt")),"increments throat's volume of all interfaces by flux*dt")
 		.def("solvePressure",&PhaseCluster::solvePressure,"Solve 1-phase flow in one single cluster defined by its id.")
+		.def("solvePressures",&PhaseCluster::solvePressures,(boost::python::arg("capPressures")),"Solve 1-phase flow in the cluster for several sets of interfacial capillary pressures at once (a list of lists, one value per interface in the order of getInterfaces()). The matrix is factorized once (or not at all if it already is) and all right-hand sides go through the same triangular solves. Returns one list of pressures per set, in the order of getPores(); cell pressures are not modified. This is a Python-side API: the invasion loops of TwoPhaseFlowEngine do not solve cluster pressures.")
 		)
 	// clang-format on
 
@@ -298,6 +304,7 @@ public:
 	bool                             imposeDeformationFluxTPFSwitch = false;
 	Real                             totalCellVolume;
 	vector<shared_ptr<PhaseCluster>> clusters; // the list of clusters
+	virtual ~TwoPhaseFlowEngine() { stopBackground(); }
 
 	//We can overload every functions of the base engine to make it behave differently
 	//if we overload action() like this, this engine is doing nothing in a standard timestep, it can still have useful functions
@@ -346,6 +353,7 @@ public:
 	void updateReservoirLabel();
 	void invasion2(); //without-trap
 	void updateReservoirs2();
+	vector<Real> drainageCurve(const vector<Real>& capPressures); //event-driven equivalent of a sequence of invasion() calls
 	///end of invasion model
 
 	//## Clusters ##
@@ -491,6 +499,7 @@ public:
 	typedef Eigen::Triplet<Real>                                                            ETriplet;
 	std::vector<ETriplet>                                                                   tripletList;
 	Eigen::SparseLU<Eigen::SparseMatrix<Real, Eigen::ColMajor>, Eigen::COLAMDOrdering<int>> eSolver;
+	std::vector<int>                                                                        analyzedOuter, analyzedInner; //sparsity pattern analyzed by eSolver
 
 	int getCell2(Real posX, Real posY, Real posZ) const
 	{ //Should be fixed properly
@@ -721,6 +730,7 @@ public:
 	.def("getMaxImbibitionPc",&TwoPhaseFlowEngine::getMaxImbibitionPc,"Get the maximum entry capillary pressure for the next imbibition step.")
 	.def("getSaturation",&TwoPhaseFlowEngine::getSaturation,(boost::python::arg("isSideBoundaryIncluded")),"Get saturation of entire packing. If isSideBoundaryIncluded=false (default), the pores of side boundary are excluded in saturation calculating; if isSideBoundaryIncluded=true (only in isInvadeBoundary=true drainage mode), the pores of side boundary are included in saturation calculating.")
 	.def("invasion",&TwoPhaseFlowEngine::invasion,"Run the drainage invasion.")
+	.def("drainageCurve",&TwoPhaseFlowEngine::drainageCurve,(boost::python::arg("capPressures")),"Quasi-static drainage through a sequence of capillary pressures (Pn-Pw), giving the same result as setting :yref:`bndCondValue<TwoPhaseFlowEngine.bndCondValue>` [2] to bndCondValue[3]-pc and calling :yref:`invasion<TwoPhaseFlowEngine.invasion>` for each pc in turn, with :yref:`recursiveInvasion<TwoPhaseFlowEngine.recursiveInvasion>` and trapping according to :yref:`isPhaseTrapped<TwoPhaseFlowEngine.isPhaseTrapped>`. Throats are invaded in order of entry pressure from a priority queue and trapped wetting clusters are found with a union-find traversal of the steps in reverse order, in O(E log E) for the whole curve instead of full scans of the network at each step. Returns the saturation (as :yref:`getSaturation<TwoPhaseFlowEngine.getSaturation>` (False)) after each step, and leaves the engine in the state of the last step (including bndCondValue[2] and, if :yref:`isCellLabelActivated<TwoPhaseFlowEngine.isCellLabelActivated>`, the clusters). Imbibition is not handled: raises an error unless :yref:`isDrainageActivated<TwoPhaseFlowEngine.isDrainageActivated>` and :yref:`recursiveInvasion<TwoPhaseFlowEngine.recursiveInvasion>` are True and :yref:`isImbibitionActivated<TwoPhaseFlowEngine.isImbibitionActivated>` and :yref:`useFastInvasion<TwoPhaseFlowEngine.useFastInvasion>` are False.")
 	.def("computeCapillaryForce",&TwoPhaseFlowEngine::computeCapillaryForce,(boost::python::arg("addForces")=false,boost::python::arg("permanently")=false),"Compute capillary force. Optionaly add them to body forces, for current iteration or permanently.")
 // 	.def("saveVtk",&TwoPhaseFlowEngine::saveVtk,(boost::python::arg("folder")="./VTK",boost::python::arg("withBoundaries")=false),"Save pressure field in vtk format. Specify a folder name for output.")
 	.def("getPotentialPendularSpheresPair",&TwoPhaseFlowEngine::getPotentialPendularSpheresPair,"Get the list of sphere ID pairs of potential pendular liquid bridge.")
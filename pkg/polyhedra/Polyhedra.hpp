@@ -21,6 +21,7 @@
 #include <pkg/common/Wall.hpp>
 #include <pkg/dem/FrictPhys.hpp>
 #include <pkg/dem/ScGeom.hpp>
+#include <atomic>
 #include <fstream>
 
 #ifdef YADE_OPENGL
@@ -33,6 +34,34 @@
 
 namespace yade { // Cannot have #include directive inside.
 
+//**********************************************************************************
+/*! Connectivity of a FlatPolyhedron: facet i has vertices facetVertices[facetStart[i]..facetStart[i+1]-1], counter-clockwise seen from outside;
+ * edge k joins vertices edgeVertices[2k] and edgeVertices[2k+1] and separates facets edgeFacets[2k] and edgeFacets[2k+1]. */
+struct FlatPolyhedronTopology {
+	vector<int> facetStart;
+	vector<int> facetVertices;
+	vector<int> edgeVertices;
+	vector<int> edgeFacets;
+};
+
+/*! Flat (array based) copy of a convex polyhedron, used by the contact detection instead of the CGAL halfedge structure.
+ * Facet i has outward unit normal normals[i] and offset offsets[i] (normals[i].dot(x)==offsets[i] on the facet). The topology is immutable
+ * and shared by the placed copies. */
+struct FlatPolyhedron {
+	vector<Vector3r>                         vertices;
+	vector<Vector3r>                         normals;
+	vector<Real>                             offsets;
+	shared_ptr<const FlatPolyhedronTopology> topology;
+	Vector3r                                 center; //mean of vertices
+	int                                      nFacets() const { return (int)normals.size(); }
+	int                                      nEdges() const { return topology ? (int)topology->edgeVertices.size() / 2 : 0; }
+	//build from CGAL structure
+	void set(const Polyhedron& P);
+	//copy of local moved to pos, rotated by ori and scaled by scale; only the positions are copied (into the storage of *this, so that nothing
+	//is allocated once warm), the topology is shared
+	void setPlaced(const FlatPolyhedron& local, const Quaternionr& ori, const Vector3r& pos, Real scale);
+};
+
 //**********************************************************************************
 class Polyhedra : public Shape {
 public:
@@ -49,6 +78,7 @@ public:
 	Real                GetVolume();
 	Quaternionr         GetOri();
 	Polyhedron          GetPolyhedron() const;
+	const FlatPolyhedron& GetFlatPolyhedron() const;
 	void                Clear();
 	void                setVertices(const std::vector<Vector3r>& v);
 	void                setVertices4(const Vector3r& v0, const Vector3r& v1, const Vector3r& v2, const Vector3r& v3);
@@ -60,8 +90,12 @@ protected:
 	Vector3r centroid;
 	//CGAL structure Polyhedron
 	Polyhedron P;
-	//sign of performed initialization
-	bool init;
+	//flat copy of P for the contact detection
+	FlatPolyhedron flat;
+	//sign of performed initialization, published (release) once all the data above are set: Initialize() reads it without lock
+	std::atomic<bool> init;
+	//the initialization itself, under the lock of Initialize()
+	void initGeometry();
 	//centroid Volume
 	Real volume;
 	//centroid inerta - diagonal of the tensor
@@ -329,6 +363,10 @@ CGALvector ToCGALVector(Vector3r A);
 //determination of intersection of two polyhedras
 bool do_intersect(Polyhedron A, Polyhedron B);
 bool do_intersect(Polyhedron A, Polyhedron B, std::vector<int>& sep_plane);
+//separating axis test of flat polyhedra, sep_plane is used and updated as in the CGAL version
+bool do_intersect(const FlatPolyhedron& A, const FlatPolyhedron& B, std::vector<int>& sep_plane);
+//volume, centroid and normal (least square fit of the intersection of surfaces) of the intersection of two flat polyhedra, without allocation once warm
+bool Polyhedron_Polyhedron_intersection(const FlatPolyhedron& A, const FlatPolyhedron& B, Real* volume, Vector3r* centroid, Vector3r* normal);
 //connect triagular facets if possible
 Polyhedron Simplify(Polyhedron P, Real lim);
 //list of facets and edges
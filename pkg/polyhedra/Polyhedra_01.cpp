@@ -7,6 +7,7 @@
 #undef NDEBUG
 #endif
 #include "Polyhedra.hpp"
+#include <mutex>
 
 namespace yade { // Cannot have #include directive inside.
 
@@ -37,9 +38,20 @@ Polyhedra::Polyhedra(const Vector3r&& xsize, const int&& xseed)
 	v.clear();
 	Initialize();
 }
+// a Polyhedra instance may be shared by several bodies, whose Bo1 may call Initialize() at the same time (after a load)
+static std::mutex initMutex;
+
 void Polyhedra::Initialize()
 {
-	if (init) return;
+	if (init.load(std::memory_order_acquire)) return;
+	std::lock_guard<std::mutex> lock(initMutex);
+	if (init.load(std::memory_order_relaxed)) return;
+	initGeometry();
+	init.store(true, std::memory_order_release);
+}
+
+void Polyhedra::initGeometry()
+{
 	bool isRandom = false;
 
 	//get vertices
@@ -101,7 +113,7 @@ void Polyhedra::Initialize()
 	if (isRandom && volume * 1.75 < 4. / 3. * 3.14 * size[0] / 2. * size[1] / 2. * size[2] / 2.) {
 		v.clear();
 		seed = rand();
-		Initialize();
+		initGeometry();
 	}
 	Vector3r translation((-1) * centroid);
 
@@ -215,8 +227,8 @@ In member function ‘void CGAL::Ref_counted_virtual::remove_reference()’,
 
 */
 #pragma GCC diagnostic pop
-	//initialization done
-	init = 1;
+	//flat copy for the contact detection
+	flat.set(P);
 }
 
 void Polyhedra::setVertices(const std::vector<Vector3r>& v2)
@@ -344,12 +356,15 @@ void Polyhedra::Clear()
 	init = 0;
 	size = Vector3r(1., 1., 1.);
 	faceTri.clear();
+	flat = FlatPolyhedron();
 }
 
-bool Polyhedra::IsInitialized() const { return init; }
+bool Polyhedra::IsInitialized() const { return init.load(std::memory_order_acquire); }
 
 Polyhedron Polyhedra::GetPolyhedron() const { return P; }
 
+const FlatPolyhedron& Polyhedra::GetFlatPolyhedron() const { return flat; }
+
 } // namespace yade
 
 #endif // YADE_CGAL
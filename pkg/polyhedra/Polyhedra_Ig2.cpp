@@ -43,54 +43,6 @@ bool Ig2_Polyhedra_Polyhedra_PolyhedraGeom::go(
 
 	bool isNew = !interaction->geom;
 
-	//move and rotate 1st the CGAL structure Polyhedron
-	Matrix3r    rot_mat   = (se31.orientation).toRotationMatrix();
-	Vector3r    trans_vec = se31.position;
-	const Real& s         = interactionDetectionFactor;
-
-	Transformation t_rot_trans(
-	        s * rot_mat(0, 0),
-	        s * rot_mat(0, 1),
-	        s * rot_mat(0, 2),
-	        trans_vec[0],
-	        s * rot_mat(1, 0),
-	        s * rot_mat(1, 1),
-	        s * rot_mat(1, 2),
-	        trans_vec[1],
-	        s * rot_mat(2, 0),
-	        s * rot_mat(2, 1),
-	        s * rot_mat(2, 2),
-	        trans_vec[2],
-	        1.);
-
-	Polyhedron PA = A->GetPolyhedron();
-	std::transform(PA.points_begin(), PA.points_end(), PA.points_begin(), t_rot_trans);
-
-	std::transform(PA.facets_begin(), PA.facets_end(), PA.planes_begin(), Plane_equation());
-
-	//move and rotate 2nd the CGAL structure Polyhedron
-	rot_mat     = (se32.orientation).toRotationMatrix();
-	trans_vec   = se32.position + shift2;
-	t_rot_trans = Transformation(
-	        s * rot_mat(0, 0),
-	        s * rot_mat(0, 1),
-	        s * rot_mat(0, 2),
-	        trans_vec[0],
-	        s * rot_mat(1, 0),
-	        s * rot_mat(1, 1),
-	        s * rot_mat(1, 2),
-	        trans_vec[1],
-	        s * rot_mat(2, 0),
-	        s * rot_mat(2, 1),
-	        s * rot_mat(2, 2),
-	        trans_vec[2],
-	        1.);
-
-	Polyhedron PB = B->GetPolyhedron();
-
-	std::transform(PB.points_begin(), PB.points_end(), PB.points_begin(), t_rot_trans);
-	std::transform(PB.facets_begin(), PB.facets_end(), PB.planes_begin(), Plane_equation());
-
 	shared_ptr<PolyhedraGeom> bang;
 
 	if (isNew) {
@@ -105,33 +57,98 @@ bool Ig2_Polyhedra_Polyhedra_PolyhedraGeom::go(
 		bang->isShearNew = bang->equivalentPenetrationDepth <= 0;
 	}
 
-	//find intersection Polyhedra
-	Polyhedron Int;
-	Int = Polyhedron_Polyhedron_intersection(
-	        PA, PB, ToCGALPoint(bang->contactPoint), ToCGALPoint(se31.position), ToCGALPoint(se32.position + shift2), bang->sep_plane);
-
-	//volume and centroid of intersection
 	Real     volume;
-	Vector3r centroid;
-	P_volume_centroid(Int, &volume, &centroid);
+	Vector3r centroid, normal;
+	if (cgalIntersection) {
+		//move and rotate 1st the CGAL structure Polyhedron
+		Matrix3r    rot_mat   = (se31.orientation).toRotationMatrix();
+		Vector3r    trans_vec = se31.position;
+		const Real& s         = interactionDetectionFactor;
+
+		Transformation t_rot_trans(
+		        s * rot_mat(0, 0),
+		        s * rot_mat(0, 1),
+		        s * rot_mat(0, 2),
+		        trans_vec[0],
+		        s * rot_mat(1, 0),
+		        s * rot_mat(1, 1),
+		        s * rot_mat(1, 2),
+		        trans_vec[1],
+		        s * rot_mat(2, 0),
+		        s * rot_mat(2, 1),
+		        s * rot_mat(2, 2),
+		        trans_vec[2],
+		        1.);
+
+		Polyhedron PA = A->GetPolyhedron();
+		std::transform(PA.points_begin(), PA.points_end(), PA.points_begin(), t_rot_trans);
+
+		std::transform(PA.facets_begin(), PA.facets_end(), PA.planes_begin(), Plane_equation());
+
+		//move and rotate 2nd the CGAL structure Polyhedron
+		rot_mat     = (se32.orientation).toRotationMatrix();
+		trans_vec   = se32.position + shift2;
+		t_rot_trans = Transformation(
+		        s * rot_mat(0, 0),
+		        s * rot_mat(0, 1),
+		        s * rot_mat(0, 2),
+		        trans_vec[0],
+		        s * rot_mat(1, 0),
+		        s * rot_mat(1, 1),
+		        s * rot_mat(1, 2),
+		        trans_vec[1],
+		        s * rot_mat(2, 0),
+		        s * rot_mat(2, 1),
+		        s * rot_mat(2, 2),
+		        trans_vec[2],
+		        1.);
+
+		Polyhedron PB = B->GetPolyhedron();
+
+		std::transform(PB.points_begin(), PB.points_end(), PB.points_begin(), t_rot_trans);
+		std::transform(PB.facets_begin(), PB.facets_end(), PB.planes_begin(), Plane_equation());
+
+		//find intersection Polyhedra
+		Polyhedron Int;
+		Int = Polyhedron_Polyhedron_intersection(
+		        PA, PB, ToCGALPoint(bang->contactPoint), ToCGALPoint(se31.position), ToCGALPoint(se32.position + shift2), bang->sep_plane);
+
+		//volume and centroid of intersection
+		P_volume_centroid(Int, &volume, &centroid);
+
+		if (math::isnan(volume) || volume <= 1E-25 || volume > min(A->GetVolume(), B->GetVolume())) {
+			bang->equivalentPenetrationDepth = 0;
+			bang->penetrationVolume          = min(A->GetVolume(), B->GetVolume());
+			bang->normal                     = (A->GetVolume() > B->GetVolume() ? 1 : -1) * (se32.position + shift2 - se31.position);
+			return !isNew;
+		}
 
-	if (math::isnan(volume) || volume <= 1E-25 || volume > min(A->GetVolume(), B->GetVolume())) {
-		bang->equivalentPenetrationDepth = 0;
-		bang->penetrationVolume          = min(A->GetVolume(), B->GetVolume());
-		bang->normal                     = (A->GetVolume() > B->GetVolume() ? 1 : -1) * (se32.position + shift2 - se31.position);
-		return !isNew;
-	}
+		if ((!Is_inside_Polyhedron(PA, ToCGALPoint(centroid))) or (!Is_inside_Polyhedron(PB, ToCGALPoint(centroid)))) {
+			bang->equivalentPenetrationDepth = 0;
+			return !isNew;
+		}
 
-	if ((!Is_inside_Polyhedron(PA, ToCGALPoint(centroid))) or (!Is_inside_Polyhedron(PB, ToCGALPoint(centroid)))) {
-		bang->equivalentPenetrationDepth = 0;
-		return !isNew;
+		//find normal direction
+		normal = FindNormal(Int, PA, PB);
+	} else {
+		//place the flat copies of both polyhedra; thread-local storage, so that nothing is allocated once warm
+		thread_local FlatPolyhedron PA, PB;
+		PA.setPlaced(A->GetFlatPolyhedron(), se31.orientation, se31.position, interactionDetectionFactor);
+		PB.setPlaced(B->GetFlatPolyhedron(), se32.orientation, se32.position + shift2, interactionDetectionFactor);
+
+		//separating axis test (starting from the previous separating plane), intersection computed only for overlapping pairs
+		volume = 0;
+		if (!do_intersect(PA, PB, bang->sep_plane) || !Polyhedron_Polyhedron_intersection(PA, PB, &volume, &centroid, &normal) || math::isnan(volume)
+		    || volume <= 1E-25 || volume > min(A->GetVolume(), B->GetVolume())) {
+			bang->equivalentPenetrationDepth = 0;
+			bang->penetrationVolume          = min(A->GetVolume(), B->GetVolume());
+			bang->normal                     = (A->GetVolume() > B->GetVolume() ? 1 : -1) * (se32.position + shift2 - se31.position);
+			return !isNew;
+		}
 	}
 
 	if (isNew) interaction->geom = bang;
 
-	//find normal direction
-	Vector3r normal = FindNormal(Int, PA, PB);
-
 	if ((se32.position + shift2 - centroid).dot(normal) < 0) normal *= -1;
 
 	Real area = math::pow(volume, 2. / 3.);
@@ -32,6 +32,7 @@ public:
 	// clang-format off
 		YADE_CLASS_BASE_DOC_ATTRS(Ig2_Polyhedra_Polyhedra_PolyhedraGeom,IGeomFunctor,"Create/update geometry of collision between 2 Polyhedras",
 			((Real,interactionDetectionFactor,1,,"see :yref:`Ig2_Sphere_Sphere_ScGeom.interactionDetectionFactor`"))
+			((bool,cgalIntersection,false,,"Use the former detection, which copies the CGAL structures of both polyhedra and intersects them by convex hull of the dual planes, instead of the separating axis test and facets clipping on flat arrays. Much slower, kept for reference and benchmarking."))
 		);
 	// clang-format on
 	DECLARE_LOGGER;
@@ -754,6 +754,274 @@ Polyhedron Polyhedron_Polyhedron_intersection(Polyhedron A, Polyhedron B, CGALpo
 	return Intersection;
 }
 
+//**********************************************************************************
+//flat copy of CGAL polyhedron (vertex order is preserved)
+void FlatPolyhedron::set(const Polyhedron& P)
+{
+	shared_ptr<FlatPolyhedronTopology> topo(new FlatPolyhedronTopology);
+	vector<int>&                       facetStart    = topo->facetStart;
+	vector<int>&                       facetVertices = topo->facetVertices;
+	topology                                         = topo;
+	vertices.clear();
+	normals.clear();
+	offsets.clear();
+	facetStart.assign(1, 0);
+	center = Vector3r::Zero();
+	for (Polyhedron::Vertex_const_iterator vIter = P.vertices_begin(); vIter != P.vertices_end(); ++vIter) {
+		vertices.push_back(FromCGALPoint(vIter->point()));
+		center += vertices.back();
+	}
+	if (vertices.empty()) return;
+	center /= (Real)vertices.size();
+	for (Polyhedron::Facet_const_iterator fIter = P.facets_begin(); fIter != P.facets_end(); ++fIter) {
+		Polyhedron::Halfedge_around_facet_const_circulator h = fIter->facet_begin();
+		do {
+			facetVertices.push_back(std::distance(P.vertices_begin(), h->vertex()));
+		} while (++h != fIter->facet_begin());
+		facetStart.push_back(facetVertices.size());
+	}
+	//planes by Newell's method, more robust than three points for nearly degenerated facets
+	for (int i = 0; i < (int)facetStart.size() - 1; i++) {
+		Vector3r n(Vector3r::Zero()), mid(Vector3r::Zero());
+		for (int k = facetStart[i]; k < facetStart[i + 1]; k++) {
+			const int next = (k + 1 < facetStart[i + 1]) ? k + 1 : facetStart[i];
+			n += (vertices[facetVertices[k]] - center).cross(vertices[facetVertices[next]] - center);
+			mid += vertices[facetVertices[k]];
+		}
+		n.normalize();
+		mid /= (Real)(facetStart[i + 1] - facetStart[i]);
+		normals.push_back(n);
+		offsets.push_back(n.dot(mid));
+	}
+	for (Polyhedron::Edge_const_iterator eIter = P.edges_begin(); eIter != P.edges_end(); ++eIter) {
+		topo->edgeVertices.push_back(std::distance(P.vertices_begin(), eIter->vertex()));
+		topo->edgeVertices.push_back(std::distance(P.vertices_begin(), eIter->opposite()->vertex()));
+		topo->edgeFacets.push_back(std::distance(P.facets_begin(), eIter->facet()));
+		topo->edgeFacets.push_back(std::distance(P.facets_begin(), eIter->opposite()->facet()));
+	}
+}
+
+//**********************************************************************************
+//place flat polyhedron in space, vectors keep their capacity so that this does not allocate once warm
+void FlatPolyhedron::setPlaced(const FlatPolyhedron& local, const Quaternionr& ori, const Vector3r& pos, Real scale)
+{
+	const Matrix3r rot = ori.toRotationMatrix();
+	vertices.resize(local.vertices.size());
+	normals.resize(local.normals.size());
+	offsets.resize(local.offsets.size());
+	for (unsigned i = 0; i < vertices.size(); i++)
+		vertices[i] = pos + scale * (rot * local.vertices[i]);
+	for (unsigned i = 0; i < normals.size(); i++) {
+		normals[i] = rot * local.normals[i];
+		offsets[i] = scale * local.offsets[i] + normals[i].dot(pos);
+	}
+	center = pos + scale * (rot * local.center);
+	if (topology != local.topology) topology = local.topology;
+}
+
+//**********************************************************************************
+//all vertices of B are on the positive (outer) side of i-th facet of A
+bool Facet_separates(const FlatPolyhedron& A, int i, const FlatPolyhedron& B)
+{
+	for (const Vector3r& x : B.vertices)
+		if (A.normals[i].dot(x) <= A.offsets[i]) return false;
+	return true;
+}
+
+//**********************************************************************************
+//projections of A and B on the axis perpendicular to i-th edge of A and j-th edge of B do not overlap
+bool Edges_separate(const FlatPolyhedron& A, int i, const FlatPolyhedron& B, int j)
+{
+	const vector<int>& vA   = A.topology->edgeVertices;
+	const vector<int>& vB   = B.topology->edgeVertices;
+	const Vector3r     eA   = A.vertices[vA[2 * i + 1]] - A.vertices[vA[2 * i]];
+	const Vector3r     eB   = B.vertices[vB[2 * j + 1]] - B.vertices[vB[2 * j]];
+	const Vector3r     axis = eA.cross(eB);
+	//parallel edges, the facets are tested instead
+	if (axis.squaredNorm() <= 1E-20 * eA.squaredNorm() * eB.squaredNorm()) return false;
+	Real minA = axis.dot(A.vertices[0]), maxA = minA, minB = axis.dot(B.vertices[0]), maxB = minB;
+	for (const Vector3r& x : A.vertices) {
+		const Real p = axis.dot(x);
+		minA         = math::min(minA, p);
+		maxA         = math::max(maxA, p);
+	}
+	for (const Vector3r& x : B.vertices) {
+		const Real p = axis.dot(x);
+		minB         = math::min(minB, p);
+		maxB         = math::max(maxB, p);
+	}
+	return maxA < minB || maxB < minA;
+}
+
+//**********************************************************************************
+//the arcs of the Gauss maps of i-th edge of A and j-th edge of -B cross, i.e. the edges build a face of the Minkowski difference;
+//only such pairs of edges can give a separating axis
+bool Is_Minkowski_face(const FlatPolyhedron& A, int i, const FlatPolyhedron& B, int j)
+{
+	const Vector3r& a   = A.normals[A.topology->edgeFacets[2 * i]];
+	const Vector3r& b   = A.normals[A.topology->edgeFacets[2 * i + 1]];
+	const Vector3r  c   = -B.normals[B.topology->edgeFacets[2 * j]];
+	const Vector3r  d   = -B.normals[B.topology->edgeFacets[2 * j + 1]];
+	const Vector3r  bxa = b.cross(a);
+	const Vector3r  dxc = d.cross(c);
+	const Real      cba = c.dot(bxa), dba = d.dot(bxa), adc = a.dot(dxc), bdc = b.dot(dxc);
+	return cba * dba < 0 && adc * bdc < 0 && cba * bdc > 0;
+}
+
+//**********************************************************************************
+//separating axis test, the separating plane found is stored in sep_plane with the codes of do_intersect(Polyhedron, Polyhedron, std::vector<int>&)
+bool do_intersect(const FlatPolyhedron& A, const FlatPolyhedron& B, std::vector<int>& sep_plane)
+{
+	//check previous separation plane
+	switch (sep_plane[0]) {
+		case 0: break;
+		case 1:
+			if (sep_plane[2] < A.nFacets() && Facet_separates(A, sep_plane[2], B)) return false;
+			break;
+		case 2:
+			if (sep_plane[2] < B.nFacets() && Facet_separates(B, sep_plane[2], A)) return false;
+			break;
+		case 3:
+			if (sep_plane[1] < A.nEdges() && sep_plane[2] < B.nEdges() && Edges_separate(A, sep_plane[1], B, sep_plane[2])) return false;
+			break;
+		default: LOG_WARN("Unhandled switch case:" << sep_plane[0] << ", function do_intersect(…).");
+	}
+	//regular test with no previous information about separating plane
+	for (int i = 0; i < A.nFacets(); i++) {
+		if (Facet_separates(A, i, B)) {
+			sep_plane[0] = 1;
+			sep_plane[1] = 1;
+			sep_plane[2] = i;
+			return false;
+		}
+	}
+	for (int i = 0; i < B.nFacets(); i++) {
+		if (Facet_separates(B, i, A)) {
+			sep_plane[0] = 2;
+			sep_plane[1] = 2;
+			sep_plane[2] = i;
+			return false;
+		}
+	}
+	for (int i = 0; i < A.nEdges(); i++) {
+		for (int j = 0; j < B.nEdges(); j++) {
+			if (Is_Minkowski_face(A, i, B, j) && Edges_separate(A, i, B, j)) {
+				sep_plane[0] = 3;
+				sep_plane[1] = i;
+				sep_plane[2] = j;
+				return false;
+			}
+		}
+	}
+	sep_plane[0] = 0;
+	return true;
+}
+
+//**********************************************************************************
+//clip facets of P by the half-spaces of Q (Sutherland-Hodgman), accumulate volume and static moment of the intersection (tetrahedra
+//between the clipped facets and ref) and length, first and second moments of the clipped edges lying on the surface of Q (for the normal)
+void Clip_facets(
+        const FlatPolyhedron& P,
+        const FlatPolyhedron& Q,
+        bool                  skipShared,
+        const Vector3r&       ref,
+        Real&                 volume,
+        Vector3r&             moment,
+        Real&                 length,
+        Vector3r&             first,
+        Matrix3r&             second)
+{
+	thread_local vector<Vector3r> poly, clipped;
+	thread_local vector<int>      label, clippedLabel; //label[k] >= 0 if edge k->k+1 lies on label[k]-th facet of Q
+	thread_local vector<Real>     dist;
+	for (int f = 0; f < P.nFacets(); f++) {
+		//facets shared by both polyhedra are accounted for only once
+		if (skipShared) {
+			bool shared = false;
+			for (int q = 0; q < Q.nFacets() && !shared; q++)
+				shared = Q.normals[q].dot(P.normals[f]) > 1 - 1E-12 && math::abs(Q.offsets[q] - P.offsets[f]) < DISTANCE_LIMIT;
+			if (shared) continue;
+		}
+		poly.clear();
+		label.clear();
+		for (int k = P.topology->facetStart[f]; k < P.topology->facetStart[f + 1]; k++) {
+			poly.push_back(P.vertices[P.topology->facetVertices[k]]);
+			label.push_back(-1);
+		}
+		for (int q = 0; q < Q.nFacets() && poly.size() > 2; q++) {
+			const int n       = poly.size();
+			bool      outside = false;
+			dist.resize(n);
+			for (int k = 0; k < n; k++) {
+				dist[k] = Q.normals[q].dot(poly[k]) - Q.offsets[q];
+				outside = outside || dist[k] > 0;
+			}
+			if (!outside) continue;
+			clipped.clear();
+			clippedLabel.clear();
+			for (int k = 0; k < n; k++) {
+				const int  k1 = (k + 1 < n) ? k + 1 : 0;
+				const bool in = dist[k] <= 0, in1 = dist[k1] <= 0;
+				if (in) {
+					clipped.push_back(poly[k]);
+					clippedLabel.push_back(label[k]);
+				}
+				if (in != in1) {
+					clipped.push_back(poly[k] + (poly[k1] - poly[k]) * (dist[k] / (dist[k] - dist[k1])));
+					clippedLabel.push_back(in ? q : label[k]);
+				}
+			}
+			poly.swap(clipped);
+			label.swap(clippedLabel);
+		}
+		const int n = poly.size();
+		if (n < 3) continue;
+		for (int k = 1; k < n - 1; k++) {
+			const Real v = (poly[0] - ref).dot((poly[k] - ref).cross(poly[k + 1] - ref)) / 6.;
+			volume += v;
+			moment += v * (poly[0] + poly[k] + poly[k + 1] - 3. * ref) / 4.;
+		}
+		for (int k = 0; k < n; k++) {
+			if (label[k] < 0) continue;
+			const Vector3r a = poly[k] - ref, b = poly[(k + 1 < n) ? k + 1 : 0] - ref;
+			const Real     l = (b - a).norm();
+			length += l;
+			first += l * (a + b) / 2.;
+			second += l * ((a * a.transpose() + b * b.transpose()) / 3. + (a * b.transpose() + b * a.transpose()) / 6.);
+		}
+	}
+}
+
+//**********************************************************************************
+//intersection of two convex polyhedra; its surface is made of the facets of A clipped by B and of the facets of B clipped by A
+bool Polyhedron_Polyhedron_intersection(const FlatPolyhedron& A, const FlatPolyhedron& B, Real* volume, Vector3r* centroid, Vector3r* normal)
+{
+	const Vector3r ref = (A.center + B.center) / 2.;
+	Real           length(0);
+	Vector3r       moment(Vector3r::Zero()), first(Vector3r::Zero());
+	Matrix3r       second(Matrix3r::Zero());
+	(*volume) = 0;
+	Clip_facets(A, B, false, ref, *volume, moment, length, first, second);
+	Clip_facets(B, A, true, ref, *volume, moment, length, first, second);
+	if (!(*volume > 0)) return false;
+	(*centroid) = ref + moment / (*volume);
+	if (length <= 0) {
+		//one polyhedron inside the other, no intersection of surfaces
+		(*normal) = (B.center - A.center).normalized();
+		return true;
+	}
+	//plane fitted to the segments of intersection of surfaces, its normal is the eigenvector of the smallest eigenvalue
+	first /= length;
+	const Matrix3r covariance = second / length - first * first.transpose();
+	Matrix3r       rot, diag;
+	matrixEigenDecomposition(covariance, rot, diag);
+	int minIndex = 0;
+	for (int i = 1; i < 3; i++)
+		if (diag(i, i) < diag(minIndex, minIndex)) minIndex = i;
+	(*normal) = rot.col(minIndex);
+	return true;
+}
+
 //**********************************************************************************
 Vector3r FromCGALPoint(CGALpoint A) { return Vector3r(A.x(), A.y(), A.z()); }
 
@@ -21,6 +21,7 @@
 #include <iostream>
 //#include <iomanip>
 
+#include <Eigen/Cholesky>
 #include <Eigen/Core>
 #include <Eigen/LU>
 #include <Eigen/QR>
@@ -193,40 +194,70 @@ bool Ig2_PB_PB_ScGeom::go(
 
 	TIMING_DELTAS_CHECKPOINT("Setup");
 
-	//	bool convergeFeasibility = true;
-	//	fA = evaluatePB(cm1, state1, contactPt);
-	//	fB = evaluatePB(cm2, state2, contactPt);
-
-	//if (fA < -pow(10.0,-6) && fB < -pow(10.0,-6) ){
-	//	contact = true;
-	//}else{
-	contact = startingPointFeasibilityCLP(cm1, state1, cm2, state2, shift2, contactPt /*, convergeFeasibility */);
-	//}
-
-	TIMING_DELTAS_CHECKPOINT("End of startingPointFeasibilityCLP");
+	/* The analytic centre depends on the relative position of the blocks only: if it has not changed more than reuseTolerance since the last solution, the latter is moved with particle 1 and reused, as well as the contact area and face properties */
+	bool reused = false;
+	if (reuseTolerance > 0 && hasGeom && hasPhys && scm->penetrationDepth > 0) {
+		const Vector3r    relPos = state1.ori.conjugate() * (state2.pos + shift2 - state1.pos);
+		const Quaternionr relOri = state1.ori.conjugate() * state2.ori;
+		if ((relPos - phys->solvedRelPos).norm() < reuseTolerance * math::min(s1->R, s2->R) && relOri.angularDistance(phys->solvedRelOri) < reuseTolerance) {
+			contactPt = state1.pos + state1.ori * phys->solvedContactPt;
+			reused    = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt) < 0.0 && evaluatePB(cm2, state2, shift2, contactPt) < 0.0;
+		}
+	}
 
-	//FIXME: Check how necessary the following check of the sign of fA*fB is. Here, we check the updated contactPt after running the feasibility check and before calculating the analytic centre and we end up calculating the fA,fB for two candidate contact points @vsangelidakis
-	fA = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
-	fB = evaluatePB(cm2, state2, shift2, contactPt);
-	if (fA * fB < 0.0) {
-		std::cout << "after clp fA: " << fA << ", fB: " << fB << ", contact: " << contact << /* ", convergeFeasibility: "<<convergeFeasibility */ endl;
+	/* Warm start: the previous contact point, if still inside both blocks, is a feasible starting point for the analytic centre and the LP is skipped */
+	bool warmStarted = false;
+	if (!reused && warmStart && hasGeom && scm->penetrationDepth > 0) {
+		fA = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
+		fB = evaluatePB(cm2, state2, shift2, contactPt);
+		if (fA < 0.0 && fB < 0.0) { warmStarted = customSolveAnalyticCentre(cm1, state1, cm2, state2, shift2, contactPt, true); }
 	}
 
-	if (contact /* && convergeFeasibility == true */) {
-		converge = customSolveAnalyticCentre(cm1, state1, cm2, state2, shift2, contactPt);
-		fA       = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
-		fB       = evaluatePB(cm2, state2, shift2, contactPt);
-		if (converge == false) {
+	if (reused || warmStarted) {
+		contact = true;
+		TIMING_DELTAS_CHECKPOINT("End of startingPointFeasibilityCLP");
+		fA = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
+		fB = evaluatePB(cm2, state2, shift2, contactPt);
+		if (fA >= 0.0 || fB >= 0.0) {
 			contact   = false;
 			contactPt = 0.5 * (state1.pos + state2.pos);
-			std::cout << "analytic centre did not converge" << endl;
-		} else if (fA < 0.0 && fB < 0.0) {
-			contact = true;
-		} else {
-			contact = false;
-			std::cout << "One outside, fA: " << fA << ", fB: " << fB << ",s1->isBoundary: " << s1->isBoundary
-			          << ", s2->isBoundary: " << s2->isBoundary << endl;
-			contactPt = 0.5 * (state1.pos + state2.pos);
+		}
+	} else {
+		//	bool convergeFeasibility = true;
+		//	fA = evaluatePB(cm1, state1, contactPt);
+		//	fB = evaluatePB(cm2, state2, contactPt);
+
+		//if (fA < -pow(10.0,-6) && fB < -pow(10.0,-6) ){
+		//	contact = true;
+		//}else{
+		contact = startingPointFeasibilityCLP(cm1, state1, cm2, state2, shift2, contactPt /*, convergeFeasibility */);
+		//}
+
+		TIMING_DELTAS_CHECKPOINT("End of startingPointFeasibilityCLP");
+
+		//FIXME: Check how necessary the following check of the sign of fA*fB is. Here, we check the updated contactPt after running the feasibility check and before calculating the analytic centre and we end up calculating the fA,fB for two candidate contact points @vsangelidakis
+		fA = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
+		fB = evaluatePB(cm2, state2, shift2, contactPt);
+		if (fA * fB < 0.0) {
+			std::cout << "after clp fA: " << fA << ", fB: " << fB << ", contact: " << contact << /* ", convergeFeasibility: "<<convergeFeasibility */ endl;
+		}
+
+		if (contact /* && convergeFeasibility == true */) {
+			converge = customSolveAnalyticCentre(cm1, state1, cm2, state2, shift2, contactPt, false);
+			fA       = evaluatePB(cm1, state1, Vector3r(0, 0, 0), contactPt);
+			fB       = evaluatePB(cm2, state2, shift2, contactPt);
+			if (converge == false) {
+				contact   = false;
+				contactPt = 0.5 * (state1.pos + state2.pos);
+				std::cout << "analytic centre did not converge" << endl;
+			} else if (fA < 0.0 && fB < 0.0) {
+				contact = true;
+			} else {
+				contact = false;
+				std::cout << "One outside, fA: " << fA << ", fB: " << fB << ",s1->isBoundary: " << s1->isBoundary
+				          << ", s2->isBoundary: " << s2->isBoundary << endl;
+				contactPt = 0.5 * (state1.pos + state2.pos);
+			}
 		}
 	}
 
@@ -270,7 +301,9 @@ bool Ig2_PB_PB_ScGeom::go(
 
 				/* Get contact area */
 				//				phys->prevJointLength = jointLength; //Real prevContactArea = phys->contactArea;
-				if (calContactArea) { //calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts
+				if (reused) {
+					//same relative position as the last solution: same area
+				} else if (calContactArea) { //calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts
 					phys->contactArea = getAreaPolygon2(
 					        cm1,
 					        state1,
@@ -296,7 +329,7 @@ bool Ig2_PB_PB_ScGeom::go(
 				}
 
 				/* Get physical properties of the contact from the physical properties of the involved (intersecting) particle faces */
-				if (phys->useFaceProperties) {
+				if (phys->useFaceProperties && !reused) {
 					Real phi_b1 = 0.0, phi_b2 = 0.0, phi_r1 = 0.0, phi_r2 = 0.0, cohesion1 = 0.0, cohesion2 = 0.0, tension1 = 0.0,
 					     tension2    = 0.0;
 					bool intactRock1 = false, intactRock2 = false;
@@ -363,6 +396,13 @@ bool Ig2_PB_PB_ScGeom::go(
 					}
 					//					if(noActive1 == 1 || noActive2 == 1){phys->rockJointContact = true;}else{phys->rockJointContact = false; }
 				}
+
+				/* Relative position and contact point (in the frame of particle 1) of this solution, see reuseTolerance */
+				if (!reused) {
+					phys->solvedRelPos    = state1.ori.conjugate() * (state2.pos + shift2 - state1.pos);
+					phys->solvedRelOri    = state1.ori.conjugate() * state2.ori;
+					phys->solvedContactPt = state1.ori.conjugate() * (contactPt - state1.pos);
+				}
 			}
 			scm->precompute(
 			        state1,
@@ -948,313 +988,132 @@ bool Ig2_PB_PB_ScGeom::getPtOnParticleAreaNormal(
 
 /* ***************************************************************************************************************************** */
 bool Ig2_PB_PB_ScGeom::customSolveAnalyticCentre(
-        const shared_ptr<Shape>& cm1, const State& state1, const shared_ptr<Shape>& cm2, const State& state2, const Vector3r& shift2, Vector3r& contactPt)
+        const shared_ptr<Shape>& cm1,
+        const State&             state1,
+        const shared_ptr<Shape>& cm2,
+        const State&             state2,
+        const Vector3r&          shift2,
+        Vector3r&                contactPt,
+        bool                     warmStart)
 {
-	bool            converge    = true;
-	PotentialBlock* s1          = static_cast<PotentialBlock*>(cm1.get());
-	PotentialBlock* s2          = static_cast<PotentialBlock*>(cm2.get());
-	int             planeNoA    = s1->a.size();
-	int             planeNoB    = s2->a.size();
-	int             totalPlanes = planeNoA + planeNoB;
-	Matrix3r        QA          = state1.ori.toRotationMatrix(); /*direction cosine */
-	Matrix3r        QB          = state2.ori.toRotationMatrix(); /*direction cosine */
-	Real            blasQ1[3 * 3];
-	Real            blasQ2[3 * 3];
-	Real            blasP1Q[planeNoA * 3];
-	Real            d1[planeNoA];
-	Real            blasP2Q[planeNoB * 3];
-	Real            d2[planeNoB];
-	int             blasCount = 0;
-	for (int i = 0; i < 3; i++) {
-		for (int j = 0; j < 3; j++) {
-			blasQ1[blasCount] = QA(j, i);
-			blasQ2[blasCount] = QB(j, i);
-			blasCount++;
-		}
-	}
-	Real blasP1[planeNoA * 3];
+	/* Analytic centre of the intersection of both (r-inflated) blocks: minimise -sum(log(D)) with D = B - A*x, by Newton iterations with backtracking.
+	   A has one plane normal (global frame) per row, so that the gradient A(T)*(1/D) and the Hessian A(T)*diag(1/D^2)*A are accumulated plane by plane in fixed-size matrices. */
+	bool                          converge = true;
+	PotentialBlock*               s1       = static_cast<PotentialBlock*>(cm1.get());
+	PotentialBlock*               s2       = static_cast<PotentialBlock*>(cm2.get());
+	const int                     planeNoA = s1->a.size();
+	const int                     planeNoB = s2->a.size();
+	const int                     totalPlanes = planeNoA + planeNoB;
+	thread_local vector<Vector3r> normals;
+	thread_local vector<Real>     B, D;
+	normals.resize(totalPlanes);
+	B.resize(totalPlanes);
+	D.resize(totalPlanes);
 	for (int i = 0; i < planeNoA; i++) {
-		blasP1[3 * i]     = s1->a[i];
-		blasP1[3 * i + 1] = s1->b[i];
-		blasP1[3 * i + 2] = s1->c[i];
-		d1[i]             = s1->d[i] + s1->r;
+		normals[i] = state1.ori * Vector3r(s1->a[i], s1->b[i], s1->c[i]);
+		B[i]       = s1->d[i] + s1->r - normals[i].dot(contactPt - state1.pos);
 	}
-	Real blasP2[planeNoB * 3];
 	for (int i = 0; i < planeNoB; i++) {
-		blasP2[3 * i]     = s2->a[i];
-		blasP2[3 * i + 1] = s2->b[i];
-		blasP2[3 * i + 2] = s2->c[i];
-		d2[i]             = s2->d[i] + s2->r;
-	}
-	int  incx     = 1;
-	int  incy     = 1;
-	int  blas3    = 3;
-	char blasNT   = 'N';
-	char blasT    = 'T';
-	Real blas0    = 0.0;
-	Real blas1    = 1.0;
-	Real blasNeg1 = -1.0;
-	Real HessTemp[3 * totalPlanes];
-	dgemm_(&blasNT,
-	       &blasNT,
-	       &blas3,
-	       &planeNoA,
-	       &blas3,
-	       &blas1,
-	       &blasQ1[0],
-	       &blas3,
-	       &blasP1[0],
-	       &blas3,
-	       &blas0,
-	       &blasP1Q[0],
-	       &blas3); /*Matrix mulitplication Q1*P1 */
-	dgemm_(&blasNT,
-	       &blasNT,
-	       &blas3,
-	       &planeNoB,
-	       &blas3,
-	       &blas1,
-	       &blasQ2[0],
-	       &blas3,
-	       &blasP2[0],
-	       &blas3,
-	       &blas0,
-	       &blasP2Q[0],
-	       &blas3); /*Matrix mulitplication Q2*P2 */
-
-	for (int k = 0; k < planeNoA; k++) {
-		d1[k] = -1.0
-		        * (blasP1Q[3 * k] * (contactPt.x() - state1.pos.x()) + blasP1Q[3 * k + 1] * (contactPt.y() - state1.pos.y())
-		           + blasP1Q[3 * k + 2] * (contactPt.z() - state1.pos.z()) - d1[k]);
+		normals[planeNoA + i] = state2.ori * Vector3r(s2->a[i], s2->b[i], s2->c[i]);
+		B[planeNoA + i]       = s2->d[i] + s2->r - normals[planeNoA + i].dot(contactPt - state2.pos - shift2);
 	}
-	for (int k = 0; k < planeNoB; k++) {
-		d2[k] = -1.0
-		        * (blasP2Q[3 * k] * (contactPt.x() - state2.pos.x() - shift2[0]) + blasP2Q[3 * k + 1] * (contactPt.y() - state2.pos.y() - shift2[1])
-		           + blasP2Q[3 * k + 2] * (contactPt.z() - state2.pos.z() - shift2[2]) - d2[k]);
-	}
-
-	int  iter = 0;
-	Real xx[3];
-	xx[0] = 0.0;
-	xx[1] = 0.0;
-	xx[2] = 0.0;
-	Real blasStep[3];
-	Real grad[3];
-	Real Hess[9];
-	Real Atranspose[totalPlanes * 3];
-	Real B[totalPlanes];
-	Real D[totalPlanes];
-	Real Dinvert[totalPlanes];
-	Real Ddiag[totalPlanes * totalPlanes];
-	Real oriMinD = 9999999;
-	memset(Ddiag, 0.0, sizeof(Ddiag));
-	//int planeNoA3 = planeNoA*3; int planeNoB3 = planeNoB*3; int totalPlanes3 = totalPlanes*3;
 
-	for (int i = 0; i < planeNoA; i++) {
-		Atranspose[3 * i]     = blasP1Q[3 * i];
-		Atranspose[3 * i + 1] = blasP1Q[3 * i + 1];
-		Atranspose[3 * i + 2] = blasP1Q[3 * i + 2];
-		B[i]                  = d1[i];
-	}
-	for (int i = 0; i < planeNoB; i++) {
-		Atranspose[3 * (planeNoA + i)]     = blasP2Q[3 * i];
-		Atranspose[3 * (planeNoA + i) + 1] = blasP2Q[3 * i + 1];
-		Atranspose[3 * (planeNoA + i) + 2] = blasP2Q[3 * i + 2];
-		B[planeNoA + i]                    = d2[i];
+	/* the starting point (x=0) must be strictly inside both blocks */
+	Real oriMinD = *std::min_element(B.begin(), B.end());
+	if (oriMinD <= 0.0) {
+		if (!warmStart) { std::cout << "oriMinD: " << oriMinD << endl; }
+		return false;
 	}
 
-
-	//TODO: Below, we need to move some variable type declarations outside the "while" and "for" loops & replace the C arrays with std::vector<>
-	Real     val, a, b, c, orival;
-	Real     backtrack;
-	Real     blasFprime;
-	Real     minD;
-	Real     initbacktrack;
-	Vector3r solution;
-
-	while (iter < 50) {
-		val = 0.0; //Real Dinit[totalPlanes];
+	auto setD = [&](const Vector3r& x) {
+		Real minD = std::numeric_limits<Real>::max();
 		for (int i = 0; i < totalPlanes; i++) {
-			a    = Atranspose[3 * i];
-			b    = Atranspose[3 * i + 1];
-			c    = Atranspose[3 * i + 2];
-			D[i] = B[i] - a * xx[0] - b * xx[1] - c * xx[2];
-			if (iter == 0 && D[i] < oriMinD) { oriMinD = D[i]; }
-			//Dinit[i]=D[i];
-			val -= log(D[i]);
-			Dinvert[i]                 = 1.0 / D[i];
-			Ddiag[i * totalPlanes + i] = pow(Dinvert[i], 2);
+			D[i] = B[i] - normals[i].dot(x);
+			minD = math::min(minD, D[i]);
 		}
-		orival = val;
-		if (iter == 0 && math::sign(oriMinD) * 1.0 < 0.0) {
-			std::cout << "oriMinD: " << oriMinD << endl;
-			converge = false;
-			break;
-		}
-		/* g = A(T)*(1./d) */
-		memset(grad, 0.0, sizeof(grad));
-		dgemv_(&blasNT, &blas3, &totalPlanes, &blas1, &Atranspose[0], &blas3, &Dinvert[0], &incx, &blas0, &grad[0], &incy);
-		/* H = A(t)*diag(1/d^2)*A */
-		memset(HessTemp, 0.0, sizeof(HessTemp));
-		memset(Hess, 0.0, sizeof(Hess));
-		dgemm_(&blasNT,
-		       &blasNT,
-		       &blas3,
-		       &totalPlanes,
-		       &totalPlanes,
-		       &blas1,
-		       &Atranspose[0],
-		       &blas3,
-		       &Ddiag[0],
-		       &totalPlanes,
-		       &blas0,
-		       &HessTemp[0],
-		       &blas3);
-		dgemm_(&blasNT, &blasT, &blas3, &blas3, &totalPlanes, &blas1, &HessTemp[0], &blas3, &Atranspose[0], &blas3, &blas0, &Hess[0], &blas3);
-
-		/* Cholesky factorization */
-		//#if 0
-		/* L */
-		int  varNo = 3;
-		int  info;
-		char UPLO = 'L';
-		int  KD   = varNo - 1;
-		int  nrhs = 1; //FIXME: varNo, UPLO, KD, nrhs could be defined as "const" variables
-		Real HessianChol[varNo][varNo];
-		for (int j = 1; j <= varNo; j++) {
-			blasStep[j - 1] = -grad[j - 1];
-			for (int i = j; i <= j + KD && i <= varNo; i++) {
-				HessianChol[j - 1][1 + i - j - 1] = Hess[(i - 1) + varNo * (j - 1)];
-			}
+		return minD;
+	};
+	auto logBarrier = [&]() {
+		Real val = 0.0;
+		for (int i = 0; i < totalPlanes; i++) {
+			val -= log(D[i]);
 		}
-		//#endif
+		return val;
+	};
 
-#if 0
-			/* U */
-			for( int j=1; j<=varNo ; j++){
-				blasStep[j-1]=-blasGrad[j-1];
-				for (int i=math::max(1,j-KD); i<=j ; i++){
-					HessianChol[j-1][KD+1+i-j-1] = blasHess[(i-1)+varNo*(j-1)]; //H(i-1,j-1);
-				}
-			}
-#endif
-		//#if 0
-		dpbsv_(&UPLO, &varNo, &KD, &nrhs, &HessianChol[0][0], &varNo, blasStep, &varNo, &info);
-		if (info != 0) {
-			//	std::cout<<"chol error iter:"<<iter<<endl;
-			//return false;
-			/* LU factorization */
-			for (int i = 0; i < varNo; i++) {
-				blasStep[i] = -1.0 * grad[i]; //g[i];
-			}
-			int ipiv[varNo];
-			int bColNo = 1;
-			dgesv_(&varNo, &bColNo, Hess, &varNo, ipiv, blasStep, &varNo, &info);
+	int      iter = 0;
+	Vector3r xx(Vector3r::Zero()), step, newX, grad;
+	Matrix3r Hess;
+	Real     orival, val, fprime, backtrack, initbacktrack, minD = oriMinD;
+	while (iter < 50) {
+		setD(xx);
+		orival = logBarrier();
+		grad   = Vector3r::Zero();
+		Hess   = Matrix3r::Zero();
+		for (int i = 0; i < totalPlanes; i++) {
+			const Real Dinvert = 1.0 / D[i];
+			grad += Dinvert * normals[i];
+			Hess += (Dinvert * Dinvert) * normals[i] * normals[i].transpose();
 		}
-//#endif
-#if 0
-			/* QR */
-			for (int i=0; i<varNo; i++ ){
-					blasStep[i]=-1.0*grad[i]; //g[i];
+		/* Cholesky factorization, LU if the Hessian is not numerically positive definite */
+		Eigen::LLT<Matrix3r> chol(Hess);
+		if (chol.info() == Eigen::Success) {
+			step = -chol.solve(grad);
+		} else {
+			Eigen::FullPivLU<Matrix3r> lu(Hess);
+			if (!lu.isInvertible()) {
+				std::cout << "linear algebra error, iter:" << iter << endl;
+				converge = false;
+				break;
 			}
-			Real work[30]; int lwork = 30;
-			dgels_(&blasT, &blas3, &blas3, &nrhs, Hess, &blas3, blasStep, &blas3, work, &lwork, &info);
-#endif
-		if (info != 0) {
-			std::cout << "linear algebra error, iter:" << iter << endl;
-			converge = false;
-			break;
+			step = -lu.solve(grad);
 		}
-		//std::cout<<"blasStep: "<<blasStep[0]<<", "<<blasStep[1]<<", "<<blasStep[2]<<endl;
-		/*Linesearch */
+		/* Linesearch */
+		fprime = step.dot(grad);
+		if (-fprime * 0.5 < pow(10, -8)) { break; }
 		backtrack = 1.0;
-		Real blasNewX[3];
-		dcopy_(&varNo, &xx[0], &incx, &blasNewX[0], &incy);
-		daxpy_(&varNo, &backtrack, &blasStep[0], &incx, &blasNewX[0], &incy);
-		//fprime = step.transpose()*g;
-		blasFprime = ddot_(&varNo, &blasStep[0], &incx, &grad[0], &incy);
-		if (-blasFprime * 0.5 < pow(10, -8)) {
-			//std::cout<<"blasFprime: "<<blasFprime<<", blasStep: "<<blasStep[0]<<", "<<blasStep[1]<<", "<<blasStep[2]<<endl;
-			break;
-		}
-		minD = 9999999999;
-		/* d = B - A*x	*/
-		dcopy_(&totalPlanes, &B[0], &incx, &D[0], &incy);
-		dgemv_(&blasT, &blas3, &totalPlanes, &blasNeg1, &Atranspose[0], &blas3, &blasNewX[0], &incx, &blas1, &D[0], &incy);
-		for (int i = 0; i < totalPlanes; i++) {
-			if (D[i] < minD) { minD = D[i]; }
-		}
+		newX      = xx + step;
+		minD      = setD(newX);
 		while (math::sign(minD) * 1.0 < 0.0) {
 			backtrack *= 0.5;
-			dcopy_(&varNo, &xx[0], &incx, &blasNewX[0], &incy);
-			daxpy_(&varNo, &backtrack, &blasStep[0], &incx, &blasNewX[0], &incy);
-			minD = 9999999999;
-			/* d = B - A*x */
-			dcopy_(&totalPlanes, &B[0], &incx, &D[0], &incy);
-			dgemv_(&blasT, &blas3, &totalPlanes, &blasNeg1, &Atranspose[0], &blas3, &blasNewX[0], &incx, &blas1, &D[0], &incy);
-
-			for (int i = 0; i < totalPlanes; i++) {
-				if (D[i] < minD) { minD = D[i]; }
-			}
+			newX = xx + backtrack * step;
+			minD = setD(newX);
 			if (backtrack < pow(10, -15)) {
-				std::cout << "backtrack: " << backtrack << ", iter: " << iter << ", blasStep: " << blasStep[0] << "," << blasStep[1] << ","
-				          << blasStep[2] << ", minD: " << minD << ", oriMinD: " << oriMinD << ", grad: " << grad[0] << "," << grad[1] << ","
-				          << grad[2] << ", xx: " << xx[0] << "," << xx[1] << "," << xx[2] << ", Hess: " << Hess[0] << "," << Hess[1] << ","
-				          << Hess[2] << "," << Hess[3] << "," << Hess[4] << "," << Hess[5] << "," << Hess[6] << "," << Hess[7] << "," << Hess[8]
-				          << endl;
+				std::cout << "backtrack: " << backtrack << ", iter: " << iter << ", step: " << step.transpose() << ", minD: " << minD
+				          << ", oriMinD: " << oriMinD << ", grad: " << grad.transpose() << ", xx: " << xx.transpose() << endl;
 				converge = false;
 				break;
 			}
 		}
+		if (converge == false) { break; }
 
-		/* d = B - A*x */
-		dcopy_(&totalPlanes, &B[0], &incx, &D[0], &incy);
-		dgemv_(&blasT, &blas3, &totalPlanes, &blasNeg1, &Atranspose[0], &totalPlanes, &blasNewX[0], &incx, &blas1, &D[0], &incy);
-
-		val = 0.0;
-		for (int i = 0; i < totalPlanes; i++) {
-			val -= log(D[i]);
-		}
-
+		val           = logBarrier();
 		initbacktrack = backtrack;
-		while (val > orival + backtrack * 0.01 * blasFprime) {
+		while (val > orival + backtrack * 0.01 * fprime) {
 			backtrack *= 0.5;
-			dcopy_(&varNo, &xx[0], &incx, &blasNewX[0], &incy);
-			daxpy_(&varNo, &backtrack, &blasStep[0], &incx, &blasNewX[0], &incy);
-			/* d = B - A*x */
-			// dcopy_(&totalPlanes, &B[0], &incx, &D[0], &incy);
-			// dgemv_(&blasT, &blas3, &totalPlanes, &blasNeg1, &Atranspose[0], &blas3, &blasNewX[0], &incx, &blas1, &D[0], &incy);
-			val = 0.0;
-			for (int i = 0; i < totalPlanes; i++) {
-				a    = Atranspose[3 * i];
-				b    = Atranspose[3 * i + 1];
-				c    = Atranspose[3 * i + 2];
-				D[i] = B[i] - a * blasNewX[0] - b * blasNewX[1] - c * blasNewX[2];
-				val -= log(D[i]);
-			}
+			newX = xx + backtrack * step;
+			setD(newX);
+			val = logBarrier();
 			if (backtrack < pow(10, -15)) {
-				std::cout << "initbacktrack: " << initbacktrack << ", backtrack: " << backtrack << ", iter: " << iter
-				          << ", blasStep: " << blasStep[0] << "," << blasStep[1] << "," << blasStep[2] << ", blasFprime: " << blasFprime
-				          << ", val: " << val << ", orival: " << orival << ", oriMinD: " << oriMinD << ", minD: " << minD << endl;
-
+				std::cout << "initbacktrack: " << initbacktrack << ", backtrack: " << backtrack << ", iter: " << iter << ", step: " << step.transpose()
+				          << ", fprime: " << fprime << ", val: " << val << ", orival: " << orival << ", oriMinD: " << oriMinD << ", minD: " << minD
+				          << endl;
 				converge = false;
 				break;
 			}
 		}
 
-		dcopy_(&blas3, &blasNewX[0], &incx, &xx[0], &incy);
+		xx = newX;
 		iter++;
 
 		if (iter > 49) {
-			std::cout << "custom analytic center iter: " << iter << ", blasFprime: " << blasFprime << endl;
+			std::cout << "custom analytic center iter: " << iter << ", fprime: " << fprime << endl;
 			converge = false;
 		}
 		if (converge == false) { break; }
 	}
 
-	solution = Vector3r((xx[0] - 0.0), (xx[1] - 0.0), (xx[2] - 0.0));
-
-	if (converge) { contactPt = solution + contactPt; }
+	if (converge) { contactPt = xx + contactPt; }
 	return converge;
 }
 
@@ -1293,47 +1152,20 @@ bool Ig2_PB_PB_ScGeom::startingPointFeasibilityCLP(
 	PotentialBlock* s2 = static_cast<PotentialBlock*>(cm2.get());
 
 	/* Parameters for particles A and B */
-	int      planeNoA = s1->a.size();
-	int      planeNoB = s2->a.size();
-	Matrix3r Q1       = state1.ori.toRotationMatrix().transpose(); //(state1.ori.conjugate()).toRotationMatrix();
-	Matrix3r Q2       = state2.ori.toRotationMatrix().transpose(); //(state2.ori.conjugate()).toRotationMatrix();
-	MatrixXr A1       = MatrixXr::Zero(planeNoA, 3);
+	int planeNoA = s1->a.size();
+	int planeNoB = s2->a.size();
+	/* rows of the constraints: plane normals in the global frame, fixed-size vectors */
+	thread_local vector<Vector3r> AQ1, AQ2;
+	AQ1.resize(planeNoA);
+	AQ2.resize(planeNoB);
 	for (int i = 0; i < planeNoA; i++) {
-		A1(i, 0) = s1->a[i] / rescale;
-		A1(i, 1) = s1->b[i] / rescale;
-		A1(i, 2) = s1->c[i] / rescale;
+		AQ1[i] = state1.ori * Vector3r(s1->a[i], s1->b[i], s1->c[i]) / rescale;
 	}
-	MatrixXr A2 = MatrixXr::Zero(planeNoB, 3);
 	for (int i = 0; i < planeNoB; i++) {
-		A2(i, 0) = s2->a[i] / rescale;
-		A2(i, 1) = s2->b[i] / rescale;
-		A2(i, 2) = s2->c[i] / rescale;
+		AQ2[i] = state2.ori * Vector3r(s2->a[i], s2->b[i], s2->c[i]) / rescale;
 	}
-	MatrixXr AQ1 = A1 * Q1;
-	MatrixXr AQ2 = A2 * Q2;
-
-	MatrixXr pos1(3, 1);
-	pos1(0, 0)      = rescale * state1.pos.x();
-	pos1(1, 0)      = rescale * state1.pos.y();
-	pos1(2, 0)      = rescale * state1.pos.z();
-	MatrixXr Q1pos1 = AQ1 * pos1;
-
-	MatrixXr pos2(3, 1);
-	pos2(0, 0)      = rescale * (state2.pos.x() + shift2[0]);
-	pos2(1, 0)      = rescale * (state2.pos.y() + shift2[1]);
-	pos2(2, 0)      = rescale * (state2.pos.z() + shift2[2]);
-	MatrixXr Q2pos2 = AQ2 * pos2;
-
-	// MatrixXr xinit(3,1);
-	MatrixXr b1 = Q1pos1; // - AQ1*xinit;
-	MatrixXr b2 = Q2pos2; // - AQ2*xinit;
-	//Real constraintInit[planeNoA+planeNoB];
-	//for (int i=0; i<planeNoA; i++){
-	//	constraintInit[i] = b1(i,0);
-	//}
-	//for (int i=0; i<planeNoB; i++){
-	//	constraintInit[planeNoA+i] = b2(i,0);
-	//}
+	const Vector3r pos1 = rescale * state1.pos;
+	const Vector3r pos2 = rescale * (state2.pos + shift2);
 	/* Parameters for particles A and B */
 	Real s      = 0.0; /* get value of x[3] after optimization */
 	int  NUMCON = planeNoA + planeNoB;
@@ -1365,10 +1197,10 @@ bool Ig2_PB_PB_ScGeom::startingPointFeasibilityCLP(
 
 	// Rows
 	for (int i = 0; i < planeNoA; i++) {
-		rowUpper[i] = s1->d[i] + s1->r + Q1pos1(i, 0);
+		rowUpper[i] = s1->d[i] + s1->r + AQ1[i].dot(pos1);
 	}
 	for (int i = 0; i < planeNoB; i++) {
-		rowUpper[planeNoA + i] = s2->d[i] + s2->r + Q2pos2(i, 0);
+		rowUpper[planeNoA + i] = s2->d[i] + s2->r + AQ2[i].dot(pos2);
 	}
 	for (int k = 0; k < numberRows; k++) {
 		rowLower[k] = -COIN_DBL_MAX;
@@ -1376,12 +1208,12 @@ bool Ig2_PB_PB_ScGeom::startingPointFeasibilityCLP(
 
 	for (int i = 0; i < planeNoA; i++) {
 		int  rowIndex[] = { 0, 1, 2, 3 };
-		Real rowValue[] = { AQ1(i, 0), AQ1(i, 1), AQ1(i, 2), -1.0 };
+		Real rowValue[] = { AQ1[i][0], AQ1[i][1], AQ1[i][2], -1.0 };
 		model2.addRow(4, rowIndex, rowValue, rowLower[i], rowUpper[i]);
 	}
 	for (int i = 0; i < planeNoB; i++) {
 		int  rowIndex[] = { 0, 1, 2, 3 };
-		Real rowValue[] = { AQ2(i, 0), AQ2(i, 1), AQ2(i, 2), -1.0 };
+		Real rowValue[] = { AQ2[i][0], AQ2[i][1], AQ2[i][2], -1.0 };
 		model2.addRow(4, rowIndex, rowValue, rowLower[planeNoA + i], rowUpper[planeNoA + i]);
 	}
 
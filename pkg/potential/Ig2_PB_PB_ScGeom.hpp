@@ -108,7 +108,8 @@ public:
 	        const shared_ptr<Shape>& cm2,
 	        const State&             state2,
 	        const Vector3r&          shift2,
-	        Vector3r&                contactPt);
+	        Vector3r&                contactPt,
+	        bool                     warmStart);
 	Real getAreaPolygon2(
 	        const shared_ptr<Shape>& cm1,
 	        const State&             state1,
@@ -133,6 +134,8 @@ public:
 		((bool, twoDimension, false,,"Whether the contact is 2-D"))
 		((Real, unitWidth2D, 1.0,,"Unit width in 2D"))
 		((bool, calContactArea, true,,"Whether to calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts"))
+		((bool, warmStart, false,,"If the blocks were in contact at the previous step and the previous contact point is still inside both, start the analytic centre from it and skip the feasibility LP (startingPointFeasibilityCLP). The analytic centre is unique, so that only the cost changes; the LP is run if the warm-started solution fails."))
+		((Real, reuseTolerance, 0,,"If >0, the contact point of the last solution (moved with particle 1), the contact area and the face properties are reused as long as the relative displacement of the blocks since that solution is smaller than reuseTolerance*min(R1,R2) and their relative rotation smaller than reuseTolerance (radians). Normal and overlap are still updated. 0 disables reuse."))
 		, /* ctor */
 	);
 	// clang-format on
@@ -96,15 +96,30 @@ bool Ig2_PP_PP_ScGeom::go(
 	}
 
 	converge = true;
-	//	fA = evaluatePP(cm1,state1,contactPt);
-	//	fB = evaluatePP(cm2,state2,contactPt);
 
-	//Default does not have warmstart
-	//if(fA < 0.0 && fB <0.0){
-	//	converge = customSolve(cm1,state1,cm2,state2,contactPt,true);
-	//}else{
-	converge = customSolve(cm1, state1, cm2, state2, shift2, contactPt, false /* c->phys->warmstart */);
-	//}
+	/* The solution depends on the relative position of the particles only: if it has not changed more than reuseTolerance since the last solution, the latter is moved with particle 1 and reused, as well as the contact area */
+	bool reused = false;
+	if (reuseTolerance > 0 && hasGeom && hasPhys && scm->penetrationDepth > 0) {
+		const Vector3r    relPos = state1.ori.conjugate() * (state2.pos + shift2 - state1.pos);
+		const Quaternionr relOri = state1.ori.conjugate() * state2.ori;
+		if ((relPos - phys->solvedRelPos).norm() < reuseTolerance * math::min(s1->R, s2->R) && relOri.angularDistance(phys->solvedRelOri) < reuseTolerance) {
+			const Vector3r reusedPt = state1.pos + state1.ori * phys->solvedContactPt;
+			reused = evaluatePP(cm1, state1, Vector3r::Zero(), reusedPt) < 0.0 && evaluatePP(cm2, state2, shift2, reusedPt) < 0.0;
+			if (reused) { contactPt = reusedPt; }
+		}
+	}
+
+	/* Warm start from the previous contact point (smaller perturbations and barrier parameter, see customSolve) if the particles were in contact; cold start if it fails */
+	if (!reused) {
+		bool solved = false;
+		if (warmStart && hasGeom && scm->penetrationDepth > 0) {
+			Vector3r warmPt = contactPt;
+			solved          = customSolve(cm1, state1, cm2, state2, shift2, warmPt, true)
+			        && evaluatePP(cm1, state1, Vector3r::Zero(), warmPt) < 0.0 && evaluatePP(cm2, state2, shift2, warmPt) < 0.0;
+			if (solved) { contactPt = warmPt; }
+		}
+		if (!solved) { converge = customSolve(cm1, state1, cm2, state2, shift2, contactPt, false); }
+	}
 
 	fA = evaluatePP(cm1, state1, Vector3r::Zero(), contactPt);
 	fB = evaluatePP(cm2, state2, shift2, contactPt);
@@ -156,7 +171,9 @@ bool Ig2_PP_PP_ScGeom::go(
 				shearDir                                                          = phys->shearDir;
 				shearDir.normalize();
 
-				if (calContactArea) { //calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts
+				if (reused) {
+					//same relative position as the last solution: same area
+				} else if (calContactArea) { //calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts
 					phys->contactArea = getAreaPolygon2(
 					        cm1,
 					        state1,
@@ -181,6 +198,13 @@ bool Ig2_PP_PP_ScGeom::go(
 					}
 				}
 				//				if( math::isnan(jointLength ) {jointLength = 1.0; phys->jointLength = jointLength; /*math::min(s1->R,s2->R);*/}
+
+				/* Relative position and contact point (in the frame of particle 1) of this solution, see reuseTolerance */
+				if (!reused) {
+					phys->solvedRelPos    = state1.ori.conjugate() * (state2.pos + shift2 - state1.pos);
+					phys->solvedRelOri    = state1.ori.conjugate() * state2.ori;
+					phys->solvedContactPt = state1.ori.conjugate() * (contactPt - state1.pos);
+				}
 			}
 
 			scm->precompute(
@@ -75,6 +75,8 @@ public:
 			((Real, unitWidth2D, 1.0, ,"Unit width in 2D"))
 			((bool, calContactArea, true,,"Whether to calculate jointLength for 2-D contacts and contactArea for 2-D and 3-D contacts"))
 			((int, areaStep, 5, ,"Angular step (degrees) to calculate :yref:`KnKsPhys.contactArea`. Must be a divisor of 360, e.g. 1,2,3,4,5,6,8,9 and so on, to form a closed loop. Must be smaller than 90 degrees. Smaller angles lead to more accurate calculations but are more expensive"))
+			((bool, warmStart, false,,"If the particles were in contact at the previous step, start the SOCP from the previous contact point with smaller perturbations and barrier parameter (warmstart of customSolve); the cold start is used if the warm-started solution fails."))
+			((Real, reuseTolerance, 0,,"If >0, the contact point of the last solution (moved with particle 1) and the contact area are reused as long as the relative displacement of the particles since that solution is smaller than reuseTolerance*min(R1,R2) and their relative rotation smaller than reuseTolerance (radians). Normal and overlap are still updated. 0 disables reuse."))
 			, /* ctor */
 		);
 	// clang-format on
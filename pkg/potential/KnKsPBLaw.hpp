@@ -68,6 +68,9 @@ public:
 //			((Vector3r, initial1, Vector3r::Zero(),,"midpoint"))
 		((Vector3r, ptOnP1, Vector3r::Zero(),,"Point on particle 1"))
 		((Vector3r, ptOnP2, Vector3r::Zero(),,"Point on particle 2"))
+		((Vector3r, solvedRelPos, Vector3r::Zero(),Attr::readonly,"Position of particle 2 in the frame of particle 1 when the contact point was last solved, see :yref:`Ig2_PB_PB_ScGeom.reuseTolerance`"))
+		((Quaternionr, solvedRelOri, Quaternionr::Identity(),Attr::readonly,"Orientation of particle 2 relative to particle 1 when the contact point was last solved"))
+		((Vector3r, solvedContactPt, Vector3r::Zero(),Attr::readonly,"Last solved contact point, in the frame of particle 1"))
 //			((vector<bool>, redundantA, ,Attr::hidden,"not used, activePlanes for interaction.id1"))
 //			((vector<bool>, redundantB, ,Attr::hidden,"not used, activePlanes for interaction.id1"))
 //			((vector<bool>, activePlanes1, ,Attr::hidden,"not used, activePlanes for interaction.id1"))
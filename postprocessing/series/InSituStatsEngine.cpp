@@ -0,0 +1,135 @@
+#include "InSituStatsEngine.hpp"
+#include <core/Scene.hpp>
+#include <preprocessing/dem/Shop.hpp>
+#include <chrono>
+
+namespace yade { // Cannot have #include directive inside.
+
+YADE_PLUGIN((InSituStatsEngine));
+CREATE_LOGGER(InSituStatsEngine);
+
+namespace {
+	void putMatrix(double* dst, const Matrix3r& m)
+	{
+		if (!dst) return;
+		for (int k = 0; k < 9; k++)
+			dst[k] = static_cast<double>(m(k / 3, k % 3));
+	}
+}
+
+void InSituStatsEngine::action()
+{
+	typedef Shop::GlobalStats GS;
+	auto                      t0 = std::chrono::steady_clock::now();
+	int                       what = GS::COUNTS;
+	for (const string& r : reductions) {
+		if (r == "all") what |= GS::STRESS | GS::FABRIC_SPLIT | GS::NORMAL_SHEAR | GS::COORDINATION | GS::COORD_HISTOGRAM | GS::ANGLE_HISTOGRAM;
+		else if (r == "stress")
+			what |= GS::STRESS;
+		else if (r == "fabric")
+			what |= GS::FABRIC;
+		else if (r == "fabricSplit")
+			what |= GS::FABRIC_SPLIT;
+		else if (r == "normalShear")
+			what |= GS::NORMAL_SHEAR;
+		else if (r == "coordination")
+			what |= GS::COORDINATION;
+		else if (r == "coordHistogram")
+			what |= GS::COORD_HISTOGRAM;
+		else if (r == "angleHistogram")
+			what |= GS::ANGLE_HISTOGRAM;
+		else
+			LOG_ERROR("Unknown reduction `" << r
+			                                << "' (supported are: all, stress, fabric, fabricSplit, normalShear, coordination, coordHistogram, "
+			                                   "angleHistogram). Ignored.");
+	}
+	if (angleAxis < 0 || angleAxis > 2) throw std::invalid_argument("InSituStatsEngine.angleAxis must be 0, 1 or 2.");
+	Shop::GlobalStatsOptions options;
+	options.mask      = mask;
+	options.volume    = volume;
+	options.coordBins = coordBins;
+	options.angleAxis = angleAxis;
+	options.angleBins = angleBins;
+	const GS s        = Shop::computeGlobalStats(what, options, scene);
+	what              = s.computed; // with the implied reductions
+	contacts          = s.contacts;
+	particles         = s.particles;
+	if (what & GS::STRESS) stress = s.stress;
+	if (what & GS::FABRIC) {
+		fabric          = s.fabric;
+		meanNormalForce = s.meanNormalForce;
+	}
+	if (what & GS::FABRIC_SPLIT) {
+		fabricStrong = s.fabricStrong;
+		fabricWeak   = s.fabricWeak;
+	}
+	if (what & GS::NORMAL_SHEAR) {
+		normalStress = s.normalStress;
+		shearStress  = s.shearStress;
+	}
+	if (what & GS::COORDINATION) {
+		coordination           = s.coordination;
+		mechanicalCoordination = s.mechanicalCoordination;
+	}
+	coordHistogram = (what & GS::COORD_HISTOGRAM) ? s.coordHistogram : vector<int>();
+	angleHistogram = s.angleHistogram;
+
+	// *** time series ***/
+	if (!fileName.empty()) {
+		if (!writer.isOpen()) writer.open(fileName);
+		writer.compress   = compress;
+		writer.chunkSteps = chunkSteps;
+		vector<SeriesWriter::Field> fields { { "time", false, 1 }, { "contacts", true, 1 }, { "particles", true, 1 } };
+		if (what & GS::STRESS) fields.push_back({ "stress", false, 9 });
+		if (what & GS::FABRIC) {
+			fields.push_back({ "fabric", false, 9 });
+			fields.push_back({ "meanNormalForce", false, 1 });
+		}
+		if (what & GS::FABRIC_SPLIT) {
+			fields.push_back({ "fabricStrong", false, 9 });
+			fields.push_back({ "fabricWeak", false, 9 });
+		}
+		if (what & GS::NORMAL_SHEAR) {
+			fields.push_back({ "normalStress", false, 9 });
+			fields.push_back({ "shearStress", false, 9 });
+		}
+		if (what & GS::COORDINATION) {
+			fields.push_back({ "coordination", false, 1 });
+			fields.push_back({ "mechanicalCoordination", false, 1 });
+		}
+		if (what & GS::COORD_HISTOGRAM) fields.push_back({ "coordHistogram", true, (int)coordHistogram.size() });
+		if (what & GS::ANGLE_HISTOGRAM) fields.push_back({ "angleHistogram", false, (int)angleHistogram.size() });
+		writer.setFields(fields);
+		writer.beginStep(scene->iter);
+		writer.real("time", 1)[0]           = static_cast<double>(scene->time);
+		writer.integer("contacts", 1)[0]    = contacts;
+		writer.integer("particles", 1)[0]   = particles;
+		if (what & GS::STRESS) putMatrix(writer.real("stress", 1), stress);
+		if (what & GS::FABRIC) {
+			putMatrix(writer.real("fabric", 1), fabric);
+			writer.real("meanNormalForce", 1)[0] = static_cast<double>(meanNormalForce);
+		}
+		if (what & GS::FABRIC_SPLIT) {
+			putMatrix(writer.real("fabricStrong", 1), fabricStrong);
+			putMatrix(writer.real("fabricWeak", 1), fabricWeak);
+		}
+		if (what & GS::NORMAL_SHEAR) {
+			putMatrix(writer.real("normalStress", 1), normalStress);
+			putMatrix(writer.real("shearStress", 1), shearStress);
+		}
+		if (what & GS::COORDINATION) {
+			writer.real("coordination", 1)[0]           = static_cast<double>(coordination);
+			writer.real("mechanicalCoordination", 1)[0] = static_cast<double>(mechanicalCoordination);
+		}
+		if (what & GS::COORD_HISTOGRAM) std::copy(coordHistogram.begin(), coordHistogram.end(), writer.integer("coordHistogram", 1));
+		if (what & GS::ANGLE_HISTOGRAM) {
+			double* dst = writer.real("angleHistogram", 1);
+			for (size_t k = 0; k < angleHistogram.size(); k++)
+				dst[k] = static_cast<double>(angleHistogram[k]);
+		}
+		writer.endStep();
+	}
+	reductionTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace yade
@@ -0,0 +1,64 @@
+#pragma once
+#include <pkg/common/PeriodicEngines.hpp>
+#include <postprocessing/series/SeriesWriter.hpp>
+
+namespace yade { // Cannot have #include directive inside.
+
+/* Global statistics of the packing computed together by Shop::computeGlobalStats, see the class doc below; the reductions are those of
+Shop::globalStats, with a mask, a volume and the bins of the histograms. */
+class InSituStatsEngine : public PeriodicEngine {
+private:
+	SeriesWriter writer;
+
+public:
+	void action() override;
+	void flush() { writer.flush(); }
+	// clang-format off
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(InSituStatsEngine,PeriodicEngine,"Engine computing at every run a set of global statistics of the packing, otherwise obtained from separate passes of :yref:`yade._utils.getStress`, :yref:`yade._utils.fabricTensor`, :yref:`yade._utils.normalShearStressTensors`, :yref:`yade.utils.avgNumInteractions`, :yref:`yade._utils.bodyNumInteractionsHistogram` and :yref:`yade._utils.interactionAnglesHistogram`. All :yref:`reductions<InSituStatsEngine.reductions>` are computed together, as by :yref:`yade._utils.globalStats`, in one parallel pass over bodies and one over interactions (plus one over interactions for ``fabricSplit`` and one over bodies for ``coordination`` and ``coordHistogram``), and the results do not depend on the number of threads.\n\nThe last results are available as attributes; they are also appended to the time series file :yref:`fileName<InSituStatsEngine.fileName>` if given, one value per field and step (read it with :yref:`yade.export.SeriesReader`, e.g. ``SeriesReader(fileName).stacked('stress')``, the tensors being stored row-major with 9 components). Only real interactions with :yref:`NormShearPhys` physics (and :yref:`GenericSpheresContact` geometry, except for ``stress``) between bodies compatible with :yref:`mask<InSituStatsEngine.mask>` are considered.\n\n:yref:`PeriodicEngine.initRun` is initialized to ``True`` automatically.",
+		((vector<string>,reductions,vector<string>({"stress","fabric","coordination"}),,R"""(Statistics to compute:
+
+* ``all`` computes all statistics below
+* ``stress`` gives the Love-Weber stress tensor :yref:`stress<InSituStatsEngine.stress>`, as :yref:`yade._utils.getStress`
+* ``fabric`` gives the fabric tensor :yref:`fabric<InSituStatsEngine.fabric>` [Satake1982]_ and the mean normal force :yref:`meanNormalForce<InSituStatsEngine.meanNormalForce>`, as :yref:`yade._utils.fabricTensor`
+* ``fabricSplit`` gives :yref:`fabricStrong<InSituStatsEngine.fabricStrong>` and :yref:`fabricWeak<InSituStatsEngine.fabricWeak>`, the fabric tensors of contacts with a normal force larger and smaller than the mean, as :yref:`yade._utils.fabricTensor` with ``splitTensor=True`` (it needs a second pass over interactions)
+* ``normalShear`` gives the contributions of normal and shear forces to the stress tensor :yref:`normalStress<InSituStatsEngine.normalStress>` and :yref:`shearStress<InSituStatsEngine.shearStress>` [Thornton2000]_, as :yref:`yade._utils.normalShearStressTensors`
+* ``coordination`` gives :yref:`coordination<InSituStatsEngine.coordination>` and :yref:`mechanicalCoordination<InSituStatsEngine.mechanicalCoordination>`, as :yref:`yade.utils.avgNumInteractions` with ``considerClumps=True``, with or without ``skipFree``
+* ``coordHistogram`` gives :yref:`coordHistogram<InSituStatsEngine.coordHistogram>`, as :yref:`yade._utils.bodyNumInteractionsHistogram`
+* ``angleHistogram`` gives :yref:`angleHistogram<InSituStatsEngine.angleHistogram>`, as :yref:`yade._utils.interactionAnglesHistogram`
+
+The numbers of :yref:`contacts<InSituStatsEngine.contacts>` and :yref:`particles<InSituStatsEngine.particles>` are always computed.)"""))
+		((string,fileName,"",,"Time series file to which the results are appended, created (overwritten) at the first run. If empty, the results are only kept in the attributes."))
+		((Real,volume,0,,"Volume used for stresses. If 0, the volume of the periodic cell, or that of the axis-aligned bounding box of spheres for aperiodic simulations (which underestimates the stress, see :yref:`yade._utils.getStress`)."))
+		((int,mask,0,,"If non-zero, only interactions between bodies with a compatible :yref:`groupMask<Body.groupMask>`, and those bodies, are considered."))
+		((int,coordBins,13,,"Number of bins of :yref:`coordHistogram<InSituStatsEngine.coordHistogram>`; the last one counts all particles with at least coordBins-1 contacts."))
+		((int,angleAxis,2,,"Axis (0, 1 or 2 for x, y or z) about which the angles of :yref:`angleHistogram<InSituStatsEngine.angleHistogram>` are measured."))
+		((int,angleBins,18,,"Number of bins of :yref:`angleHistogram<InSituStatsEngine.angleHistogram>` over [0,π), centered on k·π/angleBins as those of :yref:`yade._utils.interactionAnglesHistogram` (the first bin gathers the angles close to 0 and to π)."))
+		((bool,compress,true,,"Compress the time series file."))
+		((int,chunkSteps,64,,"Number of steps buffered before they are written to the time series file."))
+		((Matrix3r,stress,Matrix3r::Zero(),Attr::readonly,"Love-Weber stress tensor (tension positive)."))
+		((Matrix3r,fabric,Matrix3r::Zero(),Attr::readonly,"Fabric tensor."))
+		((Matrix3r,fabricStrong,Matrix3r::Zero(),Attr::readonly,"Fabric tensor of the contacts with a compressive normal force larger than the mean."))
+		((Matrix3r,fabricWeak,Matrix3r::Zero(),Attr::readonly,"Fabric tensor of the other contacts."))
+		((Real,meanNormalForce,0,Attr::readonly,"Mean normal force of the contacts (negative in compression), as ``Fmean`` of :yref:`yade._utils.fabricTensor`."))
+		((Matrix3r,normalStress,Matrix3r::Zero(),Attr::readonly,"Contribution of normal forces to the stress tensor (tension positive)."))
+		((Matrix3r,shearStress,Matrix3r::Zero(),Attr::readonly,"Contribution of shear forces to the stress tensor."))
+		((Real,coordination,0,Attr::readonly,"Mean number of contacts per particle (clumps being one particle)."))
+		((Real,mechanicalCoordination,0,Attr::readonly,"Mean number of contacts per particle, without the particles with 0 or 1 contact [Thornton2000]_."))
+		((long,contacts,0,Attr::readonly,"Number of contacts considered."))
+		((long,particles,0,Attr::readonly,"Number of particles: bodies that are not clump members, clumps included."))
+		((vector<int>,coordHistogram,,Attr::readonly,"Number of particles with 0, 1, 2… contacts."))
+		((vector<Real>,angleHistogram,,Attr::readonly,"Sum of the lengths of contact normals projected on the plane perpendicular to :yref:`angleAxis<InSituStatsEngine.angleAxis>`, by bins of their angle in that plane."))
+		((Real,reductionTime,0,Attr::readonly,"Wall time of the last run (s)."))
+		,
+		/*ctor*/
+		initRun=true;
+		,
+		/*py*/
+		.def("flush",&InSituStatsEngine::flush,"Write the buffered steps to the time series file.")
+	);
+	// clang-format on
+	DECLARE_LOGGER;
+};
+REGISTER_SERIALIZABLE(InSituStatsEngine);
+
+} // namespace yade
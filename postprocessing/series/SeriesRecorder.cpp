@@ -0,0 +1,220 @@
+#include "SeriesRecorder.hpp"
+#include <core/Scene.hpp>
+#include <pkg/common/NormShearPhys.hpp>
+#include <pkg/common/Sphere.hpp>
+#include <pkg/dem/DemXDofGeom.hpp>
+#include <preprocessing/dem/Shop.hpp>
+#include <map>
+
+namespace yade { // Cannot have #include directive inside.
+
+YADE_PLUGIN((SeriesRecorder));
+CREATE_LOGGER(SeriesRecorder);
+
+namespace {
+	enum Kind { STEP, PARTICLE, CONTACT };
+	struct Column {
+		SeriesWriter::Field field;
+		Kind                kind;
+	};
+
+	vector<Column> layout(const vector<bool>& recActive)
+	{
+		vector<Column> ret;
+		auto           add = [&ret](const char* name, Kind kind, bool isInt, int components) { ret.push_back(Column { { name, isInt, components }, kind }); };
+		add("time", STEP, false, 1);
+		add("id", PARTICLE, true, 1);
+		if (recActive[SeriesRecorder::REC_SPHERES]) {
+			add("pos", PARTICLE, false, 3);
+			add("radius", PARTICLE, false, 1);
+		}
+		if (recActive[SeriesRecorder::REC_VELOCITY]) {
+			add("linVel", PARTICLE, false, 3);
+			add("angVel", PARTICLE, false, 3);
+		}
+		if (recActive[SeriesRecorder::REC_FORCE]) {
+			add("force", PARTICLE, false, 3);
+			add("torque", PARTICLE, false, 3);
+		}
+		if (recActive[SeriesRecorder::REC_MASS]) add("mass", PARTICLE, false, 1);
+		if (recActive[SeriesRecorder::REC_CLUMPID]) add("clumpId", PARTICLE, true, 1);
+		if (recActive[SeriesRecorder::REC_MASK]) add("mask", PARTICLE, true, 1);
+		if (recActive[SeriesRecorder::REC_MATERIALID]) add("materialId", PARTICLE, true, 1);
+		if (recActive[SeriesRecorder::REC_COLORS]) add("color", PARTICLE, false, 3);
+		if (recActive[SeriesRecorder::REC_COORDNUMBER]) add("coordNumber", PARTICLE, true, 1);
+		if (recActive[SeriesRecorder::REC_STRESS]) {
+			add("normalStress", PARTICLE, false, 3);
+			add("shearStress", PARTICLE, false, 3);
+		}
+		if (recActive[SeriesRecorder::REC_BSTRESS]) add("bStress", PARTICLE, false, 9);
+		if (recActive[SeriesRecorder::REC_INTR]) {
+			add("contactIds", CONTACT, true, 2);
+			add("contactPoint", CONTACT, false, 3);
+			add("contactNormal", CONTACT, false, 3);
+			add("normalForce", CONTACT, false, 3);
+			add("shearForce", CONTACT, false, 3);
+		}
+		return ret;
+	}
+}
+
+void SeriesRecorder::action()
+{
+	if (!writer.isOpen()) {
+		if (fileName.empty()) throw std::runtime_error("SeriesRecorder.fileName must not be empty.");
+		writer.open(fileName);
+		steps = 0;
+	}
+	writer.compress         = compress;
+	writer.compressionLevel = compressionLevel;
+	writer.chunkSteps       = chunkSteps;
+	vector<bool> recActive(REC_COUNT, false);
+	for (const string& rec : recorders) {
+		if (rec == "all") {
+			std::fill(recActive.begin(), recActive.end(), true);
+		} else if (rec == "spheres")
+			recActive[REC_SPHERES] = true;
+		else if (rec == "velocity")
+			recActive[REC_VELOCITY] = true;
+		else if (rec == "force")
+			recActive[REC_FORCE] = true;
+		else if (rec == "mass")
+			recActive[REC_MASS] = true;
+		else if ((rec == "ids") || (rec == "id"))
+			recActive[REC_ID] = true;
+		else if ((rec == "clumpids") || (rec == "clumpId"))
+			recActive[REC_CLUMPID] = true;
+		else if (rec == "mask")
+			recActive[REC_MASK] = true;
+		else if (rec == "materialId")
+			recActive[REC_MATERIALID] = true;
+		else if ((rec == "colors") || (rec == "color"))
+			recActive[REC_COLORS] = true;
+		else if (rec == "coordNumber")
+			recActive[REC_COORDNUMBER] = true;
+		else if (rec == "stress")
+			recActive[REC_STRESS] = true;
+		else if (rec == "bstresses")
+			recActive[REC_BSTRESS] = true;
+		else if (rec == "intr")
+			recActive[REC_INTR] = true;
+		else
+			LOG_WARN("Recorder `" << rec
+			                      << "' is not supported (supported are: all, spheres, velocity, force, mass, id, clumpId, mask, materialId, colors, "
+			                         "coordNumber, stress, bstresses, intr). Ignored.");
+	}
+
+	const vector<Column>         columns = layout(recActive);
+	vector<SeriesWriter::Field> fields;
+	for (const Column& c : columns)
+		fields.push_back(c.field);
+	writer.setFields(fields);
+
+	vector<const Body*> bodies;
+	for (const auto& b : *scene->bodies) {
+		if (!b) continue;
+		if (mask != 0 && !b->maskCompatible(mask)) continue;
+		if (!dynamic_cast<Sphere*>(b->shape.get())) continue;
+		bodies.push_back(b.get());
+	}
+	vector<const Interaction*> contacts;
+	if (recActive[REC_INTR]) {
+		for (const auto& I : *scene->interactions) {
+			if (!I->isReal()) continue;
+			if (!dynamic_cast<GenericSpheresContact*>(I->geom.get()) || !dynamic_cast<NormShearPhys*>(I->phys.get())) continue;
+			if (mask != 0) {
+				const auto& b1 = Body::byId(I->getId1(), scene);
+				const auto& b2 = Body::byId(I->getId2(), scene);
+				if (!b1->maskCompatible(mask) || !b2->maskCompatible(mask)) continue;
+			}
+			contacts.push_back(I.get());
+		}
+	}
+	vector<Shop::bodyState> bodyStates;
+	if (recActive[REC_STRESS]) Shop::getStressForEachBody(bodyStates);
+	vector<Matrix3r> bStresses;
+	if (recActive[REC_BSTRESS]) Shop::getStressLWForEachBody(bStresses);
+	if (recActive[REC_FORCE]) scene->forces.sync();
+
+	// append the rows of this step; pointers are null for fields not recorded
+	writer.beginStep(scene->iter);
+	std::map<string, double*>  real;
+	std::map<string, int64_t*> integer;
+	for (const Column& c : columns) {
+		const size_t rows = (c.kind == STEP ? 1 : (c.kind == PARTICLE ? bodies.size() : contacts.size()));
+		if (c.field.isInt) integer[c.field.name] = writer.integer(c.field.name, rows);
+		else
+			real[c.field.name] = writer.real(c.field.name, rows);
+	}
+	real["time"][0] = static_cast<double>(scene->time);
+	int64_t* id      = integer["id"];
+	double * pos = real["pos"], *radius = real["radius"], *linVel = real["linVel"], *angVel = real["angVel"], *force = real["force"],
+	       *torque = real["torque"], *mass = real["mass"], *color = real["color"], *normalStress = real["normalStress"],
+	       *shearStress = real["shearStress"], *bStress = real["bStress"];
+	int64_t *clumpId = integer["clumpId"], *groupMask = integer["mask"], *materialId = integer["materialId"], *coordNumber = integer["coordNumber"];
+	auto     put3    = [](double* v, long i, const Vector3r& x) {
+                for (int k = 0; k < 3; k++)
+                        v[3 * i + k] = static_cast<double>(x[k]);
+	};
+	const long n = (long)bodies.size();
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long i = 0; i < n; i++) {
+		const Body* b   = bodies[i];
+		const auto  bId = b->getId();
+		id[i]           = bId;
+		if (pos) {
+			put3(pos, i, b->state->pos);
+			radius[i] = static_cast<double>(static_cast<const Sphere*>(b->shape.get())->radius);
+		}
+		if (linVel) {
+			put3(linVel, i, b->state->vel);
+			put3(angVel, i, b->state->angVel);
+		}
+		if (force) {
+			put3(force, i, scene->forces.getForce(bId));
+			put3(torque, i, scene->forces.getTorque(bId));
+		}
+		if (mass) mass[i] = static_cast<double>(b->state->mass);
+		if (clumpId) clumpId[i] = b->clumpId;
+#ifdef YADE_MASK_ARBITRARY
+		if (groupMask) groupMask[i] = b->groupMask.to_ulong();
+#else
+		if (groupMask) groupMask[i] = b->groupMask;
+#endif
+		if (materialId) materialId[i] = b->material->id;
+		if (color) put3(color, i, b->shape->color);
+		if (coordNumber) coordNumber[i] = b->coordNumber();
+		if (normalStress) {
+			put3(normalStress, i, bodyStates[bId].normStress);
+			put3(shearStress, i, bodyStates[bId].shearStress);
+		}
+		if (bStress)
+			for (int k = 0; k < 9; k++)
+				bStress[9 * i + k] = static_cast<double>(bStresses[bId](k / 3, k % 3));
+	}
+	if (recActive[REC_INTR]) {
+		int64_t*   ids = integer["contactIds"];
+		double *   point = real["contactPoint"], *normal = real["contactNormal"], *fn = real["normalForce"], *fs = real["shearForce"];
+		const long nc    = (long)contacts.size();
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for (long i = 0; i < nc; i++) {
+			const Interaction*           I    = contacts[i];
+			const GenericSpheresContact* geom = static_cast<const GenericSpheresContact*>(I->geom.get());
+			const NormShearPhys*         phys = static_cast<const NormShearPhys*>(I->phys.get());
+			ids[2 * i]                        = I->getId1();
+			ids[2 * i + 1]                    = I->getId2();
+			put3(point, i, geom->contactPoint);
+			put3(normal, i, geom->normal);
+			put3(fn, i, phys->normalForce);
+			put3(fs, i, phys->shearForce);
+		}
+	}
+	writer.endStep();
+	steps++;
+}
+
+} // namespace yade
@@ -0,0 +1,50 @@
+#pragma once
+#include <pkg/common/PeriodicEngines.hpp>
+#include <postprocessing/series/SeriesWriter.hpp>
+
+namespace yade { // Cannot have #include directive inside.
+
+/* Time series of particle and contact fields in one file per run, see SeriesWriter for the format. */
+class SeriesRecorder : public PeriodicEngine {
+public:
+	enum { REC_SPHERES = 0, REC_VELOCITY, REC_FORCE, REC_MASS, REC_ID, REC_CLUMPID, REC_MASK, REC_MATERIALID, REC_COLORS, REC_COORDNUMBER, REC_STRESS, REC_BSTRESS, REC_INTR, REC_COUNT };
+
+private:
+	SeriesWriter writer;
+
+public:
+	void action() override;
+	void flush() { writer.flush(); }
+	// clang-format off
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(SeriesRecorder,PeriodicEngine,"Engine recording particle and contact fields at every run into a single binary file, as compressed chunks of consecutive steps for each field (see the format in ``SeriesWriter.hpp``). It is much smaller and faster to read back than a series of :yref:`VTKRecorder` or :yref:`yade.export.textExt` files; read it with :yref:`yade.export.SeriesReader`, which gives the values of one field at all recorded steps without reading the other fields (and memory-maps them if not :yref:`compressed<SeriesRecorder.compress>`).\n\nParticle fields are recorded for spheres (respecting :yref:`mask<SeriesRecorder.mask>`), and always include their ``id`` so that steps with different numbers of spheres can be matched. Contact fields are recorded for real interactions with :yref:`GenericSpheresContact` geometry and :yref:`NormShearPhys` physics. The file is created (overwritten) at the first run.\n\n:yref:`PeriodicEngine.initRun` is initialized to ``True`` automatically.",
+		((string,fileName,"",,"File to write to; must not be empty."))
+		((vector<string>,recorders,vector<string>(1,string("all")),,R"""(Fields to record, named as in :yref:`VTKRecorder.recorders`:
+
+* ``all`` saves all fields below
+* ``spheres`` saves positions ``pos`` and radii ``radius``
+* ``velocity`` saves linear and angular velocities ``linVel``, ``angVel``
+* ``force`` saves forces and torques ``force``, ``torque``
+* ``mass``, ``clumpId``, ``mask``, ``materialId``, ``coordNumber``, ``colors`` (as ``color``) save the corresponding sphere attribute
+* ``stress`` saves the sums of normal and shear contact forces acting on each sphere ``normalStress`` and ``shearStress``, as ``stress`` of :yref:`VTKRecorder`
+* ``bstresses`` saves the stress tensor ``bStress`` of :yref:`yade._utils.bodyStressTensors` (9 components, row-major)
+* ``intr`` saves, for each contact, the ids ``contactIds`` (2 components), ``contactPoint``, ``contactNormal``, ``normalForce`` and ``shearForce``
+
+The simulation time ``time`` is always saved. Other recorders of :yref:`VTKRecorder` are not supported (a warning is given).)"""))
+		((int,mask,0,,"If non-zero, only spheres with a compatible :yref:`groupMask<Body.groupMask>` are recorded, and contacts between them."))
+		((bool,compress,true,,"Compress the chunks with zlib. Uncompressed files are larger but can be memory-mapped."))
+		((int,compressionLevel,1,,"zlib compression level, from 1 (fastest) to 9 (smallest)."))
+		((int,chunkSteps,16,,"Number of recorded steps buffered in memory before they are written, as one chunk per field. Chunks are written earlier when the buffered values exceed 64 MiB, and by :yref:`flush<SeriesRecorder.flush>`."))
+		((long,steps,0,Attr::readonly,"Number of steps recorded so far."))
+		,
+		/*ctor*/
+		initRun=true;
+		,
+		/*py*/
+		.def("flush",&SeriesRecorder::flush,"Write the buffered steps to the file.")
+	);
+	// clang-format on
+	DECLARE_LOGGER;
+};
+REGISTER_SERIALIZABLE(SeriesRecorder);
+
+} // namespace yade
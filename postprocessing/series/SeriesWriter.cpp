@@ -0,0 +1,141 @@
+#include "SeriesWriter.hpp"
+#include <cstring>
+#include <zlib.h>
+
+namespace yade { // Cannot have #include directive inside.
+
+CREATE_LOGGER(SeriesWriter);
+
+static_assert(sizeof(SeriesWriter::ChunkHeader) == 80, "SeriesWriter::ChunkHeader must be 80 bytes");
+
+SeriesWriter::~SeriesWriter()
+{
+	try {
+		flush();
+	} catch (const std::exception& e) {
+		LOG_ERROR("Writing " << fileName << " failed: " << e.what());
+	}
+}
+
+void SeriesWriter::open(const string& _fileName)
+{
+	if (_fileName.empty()) throw std::runtime_error("SeriesWriter: empty file name.");
+	if (out.is_open()) out.close();
+	fileName = _fileName;
+	out.open(fileName.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out.good()) throw std::runtime_error("SeriesWriter: unable to open " + fileName);
+	const char     magic[8]   = "YADESER";
+	const uint32_t version[2] = { 1, 0 };
+	out.write(magic, sizeof(magic));
+	out.write(reinterpret_cast<const char*>(version), sizeof(version));
+	columns.clear();
+	iters.clear();
+}
+
+void SeriesWriter::setFields(const vector<Field>& fields)
+{
+	bool same = fields.size() == columns.size();
+	for (size_t i = 0; same && i < fields.size(); i++)
+		same = fields[i] == columns[i].field;
+	if (same) return;
+	writeChunks();
+	columns.resize(fields.size());
+	for (size_t i = 0; i < fields.size(); i++) {
+		columns[i].field = fields[i];
+		columns[i].real.clear();
+		columns[i].integer.clear();
+		columns[i].rowOffsets.assign(1, 0);
+	}
+}
+
+void SeriesWriter::beginStep(long iter)
+{
+	iters.push_back(iter);
+	for (Column& c : columns)
+		c.rowOffsets.push_back(c.rowOffsets.back());
+}
+
+SeriesWriter::Column* SeriesWriter::column(const string& name)
+{
+	for (Column& c : columns)
+		if (c.field.name == name) return &c;
+	return nullptr;
+}
+
+double* SeriesWriter::real(const string& name, size_t rows)
+{
+	Column* c = column(name);
+	if (!c || c->field.isInt) return nullptr;
+	const size_t begin = c->real.size();
+	c->rowOffsets.back() += rows;
+	c->real.resize(begin + rows * c->field.components);
+	return c->real.data() + begin;
+}
+
+int64_t* SeriesWriter::integer(const string& name, size_t rows)
+{
+	Column* c = column(name);
+	if (!c || !c->field.isInt) return nullptr;
+	const size_t begin = c->integer.size();
+	c->rowOffsets.back() += rows;
+	c->integer.resize(begin + rows * c->field.components);
+	return c->integer.data() + begin;
+}
+
+void SeriesWriter::endStep()
+{
+	size_t buffered = 0;
+	for (const Column& c : columns)
+		buffered += (c.real.size() + c.integer.size()) * 8;
+	if ((int)iters.size() >= math::max(1, chunkSteps) || buffered > (size_t(1) << 26)) writeChunks();
+}
+
+void SeriesWriter::flush()
+{
+	if (!out.is_open()) return;
+	writeChunks();
+	out.flush();
+}
+
+void SeriesWriter::writeChunks()
+{
+	if (iters.empty()) return;
+	for (Column& c : columns) {
+		ChunkHeader h;
+		memset(&h, 0, sizeof(h));
+		memcpy(h.magic, "CHNK", 4);
+		h.nSteps        = (uint32_t)iters.size();
+		h.headerSize    = (uint32_t)(sizeof(ChunkHeader) + (2 * h.nSteps + 1) * sizeof(int64_t));
+		h.dtype         = c.field.isInt ? 1 : 0;
+		h.components    = c.field.components;
+		h.rows          = c.rowOffsets.back();
+		h.rawSize       = c.field.isInt ? c.integer.size() * sizeof(int64_t) : c.real.size() * sizeof(double);
+		const auto* raw = c.field.isInt ? reinterpret_cast<const unsigned char*>(c.integer.data()) : reinterpret_cast<const unsigned char*>(c.real.data());
+		strncpy(h.name, c.field.name.c_str(), sizeof(h.name) - 1);
+		vector<unsigned char> packed;
+		if (compress) {
+			uLongf size = compressBound(h.rawSize);
+			packed.resize(size);
+			if (compress2(packed.data(), &size, raw, h.rawSize, math::min(9, math::max(1, compressionLevel))) != Z_OK)
+				throw std::runtime_error("SeriesWriter: zlib compression failed");
+			packed.resize(size);
+			h.compressed = 1;
+			h.storedSize = size;
+		} else
+			h.storedSize = h.rawSize;
+		out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+		out.write(reinterpret_cast<const char*>(iters.data()), iters.size() * sizeof(int64_t));
+		out.write(reinterpret_cast<const char*>(c.rowOffsets.data()), c.rowOffsets.size() * sizeof(int64_t));
+		out.write(compress ? reinterpret_cast<const char*>(packed.data()) : reinterpret_cast<const char*>(raw), h.storedSize);
+		// the next chunk starts at a multiple of 8 bytes
+		const char pad[8] = {};
+		if (h.storedSize % 8) out.write(pad, 8 - h.storedSize % 8);
+		c.real.clear();
+		c.integer.clear();
+		c.rowOffsets.assign(1, 0);
+	}
+	iters.clear();
+	if (!out.good()) throw std::runtime_error("SeriesWriter: error while writing " + fileName);
+}
+
+} // namespace yade
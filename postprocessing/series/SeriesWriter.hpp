@@ -0,0 +1,76 @@
+#pragma once
+#include <lib/base/Logging.hpp>
+#include <lib/base/Math.hpp>
+#include <cstdint>
+#include <fstream>
+
+namespace yade { // Cannot have #include directive inside.
+
+/* Writer of time series files, read by yade.export.SeriesReader; used by SeriesRecorder and InSituStatsEngine.
+
+The file starts with the 16 bytes magic "YADESER" (null-terminated) and the format version (uint32, then 4 unused bytes), followed by chunks.
+A chunk holds the values of one field over consecutive recorded steps; the chunks of all fields are written together every chunkSteps steps:
+- ChunkHeader (80 bytes),
+- the iterations of the steps (int64 each),
+- the row offsets of the steps (nSteps+1 int64, starting with 0), the rows of step k being rowOffsets[k]…rowOffsets[k+1]-1,
+- the values, rows×components float64 or int64 in row-major order, as they are or as one zlib stream.
+All numbers are little-endian, and the values start at a multiple of 8 bytes from the chunk, so that uncompressed ones can be memory-mapped.
+The number of rows of a field may change from one step to the next (one per particle, one per contact…). */
+class SeriesWriter {
+public:
+	struct ChunkHeader {
+		char     magic[4];   // "CHNK"
+		uint32_t headerSize; // from the start of the chunk to the values
+		uint32_t dtype;      // 0: float64, 1: int64
+		uint32_t components;
+		uint32_t nSteps;
+		uint32_t compressed;
+		uint64_t rows;       // rows of all steps
+		uint64_t storedSize; // bytes of values in the file
+		uint64_t rawSize;    // bytes of values once uncompressed
+		char     name[32];   // null-terminated
+	};
+	struct Field {
+		string name;
+		bool   isInt;
+		int    components;
+		bool   operator==(const Field& f) const { return name == f.name && isInt == f.isInt && components == f.components; }
+	};
+
+	bool compress         = true;
+	int  compressionLevel = 1;
+	int  chunkSteps       = 16; // chunks are also written when the buffered values exceed 64 MiB
+
+	~SeriesWriter(); // writes the buffered steps
+	// creates (overwrites) the file
+	void open(const string& fileName);
+	bool isOpen() const { return out.is_open(); }
+	// fields of the next steps; a different set of fields starts new chunks
+	void setFields(const vector<Field>& fields);
+	void beginStep(long iter);
+	// rows of the current step for a field, appended to the previous ones of the same step; null if the field is not in the current set
+	double*  real(const string& name, size_t rows);
+	int64_t* integer(const string& name, size_t rows);
+	// writes the chunks if chunkSteps steps (or too many values) are buffered
+	void endStep();
+	// writes the buffered steps
+	void flush();
+
+private:
+	struct Column {
+		Field           field;
+		vector<double>  real;
+		vector<int64_t> integer;
+		vector<int64_t> rowOffsets;
+	};
+	Column* column(const string& name);
+	void    writeChunks();
+
+	vector<Column>  columns; // buffered steps of each field
+	vector<int64_t> iters;   // iterations of the buffered steps
+	string          fileName;
+	std::ofstream   out;
+	DECLARE_LOGGER;
+};
+
+} // namespace yade
@@ -68,6 +68,7 @@
 #include <boost/fusion/include/pair.hpp>
 #include <boost/fusion/support/pair.hpp>
 #include <boost/unordered_map.hpp>
+#include <chrono>
 
 namespace yade { // Cannot have #include directive inside.
 
@@ -80,6 +81,135 @@ CREATE_LOGGER(VTKRecorder);
 #define GET_MASK(b) b->groupMask
 #endif
 
+void VTKRecorder::flush()
+{
+	if (streamWriter) streamWriter->flush();
+}
+
+void VTKRecorder::snapshotSpheres(const vector<bool>& recActive, const vector<Shop::bodyState>& bodyStates, const vector<Matrix3r>& bStresses)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	if (!asyncWarned) {
+		const int unsupported[] = { REC_TEMP, REC_CPM, REC_JCFPM, REC_LUBRICATION, REC_SPH, REC_DEFORM, REC_LIQ, REC_PARTIALSAT };
+		for (int rec : unsupported)
+			if (recActive[rec]) {
+				LOG_WARN("asyncWrite only writes the sphere fields of spheres, id, mask, mass, clumpId, colors, velocity, stress, bstresses, force, "
+				         "materialId and coordNumber; other sphere fields are skipped.");
+				asyncWarned = true;
+				break;
+			}
+	}
+	if (!streamWriter) streamWriter = shared_ptr<VTKStreamWriter>(new VTKStreamWriter(maxPending));
+	else
+		streamWriter->setMaxPending(maxPending);
+	// the bodies to export, in the order of the synchronous writer
+	vector<const Body*> bodies;
+	for (const auto& b : *scene->bodies) {
+		if (!b) continue;
+		if (mask != 0 && !b->maskCompatible(mask)) continue;
+		if (!dynamic_cast<Sphere*>(b->shape.get())) continue;
+		if (skipNondynamic && b->state->blockedDOFs == State::DOF_ALL) continue;
+		bodies.push_back(b.get());
+	}
+	if (recActive[REC_FORCE]) scene->forces.sync();
+	const long                            n    = (long)bodies.size();
+	shared_ptr<VTKStreamWriter::Snapshot> snap = streamWriter->acquire();
+	snap->fileName                             = fileName + "spheres." + boost::lexical_cast<string>(scene->iter) + ".vtu";
+	snap->compress                             = compress;
+	snap->count                                = n;
+	snap->points.resize(3 * n);
+	// field buffers, in the order of the synchronous writer; null if not recorded
+	vector<double>&  radii  = snap->add("radii");
+	vector<int64_t>* id     = recActive[REC_ID] ? &snap->addInt("id") : nullptr;
+	vector<int64_t>* msk    = recActive[REC_MASK] ? &snap->addInt("mask") : nullptr;
+	vector<double>*  mass   = recActive[REC_MASS] ? &snap->add("mass") : nullptr;
+	vector<int64_t>* clump  = recActive[REC_CLUMPID] ? &snap->addInt("clumpId") : nullptr;
+	vector<double>*  color  = recActive[REC_COLORS] ? &snap->add("color", 3) : nullptr;
+	vector<double>*  vel[4] = { nullptr, nullptr, nullptr, nullptr };
+	if (recActive[REC_VELOCITY]) {
+		vel[0] = &snap->add("linVelVec", 3);
+		vel[1] = &snap->add("angVelVec", 3);
+		vel[2] = &snap->add("linVelLen");
+		vel[3] = &snap->add("angVelLen");
+	}
+	vector<double>* stress[3] = { nullptr, nullptr, nullptr };
+	if (recActive[REC_STRESS]) {
+		stress[0] = &snap->add("normalStress", 3);
+		stress[1] = &snap->add("shearStress", 3);
+		stress[2] = &snap->add("normalStressNorm");
+	}
+	vector<double>* force[4] = { nullptr, nullptr, nullptr, nullptr };
+	if (recActive[REC_FORCE]) {
+		force[0] = &snap->add("forceVec", 3);
+		force[1] = &snap->add("forceLen");
+		force[2] = &snap->add("torqueVec", 3);
+		force[3] = &snap->add("torqueLen");
+	}
+	vector<double>* bstress[6] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+	if (recActive[REC_BSTRESS]) {
+		const char* names[6] = { "sigI", "sigII", "sigIII", "dirI", "dirII", "dirIII" };
+		for (int k = 0; k < 6; k++)
+			bstress[k] = &snap->add(names[k], k < 3 ? 1 : 3);
+	}
+	vector<int64_t>* material = recActive[REC_MATERIALID] ? &snap->addInt("materialId") : nullptr;
+	vector<int64_t>* coord    = recActive[REC_COORDNUMBER] ? &snap->addInt("coordNumber", 1, true) : nullptr;
+
+	auto put3 = [](vector<double>* v, long i, const Vector3r& x) {
+		for (int k = 0; k < 3; k++)
+			(*v)[3 * i + k] = static_cast<double>(x[k]);
+	};
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long i = 0; i < n; i++) {
+		const Body*   b      = bodies[i];
+		const Sphere* sphere = static_cast<const Sphere*>(b->shape.get());
+		const auto    bId    = b->getId();
+		put3(&snap->points, i, scene->isPeriodic ? scene->cell->wrapShearedPt(b->state->pos) : b->state->pos);
+		radii[i] = static_cast<double>(sphere->radius);
+		if (id) (*id)[i] = bId;
+		if (msk) (*msk)[i] = GET_MASK(b);
+		if (mass) (*mass)[i] = static_cast<double>(b->state->mass);
+		if (clump) (*clump)[i] = b->clumpId;
+		if (color) put3(color, i, sphere->color);
+		if (vel[0]) {
+			Vector3r v = b->state->vel;
+			if (scene->isPeriodic) { // Take care of cell deformation
+				v = scene->cell->bodyFluctuationVel(b->state->pos, b->state->vel, scene->cell->prevVelGrad)
+				        + scene->cell->prevVelGrad * scene->cell->wrapShearedPt(b->state->pos);
+			}
+			put3(vel[0], i, v);
+			put3(vel[1], i, b->state->angVel);
+			(*vel[2])[i] = static_cast<double>(v.norm());
+			(*vel[3])[i] = static_cast<double>(b->state->angVel.norm());
+		}
+		if (stress[0]) {
+			put3(stress[0], i, bodyStates[bId].normStress);
+			put3(stress[1], i, bodyStates[bId].shearStress);
+			(*stress[2])[i] = static_cast<double>(bodyStates[bId].normStress.norm());
+		}
+		if (force[0]) {
+			const Vector3r& f = scene->forces.getForce(bId);
+			const Vector3r& t = scene->forces.getTorque(bId);
+			put3(force[0], i, f);
+			(*force[1])[i] = static_cast<double>(f.norm());
+			put3(force[2], i, t);
+			(*force[3])[i] = static_cast<double>(t.norm());
+		}
+		if (bstress[0]) {
+			Eigen::SelfAdjointEigenSolver<Matrix3r> solver(bStresses[bId]);
+			for (int k = 0; k < 3; k++) {
+				(*bstress[k])[i] = static_cast<double>(solver.eigenvalues()[2 - k]); // sigI is the largest
+				put3(bstress[3 + k], i, solver.eigenvectors().col(2 - k));
+			}
+		}
+		if (material) (*material)[i] = b->material->id;
+		if (coord) (*coord)[i] = b->coordNumber();
+	}
+	waitTime += streamWriter->push(snap);
+	snapshotTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
 void VTKRecorder::action()
 {
 #ifdef YADE_MPI
@@ -713,6 +843,23 @@ void VTKRecorder::action()
 		Law2_ScGeom_ImplicitLubricationPhys::getStressForEachBody(NCStresses, SCStresses, NLStresses, SLStresses, NPStresses);
 	}
 
+	// with asyncWrite, spheres are copied to a snapshot written by another thread, and skipped below
+	bool streamSpheres = asyncWrite && recActive[REC_SPHERES];
+#ifdef YADE_VTK_MULTIBLOCK
+	if (multiblock) streamSpheres = false;
+#endif
+#ifdef YADE_MPI
+	if (parallelMode) streamSpheres = false;
+#endif
+	if (asyncWrite && !streamSpheres && recActive[REC_SPHERES] && !asyncWarned) {
+		LOG_WARN("asyncWrite is not used with multiblock or parallelMode, spheres are written synchronously.");
+		asyncWarned = true;
+	}
+	if (streamSpheres) {
+		snapshotSpheres(recActive, bodyStates, bStresses);
+		recActive[REC_SPHERES] = false;
+	}
+
 
 #ifdef YADE_MPI
 	const auto& subD = YADE_PTR_CAST<Subdomain>(scene->subD);
@@ -1,6 +1,8 @@
 #pragma once
 #include <lib/compatibility/VTKCompatibility.hpp> // fix InsertNextTupleValue → InsertNextTuple name change (and others in the future)
 #include <pkg/common/PeriodicEngines.hpp>
+#include <postprocessing/vtk/VTKStreamWriter.hpp>
+#include <preprocessing/dem/Shop.hpp>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
 #pragma GCC diagnostic ignored "-Wsuggest-override"
@@ -27,6 +29,10 @@ private:
 	int  rank, commSize;
 	bool sceneRefreshed = false;
 #endif
+	shared_ptr<VTKStreamWriter> streamWriter; // created at the first asyncWrite export
+	bool                        asyncWarned = false;
+	void                        snapshotSpheres(const vector<bool>& recActive, const vector<Shop::bodyState>& bodyStates, const vector<Matrix3r>& bStresses);
+
 public:
 	enum {
 		REC_SPHERES = 0,
@@ -63,9 +69,10 @@ public:
 		REC_LS
 	};
 	void action() override;
+	void flush();
 	void addWallVTK(vtkSmartPointer<vtkQuad>& boxes, vtkSmartPointer<vtkPointsReal>& boxesPos, Vector3r& W1, Vector3r& W2, Vector3r& W3, Vector3r& W4);
 	// clang-format off
-	YADE_CLASS_BASE_DOC_ATTRS_CTOR(VTKRecorder,PeriodicEngine,"Engine recording snapshots of simulation into series of \\*.vtu files, readable by VTK-based postprocessing programs such as Paraview. Both bodies (depending on their :yref:`shapes<Shape>`) and interactions can be recorded, with various vector/scalar quantities that are defined on them.\n\n:yref:`PeriodicEngine.initRun` is initialized to ``True`` automatically.",
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(VTKRecorder,PeriodicEngine,"Engine recording snapshots of simulation into series of \\*.vtu files, readable by VTK-based postprocessing programs such as Paraview. Both bodies (depending on their :yref:`shapes<Shape>`) and interactions can be recorded, with various vector/scalar quantities that are defined on them.\n\n:yref:`PeriodicEngine.initRun` is initialized to ``True`` automatically.",
 		((bool,compress,false,,"Compress output XML files [experimental]."))
 		((bool,ascii,false,,"Store data as readable text in the XML file (sets `vtkXMLWriter <http://www.vtk.org/doc/nightly/html/classvtkXMLWriter.html>`__ data mode to ``vtkXMLWriter::Ascii``, while the default is ``Appended``)"))
 		((bool,skipFacetIntr,true,,"Skip interactions that are not of sphere-sphere type (e.g. sphere-facet, sphere-box...), when saving interactions"))
@@ -156,9 +163,17 @@ public:
 		Saves bond data from hertzmindlin such as displacement or 'broken' where broken follows a displacement criteria set by user in :yref:`Law2_ScGeom_MindlinPhys_Mindlin`.
 )"""))
 		((string,Key,"",,"Necessary if :yref:`recorders<VTKRecorder.recorders>` contains 'cracks' or 'moments'. A string specifying the name of file 'cracks___.txt' that is considered in this case (see :yref:`corresponding attribute<Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM.Key>`)."))
-		((int,mask,0,,"If mask defined, only bodies with corresponding groupMask will be exported. If 0, all bodies will be exported.")),
+		((int,mask,0,,"If mask defined, only bodies with corresponding groupMask will be exported. If 0, all bodies will be exported."))
+		((bool,asyncWrite,false,,"Write the ``spheres`` file in a background thread: the requested sphere fields are copied in parallel into reusable buffers at each export, the simulation then continues while the file is written (VTK XML with appended raw binary data, zlib-compressed if :yref:`compress<VTKRecorder.compress>`). Fields are the same as without asyncWrite for the recorders ``spheres``, ``id``, ``mask``, ``mass``, ``clumpId``, ``colors``, ``velocity``, ``stress``, ``bstresses``, ``force``, ``materialId`` and ``coordNumber``; the sphere fields of other recorders are not written (a warning is given). Other files (facets, interactions...) are written as usual. Not used with :yref:`multiblock<VTKRecorder.multiblock>` or MPI ``parallelMode``. Call :yref:`flush<VTKRecorder.flush>` to wait for pending files, e.g. before reading them."))
+		((int,maxPending,2,,"With :yref:`asyncWrite<VTKRecorder.asyncWrite>`, maximum number of exports waiting to be written; a new export waits for the writer thread beyond that. Changes apply from the next export, as those of :yref:`compress<VTKRecorder.compress>`."))
+		((Real,snapshotTime,0,Attr::readonly,"With :yref:`asyncWrite<VTKRecorder.asyncWrite>`, wall time (s) of the last export spent in the simulation thread for spheres, i.e. copying the fields and waiting for a slot in the queue."))
+		((Real,waitTime,0,Attr::readonly,"With :yref:`asyncWrite<VTKRecorder.asyncWrite>`, cumulated wall time (s) spent waiting for the writer thread because :yref:`maxPending<VTKRecorder.maxPending>` exports were not written yet."))
+		,
 		/*ctor*/
 		initRun=true;
+		,
+		/*py*/
+		.def("flush",&VTKRecorder::flush,"Wait until all files of :yref:`asyncWrite<VTKRecorder.asyncWrite>` exports are written.")
 	);
 	// clang-format on
 	DECLARE_LOGGER;
@@ -0,0 +1,232 @@
+#ifdef YADE_VTK
+
+#include "VTKStreamWriter.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
+
+namespace yade { // Cannot have #include directive inside.
+
+CREATE_LOGGER(VTKStreamWriter);
+
+vector<double>& VTKStreamWriter::Snapshot::add(const string& name, int components, bool cellData)
+{
+	if (used == fields.size()) fields.push_back(Field());
+	Field& f     = fields[used++];
+	f.name       = name;
+	f.components = components;
+	f.cellData   = cellData;
+	f.integer    = false;
+	f.data.resize(count * components);
+	return f.data;
+}
+
+vector<int64_t>& VTKStreamWriter::Snapshot::addInt(const string& name, int components, bool cellData)
+{
+	if (used == fields.size()) fields.push_back(Field());
+	Field& f     = fields[used++];
+	f.name       = name;
+	f.components = components;
+	f.cellData   = cellData;
+	f.integer    = true;
+	f.ints.resize(count * components);
+	return f.ints;
+}
+
+VTKStreamWriter::VTKStreamWriter(int _maxPending)
+        : maxPending(std::max(1, _maxPending))
+        , stop(false)
+        , busy(false)
+{
+	thread = boost::thread(&VTKStreamWriter::run, this);
+}
+
+VTKStreamWriter::~VTKStreamWriter()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_all();
+	thread.join();
+}
+
+shared_ptr<VTKStreamWriter::Snapshot> VTKStreamWriter::acquire()
+{
+	shared_ptr<Snapshot> snap;
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		if (!pool.empty()) {
+			snap = pool.front();
+			pool.pop_front();
+		}
+	}
+	if (!snap) snap = shared_ptr<Snapshot>(new Snapshot);
+	snap->compress = false;
+	snap->count    = 0;
+	snap->used     = 0;
+	return snap;
+}
+
+void VTKStreamWriter::setMaxPending(int _maxPending)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	maxPending = std::max(1, _maxPending);
+}
+
+Real VTKStreamWriter::push(const shared_ptr<Snapshot>& snap)
+{
+	auto                      t0 = std::chrono::steady_clock::now();
+	boost::mutex::scoped_lock lock(mutex);
+	while ((int)queue.size() >= maxPending)
+		cond.wait(lock);
+	const Real waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+	queue.push_back(snap);
+	cond.notify_all();
+	return waited;
+}
+
+void VTKStreamWriter::flush()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	while (!queue.empty() || busy)
+		cond.wait(lock);
+}
+
+void VTKStreamWriter::run()
+{
+	while (true) {
+		shared_ptr<Snapshot> snap;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (queue.empty() && !stop)
+				cond.wait(lock);
+			if (queue.empty()) return; // stop requested and nothing left to write
+			snap = queue.front();
+			queue.pop_front();
+			busy = true;
+		}
+		cond.notify_all(); // a slot is free
+		try {
+			writeVtu(*snap);
+		} catch (const std::exception& e) {
+			LOG_ERROR("Writing " << snap->fileName << " failed: " << e.what());
+		}
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			busy = false;
+			pool.push_back(snap);
+		}
+		cond.notify_all();
+	}
+}
+
+namespace {
+	/* One DataArray of the appended section, in the layout of vtkXMLWriter with header_type="UInt64": either the size in bytes followed by the
+	 * raw data, or (with a compressor) the number of blocks, the block size, the size of the last block, the compressed size of each block,
+	 * followed by the compressed blocks. Uncompressed data are not copied. */
+	struct Block {
+		vector<unsigned char> head; // header, and compressed data if any
+		const unsigned char*  raw;
+		size_t                rawSize;
+		size_t                size() const { return head.size() + rawSize; }
+	};
+
+	template <class T> Block encode(const vector<T>& v, bool compress)
+	{
+		const size_t         nBytes = v.size() * sizeof(T);
+		const unsigned char* src    = reinterpret_cast<const unsigned char*>(v.data());
+		Block                b;
+		if (!compress) {
+			const uint64_t h = nBytes;
+			b.head.resize(sizeof(h));
+			memcpy(b.head.data(), &h, sizeof(h));
+			b.raw     = src;
+			b.rawSize = nBytes;
+			return b;
+		}
+		const uint64_t   blockSize = 1 << 16;
+		const uint64_t   nBlocks   = (nBytes + blockSize - 1) / blockSize;
+		const uint64_t   last      = nBytes - (nBlocks > 0 ? (nBlocks - 1) * blockSize : 0);
+		vector<uint64_t> h(3 + nBlocks);
+		h[0] = nBlocks;
+		h[1] = blockSize;
+		h[2] = (nBlocks > 0 ? last : 0);
+		vector<unsigned char> data;
+		for (uint64_t i = 0; i < nBlocks; i++) {
+			const uLong  len   = (i + 1 < nBlocks ? blockSize : last);
+			uLongf       clen  = compressBound(len);
+			const size_t start = data.size();
+			data.resize(start + clen);
+			if (compress2(data.data() + start, &clen, src + i * blockSize, len, Z_BEST_SPEED) != Z_OK)
+				throw std::runtime_error("zlib compression failed");
+			data.resize(start + clen);
+			h[3 + i] = clen;
+		}
+		b.head.resize(h.size() * sizeof(uint64_t) + data.size());
+		memcpy(b.head.data(), h.data(), h.size() * sizeof(uint64_t));
+		memcpy(b.head.data() + h.size() * sizeof(uint64_t), data.data(), data.size());
+		b.raw     = nullptr;
+		b.rawSize = 0;
+		return b;
+	}
+}
+
+void VTKStreamWriter::writeVtu(const Snapshot& snap)
+{
+	const bool compress = snap.compress;
+	// one vertex cell per point
+	vector<int64_t> connectivity(snap.count), offsets(snap.count);
+	vector<uint8_t> types(snap.count, 1 /* VTK_VERTEX */);
+	for (long i = 0; i < snap.count; i++) {
+		connectivity[i] = i;
+		offsets[i]      = i + 1;
+	}
+	vector<Block>      blocks;
+	std::ostringstream xml;
+	size_t             offset = 0;
+	auto               array  = [&](const char* type, const string& name, int components, Block&& b) {
+                xml << "<DataArray type=\"" << type << "\" Name=\"" << name << "\" NumberOfComponents=\"" << components
+                    << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+                offset += b.size();
+                blocks.push_back(std::move(b));
+	};
+	auto field = [&](const Field& f) {
+		if (f.integer) array("Int64", f.name, f.components, encode(f.ints, compress));
+		else
+			array("Float64", f.name, f.components, encode(f.data, compress));
+	};
+	xml << "<?xml version=\"1.0\"?>\n<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\""
+	    << (compress ? " compressor=\"vtkZLibDataCompressor\"" : "") << ">\n<UnstructuredGrid>\n<Piece NumberOfPoints=\"" << snap.count
+	    << "\" NumberOfCells=\"" << snap.count << "\">\n<PointData>\n";
+	for (size_t i = 0; i < snap.used; i++)
+		if (!snap.fields[i].cellData) field(snap.fields[i]);
+	xml << "</PointData>\n<CellData>\n";
+	for (size_t i = 0; i < snap.used; i++)
+		if (snap.fields[i].cellData) field(snap.fields[i]);
+	xml << "</CellData>\n<Points>\n";
+	array("Float64", "Points", 3, encode(snap.points, compress));
+	xml << "</Points>\n<Cells>\n";
+	array("Int64", "connectivity", 1, encode(connectivity, compress));
+	array("Int64", "offsets", 1, encode(offsets, compress));
+	array("UInt8", "types", 1, encode(types, compress));
+	xml << "</Cells>\n</Piece>\n</UnstructuredGrid>\n<AppendedData encoding=\"raw\">\n_";
+
+	std::ofstream f(snap.fileName.c_str(), std::ios::binary);
+	if (!f.good()) throw std::runtime_error("unable to open file");
+	const string header = xml.str();
+	f.write(header.data(), header.size());
+	for (const Block& b : blocks) {
+		f.write(reinterpret_cast<const char*>(b.head.data()), b.head.size());
+		if (b.rawSize > 0) f.write(reinterpret_cast<const char*>(b.raw), b.rawSize);
+	}
+	f << "\n</AppendedData>\n</VTKFile>\n";
+	if (!f.good()) throw std::runtime_error("error while writing");
+}
+
+} // namespace yade
+
+#endif /* YADE_VTK */
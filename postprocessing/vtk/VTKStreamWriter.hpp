@@ -0,0 +1,65 @@
+#pragma once
+#include <lib/base/Logging.hpp>
+#include <lib/base/Math.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdint>
+#include <deque>
+
+namespace yade { // Cannot have #include directive inside.
+
+/* Background writer of point clouds to VTK XML unstructured grids (.vtu), used by VTKRecorder with asyncWrite.
+
+The simulation thread fills a Snapshot (acquired from a pool, so that buffers are reused from one export to the next) and pushes it;
+a writer thread encodes it as appended raw binary, optionally zlib-compressed, and writes the file without VTK. At most maxPending
+snapshots wait in the queue, push() blocks beyond that; the limit can be changed between pushes with setMaxPending(). */
+class VTKStreamWriter {
+public:
+	struct Field {
+		string          name;
+		int             components;
+		bool            cellData; // cell data (one vertex cell per point) rather than point data
+		bool            integer;  // written as Int64 from ints, else as Float64 from data
+		vector<double>  data;
+		vector<int64_t> ints;
+	};
+	struct Snapshot {
+		string         fileName;
+		bool           compress; // zlib-compressed arrays
+		long           count;
+		vector<double> points; // 3 per point
+		vector<Field>  fields;
+		size_t         used; // fields in use, the others are kept for their buffers
+		// next field, resized for count values of given number of components
+		vector<double>& add(const string& name, int components = 1, bool cellData = false);
+		// next field of integers (ids, masks, counts)
+		vector<int64_t>& addInt(const string& name, int components = 1, bool cellData = false);
+	};
+
+	VTKStreamWriter(int maxPending);
+	~VTKStreamWriter(); // writes the queued snapshots before returning
+
+	shared_ptr<Snapshot> acquire();
+	// returns the time spent waiting for a free slot in the queue (s)
+	Real push(const shared_ptr<Snapshot>& snap);
+	// wait until all pushed snapshots are written
+	void flush();
+	// the queue limit of the next push()
+	void setMaxPending(int maxPending);
+
+	static void writeVtu(const Snapshot& snap);
+
+private:
+	void run();
+
+	int                              maxPending;
+	bool                             stop, busy;
+	std::deque<shared_ptr<Snapshot>> queue, pool;
+	boost::mutex                     mutex;
+	boost::condition_variable        cond;
+	boost::thread                    thread;
+	DECLARE_LOGGER;
+};
+
+} // namespace yade
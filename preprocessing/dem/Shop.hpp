@@ -20,6 +20,42 @@ class ViscElMat;
 class FrictMat;
 class Interaction;
 
+//! Global reductions of Shop::computeGlobalStats, computed together by one parallel pass over bodies and one over interactions, in an order
+//! independent of the number of threads
+struct GlobalStats {
+	enum {
+		UNBALANCED_FORCE = 1,
+		KINETIC_ENERGY   = 2,
+		STRESS           = 4,
+		FABRIC           = 8,
+		NORMAL_SHEAR     = 16,
+		FABRIC_SPLIT     = 32, // needs a second pass over interactions, implies FABRIC
+		COORDINATION     = 64, // needs a second pass over bodies, implies COUNTS
+		COORD_HISTOGRAM  = 128, // same
+		ANGLE_HISTOGRAM  = 256,
+		COUNTS           = 512,
+		ALL              = 1023
+	};
+	int           computed        = 0; // bitmask of the values below
+	unsigned long generation      = 0; // Scene::stateGeneration at which they were computed
+	Real          unbalancedForce = NaN, unbalancedForceMax = NaN; // as unbalancedForce(false) and unbalancedForce(true), NaN without dynamic bodies or contacts
+	Real          kineticEnergy   = 0;
+	Body::id_t    maxEnergyId     = Body::ID_NONE;
+	Real          volume          = 0;                 // of the periodic cell, or of the axis-aligned box of spheres
+	Matrix3r      stressSum       = Matrix3r::Zero(); // sum of f⊗l of getStress, stress=stressSum/volume
+	Matrix3r      stress          = Matrix3r::Zero();
+	Real          meanNormalForce = NaN; // Fmean and fabric of fabricTensor() with default arguments
+	Matrix3r      fabric          = Matrix3r::Zero();
+	Matrix3r      fabricStrong    = Matrix3r::Zero(); // fabricTensor(splitTensor=True)
+	Matrix3r      fabricWeak      = Matrix3r::Zero();
+	Matrix3r      normalStress    = Matrix3r::Zero(); // normal and shear parts of normalShearStressTensors(), divided by volume
+	Matrix3r      shearStress     = Matrix3r::Zero();
+	long          contacts = 0, particles = 0;         // real interactions with NormShearPhys; bodies which are not clump members
+	Real          coordination = NaN, mechanicalCoordination = NaN; // avgNumInteractions(considerClumps=True), with or without skipFree
+	vector<int>   coordHistogram; // particles with 0, 1, 2… contacts, the last bin gathering all higher numbers
+	vector<Real>  angleHistogram; // as interactionAnglesHistogram()
+};
+
 /*! Miscillaneous utility functions which are believed to be generally useful.
  *
  * All data members are methods are static, no instance of Shop is created. It is not serializable either.
@@ -82,6 +118,23 @@ public:
 	//! Get unbalanced force of the whole simulation
 	static Real unbalancedForce(bool useMaxForce = false, Scene* _rb = NULL);
 	static Real kineticEnergy(Scene* _rb = NULL, Body::id_t* maxId = NULL);
+
+	typedef yade::GlobalStats GlobalStats;
+	//! parameters of computeGlobalStats: only interactions between bodies matching mask (if non-zero), and those bodies, are considered
+	struct GlobalStatsOptions {
+		int  mask      = 0;
+		Real volume    = 0; // if 0, that of the periodic cell or of the box of spheres
+		int  coordBins = 13;
+		int  angleAxis = 2;
+		int  angleBins = 18;
+	};
+	//! compute the reductions in the bitmask what
+	static GlobalStats computeGlobalStats(int what, Scene* _rb = NULL);
+	static GlobalStats computeGlobalStats(int what, const GlobalStatsOptions& options, Scene* _rb = NULL);
+	//! same with the default options, reusing the values already computed at the current Scene::stateGeneration (i.e. by the same engine) if useCache
+	static GlobalStats globalStats(int what, bool useCache = true, Scene* _rb = NULL);
+	//! discard the values cached by globalStats, e.g. after bodies were changed from python
+	static void invalidateGlobalStats(Scene* _rb = NULL);
 	//! get total momentum of current simulation
 	static Vector3r momentum();
 	//! get total angular momentum of current simulation
@@ -1,6 +1,7 @@
 // 2007 © Václav Šmilauer <eudoxos@arcig.cz>
 #include "Shop.hpp"
 #include <lib/high-precision/Constants.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <boost/tokenizer.hpp>
 
 #include "core/Body.hpp"
@@ -100,63 +101,27 @@ Vector3r Shop::totalForceInVolume(Real& avgIsoStiffness, Scene* _rb)
 	return force;
 }
 
-Real Shop::unbalancedForce(bool useMaxForce, Scene* _rb)
-{
-	Scene* rb = _rb ? _rb : Omega::instance().getScene().get();
-	rb->forces.sync();
-	shared_ptr<NewtonIntegrator> newton;
-	Vector3r                     gravity = Vector3r::Zero();
-	for (const auto& e : rb->engines) {
-		newton = YADE_PTR_DYN_CAST<NewtonIntegrator>(e);
-		if (newton) {
-			gravity = newton->gravity;
-			break;
-		}
-	}
-	// get maximum force on a body and sum of all forces (for averaging)
-	Real sumF = 0, maxF = 0, currF;
-	int  nb = 0;
-	for (const auto& b : *rb->bodies) {
-		if (!b || b->isClumpMember() || !b->isDynamic()) continue;
-		currF = (rb->forces.getForce(b->id) + b->state->mass * gravity).norm();
-		if (b->isClump()
-		    && currF
-		            == 0) { // this should not happen unless the function is called by an engine whose position in the loop is before Newton (with the exception of bodies which really have null force), because clumps forces are updated in Newton. Typical triaxial loops are using such ordering unfortunately (triaxEngine before Newton). So, here we make sure that they will get correct unbalance. In the future, it is better for optimality to check unbalancedF inside scripts at the end of loops, so that this "if" is never active.
-			Vector3r f(rb->forces.getForce(b->id)), m(Vector3r::Zero());
-			b->shape->cast<Clump>().addForceTorqueFromMembers(b->state.get(), rb, f, m);
-			currF = (f + b->state->mass * gravity).norm();
-		}
-		maxF = max(currF, maxF);
-		sumF += currF;
-		nb++;
-	}
-	Real meanF = sumF / nb;
-	// get mean force on interactions
-	sumF = 0;
-	nb   = 0;
-	for (const auto& I : *rb->interactions) {
-		if (!I->isReal()) continue;
-		shared_ptr<NormShearPhys> nsi = YADE_PTR_CAST<NormShearPhys>(I->phys);
-		assert(nsi);
-		sumF += (nsi->normalForce + nsi->shearForce).norm();
-		nb++;
-	}
-	sumF /= nb;
-	return (useMaxForce ? maxF : meanF) / (sumF);
-}
-
-Real Shop::kineticEnergy(Scene* _scene, Body::id_t* maxId)
-{
-	Scene* scene = _scene ? _scene : Omega::instance().getScene().get();
-	Real   ret   = 0.;
-	Real   maxE  = 0;
-	if (maxId) *maxId = Body::ID_NONE;
-	Vector3r spin = scene->cell->getSpin();
-	for (const auto& b : *scene->bodies) {
-		if (!b || !b->isDynamic() || b->isClumpMember()) continue;
+namespace {
+	// per-block partial sums of Shop::computeGlobalStats; blocks are combined in order, see orderedReduce
+	struct BodyPartials {
+		Real       sumF = 0, maxF = 0, energy = 0, maxE = 0;
+		long       nb = 0, particles = 0;
+		Body::id_t maxId = Body::ID_NONE;
+		Vector3r   bbMin = Vector3r::Constant(std::numeric_limits<Real>::infinity()), bbMax = Vector3r::Constant(-std::numeric_limits<Real>::infinity());
+	};
+	struct InteractionPartials {
+		Real         sumF = 0, fabricF = 0;
+		long         nb = 0, nReal = 0, nFabric = 0, nStrong = 0, nWeak = 0;
+		Matrix3r     stress = Matrix3r::Zero(), fabric = Matrix3r::Zero(), sigN = Matrix3r::Zero(), sigT = Matrix3r::Zero();
+		Matrix3r     fabricStrong = Matrix3r::Zero(), fabricWeak = Matrix3r::Zero();
+		vector<Real> angles;
+	};
+
+	// ½(mv²+ωIω)
+	Real bodyKineticEnergy(const Scene* scene, const Body* b, const Vector3r& spin)
+	{
 		const State* state(b->state.get());
-		// ½(mv²+ωIω)
-		Real E = 0;
+		Real         E = 0;
 		if (scene->isPeriodic) {
 			/* Only take in account the fluctuation velocity, not the mean velocity of homothetic resize. */
 			E = .5 * state->mass
@@ -176,15 +141,354 @@ Real Shop::kineticEnergy(Scene* _scene, Body::id_t* maxId)
 		} else {
 			E += 0.5 * angVel.dot(state->inertia.cwiseProduct(angVel));
 		}
-		if (maxId && E > maxE) {
-			*maxId = b->getId();
-			maxE   = E;
+		return E;
+	}
+
+	void fillLowerTriangle(Matrix3r& m)
+	{
+		m(1, 0) = m(0, 1);
+		m(2, 0) = m(0, 2);
+		m(2, 1) = m(1, 2);
+	}
+}
+
+Real Shop::unbalancedForce(bool useMaxForce, Scene* _rb)
+{
+	const GlobalStats stats = computeGlobalStats(GlobalStats::UNBALANCED_FORCE, _rb);
+	return useMaxForce ? stats.unbalancedForceMax : stats.unbalancedForce;
+}
+
+Real Shop::kineticEnergy(Scene* _scene, Body::id_t* maxId)
+{
+	const GlobalStats stats = computeGlobalStats(GlobalStats::KINETIC_ENERGY, _scene);
+	if (maxId) *maxId = stats.maxEnergyId;
+	return stats.kineticEnergy;
+}
+
+Shop::GlobalStats Shop::computeGlobalStats(int what, Scene* _rb) { return computeGlobalStats(what, GlobalStatsOptions(), _rb); }
+
+/* One pass over bodies (for the unbalanced force, the kinetic energy, the box of spheres and the number of particles), then one over
+interactions, both parallel with orderedReduce so that the results do not depend on the number of threads. The strong and weak fabric tensors
+need a second pass over interactions (they are split by the mean normal force), and the coordination numbers a second pass over bodies. */
+Shop::GlobalStats Shop::computeGlobalStats(int what, const GlobalStatsOptions& options, Scene* _rb)
+{
+	Scene*      scene = _rb ? _rb : Omega::instance().getScene().get();
+	GlobalStats ret;
+	if (what & GlobalStats::FABRIC_SPLIT) what |= GlobalStats::FABRIC;
+	if (what & (GlobalStats::COORDINATION | GlobalStats::COORD_HISTOGRAM)) what |= GlobalStats::COUNTS;
+	ret.computed          = what & GlobalStats::ALL;
+	ret.generation        = scene->stateGeneration;
+	const bool unbalanced = what & GlobalStats::UNBALANCED_FORCE, kinetic = what & GlobalStats::KINETIC_ENERGY, stress = what & GlobalStats::STRESS,
+	           fabric = what & GlobalStats::FABRIC, normalShear = what & GlobalStats::NORMAL_SHEAR, split = what & GlobalStats::FABRIC_SPLIT,
+	           counts = what & GlobalStats::COUNTS, perBody = what & (GlobalStats::COORDINATION | GlobalStats::COORD_HISTOGRAM);
+	const int  mask    = options.mask;
+	const int  nAngles = (what & GlobalStats::ANGLE_HISTOGRAM) ? math::max(1, options.angleBins) : 0;
+	if (nAngles && (options.angleAxis < 0 || options.angleAxis > 2)) throw std::invalid_argument("The axis of the angle histogram must be 0, 1 or 2.");
+	// the box of spheres bounds the contacts of the fabric tensor, and gives the volume of aperiodic simulations
+	const bool box     = fabric || ((stress || normalShear) && !scene->isPeriodic && options.volume == 0);
+	Vector3r   gravity = Vector3r::Zero();
+	if (unbalanced) {
+		scene->forces.sync();
+		for (const auto& e : scene->engines) {
+			const shared_ptr<NewtonIntegrator> newton = YADE_PTR_DYN_CAST<NewtonIntegrator>(e);
+			if (newton) {
+				gravity = newton->gravity;
+				break;
+			}
 		}
-		ret += E;
+	}
+	const BodyContainer& bodies  = *scene->bodies;
+	const Vector3r       spin    = scene->cell->getSpin();
+	const auto           addBody = [&](BodyPartials& p, long i) {
+		const Body* b = bodies[i].get();
+		if (!b) return;
+		if (box) {
+			const Sphere* s = dynamic_cast<const Sphere*>(b->shape.get());
+			if (s) {
+				const Vector3r rrr(s->radius, s->radius, s->radius);
+				p.bbMin = p.bbMin.cwiseMin(b->state->pos - rrr);
+				p.bbMax = p.bbMax.cwiseMax(b->state->pos + rrr);
+			}
+		}
+		if (b->isClumpMember() || !b->maskOk(mask)) return;
+		p.particles++;
+		if (!b->isDynamic()) return;
+		if (unbalanced) {
+			Real currF = (scene->forces.getForce(b->id) + b->state->mass * gravity).norm();
+			// clumps forces are updated in Newton, so that they are null if we are called by an engine placed before Newton (as in typical triaxial
+			// loops): make sure that they get the correct unbalance. Checking unbalancedF at the end of loops avoids this.
+			if (b->isClump() && currF == 0) {
+				Vector3r f(scene->forces.getForce(b->id)), m(Vector3r::Zero());
+				b->shape->cast<Clump>().addForceTorqueFromMembers(b->state.get(), scene, f, m);
+				currF = (f + b->state->mass * gravity).norm();
+			}
+			p.maxF = max(currF, p.maxF);
+			p.sumF += currF;
+			p.nb++;
+		}
+		if (kinetic) {
+			const Real E = bodyKineticEnergy(scene, b, spin);
+			if (E > p.maxE) {
+				p.maxId = b->getId();
+				p.maxE  = E;
+			}
+			p.energy += E;
+		}
+	};
+	const auto combineBodies = [](BodyPartials& r, const BodyPartials& p) {
+		r.sumF += p.sumF;
+		r.maxF = max(r.maxF, p.maxF);
+		r.nb += p.nb;
+		r.particles += p.particles;
+		r.energy += p.energy;
+		if (p.maxE > r.maxE) { // keep the first maximum, as a serial loop
+			r.maxE  = p.maxE;
+			r.maxId = p.maxId;
+		}
+		r.bbMin = r.bbMin.cwiseMin(p.bbMin);
+		r.bbMax = r.bbMax.cwiseMax(p.bbMax);
+	};
+	BodyPartials bp;
+	if (unbalanced || kinetic || box || counts) bp = orderedReduce((long)bodies.size(), BodyPartials(), addBody, combineBodies);
+	if (kinetic) {
+		ret.kineticEnergy = bp.energy;
+		ret.maxEnergyId   = bp.maxId;
+	}
+	if (stress || normalShear) {
+		const Vector3r dim = bp.bbMax - bp.bbMin;
+		ret.volume         = options.volume != 0 ? options.volume : (scene->isPeriodic ? scene->cell->hSize.determinant() : dim[0] * dim[1] * dim[2]);
+	}
+	if (counts) ret.particles = bp.particles;
+	if (!(unbalanced || stress || fabric || normalShear || counts || nAngles)) return ret;
+
+	// contacts per particle, counted for the clump rather than for its members
+	vector<int> numIntr(perBody ? bodies.size() : 0, 0);
+	const bool  isPeriodic = scene->isPeriodic;
+	const int   axis = options.angleAxis, axis2 = (axis + 1) % 3, axis3 = (axis + 2) % 3;
+	const Real  binStep        = Mathr::PI / math::max(1, nAngles);
+	const auto  addInteraction = [&](InteractionPartials& p, long i) {
+		const Interaction* I = (*scene->interactions)[i].get();
+		if (!I->isReal()) return;
+		const Body* b1 = bodies[I->getId1()].get();
+		const Body* b2 = bodies[I->getId2()].get();
+		if (!b1->maskOk(mask) || !b2->maskOk(mask)) return;
+		// the mean interaction force averages over every real contact, those without NormShearPhys adding no force
+		p.nReal++;
+		const NormShearPhys* phys = dynamic_cast<const NormShearPhys*>(I->phys.get());
+		if (!phys) return;
+		p.nb++;
+		if (unbalanced) p.sumF += (phys->normalForce + phys->shearForce).norm();
+		if (b1->isClumpMember()) b1 = bodies[b1->clumpId].get();
+		if (b2->isClumpMember()) b2 = bodies[b2->clumpId].get();
+		if (perBody) {
+#ifdef YADE_OPENMP
+#pragma omp atomic
+#endif
+			numIntr[b1->getId()]++;
+#ifdef YADE_OPENMP
+#pragma omp atomic
+#endif
+			numIntr[b2->getId()]++;
+		}
+		// no need to check b2 because a GridNode can only be in interaction with an oher GridNode.
+		if (stress && b1->shape->getClassIndex() != GridNode::getClassIndexStatic()) {
+			Vector3r branch = b1->state->pos - b2->state->pos;
+			if (isPeriodic) branch -= scene->cell->hSize * I->cellDist.cast<Real>();
+			p.stress += (phys->normalForce + phys->shearForce) * branch.transpose();
+		}
+		const GenericSpheresContact* geom = dynamic_cast<const GenericSpheresContact*>(I->geom.get());
+		if (!geom) return;
+		const Vector3r& n = geom->normal;
+		if (fabric) {
+			const Vector3r& cp = geom->contactPoint;
+			if (cp[0] >= bp.bbMin[0] && cp[0] <= bp.bbMax[0] && cp[1] >= bp.bbMin[1] && cp[1] <= bp.bbMax[1] && cp[2] >= bp.bbMin[2]
+			&& cp[2] <= bp.bbMax[2]) {
+				for (int k = 0; k < 3; k++)
+					for (int l = k; l < 3; l++)
+						p.fabric(k, l) += n[k] * n[l];
+				p.fabricF -= phys->normalForce.dot(n); // will be < 0 in compression
+				p.nFabric++;
+			}
+		}
+		if (normalShear) {
+			const Real N = phys->normalForce.dot(n), R = .5 * (geom->refR1 + geom->refR2);
+			for (int k = 0; k < 3; k++)
+				for (int l = k; l < 3; l++) {
+					p.sigN(k, l) += R * N * n[k] * n[l];
+					p.sigT(k, l) += R * n[k] * phys->shearForce[l];
+				}
+		}
+		if (nAngles) {
+			Vector3r proj(n);
+			proj[axis]     = 0.;
+			const Real len = proj.norm();
+			if (len < 1e-6) return; // (almost) parallel to the axis
+			Real theta = acos(proj[axis2] / len) * (proj[axis3] > 0 ? 1 : -1);
+			if (theta < 0) theta += Mathr::PI;
+			// bins centered on k*binStep, as interactionAnglesHistogram; theta close to π falls in the bin of 0
+			p.angles[int(math::round(theta / binStep)) % nAngles] += len;
+		}
+	};
+	const auto combineInteractions = [](InteractionPartials& r, const InteractionPartials& p) {
+		r.sumF += p.sumF;
+		r.nb += p.nb;
+		r.nReal += p.nReal;
+		r.stress += p.stress;
+		r.fabric += p.fabric;
+		r.fabricF += p.fabricF;
+		r.nFabric += p.nFabric;
+		r.sigN += p.sigN;
+		r.sigT += p.sigT;
+		for (size_t k = 0; k < p.angles.size(); k++)
+			r.angles[k] += p.angles[k];
+	};
+	const long          nIntr = (long)scene->interactions->size();
+	InteractionPartials zero;
+	zero.angles.assign(nAngles, 0.);
+	const InteractionPartials p = orderedReduce(nIntr, zero, addInteraction, combineInteractions);
+	ret.contacts                = p.nb;
+	if (unbalanced) {
+		// NaN without dynamic bodies or without real contacts, as before the reductions were merged
+		const Real meanIntrF   = p.sumF / p.nReal;
+		ret.unbalancedForce    = (bp.sumF / bp.nb) / meanIntrF;
+		ret.unbalancedForceMax = bp.maxF / meanIntrF;
+	}
+	if (stress) {
+		ret.stressSum = p.stress;
+		ret.stress    = p.stress / ret.volume;
+	}
+	if (fabric) {
+		ret.meanNormalForce = p.fabricF / p.nFabric;
+		ret.fabric          = p.fabric;
+		fillLowerTriangle(ret.fabric);
+		ret.fabric /= p.nFabric;
+	}
+	if (normalShear) {
+		ret.normalStress = p.sigN * (2 / ret.volume);
+		ret.shearStress  = p.sigT * (2 / ret.volume);
+		fillLowerTriangle(ret.normalStress);
+		fillLowerTriangle(ret.shearStress);
+	}
+	ret.angleHistogram = p.angles;
+
+	// strong and weak fabric tensors, split by the mean normal force as fabricTensor(splitTensor=True)
+	if (split) {
+		const Real fMean         = ret.meanNormalForce;
+		const auto addStrongWeak = [&](InteractionPartials& q, long i) {
+			const Interaction* I = (*scene->interactions)[i].get();
+			if (!I->isReal()) return;
+			const NormShearPhys*         phys = dynamic_cast<const NormShearPhys*>(I->phys.get());
+			const GenericSpheresContact* geom = dynamic_cast<const GenericSpheresContact*>(I->geom.get());
+			if (!phys || !geom) return;
+			if (!bodies[I->getId1()]->maskOk(mask) || !bodies[I->getId2()]->maskOk(mask)) return;
+			const Vector3r& cp = geom->contactPoint;
+			if (!(cp[0] >= bp.bbMin[0] && cp[0] <= bp.bbMax[0] && cp[1] >= bp.bbMin[1] && cp[1] <= bp.bbMax[1] && cp[2] >= bp.bbMin[2]
+			      && cp[2] <= bp.bbMax[2]))
+				return;
+			const Vector3r& n      = geom->normal;
+			const bool      strong = -phys->normalForce.dot(n) < fMean; // the largest compressive forces
+			Matrix3r&       f      = strong ? q.fabricStrong : q.fabricWeak;
+			for (int k = 0; k < 3; k++)
+				for (int l = k; l < 3; l++)
+					f(k, l) += n[k] * n[l];
+			(strong ? q.nStrong : q.nWeak)++;
+		};
+		const auto combineStrongWeak = [](InteractionPartials& r, const InteractionPartials& q) {
+			r.fabricStrong += q.fabricStrong;
+			r.fabricWeak += q.fabricWeak;
+			r.nStrong += q.nStrong;
+			r.nWeak += q.nWeak;
+		};
+		const InteractionPartials sw = orderedReduce(nIntr, InteractionPartials(), addStrongWeak, combineStrongWeak);
+		ret.fabricStrong             = sw.fabricStrong;
+		ret.fabricWeak               = sw.fabricWeak;
+		fillLowerTriangle(ret.fabricStrong);
+		fillLowerTriangle(ret.fabricWeak);
+		ret.fabricStrong /= sw.nStrong;
+		ret.fabricWeak /= sw.nWeak;
+	}
+
+	// coordination numbers, from the contacts of each particle
+	if (perBody) {
+		const int  nBins   = math::max(1, options.coordBins);
+		const auto addBody = [&](vector<int>& hist, long i) {
+			const Body* b = bodies[i].get();
+			if (!b || b->isClumpMember() || !b->maskOk(mask)) return;
+			hist[math::min(nBins - 1, numIntr[i])]++;
+		};
+		const auto combineHistograms = [](vector<int>& r, const vector<int>& hist) {
+			for (size_t k = 0; k < hist.size(); k++)
+				r[k] += hist[k];
+		};
+		ret.coordHistogram = orderedReduce((long)bodies.size(), vector<int>(nBins, 0), addBody, combineHistograms);
+		// 2C is taken from the number of contacts, since the last bin of the histogram may gather several coordination numbers
+		const Real sumIntr = 2. * ret.contacts, n0 = ret.coordHistogram[0], n1 = nBins > 1 ? ret.coordHistogram[1] : 0;
+		ret.coordination   = ret.particles > 0 ? sumIntr / ret.particles : NaN;
+		ret.mechanicalCoordination = ret.particles - n0 - n1 > 0 ? (sumIntr - n1) / (ret.particles - n0 - n1) : NaN;
 	}
 	return ret;
 }
 
+Shop::GlobalStats Shop::globalStats(int what, bool useCache, Scene* _rb)
+{
+	Scene* scene = _rb ? _rb : Omega::instance().getScene().get();
+	// python may call this while an engine of the running simulation does: the cached values are never modified in place, an updated copy
+	// replaces them atomically
+	const unsigned long           generation = scene->stateGeneration;
+	shared_ptr<const GlobalStats> cached     = boost::atomic_load(&scene->globalStatsCache);
+	GlobalStats                   cache;
+	if (useCache && cached && cached->generation == generation) cache = *cached;
+	cache.generation  = generation;
+	const int missing = what & GlobalStats::ALL & ~cache.computed;
+	if (!missing) return cache;
+	const GlobalStats s     = computeGlobalStats(missing, scene);
+	const int         added = s.computed; // with the reductions implied by the missing ones
+	if (added & GlobalStats::UNBALANCED_FORCE) {
+		cache.unbalancedForce    = s.unbalancedForce;
+		cache.unbalancedForceMax = s.unbalancedForceMax;
+	}
+	if (added & GlobalStats::KINETIC_ENERGY) {
+		cache.kineticEnergy = s.kineticEnergy;
+		cache.maxEnergyId   = s.maxEnergyId;
+	}
+	if (added & (GlobalStats::STRESS | GlobalStats::NORMAL_SHEAR)) cache.volume = s.volume;
+	if (added & GlobalStats::STRESS) {
+		cache.stressSum = s.stressSum;
+		cache.stress    = s.stress;
+	}
+	if (added & GlobalStats::FABRIC) {
+		cache.meanNormalForce = s.meanNormalForce;
+		cache.fabric          = s.fabric;
+	}
+	if (added & GlobalStats::FABRIC_SPLIT) {
+		cache.fabricStrong = s.fabricStrong;
+		cache.fabricWeak   = s.fabricWeak;
+	}
+	if (added & GlobalStats::NORMAL_SHEAR) {
+		cache.normalStress = s.normalStress;
+		cache.shearStress  = s.shearStress;
+	}
+	if (added & GlobalStats::COUNTS) {
+		cache.contacts  = s.contacts;
+		cache.particles = s.particles;
+	}
+	if (added & GlobalStats::COORDINATION) {
+		cache.coordination           = s.coordination;
+		cache.mechanicalCoordination = s.mechanicalCoordination;
+	}
+	if (added & GlobalStats::COORD_HISTOGRAM) cache.coordHistogram = s.coordHistogram;
+	if (added & GlobalStats::ANGLE_HISTOGRAM) cache.angleHistogram = s.angleHistogram;
+	cache.computed |= added;
+	boost::atomic_store(&scene->globalStatsCache, shared_ptr<const GlobalStats>(new GlobalStats(cache)));
+	return cache;
+}
+
+void Shop::invalidateGlobalStats(Scene* _rb)
+{
+	Scene* scene = _rb ? _rb : Omega::instance().getScene().get();
+	boost::atomic_store(&scene->globalStatsCache, shared_ptr<const GlobalStats>());
+}
+
 Vector3r Shop::momentum()
 {
 	Vector3r ret   = Vector3r::Zero();
@@ -1,6 +1,7 @@
 // 2007 © Václav Šmilauer <eudoxos@arcig.cz>
 #include "Shop.hpp"
 #include <lib/base/LoggingUtils.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <lib/high-precision/Constants.hpp>
 
 #include <core/Body.hpp>
@@ -188,11 +189,19 @@ py::tuple Shop::normalShearStressTensors(bool compressionPositive, bool splitNor
 	//*** Stress tensor split into shear and normal contribution ***/
 	Scene* scene = Omega::instance().getScene().get();
 	if (!scene->isPeriodic) { throw runtime_error("Can't compute stress of periodic cell in aperiodic simulation."); }
-	Matrix3r sigN(Matrix3r::Zero()), sigT(Matrix3r::Zero());
+	// sums of the upper triangles of two tensors, accumulated in parallel by orderedReduce
+	struct Sums {
+		Matrix3r a = Matrix3r::Zero(), b = Matrix3r::Zero();
+	};
+	const auto sumTensors = [](Sums& r, const Sums& p) {
+		r.a += p.a;
+		r.b += p.b;
+	};
+	const long nIntr = (long)scene->interactions->size();
 	//const Matrix3r& cellHsize(scene->cell->Hsize);   //Disabled because of warning.
-	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions)
-	{
-		if (!I->isReal()) continue;
+	const auto addNormalShear = [&](Sums& p, long k) {
+		const Interaction* I = (*scene->interactions)[k].get();
+		if (!I->isReal()) return;
 		GenericSpheresContact* geom = YADE_CAST<GenericSpheresContact*>(I->geom.get());
 		NormShearPhys*         phys = YADE_CAST<NormShearPhys*>(I->phys.get());
 		const Vector3r&        n    = geom->normal;
@@ -207,10 +216,13 @@ py::tuple Shop::normalShearStressTensors(bool compressionPositive, bool splitNor
 		Real R = .5 * (geom->refR1 + geom->refR2);
 		for (int i = 0; i < 3; i++)
 			for (int j = i; j < 3; j++) {
-				sigN(i, j) += R * N * n[i] * n[j];
-				if (hasShear) sigT(i, j) += R * T * n[i] * t[j];
+				p.a(i, j) += R * N * n[i] * n[j];
+				if (hasShear) p.b(i, j) += R * T * n[i] * t[j];
 			}
-	}
+	};
+	const Sums normalShear = orderedReduce(nIntr, Sums(), addNormalShear, sumTensors);
+	Matrix3r   sigN(normalShear.a), sigT(normalShear.b);
+
 	Real vol = scene->cell->getVolume();
 	sigN *= 2 / vol;
 	sigT *= 2 / vol;
@@ -226,29 +238,24 @@ py::tuple Shop::normalShearStressTensors(bool compressionPositive, bool splitNor
 	Real     Fmean(0);
 	Matrix3r f, fs, fw;
 	fabricTensor(Fmean, f, fs, fw); // 0,false,NaN,empty vector for cutoff, split, thresholdForce and extrema as default arguments
-	Matrix3r sigNStrong(Matrix3r::Zero()), sigNWeak(Matrix3r::Zero());
-	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions)
-	{
-		if (!I->isReal()) continue;
+	const Real Fsplit        = (!math::isnan(thresholdForce)) ? thresholdForce : Fmean;
+	const auto addStrongWeak = [&](Sums& p, long k) {
+		const Interaction* I = (*scene->interactions)[k].get();
+		if (!I->isReal()) return;
 		GenericSpheresContact* geom = YADE_CAST<GenericSpheresContact*>(I->geom.get());
 		NormShearPhys*         phys = YADE_CAST<NormShearPhys*>(I->phys.get());
 		const Vector3r&        n    = geom->normal;
 		Real                   N    = (compressionPositive ? -1 : 1) * phys->normalForce.dot(n);
 		// Real R=(Body::byId(I->getId2(),scene)->state->pos+cellHsize*I->cellDist.cast<Real>()-Body::byId(I->getId1(),scene)->state->pos).norm();
-		Real R      = .5 * (geom->refR1 + geom->refR2);
-		Real Fsplit = (!math::isnan(thresholdForce)) ? thresholdForce : Fmean;
-		if (compressionPositive ? (N < Fsplit) : (N > Fsplit)) {
-			for (int i = 0; i < 3; i++)
-				for (int j = i; j < 3; j++) {
-					sigNStrong(i, j) += R * N * n[i] * n[j];
-				}
-		} else {
-			for (int i = 0; i < 3; i++)
-				for (int j = i; j < 3; j++) {
-					sigNWeak(i, j) += R * N * n[i] * n[j];
-				}
-		}
-	}
+		Real      R      = .5 * (geom->refR1 + geom->refR2);
+		Matrix3r& target = (compressionPositive ? (N < Fsplit) : (N > Fsplit)) ? p.a : p.b;
+		for (int i = 0; i < 3; i++)
+			for (int j = i; j < 3; j++) {
+				target(i, j) += R * N * n[i] * n[j];
+			}
+	};
+	const Sums strongWeak = orderedReduce(nIntr, Sums(), addStrongWeak, sumTensors);
+	Matrix3r   sigNStrong(strongWeak.a), sigNWeak(strongWeak.b);
 	sigNStrong *= 2 / vol;
 	sigNWeak *= 2 / vol;
 	// fill terms under the diagonal
@@ -292,27 +299,45 @@ void Shop::fabricTensor(
 		bbMin = extrema[0];
 		bbMax = extrema[1];
 	}
-	Vector3r cp;
 
-	Fmean = 0; // initialize average contact force for split = 1 fabric measurements
+	const auto inBox = [&bbMin, &bbMax](const Vector3r& cp) {
+		// possible to use isInBB() from _utils.cpp ? (NB: would exclude the contact points exactly along the BB)
+		return cp[0] >= bbMin[0] && cp[0] <= bbMax[0] && cp[1] >= bbMin[1] && cp[1] <= bbMax[1] && cp[2] >= bbMin[2] && cp[2] <= bbMax[2];
+	};
+	// partial sums of interactions accumulated in parallel by orderedReduce
+	struct Sums {
+		Matrix3r a = Matrix3r::Zero(), b = Matrix3r::Zero();
+		Real     f = 0;
+		int      na = 0, nb = 0;
+	};
+	const auto sumPartials = [](Sums& r, const Sums& p) {
+		r.a += p.a;
+		r.b += p.b;
+		r.f += p.f;
+		r.na += p.na;
+		r.nb += p.nb;
+	};
+	const long nIntr = (long)scene->interactions->size();
+
 	// interactions loop to compute the fabric tensor returned when split = 0, and also measures average force for subsequent computations for split = 1:
-	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions)
-	{
-		if (!I->isReal()) continue;
+	const auto addFabric = [&](Sums& p, long k) {
+		const Interaction* I = (*scene->interactions)[k].get();
+		if (!I->isReal()) return;
 		GenericSpheresContact* geom = YADE_CAST<GenericSpheresContact*>(I->geom.get());
-		cp                          = geom->contactPoint;
-		if (!(cp[0] >= bbMin[0] && cp[0] <= bbMax[0] && cp[1] >= bbMin[1] && cp[1] <= bbMax[1] && cp[2] >= bbMin[2] && cp[2] <= bbMax[2]))
-			continue; // possible to use isInBB() from _utils.cpp ? (NB: would exclude the contact points exactly along the BB)
+		if (!inBox(geom->contactPoint)) return;
 		const Vector3r& n = geom->normal;
 		for (int i = 0; i < 3; i++)
 			for (int j = i; j < 3; j++) {
-				fabric(i, j) += n[i] * n[j];
+				p.a(i, j) += n[i] * n[j];
 			}
 		NormShearPhys* phys = YADE_CAST<NormShearPhys*>(I->phys.get());
-		Real           f    = -phys->normalForce.dot(n); // will be < 0 in compression
-		Fmean += f;
-		count++;
-	}
+		p.f -= phys->normalForce.dot(n); // will be < 0 in compression
+		p.na++;
+	};
+	const Sums total = orderedReduce(nIntr, Sums(), addFabric, sumPartials);
+	fabric = total.a;
+	Fmean  = total.f; // average contact force for split = 1 fabric measurements
+	count  = total.na;
 	Fmean /= count;
 	// fill terms under the diagonal
 	fabric(1, 0) = fabric(0, 1);
@@ -327,39 +352,32 @@ void Shop::fabricTensor(
 	// *** Weak and strong fabric tensors ***/
 	// evaluate two different parts of the fabric tensor
 	// making distinction between strong and weak network of contact forces
-	fabricStrong = Matrix3r::Zero();
-	fabricWeak   = Matrix3r::Zero();
-	int nStrong(0), nWeak(0); // number of strong and weak contacts respectively
 	if (!splitTensor & !math::isnan(thresholdForce)) {
 		LOG_WARN("The bool splitTensor should be set to True if you specified a threshold value for the contact force, otherwise the function will "
 		         "return only the fabric tensor and not the two separate contributions.");
 	}
-	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions)
-	{
-		if (!I->isReal()) continue;
+	// slipt the tensor according to the mean contact force or a threshold value if this is given
+	const Real Fsplit        = (!math::isnan(thresholdForce)) ? thresholdForce : Fmean;
+	const auto addStrongWeak = [&](Sums& p, long k) {
+		const Interaction* I = (*scene->interactions)[k].get();
+		if (!I->isReal()) return;
 		GenericSpheresContact* geom = YADE_CAST<GenericSpheresContact*>(I->geom.get());
-		cp                          = geom->contactPoint;
-		if (!(cp[0] >= bbMin[0] && cp[0] <= bbMax[0] && cp[1] >= bbMin[1] && cp[1] <= bbMax[1] && cp[2] >= bbMin[2] && cp[2] <= bbMax[2]))
-			continue; // see above for idea about isInBB() from _utils.cpp
-		NormShearPhys*  phys = YADE_CAST<NormShearPhys*>(I->phys.get());
-		const Vector3r& n    = geom->normal;
-		Real            f    = -phys->normalForce.dot(n);
-		// slipt the tensor according to the mean contact force or a threshold value if this is given
-		Real Fsplit = (!math::isnan(thresholdForce)) ? thresholdForce : Fmean;
-		if (f < Fsplit) { // strong contact network is defined from contacts with the greatest compressive forces
-			for (int i = 0; i < 3; i++)
-				for (int j = i; j < 3; j++) {
-					fabricStrong(i, j) += n[i] * n[j];
-				}
-			nStrong++;
-		} else {
-			for (int i = 0; i < 3; i++)
-				for (int j = i; j < 3; j++) {
-					fabricWeak(i, j) += n[i] * n[j];
-				}
-			nWeak++;
-		}
-	}
+		if (!inBox(geom->contactPoint)) return;
+		NormShearPhys*  phys   = YADE_CAST<NormShearPhys*>(I->phys.get());
+		const Vector3r& n      = geom->normal;
+		Real            f      = -phys->normalForce.dot(n);
+		const bool      strong = f < Fsplit; // strong contact network is defined from contacts with the greatest compressive forces
+		Matrix3r&       target = strong ? p.a : p.b;
+		for (int i = 0; i < 3; i++)
+			for (int j = i; j < 3; j++) {
+				target(i, j) += n[i] * n[j];
+			}
+		(strong ? p.na : p.nb)++;
+	};
+	const Sums strongWeak = orderedReduce(nIntr, Sums(), addStrongWeak, sumPartials);
+	fabricStrong = strongWeak.a;
+	fabricWeak   = strongWeak.b;
+	int nStrong(strongWeak.na), nWeak(strongWeak.nb); // number of strong and weak contacts respectively
 	// fill terms under the diagonal
 	fabricStrong(1, 0) = fabricStrong(0, 1);
 	fabricStrong(2, 0) = fabricStrong(0, 2);
@@ -394,33 +412,14 @@ py::tuple Shop::fabricTensor(Real cutoff, bool splitTensor, Real thresholdForce,
 
 Matrix3r Shop::getStress(Real volume)
 {
-	Scene* scene         = Omega::instance().getScene().get();
-	Real   volumeNonPeri = 0;
+	Scene* scene = Omega::instance().getScene().get();
 	if (volume == 0 && !scene->isPeriodic) {
-		const auto extrema = Shop::aabbExtrema();
 		LOG_ONCE_WARN("getStress used with default volume tend to underestimate the stress due to overlaps on the boundaries, passing actual volume "
 		              "could be more safe.")
-		volumeNonPeri = (extrema.second[0] - extrema.first[0]) * (extrema.second[1] - extrema.first[1]) * (extrema.second[2] - extrema.first[2]);
-	}
-	if (volume == 0) volume = scene->isPeriodic ? scene->cell->hSize.determinant() : volumeNonPeri;
-	Matrix3r   stressTensor = Matrix3r::Zero();
-	const bool isPeriodic   = scene->isPeriodic;
-	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions)
-	{
-		if (!I->isReal()) continue;
-		shared_ptr<Body> b1 = Body::byId(I->getId1(), scene);
-		shared_ptr<Body> b2 = Body::byId(I->getId2(), scene);
-		if (b1->isClumpMember()) b1 = Body::byId(b1->clumpId, scene);
-		if (b2->isClumpMember()) b2 = Body::byId(b2->clumpId, scene);
-
-		if (b1->shape->getClassIndex() == GridNode::getClassIndexStatic())
-			continue; //no need to check b2 because a GridNode can only be in interaction with an oher GridNode.
-		NormShearPhys* nsi    = YADE_CAST<NormShearPhys*>(I->phys.get());
-		Vector3r       branch = b1->state->pos - b2->state->pos;
-		if (isPeriodic) branch -= scene->cell->hSize * I->cellDist.cast<Real>();
-		stressTensor += (nsi->normalForce + nsi->shearForce) * branch.transpose();
 	}
-	return stressTensor / volume;
+	// the volume is that of the cell, or of the box of spheres as aabbExtrema()
+	const GlobalStats stats = computeGlobalStats(GlobalStats::STRESS, scene);
+	return stats.stressSum / (volume == 0 ? stats.volume : volume);
 }
 
 
@@ -906,6 +905,7 @@ void Shop::growParticles(Real multiplier, bool updateMass, bool dynamicOnly)
 					// B.first is Body::id_t, B.second is local Se3r of that body in the clump
 					B.second.position *= multiplier;
 				}
+				YADE_PTR_CAST<Clump>(b->shape)->invalidateMembersCache();
 				// for clumps we are done
 				continue;
 			}
@@ -953,15 +953,24 @@ void Shop::growParticle(Body::id_t bodyID, Real multiplier, bool updateMass)
 pair<Vector3r, Vector3r> Shop::aabbExtrema(Real cutoff, bool centers)
 {
 	if (cutoff < 0. || cutoff > 1.) throw invalid_argument("Cutoff must be >=0 and <=1.");
-	Real     inf = std::numeric_limits<Real>::infinity();
-	Vector3r minimum(inf, inf, inf), maximum(-inf, -inf, -inf);
-	for (const auto& b : *Omega::instance().getScene()->bodies) {
-		shared_ptr<Sphere> s = YADE_PTR_DYN_CAST<Sphere>(b->shape);
-		if (!s) continue;
+	typedef pair<Vector3r, Vector3r> Box;
+	const Real                       inf     = std::numeric_limits<Real>::infinity();
+	const BodyContainer&             bodies  = *Omega::instance().getScene()->bodies;
+	const auto                       addBody = [&](Box& box, long i) {
+		const Body* b = bodies[i].get();
+		if (!b) return;
+		const Sphere* s = dynamic_cast<const Sphere*>(b->shape.get());
+		if (!s) return;
 		Vector3r rrr(s->radius, s->radius, s->radius);
-		minimum = minimum.cwiseMin(b->state->pos - (centers ? Vector3r::Zero() : rrr));
-		maximum = maximum.cwiseMax(b->state->pos + (centers ? Vector3r::Zero() : rrr));
-	}
+		box.first  = box.first.cwiseMin(b->state->pos - (centers ? Vector3r::Zero() : rrr));
+		box.second = box.second.cwiseMax(b->state->pos + (centers ? Vector3r::Zero() : rrr));
+	};
+	const auto combine = [](Box& r, const Box& box) {
+		r.first  = r.first.cwiseMin(box.first);
+		r.second = r.second.cwiseMax(box.second);
+	};
+	const Box                aabb = orderedReduce((long)bodies.size(), Box(Vector3r(inf, inf, inf), Vector3r(-inf, -inf, -inf)), addBody, combine);
+	const Vector3r&          minimum(aabb.first), maximum(aabb.second);
 	Vector3r                 dim = maximum - minimum;
 	pair<Vector3r, Vector3r> ret(minimum + .5 * cutoff * dim, maximum - .5 * cutoff * dim);
 	return ret;
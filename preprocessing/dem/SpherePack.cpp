@@ -1,6 +1,7 @@
 // © 2009 Václav Šmilauer <eudoxos@arcig.cz>
 
 #include <lib/base/AliasNamespaces.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <lib/high-precision/Constants.hpp>
 #include <core/Omega.hpp>
 #include <core/Scene.hpp>
@@ -8,6 +9,8 @@
 #include <pkg/common/Sphere.hpp>
 #include <preprocessing/dem/Shop.hpp>
 #include <preprocessing/dem/SpherePack.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cstring>
 #include <random>
 
 namespace yade { // Cannot have #include directive inside.
@@ -87,6 +90,77 @@ void SpherePack::toFile(const string& fname) const
 	f.close();
 };
 
+namespace {
+	const char     binaryMagic[8] = "YADESPK";
+	const uint32_t binaryVersion  = 1;
+}
+
+void SpherePack::toBinary(const string& fname) const
+{
+	std::ofstream f(fname.c_str(), std::ios::binary);
+	if (!f.good()) { throw runtime_error("Unable to open file `" + fname + "'"); }
+	BinaryHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, binaryMagic, sizeof(h.magic));
+	h.version  = binaryVersion;
+	h.periodic = (cellSize != Vector3r::Zero());
+	h.count    = pack.size();
+	for (int ax = 0; ax < 3; ax++)
+		h.cellSize[ax] = static_cast<double>(cellSize[ax]);
+	h.appliedPsdScaling = static_cast<double>(appliedPsdScaling);
+	f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	// by chunks, to keep the buffer small for large packings
+	const size_t         chunk = 1 << 16;
+	vector<BinarySphere> buf;
+	for (size_t begin = 0; begin < pack.size(); begin += chunk) {
+		const size_t end = std::min(pack.size(), begin + chunk);
+		buf.assign(end - begin, BinarySphere());
+		for (size_t i = begin; i < end; i++) {
+			BinarySphere& b = buf[i - begin];
+			for (int ax = 0; ax < 3; ax++)
+				b.c[ax] = static_cast<double>(pack[i].c[ax]);
+			b.r       = static_cast<double>(pack[i].r);
+			b.clumpId = pack[i].clumpId;
+		}
+		f.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(BinarySphere));
+	}
+	if (!f.good()) { throw runtime_error("Error writing file `" + fname + "'"); }
+}
+
+void SpherePack::fromBinary(const string& fname)
+{
+	boost::iostreams::mapped_file_source file;
+	try {
+		file.open(fname);
+	} catch (const std::exception& e) {
+		throw runtime_error("Unable to map file `" + fname + "': " + e.what());
+	}
+	BinaryHeader h;
+	if (file.size() < sizeof(h)) throw runtime_error("File `" + fname + "' is not a binary SpherePack (too short).");
+	memcpy(&h, file.data(), sizeof(h));
+	if (memcmp(h.magic, binaryMagic, sizeof(h.magic)) != 0) throw runtime_error("File `" + fname + "' is not a binary SpherePack.");
+	if (h.version != binaryVersion)
+		throw runtime_error("File `" + fname + "' has binary SpherePack version " + boost::lexical_cast<string>(h.version) + ", only version "
+		                    + boost::lexical_cast<string>(binaryVersion) + " is supported.");
+	// count is compared before multiplying, a corrupt count must not overflow the expected size
+	if (h.count > (file.size() - sizeof(h)) / sizeof(BinarySphere) || file.size() != sizeof(h) + h.count * sizeof(BinarySphere))
+		throw runtime_error("File `" + fname + "' is truncated or corrupt.");
+	const char* data = file.data() + sizeof(h);
+	const long  n    = (long)h.count;
+	pack.assign(n, Sph(Vector3r::Zero(), 0));
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long i = 0; i < n; i++) {
+		BinarySphere b;
+		memcpy(&b, data + i * sizeof(BinarySphere), sizeof(b)); // the mapping is not guaranteed to be aligned for doubles
+		pack[i] = Sph(Vector3r(b.c[0], b.c[1], b.c[2]), b.r, b.clumpId);
+	}
+	isPeriodic        = h.periodic;
+	cellSize          = h.periodic ? Vector3r(h.cellSize[0], h.cellSize[1], h.cellSize[2]) : Vector3r::Zero();
+	appliedPsdScaling = h.appliedPsdScaling;
+}
+
 void SpherePack::fromSimulation()
 {
 	pack.clear();
@@ -115,7 +189,8 @@ long SpherePack::makeCloud(
         const vector<Real>& psdCumm,
         bool                distributeMass,
         int                 seed,
-        Matrix3r            hSize)
+        Matrix3r            hSize,
+        bool                parallel)
 {
 	isPeriodic = periodic;
 
@@ -219,22 +294,19 @@ long SpherePack::makeCloud(
 	// adjust uniform distribution parameters with distributeMass; rMean has the meaning (dimensionally) of _volume_
 	const int maxTry = 1000;
 	if (periodic && volume && !hSizeFound) (cellSize = size);
-	Real r = 0;
-	for (int i = 0; (i < num) || (num < 0); i++) {
-		Real norm, rand;
-		//Determine radius of the next sphere that will be placed in space. If (num>0), generate radii the deterministic way, in decreasing order, else radii are stochastic since we don't know what the final number will be
+	// radius of the i-th sphere; if (num>0), generate radii the deterministic way, in decreasing order, else radii are stochastic since we don't know what the final number will be
+	// (drawn one by one between the positions, not largest first: sorting a pre-drawn batch would change the packing obtained with a given seed)
+	auto drawRadius = [&](long i) -> Real {
+		Real norm, rand, r = 0;
 		if (num > 0) rand = ((Real)num - (Real)i + 0.5) / ((Real)num + 1.);
 		else
 			rand = dis(gen);
-		int t;
 		switch (mode) {
 			case e_Mode::UNDEFINED:
 				throw invalid_argument(
 				        "SpherePack.makeCloud: at least one of rMean, porosity, psdSizes & psdCumm arguments must be specified. rMean can't be "
 				        "combined with psdSizes.");
 			case e_Mode::RDIST_RMEAN:
-			//FIXME : r is never defined, it will be zero at first iteration, but it will have values in the next ones.
-			//I don't understand why it apparently works. Some magic?
 			case e_Mode::RDIST_NUM:
 				if (distributeMass) r = pow3Interp(rand, rMean * (1 - rRelFuzz), rMean * (1 + rRelFuzz));
 				else
@@ -251,100 +323,404 @@ long SpherePack::makeCloud(
 				break;
 			default: throw std::runtime_error(__FILE__ " : switch default case error.");
 		}
-		// try to put the sphere into a free spot
-		for (t = 0; t < maxTry; ++t) {
-			Vector3r c = Vector3r::Zero();
-			if (!periodic) {
-				//we handle 2D with the special case size[axis]==0
-				for (int axis = 0; axis < 3; axis++) {
-					c[axis] = mn[axis] + (size[axis] ? (size[axis] - 2 * r) * dis(gen) + r : 0);
-				}
-			} else {
-				for (int axis = 0; axis < 3; axis++) {
-					c[axis] = dis(gen); //coordinates in [0,1]
+		return r;
+	};
+	// random position for a sphere of radius r
+	auto drawCenter = [&](std::mt19937& g, std::uniform_real_distribution<>& d, Real r) -> Vector3r {
+		Vector3r c = Vector3r::Zero();
+		if (!periodic) {
+			//we handle 2D with the special case size[axis]==0
+			for (int axis = 0; axis < 3; axis++) {
+				c[axis] = mn[axis] + (size[axis] ? (size[axis] - 2 * r) * d(g) + r : 0);
+			}
+		} else {
+			for (int axis = 0; axis < 3; axis++) {
+				c[axis] = d(g); //coordinates in [0,1]
+			}
+			c = hSize * c + mn; //coordinates in reference frame (inside the base cell)
+		}
+		return c;
+	};
+	// squared distance between c and sphere j (closest periodic image)
+	auto distSq = [&](const Vector3r& c, size_t j) -> Real {
+		if (!periodic) return (pack[j].c - c).squaredNorm();
+		Vector3r dr = Vector3r::Zero();
+		if (!hSizeFound) { //The box is axis-aligned, use the wrap methods
+			for (int axis = 0; axis < 3; axis++) {
+				if (size[axis]) {
+					dr[axis]
+					        = min(cellWrapRel(c[axis], pack[j].c[axis], pack[j].c[axis] + size[axis]),
+					              cellWrapRel(pack[j].c[axis], c[axis], c[axis] + size[axis]));
+				} else {
+					dr[axis] = 0;
 				}
-				c = hSize * c + mn; //coordinates in reference frame (inside the base cell)
 			}
+		} else { //not aligned, find closest neighbor in a cube of size 1, then transform distance to cartesian coordinates
+			Vector3r c1c2 = invHsize * (pack[j].c - c);
+			for (int axis = 0; axis < 3; axis++) {
+				if (math::abs(c1c2[axis]) < math::abs(c1c2[axis] - math::sign(c1c2[axis]))) dr[axis] = c1c2[axis];
+				else
+					dr[axis] = c1c2[axis] - math::sign(c1c2[axis]);
+			}
+			dr = hSize * dr; //now in cartesian coordinates
+		}
+		return dr.squaredNorm();
+	};
 
-			size_t packSize = pack.size();
-			bool   overlap  = false;
-			if (!periodic) {
-				for (size_t j = 0; j < packSize; j++) {
-					if (pow(pack[j].r + r, 2) >= (pack[j].c - c).squaredNorm()) {
-						overlap = true;
-						break;
-					}
-				}
+	// only the spheres in neighbouring cells of the grid are tested for overlap, including spheres already in the packing
+	Real rMaxPack = 0; // largest radius in the packing, to bound the distance of possible overlaps
+	for (const auto& s : pack)
+		rMaxPack = max(rMaxPack, s.r);
+	const Real rMaxNew = (mode == e_Mode::RDIST_PSD) ? psdRadii.back() : rMean * (1 + math::abs(rRelFuzz));
+	CloudGrid  grid(mn, size, hSize, periodic && hSizeFound, periodic, 2 * max(rMaxPack, rMaxNew));
+	for (size_t j = 0; j < pack.size(); j++)
+		grid.insert(j, pack[j].c);
+	auto overlaps = [&](const Vector3r& c, Real r) { return grid.anyNear(c, r + rMaxPack, [&](int j) { return pow(pack[j].r + r, 2) >= distSq(c, j); }); };
+	auto insert   = [&](const Vector3r& c, Real r) {
+                pack.push_back(Sph(c, r));
+                grid.insert(pack.size() - 1, c);
+                rMaxPack = max(rMaxPack, r);
+	};
+	// called when a sphere could not be placed after i spheres were inserted
+	auto notPlaced = [&](long i) -> long {
+		if (num > 0) {
+			if (mode != e_Mode::RDIST_RMEAN) {
+				//if rMean is not imposed, then we call makeCloud recursively,
+				//scaling the PSD down until the target num is obtained
+				Real nextPoro = porosity + (1 - porosity) / 10.;
+				LOG_WARN(
+				        "Exceeded " << maxTry << " tries to insert non-overlapping sphere to packing. Only " << i
+				                    << " spheres were added, although you requested " << num << ". Trying again with porosity " << nextPoro
+				                    << ". The size distribution is being scaled down");
+				pack.clear();
+				return makeCloud(
+				        mn,
+				        mx,
+				        -1.,
+				        rRelFuzz,
+				        num,
+				        periodic,
+				        nextPoro,
+				        psdSizes,
+				        psdCumm,
+				        distributeMass,
+				        seed,
+				        hSizeFound ? hSize : Matrix3r::Zero(),
+				        parallel);
 			} else {
-				for (size_t j = 0; j < packSize; j++) {
-					Vector3r dr = Vector3r::Zero();
-					if (!hSizeFound) { //The box is axis-aligned, use the wrap methods
-						for (int axis = 0; axis < 3; axis++) {
-							if (size[axis]) {
-								dr[axis]
-								        = min(cellWrapRel(c[axis], pack[j].c[axis], pack[j].c[axis] + size[axis]),
-								              cellWrapRel(pack[j].c[axis], c[axis], c[axis] + size[axis]));
-							} else {
-								dr[axis] = 0;
-							}
-						}
-					} else { //not aligned, find closest neighbor in a cube of size 1, then transform distance to cartesian coordinates
-						Vector3r c1c2 = invHsize * (pack[j].c - c);
-						for (int axis = 0; axis < 3; axis++) {
-							if (math::abs(c1c2[axis]) < math::abs(c1c2[axis] - math::sign(c1c2[axis]))) dr[axis] = c1c2[axis];
-							else
-								dr[axis] = c1c2[axis] - math::sign(c1c2[axis]);
-						}
-						dr = hSize * dr; //now in cartesian coordinates
-					}
-					if (pow(pack[j].r + r, 2) >= dr.squaredNorm()) {
-						overlap = true;
-						break;
-					}
-				}
+				LOG_WARN(
+				        "Exceeded " << maxTry << " tries to insert non-overlapping sphere to packing. Only " << i
+				                    << " spheres were added, although you requested " << num << ".");
 			}
-			if (!overlap) {
-				pack.push_back(Sph(c, r));
-				break;
+		}
+		return i;
+	};
+
+	if (!parallel) {
+		for (long i = 0; (i < num) || (num < 0); i++) {
+			const Real r = drawRadius(i);
+			// try to put the sphere into a free spot
+			int t;
+			for (t = 0; t < maxTry; ++t) {
+				const Vector3r c = drawCenter(gen, dis, r);
+				if (!overlaps(c, r)) {
+					insert(c, r);
+					break;
+				}
 			}
+			if (t == maxTry) return notPlaced(i);
 		}
-		if (t == maxTry) {
-			if (num > 0) {
-				if (mode != e_Mode::RDIST_RMEAN) {
-					//if rMean is not imposed, then we call makeCloud recursively,
-					//scaling the PSD down until the target num is obtained
-					Real nextPoro = porosity + (1 - porosity) / 10.;
-					LOG_WARN(
-					        "Exceeded " << maxTry << " tries to insert non-overlapping sphere to packing. Only " << i
-					                    << " spheres were added, although you requested " << num << ". Trying again with porosity "
-					                    << nextPoro << ". The size distribution is being scaled down");
-					pack.clear();
-					return makeCloud(
-					        mn,
-					        mx,
-					        -1.,
-					        rRelFuzz,
-					        num,
-					        periodic,
-					        nextPoro,
-					        psdSizes,
-					        psdCumm,
-					        distributeMass,
-					        seed,
-					        hSizeFound ? hSize : Matrix3r::Zero());
-				} else {
-					LOG_WARN(
-					        "Exceeded " << maxTry << " tries to insert non-overlapping sphere to packing. Only " << i
-					                    << " spheres were added, although you requested " << num << ".");
+	} else {
+		/* Batches of spheres look for a free spot in parallel, against the grid as it was at the beginning of the batch;
+		 * the spots found are then checked again in order against the spheres inserted in the same batch, and spheres in conflict are
+		 * tried again in the next batch. Each sphere has its own random sequence and batches have a fixed size, so that the result does
+		 * not depend on the number of threads. The radii are the same as in the sequential algorithm, the positions are not. */
+		struct Candidate {
+			long     index;
+			Real     r;
+			int      tries;
+			bool     found;
+			Vector3r c;
+		};
+		const int              batchSize = 4096;
+		const unsigned         seedBase  = (seed >= 0 ? seed : rd());
+		vector<Candidate>      batch, deferred;
+		long                   drawn = 0, inserted = 0;
+		bool                   exhausted = false;
+		while (!exhausted) {
+			while ((long)batch.size() < batchSize && (num < 0 || drawn < num)) {
+				batch.push_back(Candidate { drawn, drawRadius(drawn), 0, false, Vector3r::Zero() });
+				drawn++;
+			}
+			if (batch.empty()) break;
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+			for (long k = 0; k < (long)batch.size(); k++) {
+				Candidate&                       cand = batch[k];
+				std::seed_seq                    seq { seedBase, (unsigned)cand.index, (unsigned)cand.tries };
+				std::mt19937                     g(seq);
+				std::uniform_real_distribution<> d(0.0, 1.0);
+				cand.found = false;
+				while (cand.tries < maxTry && !cand.found) {
+					cand.c     = drawCenter(g, d, cand.r);
+					cand.found = !overlaps(cand.c, cand.r);
+					cand.tries++;
 				}
 			}
-			return i;
+			deferred.clear();
+			for (const Candidate& cand : batch) {
+				if (cand.found && !overlaps(cand.c, cand.r)) {
+					insert(cand.c, cand.r);
+					inserted++;
+				} else if (cand.tries < maxTry)
+					deferred.push_back(cand);
+				else
+					exhausted = true;
+			}
+			batch.swap(deferred);
 		}
+		if (exhausted) return notPlaced(inserted);
 	}
 	if (appliedPsdScaling < 1) LOG_WARN("The size distribution has been scaled down by a factor pack.appliedPsdScaling=" << appliedPsdScaling);
 	return pack.size();
 }
 
+Real SpherePack::makeDense(
+        Vector3r            mn,
+        Vector3r            mx,
+        Real                porosity,
+        int                 num,
+        Real                rRelFuzz,
+        bool                periodic,
+        const vector<Real>& psdSizes,
+        const vector<Real>& psdCumm,
+        bool                distributeMass,
+        int                 seed,
+        Real                tolerance,
+        int                 maxIter)
+{
+	if (num <= 0) throw invalid_argument("SpherePack.makeDense: num must be positive.");
+	if (porosity <= 0 || porosity >= 1) throw invalid_argument("SpherePack.makeDense: porosity must be in (0,1).");
+	const Vector3r size = mx - mn;
+	int            dim  = 0; // 2 for a flat box (disks of the plane), 3 otherwise
+	Real           measure(1);
+	for (int ax = 0; ax < 3; ax++) {
+		if (size[ax] < 0) throw invalid_argument("SpherePack.makeDense: max must not be smaller than min.");
+		if (size[ax] > 0) {
+			dim++;
+			measure *= size[ax];
+		}
+	}
+	if (dim < 2) throw invalid_argument("SpherePack.makeDense: the box must have non-zero size along at least two axes.");
+	pack.clear();
+	isPeriodic        = periodic;
+	cellSize          = periodic ? size : Vector3r::Zero();
+	appliedPsdScaling = 1.;
+
+	// relative radii in decreasing order, the deterministic way of makeCloud with num>0
+	vector<Real> rel(num);
+	if (psdSizes.size() > 0) {
+		if (psdSizes.size() != psdCumm.size()) throw invalid_argument("SpherePack.makeDense: psdSizes and psdCumm must have same dimensions.");
+		if (psdSizes.size() <= 1) throw invalid_argument("SpherePack.makeDense: psdSizes must have at least 2 items");
+		if ((*psdCumm.begin()) != 0. || (*psdCumm.rbegin()) != 1.)
+			throw invalid_argument("SpherePack.makeDense: first and last items of psdCumm *must* be exactly 0 and 1.");
+		vector<Real> cumm(psdCumm);
+		for (size_t i = 1; i < psdSizes.size(); i++) {
+			if (psdSizes[i - 1] >= psdSizes[i] || psdCumm[i - 1] > psdCumm[i])
+				throw invalid_argument("SpherePack.makeDense: psdSizes must be increasing and psdCumm non-decreasing.");
+			// number of spheres per piece for a mass distribution, as psdCumm2 in makeCloud (constant factors cancel in the normalization below)
+			if (distributeMass)
+				cumm[i] = cumm[i - 1]
+				        + (psdCumm[i] - psdCumm[i - 1]) / (psdSizes[i] - psdSizes[i - 1]) * (pow(psdSizes[i - 1], -2) - pow(psdSizes[i], -2));
+		}
+		if (distributeMass)
+			for (size_t i = 1; i < cumm.size(); i++)
+				cumm[i] /= cumm.back();
+		for (int i = 0; i < num; i++) {
+			Real      norm;
+			const int piece = psdGetPiece(((Real)num - (Real)i + 0.5) / ((Real)num + 1.), cumm, norm);
+			if (distributeMass) rel[i] = pow3Interp(norm, .5 * psdSizes[piece], .5 * psdSizes[piece + 1]);
+			else
+				rel[i] = .5 * (psdSizes[piece] + norm * (psdSizes[piece + 1] - psdSizes[piece]));
+		}
+	} else {
+		for (int i = 0; i < num; i++) {
+			const Real rand = ((Real)num - (Real)i + 0.5) / ((Real)num + 1.);
+			if (distributeMass) rel[i] = pow3Interp(rand, 1 - rRelFuzz, 1 + rRelFuzz);
+			else
+				rel[i] = 2 * (rand - .5) * rRelFuzz + 1;
+		}
+	}
+	// scale radii to the solid fraction 1-porosity
+	Real solid = 0;
+	for (const Real& r : rel)
+		solid += (dim == 3) ? (4 / 3.) * Mathr::PI * pow(r, 3) : Mathr::PI * pow(r, 2);
+	const Real scale = pow((1 - porosity) * measure / solid, 1. / dim);
+	if (psdSizes.size() > 0) appliedPsdScaling = scale;
+
+	// random positions, overlaps are allowed
+	std::random_device               rd;
+	std::mt19937                     gen(seed >= 0 ? seed : rd());
+	std::uniform_real_distribution<> dis(0.0, 1.0);
+	pack.reserve(num);
+	Real rMax = 0;
+	for (int i = 0; i < num; i++) {
+		const Real r = scale * rel[i];
+		Vector3r   c = mn;
+		for (int ax = 0; ax < 3; ax++)
+			if (size[ax] > 0) c[ax] += periodic ? size[ax] * dis(gen) : max(Real(0), size[ax] - 2 * r) * dis(gen) + min(r, size[ax] / 2);
+		pack.push_back(Sph(c, r));
+		rMax = max(rMax, r);
+	}
+
+	/* Collective rearrangement: every overlapping pair is pushed apart along the line of centers, the overlap being shared inversely to the volume of the spheres
+	 * (and walls push spheres back inside a non-periodic box). Displacements of all spheres are computed from the same positions (in parallel), then applied with
+	 * some over-relaxation. If the largest overlap did not decrease enough over a few iterations the packing is jammed at this porosity, and radii are reduced a bit. */
+	const Real       omega = 1.8, shrink = 0.002; // over-relaxation, 1.3 jams above 0.37 for monodisperse spheres
+	const int        checkPeriod = 100;
+	vector<Vector3r> disp(num);
+#ifdef YADE_OPENMP
+	vector<Real> threadMaxOverlap(omp_get_max_threads());
+#else
+	vector<Real> threadMaxOverlap(1);
+#endif
+	Real maxOverlap = 0, lastCheck = std::numeric_limits<Real>::infinity();
+	int  iter = 0, nShrink = 0;
+	for (; iter < maxIter; iter++) {
+		CloudGrid grid(mn, size, Matrix3r(size.asDiagonal()), false, periodic, 2 * rMax);
+		for (int i = 0; i < num; i++)
+			grid.insert(i, pack[i].c);
+		std::fill(threadMaxOverlap.begin(), threadMaxOverlap.end(), 0);
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for (int i = 0; i < num; i++) {
+#ifdef YADE_OPENMP
+			Real& thMax = threadMaxOverlap[omp_get_thread_num()];
+#else
+			Real& thMax = threadMaxOverlap[0];
+#endif
+			const Sph& si = pack[i];
+			Vector3r   d  = Vector3r::Zero();
+			grid.anyNear(si.c, si.r + rMax, [&](int j) {
+				if (j == i) return false;
+				const Sph& sj = pack[j];
+				Vector3r   dr = si.c - sj.c;
+				if (periodic)
+					for (int ax = 0; ax < 3; ax++)
+						if (size[ax] > 0) dr[ax] -= size[ax] * math::round(dr[ax] / size[ax]);
+				const Real dist    = dr.norm();
+				const Real overlap = si.r + sj.r - dist;
+				if (overlap > 0) {
+					// coincident centers: separate along the first axis of the box
+					Vector3r n = Vector3r::Zero();
+					if (dist > 0) n = dr / dist;
+					else
+						n[size[0] > 0 ? 0 : 1] = (i < j) ? 1 : -1;
+					d += overlap * pow(sj.r, 3) / (pow(si.r, 3) + pow(sj.r, 3)) * n;
+					thMax = max(thMax, overlap / min(si.r, sj.r));
+				}
+				return false;
+			});
+			if (!periodic)
+				for (int ax = 0; ax < 3; ax++) {
+					if (size[ax] == 0) continue;
+					const Real below = mn[ax] + si.r - si.c[ax], above = si.c[ax] + si.r - mx[ax];
+					if (below > 0) d[ax] += below;
+					if (above > 0) d[ax] -= above;
+					thMax = max(thMax, max(below, above) / si.r);
+				}
+			disp[i] = d;
+		}
+		maxOverlap = *std::max_element(threadMaxOverlap.begin(), threadMaxOverlap.end());
+		if (maxOverlap < tolerance) break;
+		for (int i = 0; i < num; i++) {
+			Vector3r& c = pack[i].c;
+			c += omega * disp[i];
+			if (periodic)
+				for (int ax = 0; ax < 3; ax++)
+					if (size[ax] > 0) c[ax] -= size[ax] * math::floor((c[ax] - mn[ax]) / size[ax]);
+		}
+		if (iter % checkPeriod == checkPeriod - 1) {
+			if (maxOverlap > 0.95 * lastCheck) {
+				for (auto& s : pack)
+					s.r *= 1 - shrink;
+				rMax *= 1 - shrink;
+				nShrink++;
+			}
+			lastCheck = maxOverlap;
+		}
+	}
+	Real solidNow = 0;
+	for (const auto& s : pack)
+		solidNow += (dim == 3) ? (4 / 3.) * Mathr::PI * pow(s.r, 3) : Mathr::PI * pow(s.r, 2);
+	const Real poro = 1 - solidNow / measure;
+	if (nShrink > 0) {
+		if (psdSizes.size() > 0) appliedPsdScaling = scale * pow(1 - shrink, nShrink);
+		LOG_WARN("SpherePack.makeDense: the packing jammed before porosity " << porosity << ", radii were reduced to porosity " << poro << ".");
+	}
+	if (maxOverlap >= tolerance)
+		LOG_WARN("SpherePack.makeDense: largest relative overlap is still " << maxOverlap << " after " << maxIter << " iterations (tolerance " << tolerance << ").");
+	LOG_DEBUG("SpherePack.makeDense: " << num << " spheres, porosity " << poro << " after " << iter << " iterations.");
+	return poro;
+}
+
+SpherePack::CloudGrid::CloudGrid(const Vector3r& _mn, const Vector3r& size, const Matrix3r& hSize, bool _sheared, bool _periodic, Real h)
+        : mn(_mn)
+        , invHsize(_sheared ? Matrix3r(hSize.inverse()) : Matrix3r::Identity())
+        , sheared(_sheared)
+        , periodic(_periodic)
+{
+	for (int ax = 0; ax < 3; ax++) {
+		if (sheared) scale[ax] = invHsize.row(ax).norm();
+		else
+			scale[ax] = size[ax] ? 1 / math::abs(size[ax]) : 0; // flat box (2D): one layer of cells
+	}
+	// coarsen the grid if it would be too large (tiny spheres in a large box), 2^26 cells at most
+	const Real maxCells = Real(1 << 26);
+	for (;;) {
+		for (int ax = 0; ax < 3; ax++)
+			n[ax] = (scale[ax] > 0 && h > 0) ? (int)max(Real(1), min(Real(1 << 20), math::floor(1 / (scale[ax] * h)))) : 1;
+		if (Real(n[0]) * n[1] * n[2] <= maxCells) break;
+		h *= 2;
+	}
+	head.assign(n[0] * n[1] * n[2], -1);
+}
+
+Vector3r SpherePack::CloudGrid::reduced(const Vector3r& c) const
+{
+	if (sheared) return invHsize * (c - mn);
+	return (c - mn).cwiseProduct(scale);
+}
+
+int SpherePack::CloudGrid::cellIndex(Real s, int ax) const
+{
+	// spheres given before makeCloud may lie anywhere, avoid overflowing int
+	if (periodic) return min(n[ax] - 1, (int)((s - math::floor(s)) * n[ax]));
+	return (int)math::floor(max(Real(0), min(Real(n[ax] - 1), s * n[ax])));
+}
+
+int SpherePack::CloudGrid::wrapOrClamp(int i, int ax) const
+{
+	if (periodic) {
+		i %= n[ax];
+		return i < 0 ? i + n[ax] : i;
+	}
+	return max(0, min(n[ax] - 1, i));
+}
+
+void SpherePack::CloudGrid::insert(int id, const Vector3r& c)
+{
+	const Vector3r s    = reduced(c);
+	int            cell = 0;
+	for (int ax = 0; ax < 3; ax++)
+		cell = cell * n[ax] + cellIndex(s[ax], ax);
+	if ((int)next.size() <= id) next.resize(id + 1, -1);
+	next[id]   = head[cell];
+	head[cell] = id;
+}
+
 void SpherePack::cellFill(Vector3r vol)
 {
 	Vector3i count;
@@ -358,19 +734,18 @@ void SpherePack::cellRepeat(Vector3i count)
 {
 	if (cellSize == Vector3r::Zero()) { throw std::runtime_error("cellRepeat cannot be used on non-periodic packing."); }
 	if (count[0] <= 0 || count[1] <= 0 || count[2] <= 0) { throw std::invalid_argument("Repeat count components must be positive."); }
-	size_t origSize = pack.size();
-	pack.reserve(origSize * count[0] * count[1] * count[2]);
-	for (int i = 0; i < count[0]; i++) {
-		for (int j = 0; j < count[1]; j++) {
-			for (int k = 0; k < count[2]; k++) {
-				if ((i == 0) && (j == 0) && (k == 0)) continue; // original cell
-				Vector3r off(cellSize[0] * i, cellSize[1] * j, cellSize[2] * k);
-				for (size_t l = 0; l < origSize; l++) {
-					const Sph& s = pack[l];
-					pack.push_back(Sph(s.c + off, s.r));
-				}
-			}
-		}
+	const size_t origSize = pack.size();
+	const long   nCells   = (long)count[0] * count[1] * count[2];
+	// copies are written in place, cell by cell in parallel, in the order of the (i,j,k) loops nesting
+	pack.resize(origSize * nCells, Sph(Vector3r::Zero(), 0));
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for (long cell = 1; cell < nCells; cell++) { // cell 0 is the original one
+		const int      i = (int)(cell / ((long)count[1] * count[2])), j = (int)((cell / count[2]) % count[1]), k = (int)(cell % count[2]);
+		const Vector3r off(cellSize[0] * i, cellSize[1] * j, cellSize[2] * k);
+		for (size_t l = 0; l < origSize; l++)
+			pack[cell * origSize + l] = Sph(pack[l].c + off, pack[l].r);
 	}
 	cellSize = Vector3r(cellSize[0] * count[0], cellSize[1] * count[1], cellSize[2] * count[2]);
 }
@@ -13,12 +13,75 @@ class SpherePack {
 	// copied from PeriodicInsertionSortCollider
 	Real cellWrapRel(const Real x, const Real x0, const Real x1) const;
 	Real periPtDistSq(const Vector3r& p1, const Vector3r& p2) const;
+	struct BinaryHeader {
+		char     magic[8]; // "YADESPK" and a null byte
+		uint32_t version;
+		uint32_t periodic;
+		uint64_t count;
+		double   cellSize[3];
+		double   appliedPsdScaling;
+		char     reserved[8];
+	};
+	struct BinarySphere {
+		double  c[3];
+		double  r;
+		int32_t clumpId;
+		int32_t reserved;
+	};
+	static_assert(sizeof(BinaryHeader) == 64 && sizeof(BinarySphere) == 40, "SpherePack binary records must not be padded.");
 	struct ClumpInfo {
 		int      clumpId;
 		Vector3r center;
 		Real     rad;
 		int      minId, maxId;
 	};
+	/* Uniform grid over the box (or periodic cell) where spheres are generated, used to find the neighbours of a candidate position.
+	 * Cells are regular in reduced coordinates (box or cell mapped to the unit cube); each cell holds a chain of sphere indices (head/next),
+	 * so that insertion is O(1) and storage is one int per cell and per sphere. */
+	class CloudGrid {
+		Vector3r         mn;
+		Matrix3r         invHsize;
+		bool             sheared, periodic;
+		Vector3r         scale; // norm of rows of invHsize (reduced length per unit length)
+		Vector3i         n;     // number of cells along each reduced axis
+		vector<int>      head, next;
+		Vector3r         reduced(const Vector3r& c) const;
+		int              cellIndex(Real s, int ax) const; // index of the cell containing reduced coordinate s along ax
+		int              wrapOrClamp(int i, int ax) const;
+
+	public:
+		// h is the smallest width of cells, typically the largest diameter of the spheres
+		CloudGrid(const Vector3r& mn, const Vector3r& size, const Matrix3r& hSize, bool sheared, bool periodic, Real h);
+		void insert(int id, const Vector3r& c);
+		// call f(j) for every sphere j that may be closer than dist to c (a superset of them), stop and return true as soon as f returns true
+		template <class F> bool anyNear(const Vector3r& c, Real dist, F f) const
+		{
+			const Vector3r s = reduced(c);
+			int            lo[3], hi[3];
+			for (int ax = 0; ax < 3; ax++) {
+				const int q = cellIndex(s[ax], ax);
+				const int k = (int)math::ceil(dist * scale[ax] * n[ax]);
+				if (periodic && 2 * k + 1 >= n[ax]) {
+					lo[ax] = 0;
+					hi[ax] = n[ax] - 1;
+				} else if (periodic) {
+					lo[ax] = q - k;
+					hi[ax] = q + k;
+				} else {
+					lo[ax] = math::max(0, q - k);
+					hi[ax] = math::min(n[ax] - 1, q + k);
+				}
+			}
+			for (int i = lo[0]; i <= hi[0]; i++)
+				for (int j = lo[1]; j <= hi[1]; j++)
+					for (int k = lo[2]; k <= hi[2]; k++) {
+						const int cell = (wrapOrClamp(i, 0) * n[1] + wrapOrClamp(j, 1)) * n[2] + wrapOrClamp(k, 2);
+						for (int id = head[cell]; id >= 0; id = next[id])
+							if (f(id)) return true;
+					}
+			return false;
+		}
+	};
 
 public:
 	enum class e_Mode { UNDEFINED, RDIST_RMEAN, RDIST_NUM, RDIST_PSD };
@@ -55,9 +118,13 @@ public:
 	boost::python::list toList() const;
 	void                fromFile(const string& file);
 	void                toFile(const string& file) const;
+	// binary format: BinaryHeader followed by BinarySphere records (little-endian doubles), loaded through a memory-mapped file
+	void fromBinary(const string& file);
+	void toBinary(const string& file) const;
 	void                fromSimulation();
 
 	// random generation; if num<0, insert as many spheres as possible; if porosity>0, recompute meanRadius (porosity>0.65 recommended) and try generating this porosity with num spheres.
+	// if parallel, candidate positions are searched by batches of spheres in parallel, then inserted in order if they do not overlap spheres inserted meanwhile.
 	long makeCloud(
 	        Vector3r            min,
 	        Vector3r            max,
@@ -70,7 +137,23 @@ public:
 	        const vector<Real>& psdCumm        = vector<Real>(),
 	        bool                distributeMass = false,
 	        int                 seed           = 0,
-	        Matrix3r            hSize          = Matrix3r::Zero());
+	        Matrix3r            hSize          = Matrix3r::Zero(),
+	        bool                parallel       = false);
+	// dense random packing of num spheres by collective rearrangement: spheres are given the radii matching porosity and random positions, then pushed apart until
+	// overlaps are below tolerance (relative to radii); radii are reduced if the packing jams before. Replaces current data, returns the porosity obtained.
+	Real makeDense(
+	        Vector3r            min,
+	        Vector3r            max,
+	        Real                porosity,
+	        int                 num,
+	        Real                rRelFuzz       = 0,
+	        bool                periodic       = false,
+	        const vector<Real>& psdSizes       = vector<Real>(),
+	        const vector<Real>& psdCumm        = vector<Real>(),
+	        bool                distributeMass = false,
+	        int                 seed           = -1,
+	        Real                tolerance      = 1e-3,
+	        int                 maxIter        = 20000);
 	// return number of piece for x in piecewise function defined by cumm with non-decreasing elements ∈(0,1)
 	// norm holds normalized coordinate withing the piece
 	int psdGetPiece(Real x, const vector<Real>& cumm, Real& norm) const;
@@ -91,7 +91,8 @@ py::tuple interactionAnglesHistogram(int axis, int mask, size_t bins, py::tuple
 		if (nLen < minProjLen) continue; // this interaction is (almost) exactly parallel to our axis; skip that one
 		Real theta = acos(n[axis2] / nLen) * (n[axis3] > 0 ? 1 : -1);
 		if (theta < 0) theta += Mathr::PI;
-		int binNo = int(math::round(theta / binStep));
+		// bins are centered on binMid, theta close to π falls in the bin of 0
+		size_t binNo = size_t(math::round(theta / binStep)) % bins;
 		cummProj[binNo] += nLen;
 	}
 	py::list val, binMid;
@@ -414,6 +415,75 @@ py::object Shop__kineticEnergy(bool findMaxId)
 	Real       E = Shop::kineticEnergy(NULL, &maxId);
 	return py::make_tuple(E, maxId);
 }
+void     Shop__invalidateGlobalStats() { Shop::invalidateGlobalStats(); }
+py::dict Shop__globalStats(py::list what, bool useCache)
+{
+	typedef Shop::GlobalStats GS;
+	int                       mask = 0;
+	for (int i = 0; i < py::len(what); i++) {
+		const string w = py::extract<string>(what[i]);
+		if (w == "all") mask |= GS::ALL;
+		else if (w == "unbalancedForce")
+			mask |= GS::UNBALANCED_FORCE;
+		else if (w == "kineticEnergy")
+			mask |= GS::KINETIC_ENERGY;
+		else if (w == "stress")
+			mask |= GS::STRESS;
+		else if (w == "fabric")
+			mask |= GS::FABRIC;
+		else if (w == "normalShear")
+			mask |= GS::NORMAL_SHEAR;
+		else if (w == "fabricSplit")
+			mask |= GS::FABRIC_SPLIT;
+		else if (w == "coordination")
+			mask |= GS::COORDINATION;
+		else if (w == "coordHistogram")
+			mask |= GS::COORD_HISTOGRAM;
+		else if (w == "angleHistogram")
+			mask |= GS::ANGLE_HISTOGRAM;
+		else
+			throw std::invalid_argument(
+			        "Unknown statistics `" + w
+			        + "' (supported are: all, unbalancedForce, kineticEnergy, stress, fabric, normalShear, fabricSplit, coordination, coordHistogram, "
+			          "angleHistogram).");
+	}
+	if (!mask) mask = GS::ALL;
+	const GS s = Shop::globalStats(mask, useCache);
+	py::dict ret;
+	if (mask & GS::UNBALANCED_FORCE) {
+		ret["unbalancedForce"]    = s.unbalancedForce;
+		ret["unbalancedForceMax"] = s.unbalancedForceMax;
+	}
+	if (mask & GS::KINETIC_ENERGY) {
+		ret["kineticEnergy"] = s.kineticEnergy;
+		ret["maxEnergyId"]   = s.maxEnergyId;
+	}
+	if (mask & GS::STRESS) ret["stress"] = s.stress;
+	if (mask & GS::FABRIC) {
+		ret["fabric"]          = s.fabric;
+		ret["meanNormalForce"] = s.meanNormalForce;
+	}
+	if (mask & GS::NORMAL_SHEAR) {
+		ret["normalStress"] = s.normalStress;
+		ret["shearStress"]  = s.shearStress;
+	}
+	if (mask & GS::FABRIC_SPLIT) {
+		ret["fabricStrong"] = s.fabricStrong;
+		ret["fabricWeak"]   = s.fabricWeak;
+	}
+	if (mask & (GS::COORDINATION | GS::COORD_HISTOGRAM)) {
+		ret["contacts"]  = s.contacts;
+		ret["particles"] = s.particles;
+	}
+	if (mask & GS::COORDINATION) {
+		ret["coordination"]           = s.coordination;
+		ret["mechanicalCoordination"] = s.mechanicalCoordination;
+	}
+	if (mask & GS::COORD_HISTOGRAM) ret["coordHistogram"] = s.coordHistogram;
+	if (mask & GS::ANGLE_HISTOGRAM) ret["angleHistogram"] = s.angleHistogram;
+	if (mask & (GS::STRESS | GS::NORMAL_SHEAR)) ret["volume"] = s.volume;
+	return ret;
+}
 
 Real maxOverlapRatio()
 {
@@ -659,13 +729,24 @@ try {
 	        "Compute the ratio of mean (or maximum, if *useMaxForce*) summary force on bodies and mean force magnitude on interactions. For perfectly "
 	        "static equilibrium, summary force on all bodies is zero (since forces from interactions cancel out and induce no acceleration of particles); "
 	        "this ratio will tend to zero as simulation stabilizes, though zero is never reached because of finite precision computation. Sufficiently "
-	        "small value can be e.g. 1e-2 or smaller, depending on how much equilibrium it should be.");
+	        "small value can be e.g. 1e-2 or smaller, depending on how much equilibrium it should be. The mean interaction force is averaged over all real "
+	        "interactions (those without :yref:`NormShearPhys` counting as zero force); the result is NaN if there are no dynamic bodies or no real interactions.");
 	py::def("kineticEnergy",
 	        Shop__kineticEnergy,
 	        (py::args("findMaxId") = false),
 	        "Compute overall kinetic energy of the simulation as\n\n.. math:: "
 	        "\\sum\\frac{1}{2}\\left(m_i\\vec{v}_i^2+\\vec{\\omega}(\\mat{I}\\vec{\\omega}^T)\\right).\n\nFor :yref:`aspherical<Body.aspherical>` bodies, "
 	        "necessary frame transformations are applied to the inertia tensor $\\mat{I}$ as stored in :yref:`state.inertia<State.inertia>`.\n");
+	py::def("globalStats",
+	        Shop__globalStats,
+	        (py::args("what") = py::list(), py::args("useCache") = true),
+	        R"""(Compute several global quantities together, with one parallel pass over bodies and one over interactions, and return them in a dict. The results do not depend on the number of threads.
+
+:param list what: quantities to compute, among ``unbalancedForce`` (keys ``unbalancedForce`` and ``unbalancedForceMax``, as :yref:`yade._utils.unbalancedForce` with and without ``useMaxForce``), ``kineticEnergy`` (keys ``kineticEnergy`` and ``maxEnergyId``, as :yref:`yade._utils.kineticEnergy`), ``stress`` (key ``stress``, as :yref:`yade._utils.getStress` with the default volume), ``fabric`` (keys ``fabric`` and ``meanNormalForce``, as :yref:`yade._utils.fabricTensor` with default arguments and its ``Fmean``), ``normalShear`` (keys ``normalStress`` and ``shearStress``, as :yref:`yade._utils.normalShearStressTensors` with default arguments, but also for aperiodic simulations), ``fabricSplit`` (keys ``fabricStrong`` and ``fabricWeak``, as :yref:`yade._utils.fabricTensor` with ``splitTensor=True``), ``coordination`` (keys ``coordination`` and ``mechanicalCoordination``, as :yref:`yade.utils.avgNumInteractions` with ``considerClumps=True``, with or without ``skipFree``, and the numbers of ``contacts`` and ``particles``), ``coordHistogram`` (key ``coordHistogram``, the numbers of particles with 0, 1, … 12 and more contacts), ``angleHistogram`` (key ``angleHistogram``, as :yref:`yade._utils.interactionAnglesHistogram` with ``axis=2`` and ``bins=18``), or ``all`` (also if the list is empty). The volume used for stresses is returned as ``volume``: that of the periodic cell, or of the axis-aligned box of spheres.
+:param bool useCache: reuse the quantities already computed for the same scene, so that several checks of a :yref:`PyRunner` cost one traversal. The cached values are discarded whenever the simulation loop runs an engine; after changing bodies or forces from python while the simulation is stopped, call :yref:`yade._utils.invalidateGlobalStats` or pass ``False``.)""");
+	py::def("invalidateGlobalStats",
+	        Shop__invalidateGlobalStats,
+	        "Discard the values cached by :yref:`yade._utils.globalStats`; needed after changing bodies or forces from python at the same step.");
 	py::def("sumForces",
 	        sumForces,
 	        (py::arg("ids"), py::arg("direction")),
@@ -878,6 +959,16 @@ try {
 	py::def("TetrahedronInertiaTensor", TetrahedronInertiaTensor, "TODO");
 	py::def("TetrahedronCentralInertiaTensor", TetrahedronCentralInertiaTensor, "TODO");
 	py::def("TetrahedronWithLocalAxesPrincipal", TetrahedronWithLocalAxesPrincipal, "TODO");
+	py::def("TetraSeparatingAxis",
+	        TetraSeparatingAxis,
+	        (py::arg("a"), py::arg("b"), py::arg("cached") = -1),
+	        "Index of an axis separating the tetrahedra of vertices *a* and *b* (global coordinates) as found by the separating axis test of the "
+	        "Tetra functors, the axis *cached* being tested first; -1 if there is none.");
+	py::def("TetraIntersectionVolume",
+	        TetraIntersectionVolume,
+	        (py::arg("a"), py::arg("b")),
+	        "Volume of the intersection of the tetrahedra of vertices *a* and *b* (global coordinates), as computed by "
+	        ":yref:`Ig2_Tetra_Tetra_TTetraGeom` after the separating axis test.");
 	py::def("momentum", Shop::momentum, "TODO");
 	py::def("angularMomentum", Shop::angularMomentum, (py::args("origin") = Vector3r(Vector3r::Zero())), "TODO");
 	py::def("getSpheresVolume2D",
@@ -934,7 +1025,7 @@ try {
 		"Converts spherical coordinates to cartesian ones.\n\n:param Vector3 vec: the $(r,\\theta,\\phi)$ spherical coordinates, see cart2spher function for conventions\n:return: a $(x,y,z)$ Vector3 of cartesian coordinates");
 	py::def("lsSimpleShape",
 		ShopLS::lsSimpleShape,
-		(py::arg("shape"),py::arg("aabb"),py::arg("step")=0.1,py::arg("smearCoeff")=1.5,py::arg("epsilons")=Vector2r(Vector2r::Zero()),py::arg("clump")=boost::make_shared<Clump>()), // Vector*r(Vector*r::Zero()) is actually necessary for to-Python conversion to work (and YADE to start)
+		(py::arg("shape"),py::arg("aabb"),py::arg("step")=0.1,py::arg("smearCoeff")=1.5,py::arg("epsilons")=Vector2r(Vector2r::Zero()),py::arg("clump")=boost::make_shared<Clump>(),py::arg("fastSweeping")=false,py::arg("useCache")=false), // Vector*r(Vector*r::Zero()) is actually necessary for to-Python conversion to work (and YADE to start)
 		R"""(Creates a LevelSet shape among pre-defined ones. Not intended to be used directly, see levelSetBody() instead.
 
 :param int shape: a shape index among supported choices
@@ -943,7 +1034,10 @@ try {
 :param Real smearCoeff: passed to LevelSet.smearCoeff
 :param Vector2 epsilons: the epsilon exponents in case *shape* = 3 (superellipsoid)
 :param Clump clump: the Clump instance to mimick in case *shape* = 4
+:param bool fastSweeping: use the parallel fast sweeping method instead of the FMM for *shape* = 3 or 4, see :yref:`FastMarchingMethod.fastSweeping`
+:param bool useCache: whether to reuse the grid and distance field of a previous call with the same *shape*, *aabb*, *step*, *epsilons* and *fastSweeping* (the returned shapes then share one :yref:`lsGrid<LevelSet.lsGrid>`), or the FMM solution of an identical clump. The 16 most recently used shapes (and FMM solutions) are kept, see lsClearCache()
 :return: a LevelSet instance.)""");
+	py::def("lsClearCache",ShopLS::clearLsCache,"Empties the cache of grids and distance fields of lsSimpleShape(), together with the one of :yref:`FastMarchingMethod` solutions.");
  // NB: the rest of the code makes a mixed use of py::arg and py::args, Boost doc does not really help for this https://www.boost.org/doc/libs/1_67_0/libs/python/doc/html/reference/function_invocation_and_creation.html#function_invocation_and_creation.boost_python_args_hpp, see /usr/include/boost/python/args.hpp if you wish...
 //	NB for the two following nGP: see overloading comments in ShopLS.hpp.
 	py::def("nGP",
@@ -10,6 +10,7 @@ from builtins import range
 from builtins import object
 from yade.wrapper import *
 from yade import utils, Matrix3, Vector3
+import os
 
 
 #textExt===============================================================
@@ -1087,6 +1088,80 @@ class VTKExporter(object):
 		self.PotentialBlocksSnapCount += 1
 
 
+#SeriesReader===============================================================
+class SeriesReader(object):
+	"""Reader of the time series files written by :yref:`SeriesRecorder` and :yref:`InSituStatsEngine`. Opening the file only reads the headers of the chunks; the values of a field are read
+	(or memory-mapped, for files written without :yref:`compression<SeriesRecorder.compress>`) when the field is requested.
+
+	USAGE:
+	reader = SeriesReader('run.ser')
+	reader.iterations  # iterations of the recorded steps
+	pos = reader.field('pos')  # list of arrays of shape (n,3), one per step
+	reader.stacked('radius')  # array of shape (steps,n), if n is the same at all steps
+	"""
+
+	def __init__(self, fileName):
+		import struct
+		self.fileName = fileName
+		self.chunks = {}  # name: [(dtype, components, iterations, rowOffsets, compressed, valuesOffset, storedSize), ...]
+		chunkHeader = struct.Struct('<4sIIIIIQQQ32s')
+		with open(fileName, 'rb') as f:
+			head = f.read(16)
+			if len(head) < 16 or head[:8] != b'YADESER\0':
+				raise RuntimeError('%s is not a SeriesRecorder file' % fileName)
+			if struct.unpack('<I', head[8:12])[0] != 1:
+				raise RuntimeError('%s: unsupported version %d' % (fileName, struct.unpack('<I', head[8:12])[0]))
+			pos = 16
+			while True:
+				head = f.read(chunkHeader.size)
+				if len(head) < chunkHeader.size: break  # end of file, or a chunk being written
+				magic, headerSize, dtype, components, nSteps, compressed, rows, storedSize, rawSize, name = chunkHeader.unpack(head)
+				if magic != b'CHNK': raise RuntimeError('%s: corrupted chunk at byte %d' % (fileName, pos))
+				steps = f.read(8 * (2 * nSteps + 1))
+				if len(steps) < 8 * (2 * nSteps + 1) or pos + headerSize + storedSize > os.fstat(f.fileno()).st_size: break
+				iterations = struct.unpack('<%dq' % nSteps, steps[:8 * nSteps])
+				rowOffsets = struct.unpack('<%dq' % (nSteps + 1), steps[8 * nSteps:])
+				name = name.split(b'\0')[0].decode()
+				self.chunks.setdefault(name, []).append(('<f8' if dtype == 0 else '<i8', components, iterations, rowOffsets, compressed, pos + headerSize, storedSize))
+				pos += headerSize + storedSize + (-storedSize) % 8
+				f.seek(pos)
+
+	def fields(self):
+		"""Names of the recorded fields."""
+		return sorted(self.chunks.keys())
+
+	@property
+	def iterations(self):
+		"""Iterations of the recorded steps."""
+		return [it for chunk in self.chunks.get('time', []) for it in chunk[2]]
+
+	def field(self, name):
+		"""Values of field *name* at all recorded steps, as a list of arrays with one row per sphere (or contact), of shape (rows,) for scalars or
+		(rows,components) otherwise. They are views of memory-mapped chunks if the file is not compressed."""
+		import numpy, zlib
+		if name not in self.chunks: raise KeyError('%s: no field %s (fields are: %s)' % (self.fileName, name, ', '.join(self.fields())))
+		ret = []
+		with open(self.fileName, 'rb') as f:
+			for dtype, components, iterations, rowOffsets, compressed, valuesOffset, storedSize in self.chunks[name]:
+				count = rowOffsets[-1] * components
+				if count == 0:
+					values = numpy.zeros(0, dtype=dtype)
+				elif compressed:
+					f.seek(valuesOffset)
+					values = numpy.frombuffer(zlib.decompress(f.read(storedSize)), dtype=dtype, count=count)
+				else:
+					values = numpy.memmap(self.fileName, dtype=dtype, mode='r', offset=valuesOffset, shape=(count, ))
+				for k in range(len(iterations)):
+					v = values[rowOffsets[k] * components:rowOffsets[k + 1] * components]
+					ret.append(v if components == 1 else v.reshape(-1, components))
+		return ret
+
+	def stacked(self, name):
+		"""Values of field *name* as one array of shape (steps,rows) or (steps,rows,components); the number of rows must be the same at all steps."""
+		import numpy
+		return numpy.stack(self.field(name))
+
+
 #gmshGeoExport===============================================================
 def gmshGeo(filename, comment='', mask=-1, accuracy=-1):
 	"""Save spheres in geo-file for the following using in GMSH (http://www.geuz.org/gmsh/doc/texinfo/) program. The spheres can be there meshed.
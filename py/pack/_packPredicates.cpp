@@ -2,7 +2,9 @@
 #include <lib/base/AliasNamespaces.hpp>
 #include <lib/base/Logging.hpp>
 #include <lib/base/Math.hpp>
+#include <lib/base/openmp-accu.hpp>
 #include <lib/pyutil/doc_opts.hpp>
+#include <preprocessing/dem/SpherePack.hpp>
 
 CREATE_CPP_LOCAL_LOGGER("_packPredicates.cpp");
 
@@ -15,6 +17,10 @@ Besides the (point,pad) operator, each predicate defines aabb() method that retu
 (min,max) tuple defining minimum and maximum point of axis-aligned bounding box 
 for the predicate.
 
+Predicates implemented here (and their boolean combinations) never call back into python when
+evaluated, they are "compiled": filter() evaluates them for a whole SpherePack in parallel,
+without the GIL. Predicates defined in python (subclasses of Predicate) are evaluated serially.
+
 These classes are primarily used for yade.pack.* functions creating packings.
 See examples/regular-sphere-pack/regular-sphere-pack.py for an example.
 
@@ -33,6 +39,7 @@ struct Predicate {
 public:
 	virtual bool      operator()(const Vector3r& pt, Real pad = 0.) const = 0;
 	virtual py::tuple aabb() const                                        = 0;
+	virtual bool      compiled() const { return true; } // false if evaluation calls python code
 	Vector3r          dim() const
 	{
 		Vector3r mn, mx;
@@ -51,6 +58,7 @@ public:
 struct PredicateWrap : Predicate, py::wrapper<Predicate> {
 	bool      operator()(const Vector3r& pt, Real pad = 0.) const override { return this->get_override("__call__")(pt, pad); }
 	py::tuple aabb() const override { return this->get_override("aabb")(); }
+	bool      compiled() const override { return false; }
 };
 
 /*********************************************************************************
@@ -62,15 +70,21 @@ const Predicate& obj2pred(py::object obj) { return py::extract<const Predicate&>
 class PredicateBoolean : public Predicate {
 protected:
 	const py::object A, B;
+	// the C++ objects held by A and B, extracted once so that evaluating the tree does not go through python
+	const Predicate* a;
+	const Predicate* b;
 
 public:
 	PredicateBoolean(const py::object _A, const py::object _B)
 	        : A(_A)
 	        , B(_B)
+	        , a(&obj2pred(_A))
+	        , b(&obj2pred(_B))
 	{
 	}
 	const py::object getA() { return A; }
 	const py::object getB() { return B; }
+	bool             compiled() const override { return a->compiled() && b->compiled(); }
 };
 
 // http://www.linuxtopia.org/online_books/programming_books/python_programming/python_ch16s03.html
@@ -80,12 +94,12 @@ public:
 	        : PredicateBoolean(_A, _B)
 	{
 	}
-	bool      operator()(const Vector3r& pt, Real pad) const override { return obj2pred(A)(pt, pad) || obj2pred(B)(pt, pad); }
+	bool      operator()(const Vector3r& pt, Real pad) const override { return (*a)(pt, pad) || (*b)(pt, pad); }
 	py::tuple aabb() const override
 	{
 		Vector3r minA, maxA, minB, maxB;
-		ttuple2vvec(obj2pred(A).aabb(), minA, maxA);
-		ttuple2vvec(obj2pred(B).aabb(), minB, maxB);
+		ttuple2vvec(a->aabb(), minA, maxA);
+		ttuple2vvec(b->aabb(), minB, maxB);
 		return vvec2tuple(minA.cwiseMin(minB), maxA.cwiseMax(maxB));
 	}
 };
@@ -97,12 +111,12 @@ public:
 	        : PredicateBoolean(_A, _B)
 	{
 	}
-	bool      operator()(const Vector3r& pt, Real pad) const override { return obj2pred(A)(pt, pad) && obj2pred(B)(pt, pad); }
+	bool      operator()(const Vector3r& pt, Real pad) const override { return (*a)(pt, pad) && (*b)(pt, pad); }
 	py::tuple aabb() const override
 	{
 		Vector3r minA, maxA, minB, maxB;
-		ttuple2vvec(obj2pred(A).aabb(), minA, maxA);
-		ttuple2vvec(obj2pred(B).aabb(), minB, maxB);
+		ttuple2vvec(a->aabb(), minA, maxA);
+		ttuple2vvec(b->aabb(), minB, maxB);
 		return vvec2tuple(minA.cwiseMax(minB), maxA.cwiseMin(maxB));
 	}
 };
@@ -114,8 +128,8 @@ public:
 	        : PredicateBoolean(_A, _B)
 	{
 	}
-	bool      operator()(const Vector3r& pt, Real pad) const override { return obj2pred(A)(pt, pad) && !obj2pred(B)(pt, -pad); }
-	py::tuple aabb() const override { return obj2pred(A).aabb(); }
+	bool      operator()(const Vector3r& pt, Real pad) const override { return (*a)(pt, pad) && !(*b)(pt, -pad); }
+	py::tuple aabb() const override { return a->aabb(); }
 };
 PredicateDifference makeDifference(const py::object& A, const py::object& B) { return PredicateDifference(A, B); }
 
@@ -127,14 +141,14 @@ public:
 	}
 	bool operator()(const Vector3r& pt, Real pad) const override
 	{
-		bool inA = obj2pred(A)(pt, pad), inB = obj2pred(B)(pt, pad);
+		bool inA = (*a)(pt, pad), inB = (*b)(pt, pad);
 		return (inA && !inB) || (!inA && inB);
 	}
 	py::tuple aabb() const override
 	{
 		Vector3r minA, maxA, minB, maxB;
-		ttuple2vvec(obj2pred(A).aabb(), minA, maxA);
-		ttuple2vvec(obj2pred(B).aabb(), minB, maxB);
+		ttuple2vvec(a->aabb(), minA, maxA);
+		ttuple2vvec(b->aabb(), minB, maxB);
 		return vvec2tuple(minA.cwiseMin(minB), maxA.cwiseMax(maxB));
 	}
 };
@@ -389,6 +403,199 @@ public:
 	}
 };
 
+/*! Spheres of the packing inside the predicate, with their radius as pad.
+
+Compiled predicates are evaluated in parallel with the GIL released, others sphere by sphere. */
+SpherePack filterSpherePack(const Predicate& pred, const SpherePack& sp)
+{
+	const long        n = (long)sp.pack.size();
+	std::vector<char> inside(n);
+	if (pred.compiled()) {
+		Py_BEGIN_ALLOW_THREADS;
+#ifdef YADE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+		for (long i = 0; i < n; i++)
+			inside[i] = pred(sp.pack[i].c, sp.pack[i].r);
+		Py_END_ALLOW_THREADS;
+	} else {
+		for (long i = 0; i < n; i++)
+			inside[i] = pred(sp.pack[i].c, sp.pack[i].r);
+	}
+	SpherePack ret;
+	for (long i = 0; i < n; i++)
+		if (inside[i]) ret.pack.push_back(SpherePack::Sph(sp.pack[i].c, sp.pack[i].r));
+	return ret;
+}
+
+/* Bounding volume hierarchy over the triangles of a closed surface, for point inclusion and distance queries.
+Nodes are split at the median of triangle centroids along their longest extent and stored depth-first: the first child of an inner node is the next
+node, the second one is at Node::second. Triangles are stored by leaf, 3 vertices each. */
+class TriangleBvh {
+	struct Node {
+		Vector3r mn, mx;
+		int      first, count; // triangles of a leaf (count>0)
+		int      second;       // second child of an inner node
+	};
+	static const int        leafSize = 4, maxDepth = 64;
+	vector<Vector3r>        tri;
+	vector<Node>            nodes;
+	vector<Vector3r>        centroids; // centroids, order and src are used while building only
+	vector<int>             order;
+	const vector<Vector3r>* src;
+
+	void build(int begin, int end)
+	{
+		const int node = (int)nodes.size();
+		nodes.push_back(Node());
+		Real     inf = std::numeric_limits<Real>::infinity();
+		Vector3r mn(inf, inf, inf), mx(-inf, -inf, -inf), cMn(mn), cMx(mx);
+		for (int i = begin; i < end; i++) {
+			for (int k = 0; k < 3; k++) {
+				mn = mn.cwiseMin((*src)[3 * order[i] + k]);
+				mx = mx.cwiseMax((*src)[3 * order[i] + k]);
+			}
+			cMn = cMn.cwiseMin(centroids[order[i]]);
+			cMx = cMx.cwiseMax(centroids[order[i]]);
+		}
+		nodes[node].mn = mn;
+		nodes[node].mx = mx;
+		if (end - begin <= leafSize) {
+			nodes[node].first = (int)tri.size() / 3;
+			nodes[node].count = end - begin;
+			for (int i = begin; i < end; i++)
+				for (int k = 0; k < 3; k++)
+					tri.push_back((*src)[3 * order[i] + k]);
+			return;
+		}
+		int ax;
+		(cMx - cMn).maxCoeff(&ax);
+		const int mid = (begin + end) / 2;
+		std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](int i, int j) {
+			return centroids[i][ax] < centroids[j][ax];
+		});
+		nodes[node].count = 0;
+		build(begin, mid);
+		nodes[node].second = (int)nodes.size();
+		build(mid, end);
+	}
+	static Real boxDistSq(const Node& nd, const Vector3r& p)
+	{
+		return (nd.mn - p).cwiseMax(p - nd.mx).cwiseMax(Vector3r::Zero()).squaredNorm();
+	}
+	// squared distance from p to triangle abc (Ericson, Real-Time Collision Detection, 5.1.5)
+	static Real triDistSq(const Vector3r& p, const Vector3r& a, const Vector3r& b, const Vector3r& c)
+	{
+		const Vector3r ab = b - a, ac = c - a, ap = p - a;
+		const Real     d1 = ab.dot(ap), d2 = ac.dot(ap);
+		if (d1 <= 0 && d2 <= 0) return ap.squaredNorm();
+		const Vector3r bp = p - b;
+		const Real     d3 = ab.dot(bp), d4 = ac.dot(bp);
+		if (d3 >= 0 && d4 <= d3) return bp.squaredNorm();
+		const Real vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) return (ap - d1 / (d1 - d3) * ab).squaredNorm();
+		const Vector3r cp = p - c;
+		const Real     d5 = ab.dot(cp), d6 = ac.dot(cp);
+		if (d6 >= 0 && d5 <= d6) return cp.squaredNorm();
+		const Real vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) return (ap - d2 / (d2 - d6) * ac).squaredNorm();
+		const Real va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return (bp - (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b)).squaredNorm();
+		const Real denom = 1 / (va + vb + vc);
+		return (ap - ab * (vb * denom) - ac * (vc * denom)).squaredNorm();
+	}
+	// number of crossings of the ray p+t*d (t>0) with the surface, -1 if the ray passes too close to an edge or a vertex to be counted reliably
+	int crossings(const Vector3r& p, const Vector3r& d) const
+	{
+		const Real     tol = 1e-9;
+		const Vector3r invD(1 / d[0], 1 / d[1], 1 / d[2]);
+		int            stack[maxDepth], top = 0, ret = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const int   i  = stack[--top];
+			const Node& nd = nodes[i];
+			// slab test, the directions have no zero component
+			const Vector3r t1 = (nd.mn - p).cwiseProduct(invD), t2 = (nd.mx - p).cwiseProduct(invD);
+			if (t1.cwiseMax(t2).minCoeff() < math::max(Real(0), t1.cwiseMin(t2).maxCoeff())) continue;
+			if (nd.count == 0) {
+				stack[top++] = nd.second;
+				stack[top++] = i + 1;
+				continue;
+			}
+			for (int t = nd.first; t < nd.first + nd.count; t++) {
+				// Möller-Trumbore
+				const Vector3r &a = tri[3 * t], e1 = tri[3 * t + 1] - a, e2 = tri[3 * t + 2] - a;
+				const Vector3r  pv  = d.cross(e2);
+				const Real      det = e1.dot(pv);
+				if (math::abs(det) <= tol * e1.norm() * e2.norm()) continue; // ray parallel to the triangle
+				const Vector3r tv = p - a, qv = tv.cross(e1);
+				const Real     u = tv.dot(pv) / det, v = d.dot(qv) / det, t0 = e2.dot(qv) / det;
+				if (t0 <= 0 || u < -tol || v < -tol || u + v > 1 + tol) continue;
+				if (u < tol || v < tol || u + v > 1 - tol) return -1;
+				ret++;
+			}
+		}
+		return ret;
+	}
+
+public:
+	Vector3r mn, mx; // bounding box of the surface
+
+	// vertices holds 3 vertices per triangle
+	TriangleBvh(const vector<Vector3r>& vertices)
+	{
+		const int nTri = (int)vertices.size() / 3;
+		if (nTri == 0) throw std::invalid_argument("TriangleBvh: no triangles.");
+		src = &vertices;
+		centroids.resize(nTri);
+		order.resize(nTri);
+		for (int i = 0; i < nTri; i++) {
+			centroids[i] = (vertices[3 * i] + vertices[3 * i + 1] + vertices[3 * i + 2]) / 3.;
+			order[i]     = i;
+		}
+		tri.reserve(vertices.size());
+		build(0, nTri);
+		mn = nodes[0].mn;
+		mx = nodes[0].mx;
+		src = nullptr;
+		vector<Vector3r>().swap(centroids);
+		vector<int>().swap(order);
+	}
+	// ray parity; the ray is cast again in another direction if it grazes an edge or a vertex
+	bool isInside(const Vector3r& p) const
+	{
+		if ((p - mn).minCoeff() < 0 || (mx - p).minCoeff() < 0) return false;
+		static const Vector3r dirs[] = { Vector3r(0.5773, 0.5781, 0.5769).normalized(),
+			                         Vector3r(-0.3203, 0.8507, 0.4168).normalized(),
+			                         Vector3r(0.7071, -0.2357, -0.6664).normalized(),
+			                         Vector3r(-0.6102, -0.5257, 0.5926).normalized() };
+		int                   n = -1;
+		for (const Vector3r& d : dirs)
+			if ((n = crossings(p, d)) >= 0) break;
+		return n % 2 == 1;
+	}
+	// whether some triangle is closer to p than dist
+	bool isCloserThan(const Vector3r& p, Real dist) const
+	{
+		const Real dist2 = dist * dist;
+		int        stack[maxDepth], top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const int   i  = stack[--top];
+			const Node& nd = nodes[i];
+			if (boxDistSq(nd, p) >= dist2) continue;
+			if (nd.count == 0) {
+				stack[top++] = nd.second;
+				stack[top++] = i + 1;
+				continue;
+			}
+			for (int t = nd.first; t < nd.first + nd.count; t++)
+				if (triDistSq(p, tri[3 * t], tri[3 * t + 1], tri[3 * t + 2]) < dist2) return true;
+		}
+		return false;
+	}
+};
+
 } // namespace yade
 
 
@@ -405,25 +612,27 @@ extern "C" {
 
 namespace yade { // Cannot have #include directive inside.
 
-/* Helper function for inGtsSurface::aabb() */
-static void vertex_aabb(GtsVertex* vertex, std::pair<Vector3r, Vector3r>* bb)
+/* Helper function for inGtsSurface ctor, appends the 3 vertices of a face */
+static void face_vertices(GtsTriangle* t, vector<Vector3r>* vertices)
 {
-	GtsPoint* _p = GTS_POINT(vertex);
-	Vector3r  p(_p->x, _p->y, _p->z);
-	bb->first  = bb->first.cwiseMin(p);
-	bb->second = bb->second.cwiseMax(p);
+	GtsVertex *v1, *v2, *v3;
+	gts_triangle_vertices(t, &v1, &v2, &v3);
+	for (GtsVertex* v : { v1, v2, v3 }) {
+		GtsPoint* p = GTS_POINT(v);
+		vertices->push_back(Vector3r(p->x, p->y, p->z));
+	}
 }
 
 /*
-This class plays tricks getting around pyGTS to get GTS objects and cache bb tree to speed
-up point inclusion tests. For this reason, we have to link with _gts.so (see corresponding
+This class plays tricks getting around pyGTS to get GTS objects. For this reason, we have to link with _gts.so (see corresponding
 SConscript file), which is at the same time the python module.
+The triangles are copied once into a TriangleBvh, queries then use neither GTS nor python and can run in parallel.
 */
 class inGtsSurface : public Predicate {
-	py::object  pySurf; // to hold the reference so that surf is valid
-	GtsSurface* surf;
-	bool        is_open, noPad, noPadWarned;
-	GNode*      tree;
+	py::object                   pySurf; // to hold the reference so that surf is valid
+	GtsSurface*                  surf;
+	bool                         noPad, noPadWarned;
+	std::shared_ptr<TriangleBvh> bvh;
 
 public:
 	inGtsSurface(py::object _surf, bool _noPad = false)
@@ -434,39 +643,25 @@ public:
 		if (!pygts_surface_check(_surf.ptr())) throw std::invalid_argument("Ctor must receive a gts.Surface() instance.");
 		surf = PYGTS_SURFACE_AS_GTS_SURFACE(PYGTS_SURFACE(_surf.ptr()));
 		if (!gts_surface_is_closed(surf)) throw std::invalid_argument("Surface is not closed.");
-		is_open = gts_surface_volume(surf) < 0.;
-		if ((tree = gts_bb_tree_surface(surf)) == NULL) throw std::runtime_error("Could not create GTree.");
-	}
-	~inGtsSurface() { g_node_destroy(tree); }
-	py::tuple aabb() const override
-	{
-		Real                          inf = std::numeric_limits<Real>::infinity();
-		std::pair<Vector3r, Vector3r> bb;
-		bb.first  = Vector3r(inf, inf, inf);
-		bb.second = Vector3r(-inf, -inf, -inf);
+		vector<Vector3r> vertices;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
 #pragma GCC diagnostic ignored "-Wcast-function-type"
-		gts_surface_foreach_vertex(surf, (GtsFunc)vertex_aabb, &bb);
+		gts_surface_foreach_face(surf, (GtsFunc)face_vertices, &vertices);
 #pragma GCC diagnostic pop
-		return vvec2tuple(bb.first, bb.second);
+		bvh = std::make_shared<TriangleBvh>(vertices);
 	}
-	bool ptCheck(const Vector3r& pt) const
-	{
-		GtsPoint gp;
-		gp.x = static_cast<gdouble>(pt[0]);
-		gp.y = static_cast<gdouble>(pt[1]);
-		gp.z = static_cast<gdouble>(pt[2]);
-		return (bool)gts_point_is_inside_surface(&gp, tree, is_open);
-	}
-	bool operator()(const Vector3r& pt, Real pad = 0.) const override
+	py::tuple aabb() const override { return vvec2tuple(bvh->mn, bvh->mx); }
+	bool      operator()(const Vector3r& pt, Real pad = 0.) const override
 	{
 		if (noPad) {
 			if (pad != 0. && noPadWarned) LOG_WARN("inGtsSurface constructed with noPad; requested non-zero pad set to zero.");
-			return ptCheck(pt);
+			return bvh->isInside(pt);
 		}
-		return ptCheck(pt) && ptCheck(pt - Vector3r(pad, 0, 0)) && ptCheck(pt + Vector3r(pad, 0, 0)) && ptCheck(pt - Vector3r(0, pad, 0))
-		        && ptCheck(pt + Vector3r(0, pad, 0)) && ptCheck(pt - Vector3r(0, 0, pad)) && ptCheck(pt + Vector3r(0, 0, pad));
+		// a positive pad requires the point to be that far from the surface, a negative one accepts outside points closer than -pad
+		if (pad > 0) return bvh->isInside(pt) && !bvh->isCloserThan(pt, pad);
+		if (pad < 0) return bvh->isInside(pt) || bvh->isCloserThan(pt, -pad);
+		return bvh->isInside(pt);
 	}
 	py::object surface() const { return pySurf; }
 };
@@ -492,7 +687,14 @@ try {
 	        .def("__or__", makeUnion)
 	        .def("__and__", makeIntersection)
 	        .def("__sub__", makeDifference)
-	        .def("__xor__", makeSymmetricDifference);
+	        .def("__xor__", makeSymmetricDifference)
+	        .def("filter",
+	             filterSpherePack,
+	             (py::arg("spherePack")),
+	             "Return a new :yref:`SpherePack<yade._packSpheres.SpherePack>` with the spheres of ``spherePack`` which are inside the predicate, "
+	             "their radius being used as pad. Predicates defined in C++ and their boolean combinations are evaluated in parallel; those "
+	             "containing a predicate defined in python are evaluated sphere by sphere.")
+	        .add_property("compiled", &Predicate::compiled, "Whether evaluating the predicate runs no python code (see :yref:`yade._packPredicates.Predicate.filter`).");
 	// boolean operations
 	py::class_<PredicateBoolean, py::bases<Predicate>, boost::noncopyable>(
 	        "PredicateBoolean", "Boolean operation on 2 predicates (abstract class)", py::no_init)
@@ -561,8 +763,8 @@ try {
 	        py::init<py::object, py::optional<bool>>(
 	                py::args("surface", "noPad"),
 	                "Ctor taking a gts.Surface() instance, which must not be modified during instance lifetime.\nThe optional noPad can disable padding "
-	                "(if set to True), which speeds up calls several times.\nNote: padding checks inclusion of 6 points along +- cardinal directions in "
-	                "the pad distance from given point, which is not exact."))
+	                "(if set to True), which saves the distance query.\nNote: the triangles are copied into a bounding volume hierarchy; inclusion is "
+	                "tested by ray parity and padding by the exact distance to the nearest triangle."))
 	        .add_property("surf", &inGtsSurface::surface, "The associated gts.Surface object.");
 #endif
 
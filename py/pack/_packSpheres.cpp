@@ -35,6 +35,18 @@ try {
 	             "Make packing from given list, same format as for constructor. Discards current data.")
 	        .def("load", &SpherePack::fromFile, (boost::python::arg("fileName")), "Load packing from external text file (current data will be discarded).")
 	        .def("save", &SpherePack::toFile, (boost::python::arg("fileName")), "Save packing to external text file (will be overwritten).")
+	        .def("loadBinary",
+	             &SpherePack::fromBinary,
+	             (boost::python::arg("fileName")),
+	             "Load packing from a binary file written by :yref:`saveBinary<yade._packSpheres.SpherePack.saveBinary>` (current data will be "
+	             "discarded). The file is memory-mapped and converted in parallel.")
+	        .def("saveBinary",
+	             &SpherePack::toBinary,
+	             (boost::python::arg("fileName")),
+	             "Save packing to a binary file (will be overwritten): a 64-byte header (``YADESPK`` magic, uint32 version, uint32 periodic flag, uint64 "
+	             "count, 3 doubles cellSize, double appliedPsdScaling) followed by 40-byte records (3 doubles center, double radius, int32 clumpId, "
+	             "4 bytes reserved), little-endian. It can be read without yade by memory-mapping, see "
+	             ":yref:`yade.pack.binarySpherePackArray`. Radii and positions are stored as double whatever the precision of Real.")
 	        .def("fromSimulation", &SpherePack::fromSimulation, "Make packing corresponding to the current simulation. Discards current data.")
 	        //The basic sphere generator
 	        .def("makeCloud",
@@ -50,7 +62,8 @@ try {
 	              boost::python::arg("psdCumm")        = std::vector<Real>(),
 	              boost::python::arg("distributeMass") = false,
 	              boost::python::arg("seed")           = -1,
-	              boost::python::arg("hSize")          = Matrix3r(Matrix3r::Zero())),
+	              boost::python::arg("hSize")          = Matrix3r(Matrix3r::Zero()),
+	              boost::python::arg("parallel")       = false),
 	             R"""(Create a random cloud of particles enclosed in a parallelepiped. The resulting packing is a gas-like state with no contacts between particles initially. Usually used as a first step before reaching a dense packing.
 
 				:param Vector3 minCorner: lower corner of an axis-aligned box
@@ -65,11 +78,13 @@ try {
 				:param psdCumm: cummulative fractions of particle sizes given by ``psdSizes``; must be the same length as *psdSizes* and should be non-decreasing.
 				:param bool distributeMass: if ``True``, given distribution will be used to distribute sphere's mass rather than radius of them.
 				:param seed: number used to initialize the random number generator.
+				:param bool parallel: if ``True``, spheres are placed by batches: positions are searched in parallel (OpenMP) for all spheres of a batch, then each sphere is inserted in order unless it overlaps a sphere inserted before it in the same batch, in which case it is tried again in the next batch. The radii are the same as with ``parallel=False`` but the positions are different; for a given ``seed`` the result does not depend on the number of threads.
 				:returns: number of created spheres, which can be lower than ``num`` depending on the method used.
 
 				.. note::
 					- Works in 2D if ``minCorner[k]=maxCorner[k]`` for one coordinate.
 					- If ``num`` is defined, then sizes generation is deterministic, giving the best fit of target distribution. It enables spheres placement in descending size order, thus giving lower porosity than the random generation.
+					- Candidate positions are only tested against the spheres in neighbouring cells of a uniform grid (periodic if ``periodic``), which makes the cost linear in the number of spheres; the packing obtained is the same as with a test against all spheres.
 					- By default (with ``distributeMass==False``), the distribution is applied to particle count (i.e. particle count percent passing). The typical geomechanics sense of "particle size distribution" is the distribution of *mass fraction* (i.e. mass percent passing); this can be achieved with ``distributeMass=True``.
 					- Sphere radius distribution can be specified using one of the following ways:
 
@@ -88,6 +103,41 @@ try {
 	             "``(cumm,edges)``, where ``cumm`` are cummulative fractions for respective diameters  and ``edges`` are those diameter values. Dimension "
 	             "of both arrays is equal to ``bins+1``.")
 	        //The variant for clumps
+	        .def("makeDense",
+	             &SpherePack::makeDense,
+	             (boost::python::arg("minCorner"),
+	              boost::python::arg("maxCorner"),
+	              boost::python::arg("porosity"),
+	              boost::python::arg("num"),
+	              boost::python::arg("rRelFuzz")       = 0,
+	              boost::python::arg("periodic")       = false,
+	              boost::python::arg("psdSizes")       = std::vector<Real>(),
+	              boost::python::arg("psdCumm")        = std::vector<Real>(),
+	              boost::python::arg("distributeMass") = false,
+	              boost::python::arg("seed")           = -1,
+	              boost::python::arg("tolerance")      = 1e-3,
+	              boost::python::arg("maxIter")        = 20000),
+	             R"""(Create a dense random packing of ``num`` spheres in an axis-aligned box, without running a DEM compaction. Spheres are given the sizes matching ``porosity`` and random positions, then overlapping spheres are pushed apart collectively (each sphere moved by its overlaps with neighbours, shared inversely to the sphere volumes) until the largest overlap is below ``tolerance``. If the spheres jam before, all radii are reduced slightly and the relaxation continues, so that the porosity obtained can be larger than requested. Current data are discarded.
+
+				:param Vector3 minCorner: lower corner of the box
+				:param Vector3 maxCorner: upper corner of the box
+				:param float porosity: target porosity. Random close packing of monodisperse spheres is reached around 0.37 in periodic boxes (about 0.39 with walls), polydisperse packings can be denser.
+				:param int num: number of spheres
+				:param float rRelFuzz: dispersion of radius relative to the mean radius, as in :yref:`makeCloud<yade._packSpheres.SpherePack.makeCloud>`
+				:param bool periodic: whether the packing is periodic; otherwise spheres are kept inside the box
+				:param psdSizes: sieve sizes (particle diameters) of a particle size distribution, only relative sizes matter (see ``appliedPsdScaling``)
+				:param psdCumm: cumulative fractions of particle sizes given by ``psdSizes``
+				:param bool distributeMass: if ``True``, the distribution is for the mass of spheres rather than their number
+				:param seed: number used to initialize the random number generator
+				:param float tolerance: largest overlap allowed between two spheres (or a sphere and the box), relative to the smallest radius
+				:param int maxIter: maximum number of relaxation iterations
+				:returns: porosity of the packing
+
+				.. note::
+					- Sizes are deterministic (the same as ``makeCloud`` with ``num`` given), the mean radius follows from ``num``, ``porosity`` and the box volume.
+					- Works in 2D if ``minCorner[k]=maxCorner[k]`` for one coordinate, porosity is then the fraction of area.
+					- Displacements are computed in parallel (OpenMP), the result does not depend on the number of threads.
+				)""")
 	        .def("makeClumpCloud",
 	             &SpherePack::makeClumpCloud,
 	             (boost::python::arg("minCorner"),
@@ -454,19 +454,113 @@ def filterSpherePack(predicate, spherePack, returnSpherePack=None, **kw):
 	if dimP[0] > dimS[0] or dimP[1] > dimS[1] or dimP[2] > dimS[2]:
 		warnings.warn("Packing's dimension (%s) doesn't fully contain dimension of the predicate (%s)." % (dimS, dimP))
 	spherePack.translate(centP - centS)
-	if returnSpherePack:
+	if isinstance(predicate, Predicate):
+		# evaluated in c++, in parallel if the predicate is compiled
+		ret = predicate.filter(spherePack)
+	else:
 		ret = SpherePack()
 		for c, r in spherePack:
 			if predicate(c, r):
 				ret.add(c, r)
+	if returnSpherePack:
 		return ret
 	else:
 		# return particles to be added to O.bodies
-		ret = []
-		for s in spherePack:
-			if predicate(s[0], s[1]):
-				ret += [utils.sphere(s[0], radius=s[1], **kw)]
-		return ret
+		return [utils.sphere(c, radius=r, **kw) for c, r in ret]
+
+
+## version of the packing generators, part of the keys of cached packings; increase it when generators change so that old packings are not reused
+packingCacheVersion = 1
+
+
+def _canonicalParam(v):
+	"Parameter value in a form whose repr does not depend on its type (Vector3, list, numpy array...)."
+	if v is None or isinstance(v, (bool, int, str)):
+		return v
+	try:
+		return tuple(_canonicalParam(x) for x in v)
+	except TypeError:
+		return float(v)
+
+
+def packingCacheKey(**params):
+	"""Content address of a packing generated with given parameters: sha1 digest (hex string) of the parameters, sorted by name, and of
+	:yref:`yade.pack.packingCacheVersion`."""
+	import hashlib
+	canon = repr(sorted((k, _canonicalParam(v)) for k, v in params.items()))
+	return hashlib.sha1(('%d:%s' % (packingCacheVersion, canon)).encode('utf-8')).hexdigest()
+
+
+def _codeDigest(code):
+	"Digest of the bytecode, constants (nested functions included) and names of a code object, which do not depend on the file and line numbers."
+	import hashlib
+	h = hashlib.sha1(code.co_code)
+	h.update(repr(code.co_names).encode('utf-8'))
+	for c in code.co_consts:
+		h.update(_codeDigest(c).encode('utf-8') if hasattr(c, 'co_code') else repr(c).encode('utf-8'))
+	return h.hexdigest()
+
+
+def _generatorKey(generate):
+	"Name of a python function with the digest of its code, default arguments and closure, so that different functions (e.g. lambdas) have different keys."
+	code = getattr(generate, '__code__', None)
+	if code is None:
+		raise TypeError("cachedSpherePack: the generator is not a python function, give generatorKey.")
+	try:
+		extra = repr((_canonicalParam(generate.__defaults__ or ()), [_canonicalParam(c.cell_contents) for c in (generate.__closure__ or ())]))
+	except (TypeError, ValueError):
+		raise TypeError("cachedSpherePack: the default arguments or the closure of the generator are not plain values, give generatorKey.")
+	name = getattr(generate, '__module__', '') + '.' + getattr(generate, '__qualname__', generate.__name__)
+	return '%s:%s:%s' % (name, _codeDigest(code), extra)
+
+
+def cachedSpherePack(cacheDir, generate, generatorKey=None, **params):
+	"""Return ``generate(**params)``, a SpherePack, reusing the packing stored in directory *cacheDir* by a previous call with the same generator and
+	parameters (:yref:`yade.pack.packingCacheKey`). New packings are stored in the binary format of
+	:yref:`SpherePack.saveBinary<yade._packSpheres.SpherePack.saveBinary>`; they are renamed into place once written, so that concurrent jobs
+	(e.g. yade-batch) can share the cache. Parameters should include the seed, since packings generated with a random seed are reused as well.
+
+	The generator is identified by *generatorKey* if given (a string, to be changed when the generator changes), else by its name together with its
+	bytecode, default arguments and closure, so that two lambdas or two versions of a function do not share packings. Give *generatorKey* when the
+	generator depends on global variables or on other functions, which are not part of the digest.
+
+	.. code-block:: python
+
+		def cloud(num, porosity, seed):
+			sp = SpherePack()
+			sp.makeDense((0, 0, 0), (1, 1, 1), porosity, num, periodic=True, seed=seed)
+			return sp
+		sp = pack.cachedSpherePack('packings', cloud, num=20000, porosity=0.38, seed=1)
+	"""
+	import os
+	key = generatorKey if generatorKey is not None else _generatorKey(generate)
+	fileName = os.path.join(cacheDir, packingCacheKey(generator=key, **params) + '.spk')
+	sp = SpherePack()
+	if os.path.exists(fileName):
+		sp.loadBinary(fileName)
+		return sp
+	sp = generate(**params)
+	if not os.path.isdir(cacheDir):
+		try:
+			os.makedirs(cacheDir)
+		except OSError:
+			pass  # created by a concurrent job
+	tmp = '%s.%d.tmp' % (fileName, os.getpid())
+	sp.saveBinary(tmp)
+	os.rename(tmp, fileName)
+	return sp
+
+
+def binarySpherePackArray(fileName):
+	"""Memory-mapped numpy record array of the spheres stored in *fileName* by :yref:`SpherePack.saveBinary<yade._packSpheres.SpherePack.saveBinary>`,
+	with fields ``c`` (center), ``r`` and ``clumpId``. Data are read from the file only when accessed."""
+	import numpy
+	header = numpy.memmap(fileName, dtype=numpy.uint8, mode='r', shape=(64,))
+	if header[:8].tobytes() != b'YADESPK\0':
+		raise ValueError("%s is not a binary SpherePack file." % fileName)
+	count = int(numpy.frombuffer(header[16:24].tobytes(), dtype='<u8')[0])
+	dtype = numpy.dtype([('c', '<f8', (3,)), ('r', '<f8'), ('clumpId', '<i4'), ('reserved', '<i4')])
+	return numpy.memmap(fileName, dtype=dtype, mode='r', offset=64, shape=(count,))
 
 
 def _memoizePacking(memoizeDb, sp, radius, rRelFuzz, wantPeri, fullDim, noPrint=False):
@@ -483,11 +577,14 @@ def _memoizePacking(memoizeDb, sp, radius, rRelFuzz, wantPeri, fullDim, noPrint=
 		        'create table packings (radius real, rRelFuzz real, dimx real, dimy real, dimz real, N integer, timestamp real, periodic integer, pack blob)'
 		)
 	c = conn.cursor()
-	if (sys.version_info[0] < 3):
-		packBlob = buffer(pickle.dumps(sp.toList(), pickle.HIGHEST_PROTOCOL))
-	else:
-		packBlob = memoryview(pickle.dumps(sp.toList(), pickle.HIGHEST_PROTOCOL))
 	packDim = sp.cellSize if wantPeri else fullDim
+	# the packing goes to a binary file next to the database, the blob only holds its key (older databases hold pickled lists)
+	key = packingCacheKey(radius=radius, rRelFuzz=rRelFuzz, dim=packDim, N=len(sp), periodic=wantPeri, timestamp=time.time())
+	packDir = memoizeDb + '.packs'
+	if not os.path.isdir(packDir):
+		os.makedirs(packDir)
+	sp.saveBinary(os.path.join(packDir, key + '.spk'))
+	packBlob = memoryview(('spk:' + key).encode('ascii'))
 	c.execute(
 	        'insert into packings values (?,?,?,?,?,?,?,?,?)', (
 	                radius,
@@ -571,14 +668,23 @@ def _getMemoizedPacking(memoizeDb, radius, rRelFuzz, x1, y1, z1, fullDim, wantPe
 			if (X < fullDim[0] or Y < fullDim[1] or Z < fullDim[2]):
 				memoDbgMsg("REJECT: not large enough")
 				continue  # not large enough
+		blob = bytes(conn.cursor().execute('select pack from packings where timestamp=?', (timestamp,)).fetchone()[0])
+		if blob.startswith(b'spk:'):
+			packFile = os.path.join(memoizeDb + '.packs', blob[4:].decode('ascii') + '.spk')
+			if not os.path.exists(packFile):
+				memoDbgMsg("REJECT: packing file %s is missing." % packFile)
+				continue
+			sp = SpherePack()
+			sp.loadBinary(packFile)
+			sp.cellSize, sp.isPeriodic = (0, 0, 0), False  # as for pickled lists; set below if wanted
+		else:
+			sp = SpherePack(pickle.loads(blob))
 		memoDbgMsg("ACCEPTED")
 		if not noPrint:
 			print(
 			        "Found suitable packing in %s (radius=%g±%g,N=%g,dim=%g×%g×%g,%s,scale=%g), created %s" %
 			        (memoizeDb, R, rDev, NN, X, Y, Z, "periodic" if isPeri else "non-periodic", scale, time.asctime(time.gmtime(timestamp)))
 			)
-		c.execute('select pack from packings where timestamp=?', (timestamp,))
-		sp = SpherePack(pickle.loads(c.fetchone()[0]))
 		sp.scale(scale)
 		if isPeri and wantPeri:
 			sp.isPeriodic = True
@@ -626,7 +732,9 @@ def randomDensePack(
 		the packing that will be generated, if not found (the technique of caching results of expensive computations
 		is known as memoization). Fuzzy matching is used to select suitable candidate -- packing will be scaled, rRelFuzz
 		and dimensions compared. Packing that are too small are dictarded. From the remaining candidate, the one with the
-		least number spheres will be loaded and returned.
+		least number spheres will be loaded and returned. The database only indexes packings, which are stored in the binary
+		format of :yref:`SpherePack.saveBinary<yade._packSpheres.SpherePack.saveBinary>` in the directory ``memoizeDb+'.packs'``
+		(packings stored as pickled lists by older versions are still read).
 	:param useOBB: effective only if a inGtsSurface predicate is given. If true (not default), oriented bounding box will be
 		computed first; it can reduce substantially number of spheres for the triaxial compression (like 10× depending on
 		how much asymmetric the body is), see examples/gts-horse/gts-random-pack-obb.py
@@ -751,6 +859,42 @@ def randomDensePack(
 	return filterSpherePack(predicate, sp, material=material, color=color, returnSpherePack=returnSpherePack)
 
 
+def geometricDensePack(
+        predicate, radius, rRelFuzz=0., porosity=0.38, spheresInCell=2000, material=-1, color=None, returnSpherePack=None, seed=-1
+):
+	"""Generator of dense random packings filling the predicate, built geometrically by :yref:`yade._packSpheres.SpherePack.makeDense` instead of
+	the dynamic compaction of :yref:`yade.pack.randomDensePack`.
+
+	A periodic cell with about ``spheresInCell`` spheres is packed at ``porosity``, then repeated to fill the predicate. The spheres have no contacts
+	and no stresses; the packing is not in mechanical equilibrium, but its porosity and isotropy are close to those of a compacted packing with
+	frictionless spheres.
+
+	:param predicate: solid-defining predicate for which we generate packing
+	:param radius: mean radius of spheres
+	:param rRelFuzz: relative fuzz of the radius -- e.g. radius=10, rRelFuzz=.2, then spheres will have radii 10 ± (10*.2)), with an uniform distribution.
+	:param porosity: target porosity, possibly increased if the spheres jam before (about 0.37 for monodisperse spheres)
+	:param spheresInCell: number of spheres in the periodic cell
+	:param material: material of created spheres, passed to :yref:`yade.utils.sphere`
+	:param color: color of created spheres, passed to :yref:`yade.utils.sphere`
+	:param returnSpherePack: see the same parameter of :yref:`yade.pack.filterSpherePack`
+	:param seed: number used to initialize the random number generator
+
+	:return: SpherePack object or list of spheres, see :yref:`yade.pack.filterSpherePack`.
+	"""
+	from math import pi
+	meanVol = 4 / 3. * pi * radius**3 * (1 + rRelFuzz**2)
+	# the cell must be larger than the largest spheres, cellFill handles the rest
+	L = max((spheresInCell * meanVol / (1 - porosity))**(1 / 3.), 8 * radius * (1 + rRelFuzz))
+	num = max(1, int(round((1 - porosity) * L**3 / meanVol)))
+	sp = SpherePack()
+	sp.makeDense(Vector3().Zero, Vector3(L, L, L), porosity, num, rRelFuzz=rRelFuzz, periodic=True, seed=seed)
+	sp.cellFill(predicate.dim())
+	kw = {'material': material}
+	if color != None:
+		kw['color'] = color
+	return filterSpherePack(predicate, sp, returnSpherePack=returnSpherePack, **kw)
+
+
 def randomPeriPack(radius, initSize, rRelFuzz=0.0, memoizeDb=None, noPrint=False, seed=-1):
 	"""Generate periodic dense packing.
 
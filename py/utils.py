@@ -372,6 +372,9 @@ def levelSetBody(
         nSurfNodes=27,
         nodesPath=2,
         nodesTol=50,
+        singlePrecisionField=False,
+        fastSweeping=False,
+        useCache=False,
         orientation=Quaternion(1, 0, 0, 0),
         dynamic=True,
         material=-1
@@ -391,6 +394,9 @@ def levelSetBody(
 	:param int nSurfNodes: number of boundary nodes, passed to :yref:`LevelSet.nSurfNodes`
 	:param int nodesPath: path for the boundary nodes, passed to :yref:`LevelSet.nodesPath`
 	:param Real nodesTol: tolerance while ray tracing boundary nodes, passed to :yref:`LevelSet.nodesTol`
+	:param bool singlePrecisionField: passed to :yref:`LevelSet.singlePrecisionField`
+	:param bool fastSweeping: if True, the distance field of a *shape* = 'superellipsoid' or of a *clump* is computed with the parallel fast sweeping method instead of the FMM, see :yref:`FastMarchingMethod.fastSweeping`
+	:param bool useCache: if True, bodies with the same pre-defined *shape* and parameters share the grid and distance field computed for the first one (as well as identical *clump*), see lsSimpleShape()
 	:param Quaternion orientation: the initial orientation of the body
 	:param bool dynamic: passed to :yref:`Body.dynamic`
 	:param Material material: passed to :yref:`Body.material`
@@ -407,19 +413,21 @@ def levelSetBody(
 		raise ValueError("Inconsistent use of levelSetBody, see the doc.")
 	b = Body()
 	if shape == "disk":
-		b.shape = lsSimpleShape(0, AlignedBox3(-radius * Vector3.Ones, radius * Vector3.Ones), step=spacing, smearCoeff=smearCoeff)
+		b.shape = lsSimpleShape(0, AlignedBox3(-radius * Vector3.Ones, radius * Vector3.Ones), step=spacing, smearCoeff=smearCoeff, useCache=useCache)
 	elif shape == "sphere":
-		b.shape = lsSimpleShape(1, AlignedBox3(-radius * Vector3.Ones, radius * Vector3.Ones), step=spacing, smearCoeff=smearCoeff)
+		b.shape = lsSimpleShape(1, AlignedBox3(-radius * Vector3.Ones, radius * Vector3.Ones), step=spacing, smearCoeff=smearCoeff, useCache=useCache)
 	elif shape == "box":
 		if not isinstance(extents, Vector3):
 			extents = Vector3(extents[0], extents[1], extents[2])
-		b.shape = lsSimpleShape(2, AlignedBox3(-extents, extents), step=spacing, smearCoeff=smearCoeff)
+		b.shape = lsSimpleShape(2, AlignedBox3(-extents, extents), step=spacing, smearCoeff=smearCoeff, useCache=useCache)
 	elif shape == "superellipsoid":
 		if epsilons[0] == epsilons[1] == 0:
 			raise ValueError("Please define non zero epsilons for superellipsoid shape.")
 		if not isinstance(extents, Vector3):
 			extents = Vector3(extents[0], extents[1], extents[2])
-		b.shape = lsSimpleShape(3, AlignedBox3(-extents, extents), epsilons=epsilons, step=spacing, smearCoeff=smearCoeff)
+		b.shape = lsSimpleShape(
+		        3, AlignedBox3(-extents, extents), epsilons=epsilons, step=spacing, smearCoeff=smearCoeff, fastSweeping=fastSweeping, useCache=useCache
+		)
 	elif len(distField):
 		b.shape = LevelSet(lsGrid=grid, distField=distField, smearCoeff=smearCoeff)
 	if clump != None:
@@ -434,10 +442,13 @@ def levelSetBody(
 		        list(memb.values())[membId][0] + O.bodies[list(memb.keys())[membId]].shape.radius * Vector3(1, 1, 1) for membId in range(len(memb))
 		]  # list with greatest points for each (Aabb of a) Clump member
 		maxExt = [max([memb[axis] for memb in maxMembers]) for axis in range(3)]  # maximum of the Clump Aabb
-		b.shape = lsSimpleShape(4, AlignedBox3(minExt, maxExt), step=spacing, clump=clump, smearCoeff=smearCoeff)
+		b.shape = lsSimpleShape(
+		        4, AlignedBox3(minExt, maxExt), step=spacing, clump=clump, smearCoeff=smearCoeff, fastSweeping=fastSweeping, useCache=useCache
+		)
 	b.shape.nSurfNodes = nSurfNodes  # this was not done in lsSimpleShape()
 	b.shape.nodesPath = nodesPath  # ditto
 	b.shape.nodesTol = nodesTol
+	b.shape.singlePrecisionField = singlePrecisionField
 	inertia = b.shape.inertia()  # this line will call LevelSet::init(), if not already done.
 	_commonBodySetup(
 	        b, b.shape.volume(), inertia, material, pos=center, dynamic=dynamic
@@ -452,6 +463,36 @@ def levelSetBody(
 	return b
 
 
+def templateBody(shape, center=Vector3.Zero, orientation=Quaternion(1, 0, 0, 0), dynamic=True, material=-1, mask=1):
+	"""Creates a body which shares the given :yref:`LevelSet` or :yref:`Polyhedra` shape instance with all other bodies created from it (e.g. many grains of a same morphology), instead of carrying its own copy of the distance field, boundary nodes or vertices. The shape is initialized only once, and is saved only once by :yref:`Omega.save`. Being shared, the shape attributes (e.g. :yref:`Shape.color`) are common to all these bodies.
+
+	:param Shape shape: a :yref:`LevelSet` (from e.g. :yref:`yade.utils.levelSetBody`) or :yref:`Polyhedra` (from e.g. :yref:`yade.utils.polyhedron`) instance, expressed in its local axes
+	:param Vector3 center: (initial) position of the body
+	:param Quaternion orientation: (initial) orientation of the body, with respect to the local axes of *shape*
+	:param bool dynamic: passed to :yref:`Body.dynamic`
+	:param Material material: passed to :yref:`Body.material`
+	:param int mask: :yref:`Body.mask` for the body
+	:return: a body instance sharing *shape*"""
+	b = Body()
+	b.shape = shape
+	if shape.__class__.__name__ == 'LevelSet':
+		inertia = shape.inertia()  # calls LevelSet::init() once for all the bodies sharing that shape
+		_commonBodySetup(b, shape.volume(), inertia, material, pos=center, dynamic=dynamic)
+		iMean = inertia.mean()
+		b.aspherical = not (
+		        abs(inertia[0] - iMean) / iMean < 5.e-4 and abs(inertia[1] - iMean) / iMean < 5.e-4 and abs(inertia[2] - iMean) / iMean < 5.e-4
+		)
+		b.state.ori = b.state.refOri = orientation
+	elif shape.__class__.__name__ == 'Polyhedra':
+		_commonBodySetup(b, shape.GetVolume(), shape.GetInertia(), material, pos=center, dynamic=dynamic)
+		b.aspherical = True
+		b.state.ori = b.state.refOri = orientation * shape.GetOri()  # vertices of an initialized Polyhedra are expressed in its principal axes
+	else:
+		raise ValueError("templateBody only handles LevelSet and Polyhedra shapes, not " + shape.__class__.__name__)
+	b.mask = mask
+	return b
+
+
 #def setNewVerticesOfFacet(b,vertices):
 #	center = inscribedCircleCenter(vertices[0],vertices[1],vertices[2])
 #	vertices = Vector3(vertices[0])-center,Vector3(vertices[1])-center,Vector3(vertices[2])-center
@@ -0,0 +1,32 @@
+# encoding: utf-8
+# Check the torque gathered on a clump from the forces on its members (Clump::addForceTorqueFromMembers): the lever arms are the actual
+# member positions relative to the clump, also when the clump was moved from python since its members were last positioned
+O.bodies.appendClumped([sphere((0, 0, 0), 1), sphere((2, 0, 0), 1), sphere((0, 3, 1), 0.5)])
+clumpId = O.bodies[0].clumpId
+members = [b.id for b in O.bodies if b.isClumpMember]
+forces = [Vector3(1, 2, 3), Vector3(-2, 0, 1), Vector3(0, -1, 4)]
+expected = []
+
+
+def memberForces():
+	global expected
+	for i, f in zip(members, forces):
+		O.forces.addF(i, f)
+	c = O.bodies[clumpId].state.pos
+	expected = sum([(O.bodies[i].state.pos - c).cross(f) for i, f in zip(members, forces)], Vector3.Zero)
+
+
+O.engines = [ForceResetter(), PyRunner(command='memberForces()', iterPeriod=1), NewtonIntegrator(gravity=(0, 0, 0), damping=0)]
+O.dt = 1e-6
+O.step()
+
+# move and turn the clump from python, the members follow only at the next NewtonIntegrator
+O.bodies[clumpId].state.pos += Vector3(0.5, -1, 2)
+O.bodies[clumpId].state.ori = Quaternion((1, 1, 0), 0.7) * O.bodies[clumpId].state.ori
+for step in range(2):
+	O.step()
+	torque = O.forces.t(clumpId)
+	if (torque - expected).norm() > 1e-9 * expected.norm():
+		raise YadeCheckError("checkClumpTorque: torque " + str(torque) + " on the clump at step " + str(O.iter) + ", expected " + str(expected))
+	if (O.forces.f(clumpId) - sum(forces, Vector3.Zero)).norm() > 1e-12:
+		raise YadeCheckError("checkClumpTorque: force " + str(O.forces.f(clumpId)) + " on the clump at step " + str(O.iter))
@@ -0,0 +1,107 @@
+# encoding: utf-8
+# Check FEInternalForceEngine.assembled: the nodal forces computed with the global matrices equal the element by element ones,
+# getAssembledMatrix gives the operators of these forces, and the matrices are rebuilt when elements and nodes are erased
+if ('FEMLIKE' in features):
+	from yade.deformableelementsutils import *
+	import random
+	random.seed(1)
+
+	mat = LinIsoRayleighDampElastMat(density=2700, beta=0.05, alpha=0.05, youngmodulus=70e9)
+	O.materials.append(mat)
+	wx, wy, wz = 1, 1, 1
+	p = [Vector3(0, 0, 0), Vector3(0, wy, 0), Vector3(wx, 0, 0), Vector3(0, 0, wz), Vector3(0, wy, wz), Vector3(wx, wy, 0), Vector3(wx, 0, wz), Vector3(wx, wy, wz)]
+	elements = []
+	for e in [[0, 1, 2, 3], [3, 4, 1, 7], [2, 5, 1, 7], [7, 2, 3, 6], [1, 2, 3, 7]]:
+		elements.append(tetrahedral_element(mat, [p[i] for i in e], Lin4NodeTetra, radius=0.01))
+	nodeIds = [n.id for element, nodes in elements for n in nodes]
+	for i in nodeIds:
+		O.bodies[i].state.pos += Vector3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1)) * 1e-3
+		O.bodies[i].state.vel = Vector3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1)) * 1e-2
+
+	def forces(assembled, ids):
+		O.engines = [ForceResetter(), FEInternalForceEngine([If2_Lin4NodeTetra_LinIsoRayleighDampElast()], assembled=assembled, label="fe")]
+		O.step()
+		return [O.forces.f(i) for i in ids]
+
+	def compare(reference, result, what):
+		scale = max(f.norm() for f in reference)
+		for k in range(len(reference)):
+			if (reference[k] - result[k]).norm() > 1e-9 * scale:
+				raise YadeCheckError("checkFEAssembled: " + what + ", node " + str(k) + ": " + str(result[k]) + " vs " + str(reference[k]))
+
+	O.dt = 1e-8
+	reference = forces(False, nodeIds)
+	compare(reference, forces(True, nodeIds), "assembled forces differ from the element by element ones")
+	if fe.nAssembled != len(elements):
+		raise YadeCheckError("checkFEAssembled: " + str(fe.nAssembled) + " assembled elements instead of " + str(len(elements)))
+
+	# f=-(A*x-Ax0)-D*v with the exported operators
+	ids, A, D, Ax0 = fe.getAssembledMatrix()
+	x = [c for i in ids for c in O.bodies[i].state.pos]
+	v = [c for i in ids for c in O.bodies[i].state.vel]
+	f = [-r for r in Ax0]
+	for r, c, val in A:
+		f[r] += val * x[c]
+	for r, c, val in D:
+		f[r] += val * v[c]
+	compare([O.forces.f(i) for i in ids], [-Vector3(f[3 * k], f[3 * k + 1], f[3 * k + 2]) for k in range(len(ids))], "getAssembledMatrix operators")
+
+	# erase an element and its nodes: the same engine rebuilds the assembly without them
+	element, nodes = elements.pop()
+	O.bodies.erase(element.id)
+	for n in nodes:
+		O.bodies.erase(n.id)
+	nodeIds = [n.id for element, nodes in elements for n in nodes]
+	O.step()
+	result = [O.forces.f(i) for i in nodeIds]
+	if fe.nAssembled != len(elements):
+		raise YadeCheckError("checkFEAssembled: " + str(fe.nAssembled) + " assembled elements after erasing one, instead of " + str(len(elements)))
+	compare(forces(False, nodeIds), result, "assembled forces after erasing an element")
+
+	# a mesh whose elements share their nodes needs several colours: colouredBatches gives the forces of the direct summation, with the same
+	# result for any number of threads, and switching colouredBatches on the same engine colours the elements again
+	from yade.utils import _commonBodySetup
+	O.reset()
+	O.materials.append(mat)
+	nodes = []
+	for x in p:
+		n = node(x, 0.01)
+		O.bodies.append(n)
+		nodes.append(n)
+	for e in [[0, 1, 2, 3], [3, 4, 1, 7], [2, 5, 1, 7], [7, 2, 3, 6], [1, 2, 3, 7]]:
+		b = Body()
+		b.shape = Lin4NodeTetra()
+		O.bodies.append(b)
+		for i in e:
+			b.shape.addNode(nodes[i])
+		_commonBodySetup(b, 1, Vector3(1, 1, 1), mat, pos=Vector3(0, 0, 0), dynamic=False, fixed=True, blockedDOFs='xyzXYZ')
+		b.bounded = False
+	for n in nodes:
+		n.state.pos += Vector3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1)) * 1e-3
+		n.state.vel = Vector3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1)) * 1e-2
+	nodeIds = [n.id for n in nodes]
+
+	def sharedForces(batches, threads):
+		O.engines = [ForceResetter(), FEInternalForceEngine([If2_Lin4NodeTetra_LinIsoRayleighDampElast()], colouredBatches=batches, label="fe")]
+		fe.ompThreads = threads
+		O.step()
+		return [O.forces.f(i) for i in nodeIds]
+
+	reference = sharedForces(False, 1)
+	coloured = sharedForces(True, 1)
+	if fe.nColours < 2:
+		raise YadeCheckError("checkFEAssembled: " + str(fe.nColours) + " colours for elements sharing nodes")
+	compare(reference, coloured, "colouredBatches with shared nodes")
+	for threads in [2, 3, 4]:
+		if sharedForces(True, threads) != coloured:
+			raise YadeCheckError("checkFEAssembled: colouredBatches forces with " + str(threads) + " threads differ from those with one thread")
+	fe.colouredBatches = False
+	O.step()
+	fe.colouredBatches = True
+	O.step()
+	if fe.nColours < 2:
+		raise YadeCheckError("checkFEAssembled: the elements are not coloured again when colouredBatches is switched on")
+	compare(reference, [O.forces.f(i) for i in nodeIds], "colouredBatches switched on the same engine")
+
+else:
+	print("skip checkFEAssembled, FEMLIKE not available")
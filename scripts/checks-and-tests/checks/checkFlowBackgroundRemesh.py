@@ -0,0 +1,56 @@
+# encoding: utf-8
+# FlowEngine with the background remesh worker (multithread=True) against the serial remesh, on a fixed packing: fluxes and pressures must
+# be the same. Deleting the engine while the worker is running must not crash.
+from yade import pack
+
+if ('PFVFLOW' in features) and ('LINSOLV' in features):
+
+	def runFlow(multithread):
+		O.reset()
+		mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+		O.materials.append(FrictMat(young=1e6, poisson=0.5, frictionAngle=0, density=2600, label='spheres'))
+		O.materials.append(FrictMat(young=1e6, poisson=0.5, frictionAngle=0, density=0, label='walls'))
+		O.bodies.append(aabbWalls([mn, mx], thickness=0, material='walls'))
+		sp = pack.SpherePack()
+		sp.load(checksPath + '/data/100spheres')
+		sp.toSimulation(material='spheres')
+		O.engines = [
+		        ForceResetter(),
+		        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+		        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()],
+		                        [Law2_ScGeom_FrictPhys_CundallStrack()]),
+		        FlowEngine(
+		                label="flow",
+		                multithread=multithread,
+		                useSolver=3,
+		                meshUpdateInterval=5,
+		                defTolerance=-1,
+		                viscosity=10,
+		                bndCondIsPressure=[0, 0, 1, 1, 0, 0],
+		                bndCondValue=[0, 0, 1, 0, 0, 0],
+		                boundaryUseMaxMin=[0, 0, 0, 0, 0, 0]
+		        ),
+		]  # no NewtonIntegrator: the packing does not move, all meshes are identical
+		O.dt = 1e-4
+		O.run(23, True)
+		return flow.getBoundaryFlux(2), flow.getBoundaryFlux(3), flow.getPorePressure((0.5, 0.5, 0.5))
+
+	ref = runFlow(False)
+	background = runFlow(True)
+	print('serial remesh', ref, 'background remesh', background)
+	for a, b in zip(background, ref):
+		if abs(a - b) > 1e-8 * max(abs(b), 1e-10):
+			raise YadeCheckError('checkFlowBackgroundRemesh: background remesh gives %s instead of %s' % (str(background), str(ref)))
+	flow.meshUpdateInterval = 1
+	O.run(3, True)  # a background job is pending now
+	# the label is a reference in __builtins__ too, drop it and the scene's reference so that the engine is destroyed with its worker
+	import builtins
+	del builtins.flow
+	O.engines = []
+	O.reset()
+	O.engines = [ForceResetter()]
+	O.run(2, True)
+	if O.iter != 2:
+		raise YadeCheckError('checkFlowBackgroundRemesh: the simulation does not run after the engine with a pending remesh was deleted')
+else:
+	print("skip checkFlowBackgroundRemesh, FlowEngine with LINSOLV not available")
@@ -0,0 +1,81 @@
+# encoding: utf-8
+# Check yade._utils.globalStats: the fused reductions equal the separate functions, the cached values are discarded when engines run or
+# by invalidateGlobalStats, and the results of the parallel reductions (orderedReduce) do not depend on the number of threads
+from yade import pack
+
+O.periodic = True
+sp = pack.SpherePack()
+# enough bodies and contacts for several blocks of orderedReduce (4096 items each)
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.022, rRelFuzz=0.3, num=6000, periodic=True, seed=1)
+sp.toSimulation()
+O.cell.hSize = O.cell.hSize * 0.75  # squeeze the cell to create contacts
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        NewtonIntegrator(damping=.4),
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(10, True)
+if O.interactions.countReal() < 2 * 4096:
+	raise YadeCheckError("checkGlobalStats: only " + str(O.interactions.countReal()) + " contacts, the check is meaningless")
+
+
+def compare(name, value, reference, tolerance=1e-10):
+	try:
+		diff, scale = (value - reference).norm(), reference.norm()
+	except AttributeError:
+		diff, scale = abs(value - reference), abs(reference)
+	if not diff <= tolerance * scale:
+		raise YadeCheckError("checkGlobalStats: " + name + " " + str(value) + ", the separate function gives " + str(reference))
+
+
+# fused vs separate
+s = globalStats(useCache=False)
+compare('unbalancedForce', s['unbalancedForce'], unbalancedForce())
+compare('unbalancedForceMax', s['unbalancedForceMax'], unbalancedForce(True))
+compare('kineticEnergy', s['kineticEnergy'], kineticEnergy())
+if s['maxEnergyId'] != kineticEnergy(True)[1]:
+	raise YadeCheckError("checkGlobalStats: maxEnergyId " + str(s['maxEnergyId']) + ", kineticEnergy gives " + str(kineticEnergy(True)[1]))
+compare('stress', s['stress'], getStress())
+compare('fabric', s['fabric'], fabricTensor()[0])
+strong, weak = fabricTensor(splitTensor=True)
+compare('fabricStrong', s['fabricStrong'], strong)
+compare('fabricWeak', s['fabricWeak'], weak)
+normal, shear = normalShearStressTensors()
+compare('normalStress', s['normalStress'], normal)
+compare('shearStress', s['shearStress'], shear)
+compare('coordination', s['coordination'], avgNumInteractions(considerClumps=True))
+compare('mechanicalCoordination', s['mechanicalCoordination'], avgNumInteractions(skipFree=True))
+
+# the cache is reused until an engine runs or it is invalidated
+s = globalStats(['kineticEnergy'])
+O.bodies[0].state.vel += Vector3(1, 0, 0)
+if globalStats(['kineticEnergy'])['kineticEnergy'] != s['kineticEnergy']:
+	raise YadeCheckError("checkGlobalStats: the cached kinetic energy was not reused")
+invalidateGlobalStats()
+compare('kineticEnergy after a change from python', globalStats(['kineticEnergy'])['kineticEnergy'], kineticEnergy())
+if globalStats(['kineticEnergy'])['kineticEnergy'] == s['kineticEnergy']:
+	raise YadeCheckError("checkGlobalStats: the cached kinetic energy was not discarded by invalidateGlobalStats")
+
+# engines of the same step do not share cached values: the unbalanced force before the contact laws differs from the one after them
+before, after = [], []
+O.engines = O.engines[:2] + [PyRunner(command='before.append(globalStats(["unbalancedForce"]))', iterPeriod=1)] + O.engines[2:3] + [
+        PyRunner(command='after.append((globalStats(["unbalancedForce"])["unbalancedForce"], unbalancedForce()))', iterPeriod=1)
+] + O.engines[3:]
+O.run(1, True)
+compare('unbalancedForce after the contact laws', after[0][0], after[0][1], 0)
+
+# the parallel reductions do not depend on the number of threads
+threads = O.numThreads
+serial = globalStats(useCache=False)
+if threads > 1:
+	O.numThreads = 1
+	serial = globalStats(useCache=False)
+	O.numThreads = threads
+else:
+	print("checkGlobalStats: run with one thread, the independence of the number of threads is not checked")
+parallel = globalStats(useCache=False)
+for name in serial.keys():
+	if serial[name] != parallel[name]:
+		raise YadeCheckError("checkGlobalStats: " + name + " is " + str(serial[name]) + " with 1 thread, " + str(parallel[name]) + " with " + str(threads))
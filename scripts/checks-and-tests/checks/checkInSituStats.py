@@ -0,0 +1,69 @@
+# encoding: utf-8
+# Check InSituStatsEngine against the separate functions it replaces (getStress, fabricTensor, normalShearStressTensors, avgNumInteractions,
+# bodyNumInteractionsHistogram and interactionAnglesHistogram), on a periodic packing, and the bin of the contact normals at an angle close to π
+from yade import pack
+
+O.periodic = True
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.06, rRelFuzz=0.3, num=400, periodic=True, seed=1)
+sp.toSimulation()
+O.cell.hSize = O.cell.hSize * 0.8  # squeeze the cell to create contacts
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        NewtonIntegrator(damping=.4),
+        InSituStatsEngine(reductions=['all'], iterPeriod=1, label='stats'),
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(20, True)
+
+
+def compare(name, value, reference, tolerance=1e-10):
+	try:
+		diff, scale = (value - reference).norm(), reference.norm()
+	except AttributeError:
+		diff, scale = abs(value - reference), abs(reference)
+	if not diff <= tolerance * scale:
+		raise YadeCheckError("checkInSituStats: " + name + " " + str(value) + ", the separate function gives " + str(reference))
+
+
+if stats.contacts < 100:
+	raise YadeCheckError("checkInSituStats: only " + str(stats.contacts) + " contacts, the check is meaningless")
+compare('stress', stats.stress, getStress())
+compare('fabric', stats.fabric, fabricTensor()[0])
+strong, weak = fabricTensor(splitTensor=True)
+compare('fabricStrong', stats.fabricStrong, strong)
+compare('fabricWeak', stats.fabricWeak, weak)
+normal, shear = normalShearStressTensors()
+compare('normalStress', stats.normalStress, normal)
+compare('shearStress', stats.shearStress, shear)
+compare('coordination', stats.coordination, avgNumInteractions(considerClumps=True))
+compare('mechanicalCoordination', stats.mechanicalCoordination, avgNumInteractions(skipFree=True))
+nums, counts = bodyNumInteractionsHistogram(aabbExtrema())
+histogram = [0] * stats.coordBins
+for n, c in zip(nums, counts):
+	histogram[min(n, stats.coordBins - 1)] += c
+if list(stats.coordHistogram) != histogram:
+	raise YadeCheckError("checkInSituStats: coordHistogram " + str(list(stats.coordHistogram)) + ", bodyNumInteractionsHistogram gives " + str(histogram))
+angles = interactionAnglesHistogram(stats.angleAxis, bins=stats.angleBins)[1]
+for k in range(stats.angleBins):
+	compare('angleHistogram[' + str(k) + ']', stats.angleHistogram[k], angles[k])
+
+# a contact normal at an angle just below π about z falls in the first bin, centered on 0
+O.reset()
+O.bodies.append([sphere((0, 0, 0), 1, fixed=True), sphere((-1.9, 1e-3, 0), 1, fixed=True)])
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        InSituStatsEngine(reductions=['angleHistogram'], iterPeriod=1, label='stats'),
+]
+O.dt = 1e-6
+O.step()
+angles = interactionAnglesHistogram(2, bins=stats.angleBins)[1]
+if stats.contacts != 1 or abs(stats.angleHistogram[0] - 1) > 1e-12 or abs(angles[0] - 1) > 1e-12:
+	raise YadeCheckError(
+	        "checkInSituStats: a normal at an angle close to π is not in the first bin: " + str(list(stats.angleHistogram)) + ", interactionAnglesHistogram " +
+	        str(angles)
+	)
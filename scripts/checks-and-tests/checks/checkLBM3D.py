@@ -0,0 +1,54 @@
+# encoding: utf-8
+# Validation of HydrodynamicsLawLBM3D:
+# - body force driven Poiseuille flow between two no-slip walls, against the parabolic profile,
+# - a fixed sphere in a fully periodic box with a body force on the fluid: at steady state, the drag on the sphere balances the body force on the whole fluid.
+if ('LBMFLOW' in features):
+	dx, Nu, Rho, tau = 1e-3, 1e-6, 1000., 1.
+	dt = (tau - 0.5) / 3. * dx**2 / Nu  # LBM timestep, see HydrodynamicsLawLBM3D.lbmDt
+	nuLattice = (tau - 0.5) / 3.
+
+	# Poiseuille flow along x, walls at z=0 and z=H
+	nz = 16
+	H = nz * dx
+	uMaxLattice = 0.01  # small Mach number
+	g = uMaxLattice * 8 * nuLattice / nz**2 * dx / dt**2
+	O.engines = [
+	        ForceResetter(),
+	        HydrodynamicsLawLBM3D(
+	                lowerCorner=(0, 0, 0), upperCorner=(4 * dx, 4 * dx, H), dx=dx, periodic=(1, 1, 0), Rho=Rho, Nu=Nu, tau=tau, bodyForce=(g, 0, 0), label="lbm"
+	        ),
+	        NewtonIntegrator(gravity=(0, 0, 0), damping=0),
+	]
+	O.dt = dt
+	O.run(int(6 * nz**2 / nuLattice), True)  # a few diffusion times H^2/Nu
+	if abs(lbm.lbmDt - dt) > 1e-12 * dt:
+		raise YadeCheckError("checkLBM3D: lbmDt=" + str(lbm.lbmDt) + " instead of " + str(dt))
+	uMax = g * H**2 / (8 * Nu)
+	for k in range(nz):
+		z = (k + 0.5) * dx  # halfway bounce-back: the walls are half a spacing away from the first and last nodes
+		uTheory = g / (2 * Nu) * z * (H - z)
+		u = lbm.getVel(1, 2, k)
+		if abs(u[0] - uTheory) > 0.01 * uMax or abs(u[1]) > 1e-6 * uMax or abs(u[2]) > 1e-6 * uMax:
+			raise YadeCheckError("checkLBM3D: Poiseuille velocity " + str(u) + " at node " + str(k) + ", expected (" + str(uTheory) + ",0,0)")
+
+	# drag on a fixed sphere in a periodic box
+	O.reset()
+	n = 16
+	O.bodies.append(sphere((n / 2 * dx, n / 2 * dx, n / 2 * dx), 4 * dx, fixed=True))
+	g = 1e-5 * dx / dt**2
+	O.engines = [
+	        ForceResetter(),
+	        HydrodynamicsLawLBM3D(
+	                lowerCorner=(0, 0, 0), upperCorner=(n * dx, n * dx, n * dx), dx=dx, periodic=(1, 1, 1), Rho=Rho, Nu=Nu, tau=tau, bodyForce=(0, 0, g), label="lbm"
+	        ),
+	        NewtonIntegrator(gravity=(0, 0, 0), damping=0),
+	]
+	O.dt = dt
+	O.run(int(6 * n**2 / nuLattice), True)
+	drag = O.forces.f(0)
+	bodyForceOnFluid = Rho * g * lbm.nFluid * dx**3
+	if abs(drag[2] - bodyForceOnFluid) > 0.01 * bodyForceOnFluid or abs(drag[0]) > 1e-3 * bodyForceOnFluid or abs(drag[1]) > 1e-3 * bodyForceOnFluid:
+		raise YadeCheckError("checkLBM3D: drag " + str(drag) + " on the sphere does not balance the body force on the fluid " + str(bodyForceOnFluid))
+
+else:
+	print("skip checkLBM3D, LBMFLOW not available")
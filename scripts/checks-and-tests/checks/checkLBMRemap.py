@@ -0,0 +1,117 @@
+# encoding: utf-8
+# Check the solid mapping of the 2D HydrodynamicsLawLBM:
+# - the incremental remapping (remapThreshold>0, here smaller than any displacement so that every moving sphere is remapped) gives the same node
+#   flags and the same hydrodynamic forces as a full remapping at each call, with bounce-back links and with partially saturated cells,
+# - the force of the partially saturated cells on a fixed disk in a closed box with a body force on the fluid (hydrostatic pressure gradient)
+#   is along the gradient, and of the magnitude given by the bounce-back links.
+if ('LBMFLOW' in features):
+	from yade import pack
+	import random
+
+	L, H = 0.01, 0.005
+
+	def lbmDx(Nx):
+		return L / (Nx - 1)
+
+	def setup(remapThreshold, partialSaturation, Nx, bodyForce):
+		O.reset()
+		O.materials.append(FrictMat(young=50e6, poisson=.5, frictionAngle=0.0, density=3000))
+		# walls in the order minX,maxX,minY,maxY,minZ,maxZ
+		O.bodies.append(aabbWalls(extrema=((1e-5, 1e-5, -0.002), (L + 1e-5, H + 1e-5, 0.002)), thickness=1e-5, oversizeFactor=1.001))
+		O.engines = [
+		        ForceResetter(),
+		        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+		        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()],
+		                        [Law2_ScGeom_FrictPhys_CundallStrack()]),
+		        HydrodynamicsLawLBM(
+		                WallXm_id=0,
+		                WallXp_id=1,
+		                WallYm_id=2,
+		                WallYp_id=3,
+		                WallZm_id=4,
+		                WallZp_id=5,
+		                useWallXm=1,
+		                useWallXp=1,
+		                useWallYm=1,
+		                useWallYp=1,
+		                YmBCType=2,
+		                YpBCType=2,
+		                XmBCType=2,
+		                XpBCType=2,
+		                LBMSavedData='',
+		                tau=1.1,
+		                dP=(0, 0, 0),
+		                IterSave=1000000,
+		                IterPrint=1000000,
+		                Nx=Nx,
+		                Rho=1000,
+		                Nu=1.0e-6,
+		                VbCutOff=0.0,
+		                CstBodyForce=bodyForce,
+		                remapThreshold=remapThreshold,
+		                partialSaturation=partialSaturation,
+		                label="lbm"
+		        ),
+		        NewtonIntegrator(gravity=(0, 0, 0), damping=0),
+		]
+		# slightly below the LBM timestep nu*dx^2/Nu (nu=(tau-0.5)/3), for one DEM iteration per LBM iteration
+		O.dt = 0.9 * 0.2 * lbmDx(Nx)**2 / 1e-6
+
+	def moveSpheres(remapThreshold, partialSaturation):
+		setup(remapThreshold, partialSaturation, 100, Vector3.Zero)
+		sp = pack.SpherePack()
+		sp.makeCloud((0.002, 0.002, 0), (L - 0.002, H - 0.002, 0), rMean=0.0003, rRelFuzz=0.2, num=15, seed=1)
+		spheres = sp.toSimulation(fixed=True)
+		# prescribed velocities, below 0.02 lattice spacing per iteration: the spheres move by less than one spacing and do not touch
+		random.seed(1)
+		for i in spheres:
+			O.bodies[i].state.vel = Vector3(random.uniform(-1, 1), random.uniform(-1, 1), 0) * 1e-3
+		remapped = 0
+		for i in range(40):
+			O.step()
+			remapped += lbm.nRemapped
+		return lbm.getNodeStates(), [O.forces.f(i) for i in spheres], [O.bodies[i].state.pos for i in spheres], remapped
+
+	for partialSaturation in [False, True]:
+		what = "partialSaturation=" + str(partialSaturation)
+		refNodes, refForces, refPos, _ = moveSpheres(0, partialSaturation)
+		nodes, forces, pos, remapped = moveSpheres(1e-9, partialSaturation)
+		if remapped == 0:
+			raise YadeCheckError("checkLBMRemap: no sphere remapped incrementally, " + what)
+		bad = [
+		        i for i in range(len(nodes))
+		        if nodes[i][:4] != refNodes[i][:4] or nodes[i][5] != refNodes[i][5] or abs(nodes[i][4] - refNodes[i][4]) > 1e-12
+		]
+		if bad:
+			raise YadeCheckError(
+			        "checkLBMRemap: " + str(len(bad)) + " nodes mapped differently by the incremental remapping, first " + str(bad[0]) + ": " +
+			        str(nodes[bad[0]]) + " instead of " + str(refNodes[bad[0]]) + ", " + what
+			)
+		scale = max(f.norm() for f in refForces)
+		if scale == 0:
+			raise YadeCheckError("checkLBMRemap: no hydrodynamic force, " + what)
+		for k in range(len(forces)):
+			if (forces[k] - refForces[k]).norm() > 1e-6 * scale or (pos[k] - refPos[k]).norm() > 1e-9 * L:
+				raise YadeCheckError(
+				        "checkLBMRemap: force " + str(forces[k]) + " instead of " + str(refForces[k]) + " on sphere " + str(k) +
+				        " with the incremental remapping, " + what
+				)
+
+	def hydrostatic(partialSaturation):
+		# body force of about 1e-6 in lattice units, CstBodyForce being divided by c^2 (c=dx/dt=Nu/(nu*dx))
+		c = 1e-6 / (0.2 * lbmDx(60))
+		setup(0, partialSaturation, 60, Vector3(1e-6 * c**2, 0, 0))
+		s = O.bodies.append(sphere((L / 2, H / 2, 0), H / 6, fixed=True))
+		O.run(2500, True)
+		f = Vector3.Zero
+		for i in range(500):  # mean over the remaining acoustic oscillations
+			O.step()
+			f += O.forces.f(s) / 500.
+		return f
+
+	bounceBack, psm = hydrostatic(False), hydrostatic(True)
+	print("hydrostatic force on the disk: bounce-back", bounceBack, "partially saturated cells", psm)
+	if not (bounceBack[0] < 0 and psm[0] < 0 and 0.75 < psm[0] / bounceBack[0] < 1.33 and abs(psm[1]) < 0.05 * abs(psm[0])):
+		raise YadeCheckError("checkLBMRemap: force " + str(psm) + " of the partially saturated cells instead of about " + str(bounceBack))
+else:
+	print("skip checkLBMRemap, LBMFLOW not available")
@@ -0,0 +1,48 @@
+# encoding: utf-8
+# Check the caches of lsSimpleShape() (through levelSetBody) and FastMarchingMethod: a hit needs all the parameters to be equal, gives the same
+# distance field (and FMM solution, with known) as a computation from scratch, and the caches keep a bounded number of entries
+if ('LS_DEM' in features):
+	lsClearCache()
+	extents, epsilons = Vector3(0.5, 0.8, 0.6), Vector2(0.4, 1.2)
+	reference = levelSetBody('superellipsoid', extents=extents, epsilons=epsilons, spacing=0.1)
+	first = levelSetBody('superellipsoid', extents=extents, epsilons=epsilons, spacing=0.1, useCache=True)
+	second = levelSetBody('superellipsoid', extents=extents, epsilons=epsilons, spacing=0.1, useCache=True)
+	if first.shape.distField != reference.shape.distField or second.shape.distField != reference.shape.distField:
+		raise YadeCheckError("checkLS_DEM_cache: the cached superellipsoid distance field differs from the one computed without cache")
+	if second.shape.volume() != reference.shape.volume():
+		raise YadeCheckError("checkLS_DEM_cache: cached superellipsoid volume " + str(second.shape.volume()) + " vs " + str(reference.shape.volume()))
+	# other epsilons, other spacing, other method: no hit
+	for other, kw in [('epsilons', dict(epsilons=Vector2(0.4, 1.3), spacing=0.1)), ('spacing', dict(epsilons=epsilons, spacing=0.11)),
+	                  ('fastSweeping', dict(epsilons=epsilons, spacing=0.1, fastSweeping=True))]:
+		cached = levelSetBody('superellipsoid', extents=extents, useCache=True, **kw)
+		fresh = levelSetBody('superellipsoid', extents=extents, **kw)
+		if cached.shape.distField != fresh.shape.distField:
+			raise YadeCheckError("checkLS_DEM_cache: another " + other + " reused the cached distance field")
+	# many different shapes go through the bounded cache without error, and the last one is still found
+	for i in range(40):
+		levelSetBody('sphere', radius=0.5 + 0.01 * i, spacing=0.1, useCache=True)
+	last = levelSetBody('sphere', radius=0.5 + 0.01 * 39, spacing=0.1, useCache=True)
+	if last.shape.distField != levelSetBody('sphere', radius=0.5 + 0.01 * 39, spacing=0.1).shape.distField:
+		raise YadeCheckError("checkLS_DEM_cache: wrong sphere distance field from the cache")
+
+	# FastMarchingMethod: a hit fills the instance as a solve does
+	grid = RegularGrid(-1, 1, 25)
+	phiIni = distIniSE(extents, epsilons, grid)
+	solved = FastMarchingMethod(grid=grid, phiIni=phiIni)
+	phiSolved = solved.phi()
+	FastMarchingMethod(grid=grid, phiIni=phiIni, useCache=True).phi()
+	hit = FastMarchingMethod(grid=grid, phiIni=phiIni, useCache=True)
+	phiHit = hit.phi()
+	if phiHit != phiSolved:
+		raise YadeCheckError("checkLS_DEM_cache: FastMarchingMethod cache hit differs from the solution")
+	if len(hit.known) != len(solved.known):
+		raise YadeCheckError(
+		        "checkLS_DEM_cache: FastMarchingMethod cache hit gives " + str(len(hit.known)) + " known gridpoints, not " + str(len(solved.known))
+		)
+	# the same grid with another phiIni is another problem
+	otherIni = distIniSE(extents, Vector2(0.4, 1.3), grid)
+	if FastMarchingMethod(grid=grid, phiIni=otherIni, useCache=True).phi() != FastMarchingMethod(grid=grid, phiIni=otherIni).phi():
+		raise YadeCheckError("checkLS_DEM_cache: FastMarchingMethod with another phiIni reused the cached solution")
+	lsClearCache()
+else:
+	print("Skip checkLS_DEM_cache, LS-DEM feature not available")
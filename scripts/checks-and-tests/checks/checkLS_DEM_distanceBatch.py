@@ -0,0 +1,33 @@
+# encoding: utf-8
+# Check LevelSet.distanceBatch, the batched interpolation of Ig2_LevelSet_LevelSet_ScGeom, against the point by point LevelSet.distance and
+# LevelSet.normal, in double precision and with singlePrecisionField
+if ('LS_DEM' in features):
+	import random
+	random.seed(3)
+	for single in [False, True]:
+		b = levelSetBody('superellipsoid', extents=Vector3(0.5, 0.8, 0.6), epsilons=Vector2(0.4, 1.2), spacing=0.05, singlePrecisionField=single)
+		sh = b.shape
+		sh.volume()  # init(), which builds the contiguous copy read by distanceBatch
+		grid = sh.lsGrid
+		mn, mx = grid.min, grid.max()
+		# random points, plus the grid points and the max corner which belong to the last cell
+		pts = [Vector3(random.uniform(mn[0], mx[0]), random.uniform(mn[1], mx[1]), random.uniform(mn[2], mx[2])) for i in range(2000)]
+		pts += [grid.gridPoint(i, j, k) for i in range(0, grid.nGP[0], 3) for j in range(0, grid.nGP[1], 3) for k in range(0, grid.nGP[2], 3)]
+		pts.append(mx)
+		dist, grad = sh.distanceBatch(pts)
+		# float values of the field are exact to about 1e-7 relative to the grid extents
+		tol = (1e-6 if single else 1e-12) * (mx - mn).norm()
+		for p, d, g in zip(pts, dist, grad):
+			ref = sh.distance(p)
+			if abs(d - ref) > tol:
+				raise YadeCheckError("checkLS_DEM_distanceBatch: distance " + str(d) + " instead of " + str(ref) + " at " + str(p) + ", single=" + str(single))
+			n = sh.normal(p)
+			if g.norm() > 1e-3 and (g.normalized() - n).norm() > 1e3 * tol:
+				raise YadeCheckError("checkLS_DEM_distanceBatch: gradient " + str(g) + " not along the normal " + str(n) + " at " + str(p) + ", single=" + str(single))
+		try:
+			sh.distanceBatch([mx + Vector3(grid.spacing, 0, 0)])
+			raise YadeCheckError("checkLS_DEM_distanceBatch: no error for a point outside lsGrid")
+		except ValueError:
+			pass
+else:
+	print("skip checkLS_DEM_distanceBatch, LS_DEM not available")
@@ -0,0 +1,106 @@
+# encoding: utf-8
+# Check that SpherePack.makeCloud, which tests candidate positions against the neighbouring cells of a grid only, gives the same packing as
+# the all-pairs algorithm it replaced. The all-pairs algorithm is run here in python with the random sequence of std::mt19937 and
+# std::uniform_real_distribution, for a box, a periodic cell, a sheared periodic cell, a flat box and stochastic radii (num<0).
+# The parallel generator is checked for overlaps with all pairs.
+from yade import pack
+import math, random
+
+
+def stdUniform(seed):
+	"Random numbers in [0,1) of std::uniform_real_distribution<double> with std::mt19937(seed), as in makeCloud (libstdc++)."
+	mt = [seed & 0xffffffff]
+	for i in range(1, 624):
+		mt.append((1812433253 * (mt[-1] ^ (mt[-1] >> 30)) + i) & 0xffffffff)
+	g = random.Random()
+	g.setstate((3, tuple(mt) + (624, ), None))
+	return lambda: min((g.getrandbits(32) + g.getrandbits(32) * 4294967296.0) / 18446744073709551616.0, 1 - 2**-53)
+
+
+def cellWrapRel(x, x0, x1):
+	xNorm = (x - x0) / (x1 - x0)
+	return (xNorm - math.floor(xNorm)) * (x1 - x0)
+
+
+def allPairsCloud(mn, mx, rMean, rRelFuzz, num, periodic, seed, hSize=None):
+	"makeCloud with rMean given, testing each candidate against all the spheres already placed."
+	u = stdUniform(seed)
+	size = mx - mn
+	sheared = hSize is not None
+	if not sheared:
+		hSize = Matrix3(size[0], 0, 0, 0, size[1], 0, 0, 0, size[2])
+	invHsize = hSize.inverse() if sheared else None
+
+	def distSq(c, p):
+		if not periodic:
+			return (p - c).squaredNorm()
+		if not sheared:
+			return Vector3([min(cellWrapRel(c[a], p[a], p[a] + size[a]), cellWrapRel(p[a], c[a], c[a] + size[a])) if size[a] else 0 for a in range(3)]).squaredNorm()
+		c1c2 = invHsize * (p - c)
+		dr = Vector3([c1c2[a] if abs(c1c2[a]) < abs(c1c2[a] - math.copysign(1, c1c2[a])) else c1c2[a] - math.copysign(1, c1c2[a]) for a in range(3)])
+		return (hSize * dr).squaredNorm()
+
+	sph = []
+	i = 0
+	while num < 0 or i < num:
+		rand = (num - i + 0.5) / (num + 1.) if num > 0 else u()
+		r = rMean * (2 * (rand - .5) * rRelFuzz + 1)
+		for t in range(1000):
+			if not periodic:
+				c = Vector3([mn[a] + ((size[a] - 2 * r) * u() + r if size[a] else 0) for a in range(3)])
+			else:
+				c = hSize * Vector3(u(), u(), u()) + mn
+			if not any((s[1] + r)**2 >= distSq(c, s[0]) for s in sph):
+				sph.append((c, r))
+				break
+		else:
+			break
+		i += 1
+	return sph
+
+
+def overlapping(sp, periodic):
+	spheres = list(sp)
+	for i in range(len(spheres)):
+		for j in range(i):
+			d = sp.cellSize if periodic else Vector3.Zero
+			dr = spheres[i][0] - spheres[j][0]
+			dr = Vector3([dr[a] - d[a] * round(dr[a] / d[a]) if d[a] else dr[a] for a in range(3)])
+			if dr.norm() < spheres[i][1] + spheres[j][1]:
+				return (i, j)
+	return None
+
+
+cases = [
+        ('box', dict(minCorner=(0, 0, 0), maxCorner=(1, 1, 1), rMean=0.04, rRelFuzz=0.3, num=300, periodic=False, seed=3)),
+        ('periodic', dict(minCorner=(0, 0, 0), maxCorner=(1, 1, 1), rMean=0.04, rRelFuzz=0.3, num=300, periodic=True, seed=4)),
+        (
+                'sheared', dict(minCorner=(0, 0, 0), maxCorner=(1, 1, 1), rMean=0.04, rRelFuzz=0.3, num=200, periodic=True, seed=5,
+                                hSize=Matrix3(1, 0.3, 0, 0, 1, 0, 0, 0, 1))
+        ),
+        ('flat', dict(minCorner=(0, 0, 0), maxCorner=(1, 1, 0), rMean=0.03, rRelFuzz=0.3, num=200, periodic=False, seed=6)),
+        ('num<0', dict(minCorner=(0, 0, 0), maxCorner=(1, 1, 1), rMean=0.1, rRelFuzz=0.2, num=-1, periodic=False, seed=7)),
+]
+for name, kw in cases:
+	sp = pack.SpherePack()
+	sp.makeCloud(**kw)
+	reference = allPairsCloud(
+	        Vector3(kw['minCorner']), Vector3(kw['maxCorner']), kw['rMean'], kw['rRelFuzz'], kw['num'], kw['periodic'], kw['seed'], kw.get('hSize')
+	)
+	spheres = list(sp)
+	if len(spheres) != len(reference):
+		raise YadeCheckError("checkMakeCloud: " + name + ", " + str(len(spheres)) + " spheres instead of " + str(len(reference)) + " with all pairs")
+	for k in range(len(reference)):
+		if (spheres[k][0] - reference[k][0]).norm() > 1e-12 or abs(spheres[k][1] - reference[k][1]) > 1e-12:
+			raise YadeCheckError("checkMakeCloud: " + name + ", sphere " + str(k) + " " + str(spheres[k]) + " instead of " + str(reference[k]) + " with all pairs")
+
+	# parallel=True places the spheres elsewhere: only their number (for num>0) and the absence of overlaps (axis-aligned cells) are checked
+	if name not in ['sheared', 'num<0']:
+		kw['parallel'] = True
+		sp = pack.SpherePack()
+		sp.makeCloud(**kw)
+		if len(sp) != len(reference):
+			raise YadeCheckError("checkMakeCloud: " + name + ", " + str(len(sp)) + " spheres with parallel=True, " + str(len(reference)) + " expected")
+		pair = overlapping(sp, kw['periodic'])
+		if pair:
+			raise YadeCheckError("checkMakeCloud: " + name + ", spheres " + str(pair) + " overlap with parallel=True")
@@ -0,0 +1,44 @@
+# encoding: utf-8
+# Check SpherePack.makeDense: monodisperse spheres in a periodic cell reach porosity 0.37 without overlaps in a few hundred iterations
+# (maxIter=500), and spheres in a box with walls do not overlap or leave it
+from yade import pack
+import math
+
+num, tolerance = 1000, 1e-3
+
+
+def largestOverlap(sp, periodic, mn, mx):
+	"Largest overlap relative to the smallest radius, between two spheres or a sphere and the box, with all pairs."
+	spheres = list(sp)
+	size = Vector3(mx) - Vector3(mn)
+	worst = 0
+	for i in range(len(spheres)):
+		ci, ri = spheres[i]
+		if not periodic:
+			for ax in range(3):
+				worst = max(worst, (mn[ax] + ri - ci[ax]) / ri, (ci[ax] + ri - mx[ax]) / ri)
+		for j in range(i):
+			cj, rj = spheres[j]
+			dr = ci - cj
+			if periodic:
+				dr = Vector3([dr[ax] - size[ax] * round(dr[ax] / size[ax]) for ax in range(3)])
+			worst = max(worst, (ri + rj - dr.norm()) / min(ri, rj))
+	return worst
+
+
+for periodic, target in [(True, 0.37), (False, 0.44)]:  # the walls of a box of 1000 spheres loosen the packing
+	mn, mx = (0, 0, 0), (1, 1, 1)
+	sp = pack.SpherePack()
+	poro = sp.makeDense(mn, mx, target, num, periodic=periodic, seed=1, tolerance=tolerance, maxIter=500)
+	if len(sp) != num:
+		raise YadeCheckError("checkMakeDense: " + str(len(sp)) + " spheres instead of " + str(num))
+	solid = sum(4 / 3. * math.pi * r**3 for c, r in sp)
+	if abs(1 - solid - poro) > 1e-9:
+		raise YadeCheckError("checkMakeDense: returned porosity " + str(poro) + " but the spheres give " + str(1 - solid))
+	if periodic and poro > target + 1e-9:
+		raise YadeCheckError("checkMakeDense: porosity " + str(poro) + " in a periodic cell, " + str(target) + " requested")
+	overlap = largestOverlap(sp, periodic, mn, mx)
+	if overlap > tolerance:
+		raise YadeCheckError(
+		        "checkMakeDense: relative overlap " + str(overlap) + " after 500 iterations (periodic=" + str(periodic) + ", porosity " + str(poro) + ")"
+		)
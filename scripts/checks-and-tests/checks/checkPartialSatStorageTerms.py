@@ -0,0 +1,48 @@
+# encoding: utf-8
+# Check PartialSatClayEngine.storageRefactorTolerance: the pressures obtained by patching the storage terms of the matrix diagonal in place and
+# refactorizing numerically are those of a full rebuild of the linear system (resetLinearSystem) at each step, for useSolver 3 and 4.
+if ('PARTIALSAT' in features) and ('LINSOLV' in features):
+	from yade import pack
+
+	def wetting(useSolver, inPlace):
+		O.reset()
+		mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+		O.bodies.append(aabbWalls([mn, mx], thickness=0))
+		sp = pack.SpherePack()
+		sp.makeCloud(mn, mx, -1, 0.3333, 300, False, 0.95, seed=1)
+		sp.toSimulation(fixed=True)
+		flow = PartialSatClayEngine(
+		        useSolver=useSolver,
+		        pZero=-1e6,  # initial suction, the wetting from the top boundary changes dsdp, hence the storage terms
+		        bndCondIsPressure=[0, 0, 0, 1, 0, 0],
+		        bndCondValue=[0, 0, 0, 0, 0, 0],
+		        particleSwelling=False,
+		        crackModelActive=False,
+		        meshUpdateInterval=-1,
+		        defTolerance=-1,
+		        storageRefactorTolerance=0 if inPlace else -1
+		)
+		O.engines = [ForceResetter(), InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]), flow]
+		O.dt = 1e-3
+		pressures = []
+		for i in range(20):
+			if not inPlace and i > 0: flow.resetLinearSystem()
+			O.step()
+			pressures.append([flow.getCellPressure(k) for k in range(flow.nCells())])
+		return flow, pressures
+
+	for useSolver in [3, 4]:
+		flow, reference = wetting(useSolver, False)
+		flow, pressures = wetting(useSolver, True)
+		if flow.storageRefactors == 0:
+			raise YadeCheckError("checkPartialSatStorageTerms: no storage terms refactorization, useSolver=" + str(useSolver))
+		scale = max(abs(p) for p in reference[0])
+		for step in range(len(reference)):
+			for k in range(len(reference[step])):
+				if abs(pressures[step][k] - reference[step][k]) > 1e-8 * scale:
+					raise YadeCheckError(
+					        "checkPartialSatStorageTerms: pressure " + str(pressures[step][k]) + " instead of " + str(reference[step][k]) + " in cell " + str(k) +
+					        " at step " + str(step) + ", useSolver=" + str(useSolver)
+					)
+else:
+	print("skip checkPartialSatStorageTerms, PartialSatClayEngine or LINSOLV not available")
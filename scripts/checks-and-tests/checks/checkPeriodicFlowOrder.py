@@ -0,0 +1,40 @@
+# encoding: utf-8
+# Check PeriodicFlowEngine with the cells numbered along a Morton curve (spatialOrder, default) against the order of the triangulation: same
+# pressure in each cell, with CHOLMOD (useSolver=4) and the Eigen wrapper (useSolver=3), and with the linear system assembled by several threads.
+if ('PFVFLOW' in features) and ('LINSOLV' in features):
+	from yade import pack
+
+	mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, 500, True, 0.95, seed=1)
+
+	def pressures(useSolver, spatialOrder, threads):
+		O.reset()
+		O.periodic = True
+		O.cell.hSize = Matrix3(mx[0] - mn[0], 0, 0, 0, mx[1] - mn[1], 0, 0, 0, mx[2] - mn[2])
+		sp.toSimulation(fixed=True)
+		flow = PeriodicFlowEngine(
+		        useSolver=useSolver, spatialOrder=spatialOrder, ompThreads=threads, gradP=Vector3(1, 0.5, 0), defTolerance=-1, meshUpdateInterval=-1
+		)
+		O.engines = [ForceResetter(), InsertionSortCollider([Bo1_Sphere_Aabb()]), flow]
+		O.dt = 1e-6
+		O.run(2, True)
+		# the cells are the same in both orders, identified by their Voronoi center
+		return {tuple(flow.getCellCenter(i)): flow.getCellPressure(i) for i in range(flow.nCells())}
+
+	for useSolver in [3, 4]:
+		reference = pressures(useSolver, False, 1)
+		ordered = pressures(useSolver, True, 4)
+		if set(reference) != set(ordered):
+			raise YadeCheckError("checkPeriodicFlowOrder: not the same cells in both orders, useSolver=" + str(useSolver))
+		scale = max(abs(p) for p in reference.values())
+		if scale == 0:
+			raise YadeCheckError("checkPeriodicFlowOrder: no pressure field, useSolver=" + str(useSolver))
+		for center, p in reference.items():
+			if abs(ordered[center] - p) > 1e-9 * scale:
+				raise YadeCheckError(
+				        "checkPeriodicFlowOrder: pressure " + str(ordered[center]) + " instead of " + str(p) + " in the cell centered at " + str(center) +
+				        ", useSolver=" + str(useSolver)
+				)
+else:
+	print("skip checkPeriodicFlowOrder, PFVFLOW or LINSOLV not available")
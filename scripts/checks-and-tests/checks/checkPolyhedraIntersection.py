@@ -0,0 +1,48 @@
+# encoding: utf-8
+# Check the contact detection of Ig2_Polyhedra_Polyhedra_PolyhedraGeom on flat arrays (separating axis test and facets clipping) against the former
+# CGAL intersection (cgalIntersection=True): same overlapping pairs, same penetration volume and contact point, for random pairs of polyhedra.
+if ('CGAL' in features):
+	from yade import polyhedra_utils
+	import random
+
+	random.seed(7)
+	mat = PolyhedraMat(density=2600, young=1e7, poisson=0.002, frictionAngle=0.5)
+	size = 1.
+	for k in range(150):
+		# both polyhedra at a distance between 0.3 and 1.1 size, randomly oriented: overlapping, touching and separated pairs
+		for j in range(2):
+			b = polyhedra_utils.polyhedra(mat, size=Vector3(size, size, size), seed=2 * k + j)
+			axis = Vector3(random.gauss(0, 1), random.gauss(0, 1), random.gauss(0, 1)).normalized()
+			b.state.ori = Quaternion(axis, random.uniform(0, 2 * pi))
+			b.state.pos = Vector3(5 * size * k, 0, 0) + j * random.uniform(0.3, 1.1) * size * Vector3(
+			        random.gauss(0, 1), random.gauss(0, 1), random.gauss(0, 1)
+			).normalized()
+			O.bodies.append(b)
+	O.engines = [
+	        ForceResetter(),
+	        InsertionSortCollider([Bo1_Polyhedra_Aabb()]),
+	        InteractionLoop([Ig2_Polyhedra_Polyhedra_PolyhedraGeom(label='ig2')], [Ip2_PolyhedraMat_PolyhedraMat_PolyhedraPhys()],
+	                        [Law2_PolyhedraGeom_PolyhedraPhys_Volumetric()])
+	]
+	O.dt = 1e-8
+
+	def contacts(cgal):
+		O.interactions.clear()
+		ig2.cgalIntersection = cgal
+		O.step()
+		return {(i.id1, i.id2): (i.geom.penetrationVolume, i.geom.contactPoint) for i in O.interactions if i.isReal}
+
+	flat, reference = contacts(False), contacts(True)
+	tolVolume, tolPoint = 1e-8 * size**3, 1e-6 * size
+	if len(reference) < 30:
+		raise YadeCheckError("checkPolyhedraIntersection: only " + str(len(reference)) + " overlapping pairs")
+	for ids in set(flat) | set(reference):
+		# a pair may be missed by one of them only if its overlap is negligible
+		volume, point = flat.get(ids, (0, None))
+		refVolume, refPoint = reference.get(ids, (0, None))
+		if abs(volume - refVolume) > tolVolume + 1e-6 * refVolume:
+			raise YadeCheckError("checkPolyhedraIntersection: volume " + str(volume) + " instead of " + str(refVolume) + " for pair " + str(ids))
+		if point is not None and refPoint is not None and refVolume > tolVolume and (point - refPoint).norm() > tolPoint:
+			raise YadeCheckError("checkPolyhedraIntersection: contact point " + str(point) + " instead of " + str(refPoint) + " for pair " + str(ids))
+else:
+	print("skip checkPolyhedraIntersection, CGAL not available")
@@ -0,0 +1,80 @@
+# encoding: utf-8
+# Check that the warm start (Ig2_PP_PP_ScGeom.warmStart) and the reuse of the last solution (Ig2_PP_PP_ScGeom.reuseTolerance)
+# give the same contact as the cold start, for two overlapping cubic Potential Particles (see checkPotentialParticles.py) where
+# the second one slides along the first.
+
+if ('POTENTIAL_PARTICLES' in features):
+	Kn = 5e8
+	Ks = 5e7
+	edge = 0.10
+	k = 0.8
+	r = 0.1 * edge
+	R = edge / 2.
+
+	def cube(pos):
+		b = Body()
+		b.aspherical = True
+		b.shape = PotentialParticle(
+		        k=k,
+		        r=r,
+		        R=R,
+		        a=[1, -1, 0, 0, 0, 0],
+		        b=[0, 0, 1, -1, 0, 0],
+		        c=[0, 0, 0, 0, 1, -1],
+		        d=[edge / 2. - r] * 6,
+		        id=len(O.bodies),
+		        isBoundary=False,
+		        AabbMinMax=True,
+		        fixedNormal=False,
+		        minAabb=Vector3(edge / 2., edge / 2., edge / 2.) * 2,
+		        minAabbRotated=Vector3(edge / 2., edge / 2., edge / 2.),
+		        maxAabb=Vector3(edge / 2., edge / 2., edge / 2.) * 2,
+		        maxAabbRotated=Vector3(edge / 2., edge / 2., edge / 2.)
+		)
+		V = edge**3
+		geomInertia = 1 / 6. * V * edge**2.
+		utils._commonBodySetup(b, V, Vector3(geomInertia, geomInertia, geomInertia), material='frictional', pos=pos, fixed=True)
+		b.state.pos = pos
+		return O.bodies.append(b)
+
+	def slide(warmStart, reuseTolerance):
+		O.reset()
+		O.engines = [
+		        ForceResetter(),
+		        InsertionSortCollider([PotentialParticle2AABB()], verletDist=0.0001),
+		        InteractionLoop(
+		                [Ig2_PP_PP_ScGeom(twoDimension=False, calContactArea=True, areaStep=5, warmStart=warmStart, reuseTolerance=reuseTolerance)],
+		                [Ip2_FrictMat_FrictMat_KnKsPhys(kn_i=Kn, ks_i=Ks, Knormal=Kn, Kshear=Ks, useFaceProperties=False, viscousDamping=0.1)],
+		                [Law2_SCG_KnKsPhys_KnKsLaw(neverErase=False)]
+		        ),
+		        NewtonIntegrator(damping=0.0, exactAsphericalRot=True, gravity=[0, 0, 0]),
+		]
+		O.materials.append(FrictMat(young=-1, poisson=-1, frictionAngle=radians(30.0), density=2000, label='frictional'))
+		cube([0, 0, 0])
+		cube([edge * 0.9, 0, 0])
+		O.bodies[1].state.vel = Vector3(0, edge, 0)  # blocked DOFs, the velocity is kept
+		O.dt = 1e-4
+		history = []
+		for i in range(20):
+			O.run(1, True)
+			c = O.interactions[0, 1]
+			history.append((Vector3(c.geom.contactPoint), c.geom.penetrationDepth, Vector3(c.geom.normal)))
+		return history
+
+	reference = slide(False, 0)
+	tol = 1e-6
+	for warmStart, reuseTolerance in [(True, 0), (True, 1e-3), (False, 1e-3)]:
+		history = slide(warmStart, reuseTolerance)
+		case = "checkPotentialWarmStart: warmStart=%s reuseTolerance=%g" % (warmStart, reuseTolerance)
+		for step, (ref, res) in enumerate(zip(reference, history)):
+			if (ref[2] - res[2]).norm() > tol or abs(ref[1] - res[1]) > tol * edge:
+				raise YadeCheckError(
+				        case + " differs from the cold start at step " + str(step) + ": normal " + str(res[2]) + " vs " + str(ref[2]) +
+				        ", penetration depth " + str(res[1]) + " vs " + str(ref[1])
+				)
+			# the contact point is only reused (or started from) while it is inside both particles
+			if (ref[0] - res[0]).norm() > 0.1 * edge:
+				raise YadeCheckError(case + ": contact point " + str(res[0]) + " far from the cold start one " + str(ref[0]) + " at step " + str(step))
+
+else:
+	print("skip checkPotentialWarmStart, PotentialParticles not available")
@@ -0,0 +1,78 @@
+# encoding: utf-8
+# Check Predicate.filter (parallel evaluation of compiled predicates, sphere by sphere otherwise) against the evaluation of the predicate
+# sphere by sphere from python, for primitive predicates, boolean trees, trees containing a python predicate and GTS surfaces
+from yade import pack
+
+
+class inSlab(pack.Predicate):
+	"A predicate defined in python: |z|<=halfWidth."
+
+	def __init__(self, halfWidth):
+		self.halfWidth = halfWidth
+
+	def aabb(self):
+		inf = float('inf')
+		return Vector3(-inf, -inf, -self.halfWidth), Vector3(inf, inf, self.halfWidth)
+
+	def center(self):
+		return Vector3.Zero
+
+	def dim(self):
+		inf = float('inf')
+		return Vector3(inf, inf, 2 * self.halfWidth)
+
+	def __call__(self, pt, pad=0.):
+		return abs(pt[2]) + pad <= self.halfWidth
+
+
+# a regular packing with radii varying along x, so that the padding matters
+sp = pack.SpherePack()
+step = 0.06
+for i in range(-20, 21):
+	for j in range(-20, 21):
+		for k in range(-20, 21):
+			sp.add(Vector3(i, j, k) * step + Vector3(0.01 * j, 0.013 * k, 0.007 * i), 0.02 + 0.0005 * (i + 20))
+
+predicates = [
+        ('inSphere', pack.inSphere((0, 0, 0), 0.8), True),
+        ('inAlignedBox', pack.inAlignedBox((-0.5, -0.7, -0.3), (0.6, 0.2, 0.9)), True),
+        ('inParallelepiped', pack.inParallelepiped((-0.5, -0.5, -0.5), (0.7, -0.4, -0.5), (-0.3, 0.6, -0.4), (-0.5, -0.4, 0.8)), True),
+        ('inCylinder', pack.inCylinder((0, 0, -0.9), (0.2, 0.1, 0.9), 0.5), True),
+        ('inHyperboloid', pack.inHyperboloid((0, 0, -0.9), (0, 0, 0.9), 0.8, 0.4), True),
+        ('inEllipsoid', pack.inEllipsoid((0.1, 0, 0), (0.9, 0.5, 0.7)), True),
+        ('notInNotch', pack.notInNotch((0, 0, 0), (1, 0, 0), (0, 0, 1), 0.1) & pack.inSphere((0, 0, 0), 0.9), True),
+        (
+                'tree', (pack.inSphere((0, 0, 0), 0.9) - pack.inCylinder((0, 0, -1), (0, 0, 1), 0.3)) | (pack.inAlignedBox(
+                        (-1, -1, -1), (-0.6, 1, 1)
+                ) ^ pack.inEllipsoid((-0.7, 0, 0), (0.4, 0.6, 0.6))), True
+        ),
+        ('python leaf', pack.inSphere((0, 0, 0), 0.9) & inSlab(0.4), False),
+        ('python root', inSlab(0.4), False),
+]
+try:
+	import gts
+	surf = gts.sphere(3)
+	predicates += [
+	        ('inGtsSurface', pack.inGtsSurface(surf), True),
+	        ('inGtsSurface noPad', pack.inGtsSurface(surf, True), True),
+	        ('inGtsSurface tree', pack.inGtsSurface(surf) - pack.inCylinder((0, 0, -1), (0, 0, 1), 0.3), True),
+	]
+except ImportError:
+	print("checkPredicateFilter: gts not available, inGtsSurface is not checked")
+
+for name, pred, compiled in predicates:
+	if pred.compiled != compiled:
+		raise YadeCheckError("checkPredicateFilter: " + name + ".compiled is " + str(pred.compiled) + ", expected " + str(compiled))
+	reference = [(c, r) for c, r in sp if pred(c, r)]
+	filtered = list(pred.filter(sp))
+	if len(reference) == 0 or len(reference) == len(sp):
+		raise YadeCheckError("checkPredicateFilter: " + name + " keeps " + str(len(reference)) + " spheres of " + str(len(sp)) + ", the check is meaningless")
+	if filtered != reference:
+		raise YadeCheckError(
+		        "checkPredicateFilter: " + name + ".filter keeps " + str(len(filtered)) + " spheres, the sphere by sphere evaluation " + str(len(reference))
+		)
+	# filterSpherePack moves the packing to the center of the predicate first
+	moved = pack.SpherePack(list(sp))
+	filtered = list(pack.filterSpherePack(pred, moved, returnSpherePack=True))
+	if filtered != [(c, r) for c, r in moved if pred(c, r)]:
+		raise YadeCheckError("checkPredicateFilter: pack.filterSpherePack differs from the sphere by sphere evaluation for " + name)
@@ -0,0 +1,70 @@
+# encoding: utf-8
+# Check SeriesRecorder against export.SeriesReader: the values read back equal the states of the spheres at each recorded step, with and
+# without compression, over several chunks, and while spheres are erased so that the number of rows changes between steps
+from yade import export
+import os, shutil, tempfile
+
+tmpDir = tempfile.mkdtemp()
+expected = []
+
+
+def snapshot():
+	spheres = [b for b in O.bodies if isinstance(b.shape, Sphere)]
+	expected.append(
+	        (
+	                O.iter, O.time, {
+	                        'id': [b.id for b in spheres],
+	                        'pos': [b.state.pos for b in spheres],
+	                        'radius': [b.shape.radius for b in spheres],
+	                        'linVel': [b.state.vel for b in spheres],
+	                        'mask': [b.groupMask for b in spheres],
+	                }
+	        )
+	)
+	# erase a sphere every other step, the next recorded step has one row less
+	if O.iter % 2 and len(spheres) > 1:
+		O.bodies.erase(spheres[len(spheres) // 2].id)
+
+
+for compress in [True, False]:
+	O.reset()
+	expected = []
+	fileName = os.path.join(tmpDir, 'run%d.ser' % compress)
+	O.bodies.append([sphere((i, 0.1 * i, 0), 0.4, mask=1 + i % 3) for i in range(12)])
+	for b in O.bodies:
+		b.state.vel = Vector3(0.1 * b.id, -1, 0.5)
+	O.engines = [
+	        ForceResetter(),
+	        NewtonIntegrator(gravity=(0, 0, -10)),
+	        SeriesRecorder(fileName=fileName, recorders=['spheres', 'velocity', 'mask'], compress=compress, chunkSteps=3, iterPeriod=1, label='rec'),
+	        PyRunner(command='snapshot()', iterPeriod=1, initRun=True),
+	]
+	O.dt = 1e-3
+	O.run(10, True)
+	rec.flush()
+	reader = export.SeriesReader(fileName)
+	what = 'compressed' if compress else 'uncompressed'
+	if reader.iterations != [e[0] for e in expected]:
+		raise YadeCheckError("checkSeriesRecorder: " + what + ", iterations " + str(reader.iterations) + " instead of " + str([e[0] for e in expected]))
+	times = reader.field('time')
+	for name in ['id', 'pos', 'radius', 'linVel', 'mask']:
+		values = reader.field(name)
+		for step, (it, time, reference) in enumerate(expected):
+			if abs(times[step][0] - time) > 1e-15:
+				raise YadeCheckError("checkSeriesRecorder: " + what + ", time " + str(times[step][0]) + " at iteration " + str(it) + ", expected " + str(time))
+			if len(values[step]) != len(reference[name]):
+				raise YadeCheckError(
+				        "checkSeriesRecorder: " + what + ", " + str(len(values[step])) + " rows of " + name + " at iteration " + str(it) + " instead of " +
+				        str(len(reference[name]))
+				)
+			for row, ref in zip(values[step], reference[name]):
+				# values are stored as double, exact for the default Real
+				if isinstance(ref, Vector3):
+					ok = (Vector3(*row) - ref).norm() <= 1e-14 * (1 + ref.norm())
+				else:
+					ok = abs(row - ref) <= 1e-14 * (1 + abs(ref))
+				if not ok:
+					raise YadeCheckError("checkSeriesRecorder: " + what + ", " + name + " " + str(row) + " at iteration " + str(it) + ", expected " + str(ref))
+	if len(expected[-1][2]['id']) >= len(expected[0][2]['id']):
+		raise YadeCheckError("checkSeriesRecorder: no sphere was erased, the check is meaningless")
+shutil.rmtree(tmpDir)
@@ -0,0 +1,75 @@
+# encoding: utf-8
+# Check SpherePack.saveBinary/loadBinary round trips (periodic cell, PSD scaling, clump ids), the rejection of corrupt files, and the keys of
+# pack.cachedSpherePack: two different generators (e.g. lambdas) with the same parameters do not share a cached packing
+from yade import pack
+import os, shutil, struct, tempfile
+
+tmpDir = tempfile.mkdtemp()
+fileName = os.path.join(tmpDir, 'pack.spk')
+
+
+def roundTrip(sp, what):
+	sp.saveBinary(fileName)
+	sp2 = pack.SpherePack()
+	sp2.loadBinary(fileName)
+	if sp2.toList() != sp.toList():
+		raise YadeCheckError("checkSpherePackBinary: spheres differ after a round trip (" + what + ")")
+	if sp2.isPeriodic != sp.isPeriodic or sp2.cellSize != sp.cellSize or sp2.appliedPsdScaling != sp.appliedPsdScaling:
+		raise YadeCheckError(
+		        "checkSpherePackBinary: periodicity, cell size or PSD scaling differ after a round trip (" + what + "): " +
+		        str((sp2.isPeriodic, sp2.cellSize, sp2.appliedPsdScaling)) + " vs " + str((sp.isPeriodic, sp.cellSize, sp.appliedPsdScaling))
+		)
+
+
+# periodic, with a PSD scaled down to fit
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), psdSizes=[0.1, 0.2, 0.3], psdCumm=[0, 0.5, 1], num=400, periodic=True, porosity=0.5, seed=1)
+if not sp.isPeriodic or sp.appliedPsdScaling >= 1:
+	raise YadeCheckError("checkSpherePackBinary: the periodic packing with a scaled PSD was not generated as expected")
+roundTrip(sp, "periodic")
+# clump ids, not periodic
+sp = pack.SpherePack([(Vector3(i, 0.5 * i, -i), 0.1 + 0.01 * i, i // 3 if i % 2 else -1) for i in range(20)])
+roundTrip(sp, "clumps")
+roundTrip(pack.SpherePack(), "empty")
+
+# corrupt files are rejected
+sp.saveBinary(fileName)
+data = open(fileName, 'rb').read()
+count = struct.unpack('<Q', data[16:24])[0]
+for what, corrupt in [
+        ('truncated', data[:-1]),
+        ('too long', data + b'\0'),
+        ('short header', data[:32]),
+        ('bad magic', b'X' + data[1:]),
+        ('count', data[:16] + struct.pack('<Q', count + 1) + data[24:]),
+        ('overflowing count', data[:16] + struct.pack('<Q', 2**62 + count) + data[24:]),
+]:
+	open(fileName, 'wb').write(corrupt)
+	try:
+		pack.SpherePack().loadBinary(fileName)
+	except RuntimeError:
+		continue
+	raise YadeCheckError("checkSpherePackBinary: a corrupt file (" + what + ") was loaded")
+
+# cached packings: keyed on the code of the generator, or on generatorKey
+cacheDir = os.path.join(tmpDir, 'cache')
+
+
+def cloud(num, seed):
+	sp = pack.SpherePack()
+	sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.05, num=num, seed=seed)
+	return sp
+
+
+generated = pack.cachedSpherePack(cacheDir, cloud, num=50, seed=1)
+cached = pack.cachedSpherePack(cacheDir, cloud, num=50, seed=1)
+if cached.toList() != generated.toList() or len(os.listdir(cacheDir)) != 1:
+	raise YadeCheckError("checkSpherePackBinary: the cached packing was not reused")
+small = pack.cachedSpherePack(cacheDir, lambda num, seed: cloud(num, seed), num=50, seed=1)
+big = pack.cachedSpherePack(cacheDir, lambda num, seed: cloud(2 * num, seed), num=50, seed=1)
+if len(small) != 50 or len(big) != 100:
+	raise YadeCheckError("checkSpherePackBinary: two lambdas with the same parameters shared a cached packing (" + str((len(small), len(big))) + ")")
+keyed = pack.cachedSpherePack(cacheDir, lambda num, seed: cloud(3 * num, seed), generatorKey='cloud', num=50, seed=1)
+if len(pack.cachedSpherePack(cacheDir, cloud, generatorKey='cloud', num=50, seed=1)) != len(keyed):
+	raise YadeCheckError("checkSpherePackBinary: generatorKey did not identify the cached packing")
+shutil.rmtree(tmpDir)
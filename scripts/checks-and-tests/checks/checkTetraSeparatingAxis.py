@@ -0,0 +1,46 @@
+# encoding: utf-8
+# Check the separating axis early-out of the Tetra functors on random pairs of tetrahedra: a pair it declares separated (whatever the cached axis
+# tested first) has no intersection volume as computed by Ig2_Tetra_Tetra_TTetraGeom, including pairs with parallel edges or nearly touching.
+import random
+
+random.seed(11)
+
+
+def randomTetra(center, size):
+	while True:
+		v = [center + size * Vector3(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1)) for i in range(4)]
+		if utils.TetrahedronVolume(v) > 1e-3 * size**3: return v
+
+
+def randomUnit():
+	return Vector3(random.gauss(0, 1), random.gauss(0, 1), random.gauss(0, 1)).normalized()
+
+
+nSeparated, nOverlapping = 0, 0
+for k in range(20000):
+	a = randomTetra(Vector3.Zero, 1)
+	if k % 4 == 0:
+		# translated copy: all edges parallel to those of a
+		b = [x + random.uniform(0.5, 2.5) * randomUnit() for x in a]
+	elif k % 4 == 1:
+		# vertex of b close to a face of a, on either side
+		b = randomTetra(Vector3.Zero, 1)
+		n = (a[1] - a[0]).cross(a[2] - a[0]).normalized()
+		if n.dot(a[3] - a[0]) > 0: n = -n
+		shift = a[0] - b[0] + n * random.uniform(-1e-3, 1e-3) + 0.2 * ((a[1] - a[0]) + (a[2] - a[0]))
+		b = [x + shift for x in b]
+	else:
+		b = randomTetra(random.uniform(0.5, 2.5) * randomUnit(), random.uniform(0.3, 1.5))
+	volume = utils.TetraIntersectionVolume(a, b)
+	tol = 1e-12 * min(utils.TetrahedronVolume(a), utils.TetrahedronVolume(b))
+	for cached in [-1, random.randint(0, 43)]:
+		axis = utils.TetraSeparatingAxis(a, b, cached)
+		if axis >= 0 and volume > tol:
+			raise YadeCheckError(
+			        "checkTetraSeparatingAxis: axis " + str(axis) + " (cached " + str(cached) + ") separates tetrahedra with an intersection volume " +
+			        str(volume) + ": " + str(a) + " and " + str(b)
+			)
+	if axis >= 0: nSeparated += 1
+	elif volume > tol: nOverlapping += 1
+if nSeparated < 2000 or nOverlapping < 2000:
+	raise YadeCheckError("checkTetraSeparatingAxis: " + str(nSeparated) + " separated and " + str(nOverlapping) + " overlapping pairs only")
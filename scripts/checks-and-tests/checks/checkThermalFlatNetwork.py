@@ -0,0 +1,77 @@
+# encoding: utf-8
+# ThermalEngine on the flat, spatially ordered copy of the PFV network (FlowEngine.flatNetwork) against the original loops on CGAL handles:
+# temperatures and the estimated thermal time step must match.
+from yade import pack
+
+if ('THERMAL' in features):
+
+	def runThermal(flatNetwork):
+		O.reset()
+		mn, mx = Vector3(0, 0, 0), Vector3(0.05, 0.05, 0.05)
+		O.materials.append(FrictMat(young=5e8, poisson=0.5, frictionAngle=0, density=2600, label='walls'))
+		O.materials.append(FrictMat(young=5e6, poisson=0.5, frictionAngle=radians(30), density=2600, label='spheres'))
+		O.bodies.append(aabbWalls([mn, mx], thickness=0, material='walls'))
+		O.bodies.append(pack.regularHexa(pack.inAlignedBox(mn, mx), radius=0.005, gap=0, material='spheres'))
+		O.engines = [
+		        ForceResetter(),
+		        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+		        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()],
+		                        [Law2_ScGeom_FrictPhys_CundallStrack()]),
+		        FlowEngine(
+		                label="flow",
+		                multithread=False,
+		                flatNetwork=flatNetwork,
+		                useSolver=4,
+		                permeabilityFactor=-1e-5,
+		                viscosity=0.001,
+		                fluidBulkModulus=2.2e9,
+		                pZero=10,
+		                bndCondIsPressure=[0, 0, 0, 0, 1, 1],
+		                bndCondValue=[0, 0, 0, 0, 10, 10],
+		                thermalEngine=True,
+		                bndCondIsTemperature=[0, 0, 0, 0, 1, 0],
+		                thermalBndCondValue=[0, 0, 0, 0, 45, 0],
+		                tZero=45,
+		                meshUpdateInterval=1000
+		        ),
+		        ThermalEngine(
+		                label='thermal',
+		                conduction=True,
+		                fluidConduction=True,
+		                advection=True,
+		                thermoMech=False,
+		                useKernMethod=False,
+		                bndCondIsTemperature=[0, 0, 0, 0, 0, 1],
+		                thermalBndCondValue=[0, 0, 0, 0, 0, 25],
+		                fluidK=0.650,
+		                particleT0=25,
+		                particleK=2.0,
+		                particleCp=710,
+		                particleDensity=2700,
+		                tsSafetyFactor=0.8,
+		                uniformReynolds=10,
+		                minimumThermalCondDist=0
+		        ),
+		        NewtonIntegrator(damping=0.5)
+		]
+		O.dt = 1e-7
+		O.dynDt = False
+		O.run(200, True)
+		fluid = [flow.getPoreTemperature((x, 0.025, 0.025)) for x in (0.0125, 0.025, 0.0375)]
+		solid = [b.state.temp for b in O.bodies if isinstance(b.shape, Sphere)]
+		return thermal.getMaxTimeStep(), fluid, solid
+
+	dtRef, fluidRef, solidRef = runThermal(False)
+	dtFlat, fluidFlat, solidFlat = runThermal(True)
+	tol = 1e-8
+	print('thermal time step', dtRef, dtFlat)
+	if abs(dtFlat - dtRef) > tol * abs(dtRef):
+		raise YadeCheckError('checkThermalFlatNetwork: thermal time step differs with flatNetwork (%g instead of %g)' % (dtFlat, dtRef))
+	for a, b in zip(fluidFlat, fluidRef):
+		if abs(a - b) > tol * abs(b):
+			raise YadeCheckError('checkThermalFlatNetwork: pore temperature differs with flatNetwork (%g instead of %g)' % (a, b))
+	for a, b in zip(solidFlat, solidRef):
+		if abs(a - b) > tol * abs(b):
+			raise YadeCheckError('checkThermalFlatNetwork: particle temperature differs with flatNetwork (%g instead of %g)' % (a, b))
+else:
+	print("This checkThermalFlatNetwork.py cannot be executed because ENABLE_THERMAL is disabled")
@@ -0,0 +1,58 @@
+# encoding: utf-8
+# Solid conduction in ThermalEngine, explicit forward difference against the implicit (backward Euler) step: with a time step well below
+# the stability limit both give the same temperatures. The implicit run has no explicit term left to bound the thermal time step, its
+# conduction period must stay a valid number of iterations.
+from yade import pack
+
+if ('THERMAL' in features):
+
+	def runConduction(implicit):
+		O.reset()
+		mn, mx = Vector3(0, 0, 0), Vector3(0.05, 0.05, 0.05)
+		O.materials.append(FrictMat(young=5e8, poisson=0.5, frictionAngle=0, density=2600, label='walls'))
+		O.materials.append(FrictMat(young=5e6, poisson=0.5, frictionAngle=radians(30), density=2600, label='spheres'))
+		O.bodies.append(aabbWalls([mn, mx], thickness=0, material='walls'))
+		O.bodies.append(pack.regularHexa(pack.inAlignedBox(mn, mx), radius=0.005, gap=0, material='spheres'))
+		O.engines = [
+		        ForceResetter(),
+		        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+		        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()],
+		                        [Law2_ScGeom_FrictPhys_CundallStrack()]),
+		        FlowEngine(label="flow", multithread=False, useSolver=4, thermalEngine=True, tZero=25, meshUpdateInterval=1000),
+		        ThermalEngine(
+		                label='thermal',
+		                conduction=True,
+		                fluidConduction=False,
+		                advection=False,
+		                thermoMech=False,
+		                implicitConduction=implicit,
+		                implicitTolerance=1e-10,
+		                bndCondIsTemperature=[0, 0, 0, 0, 1, 1],
+		                thermalBndCondValue=[0, 0, 0, 0, 45, 25],
+		                particleT0=25,
+		                particleK=2.0,
+		                particleCp=710,
+		                particleDensity=2700,
+		                tsSafetyFactor=0.1
+		        ),
+		        NewtonIntegrator(damping=0.5)
+		]
+		O.dt = 1e-5
+		O.dynDt = False
+		O.run(300, True)
+		return thermal.getConductionIterPeriod(), [b.state.temp for b in O.bodies if isinstance(b.shape, Sphere)]
+
+	periodExplicit, explicitT = runConduction(False)
+	periodImplicit, implicitT = runConduction(True)
+	print('conduction periods', periodExplicit, periodImplicit)
+	if periodImplicit < 0:
+		raise YadeCheckError('checkThermalImplicit: invalid conduction period %d with implicit conduction' % periodImplicit)
+	maxDiff = max(abs(a - b) for a, b in zip(explicitT, implicitT))
+	heated = max(abs(t - 25) for t in explicitT)
+	print('largest temperature rise', heated, 'largest explicit/implicit difference', maxDiff)
+	if heated == 0:
+		raise YadeCheckError('checkThermalImplicit: no conduction happened')
+	if maxDiff > 0.02 * heated:
+		raise YadeCheckError('checkThermalImplicit: implicit and explicit conduction differ by %g (temperature rise %g)' % (maxDiff, heated))
+else:
+	print("This checkThermalImplicit.py cannot be executed because ENABLE_THERMAL is disabled")
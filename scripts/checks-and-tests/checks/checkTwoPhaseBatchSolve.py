@@ -0,0 +1,66 @@
+# encoding: utf-8
+# Check PhaseCluster.solvePressures (several capillary pressure sets in one batch of triangular solves) against PhaseCluster.solvePressure
+if ('PFVFLOW' in features) and ('TWOPHASEFLOW' in features) and ('LINSOLV' in features):
+	from yade import pack
+
+	tolerance = 1e-9
+	mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 0.4)
+	O.bodies.append(aabbWalls([mn, mx], thickness=0))
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, 300, False, 0.95, seed=1)
+	sp.toSimulation()
+
+	O.engines = [
+	        ForceResetter(),
+	        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+	        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+	        TwoPhaseFlowEngine(dead=1, label="flow"),
+	        NewtonIntegrator(damping=0.2)
+	]
+	O.dt = 0.5 * PWaveTimeStep()
+	O.run(1, True)
+
+	flow.meshUpdateInterval = -1
+	flow.useSolver = 3
+	flow.viscosity = 0.1
+	flow.bndCondIsWaterReservoir = [0, 0, 1, 0, 0, 0]
+	flow.bndCondIsPressure = [0, 0, 1, 0, 0, 0]
+	flow.bndCondValue = [0, 0, 1000, 0, 0, 0]
+	flow.surfaceTension = 0.0
+	flow.drainageFirst = False
+	flow.isDrainageActivated = False
+	flow.isImbibitionActivated = True
+	flow.isCellLabelActivated = True
+	flow.initialization()
+	c0 = flow.getClusters()[1]
+
+	# imbibe a few pores so that the cluster has interfaces with different conductivities
+	for i in range(5):
+		interface = c0.getInterfaces()[0]
+		flow.clusterOutvadePore(interface[0], interface[1])
+	nInterfaces = len(c0.getInterfaces())
+	if nInterfaces == 0:
+		raise YadeCheckError("checkTwoPhaseBatchSolve: no interface in the cluster, the check is meaningless")
+
+	pcs = [100. * (1 + 0.1 * i) for i in range(nInterfaces)]
+	for i in range(nInterfaces):
+		c0.setCapPressure(i, pcs[i])
+	c0.solvePressure()
+	reference = [flow.getCellPressure(i) for i in c0.getPores()]
+
+	batch = c0.solvePressures([pcs, [2 * p for p in pcs], [3 * p for p in pcs]])
+	scale = max(abs(p) for p in reference)
+	for k in range(len(reference)):
+		if abs(batch[0][k] - reference[k]) > tolerance * scale:
+			raise YadeCheckError(
+			        "checkTwoPhaseBatchSolve: batch column 0 differs from solvePressure in pore " + str(k) + ": " + str(batch[0][k]) + " vs " +
+			        str(reference[k])
+			)
+		# the pressure is affine in the capillary pressures
+		if abs((batch[2][k] - batch[1][k]) - (batch[1][k] - batch[0][k])) > tolerance * scale:
+			raise YadeCheckError("checkTwoPhaseBatchSolve: batch columns are not affine in the capillary pressures in pore " + str(k))
+	if [flow.getCellPressure(i) for i in c0.getPores()] != reference:
+		raise YadeCheckError("checkTwoPhaseBatchSolve: solvePressures modified the cell pressures")
+
+else:
+	print("skip checkTwoPhaseBatchSolve, TwoPhaseFlowEngine with LINSOLV not available")
@@ -0,0 +1,60 @@
+# encoding: utf-8
+# Check TwoPhaseFlowEngine.drainageCurve (event-driven quasi-static drainage) against a loop of invasion() calls at the same capillary pressures:
+# same saturations after each step and same final state of the pores, with and without trapping. The settings it does not reproduce are rejected.
+if ('PFVFLOW' in features) and ('TWOPHASEFLOW' in features):
+	from yade import pack
+
+	def drainage(eventDriven, trapped):
+		O.reset()
+		mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 0.5)
+		O.bodies.append(aabbWalls([mn, mx], thickness=0))
+		sp = pack.SpherePack()
+		sp.makeCloud(mn, mx, -1, 0.3333, 400, False, 0.95, seed=1)
+		sp.toSimulation()
+		meanDiameter = 2 * sum(b.shape.radius for b in O.bodies if isinstance(b.shape, Sphere)) / len(sp)
+		tpf = TwoPhaseFlowEngine()
+		tpf.bndCondIsPressure = [0, 0, 1, 1, 0, 0]
+		tpf.bndCondValue = [0, 0, -1e8, 0, 0, 0]
+		tpf.isPhaseTrapped = trapped
+		tpf.initialization()
+		tpf.surfaceTension = 10
+		pcs = [(1e-5 + 0.25 * k) * tpf.surfaceTension / meanDiameter for k in range(60)]
+		if eventDriven:
+			saturations = tpf.drainageCurve(pcs)
+		else:
+			saturations = []
+			for pc in pcs:
+				tpf.bndCondValue = [0, 0, -pc, 0, 0, 0]
+				tpf.invasion()
+				saturations.append(tpf.getSaturation(False))
+		cells = [(tpf.getCellSaturation(i), tpf.getCellIsNWRes(i), tpf.getCellIsTrapW(i)) for i in range(tpf.nCells())]
+		return tpf, saturations, cells
+
+	for trapped in [True, False]:
+		tpf, reference, refCells = drainage(False, trapped)
+		tpf, saturations, cells = drainage(True, trapped)
+		if reference[0] == reference[-1]:
+			raise YadeCheckError("checkTwoPhaseDrainageCurve: no pore invaded, the capillary pressures are too low")
+		for k in range(len(reference)):
+			if abs(saturations[k] - reference[k]) > 1e-12:
+				raise YadeCheckError(
+				        "checkTwoPhaseDrainageCurve: saturation " + str(saturations[k]) + " instead of " + str(reference[k]) + " at step " + str(k) +
+				        ", isPhaseTrapped=" + str(trapped)
+				)
+		if cells != refCells:
+			bad = [i for i in range(len(cells)) if cells[i] != refCells[i]]
+			raise YadeCheckError(
+			        "checkTwoPhaseDrainageCurve: " + str(len(bad)) + " pores (first " + str(bad[0]) + ") in another final state, isPhaseTrapped=" +
+			        str(trapped)
+			)
+
+	for attr, value in [('isImbibitionActivated', True), ('isDrainageActivated', False), ('recursiveInvasion', False), ('useFastInvasion', True)]:
+		setattr(tpf, attr, value)
+		try:
+			tpf.drainageCurve([1.])
+			raise YadeCheckError("checkTwoPhaseDrainageCurve: drainageCurve accepted " + attr + "=" + str(value))
+		except ValueError:
+			pass
+		setattr(tpf, attr, not value)
+else:
+	print("skip checkTwoPhaseDrainageCurve, TwoPhaseFlowEngine not available")
@@ -0,0 +1,92 @@
+# encoding: utf-8
+# Check the spheres files of VTKRecorder.asyncWrite, raw and zlib-compressed, against the synchronous VTK writer: the files are read back and
+# the points and fields compared at each export. Changes of compress and maxPending between exports apply to the next files.
+if ('VTK' in features):
+	from yade import pack
+	import os, re, struct, tempfile, zlib
+	import xml.etree.ElementTree as ET
+
+	outDir = tempfile.mkdtemp()
+
+	def readAscii(fileName):
+		"fields of a VTK XML file written with VTKRecorder.ascii, as {name: list of floats}"
+		root = ET.parse(fileName).getroot()
+		arrays = {a.get('Name'): [float(x) for x in a.text.split()] for a in root.iter('DataArray')}
+		arrays['Points'] = [float(x) for x in root.find('.//Points/DataArray').text.split()]  # not named by older VTK versions
+		return arrays
+
+	def readAppended(fileName):
+		"fields of a VTK XML file with appended raw data and UInt64 headers, compressed or not, as {name: list of floats}, and whether compressed"
+		data = open(fileName, 'rb').read()
+		start = data.index(b'<AppendedData')
+		base = data.index(b'_', start) + 1
+		head = data[:start].decode()
+		compressed = 'compressor="vtkZLibDataCompressor"' in head
+		types = {'Float64': 'd', 'Int64': 'q', 'UInt8': 'B'}
+		arrays = {}
+		for tag in re.findall(r'<DataArray [^>]*>', head):
+			attr = dict(re.findall(r'(\w+)="([^"]*)"', tag))
+			pos = base + int(attr['offset'])
+			if compressed:
+				nBlocks = struct.unpack_from('<Q', data, pos)[0]
+				sizes = struct.unpack_from('<%dQ' % nBlocks, data, pos + 24)
+				pos += 8 * (3 + nBlocks)
+				raw = b''
+				for s in sizes:
+					raw += zlib.decompress(data[pos:pos + s])
+					pos += s
+			else:
+				nBytes = struct.unpack_from('<Q', data, pos)[0]
+				raw = data[pos + 8:pos + 8 + nBytes]
+			fmt = types[attr['type']]
+			arrays[attr['Name']] = [float(x) for x in struct.unpack('<%d%s' % (len(raw) // struct.calcsize(fmt), fmt), raw)]
+		return arrays, compressed
+
+	sp = pack.SpherePack()
+	sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.05, rRelFuzz=.3, num=300, seed=1)
+	sp.toSimulation(color=(0.2, 0.4, 0.6))
+	recorders = ['spheres', 'id', 'mask', 'mass', 'clumpId', 'colors', 'velocity', 'stress', 'force', 'materialId', 'coordNumber']
+	period = 20
+
+	def recorder(prefix, **kw):
+		return VTKRecorder(fileName=os.path.join(outDir, prefix + '-'), recorders=recorders, iterPeriod=period, **kw)
+
+	reference = recorder('sync', ascii=True)
+	plain = recorder('raw', asyncWrite=True, compress=False, maxPending=3)
+	packed = recorder('zlib', asyncWrite=True, compress=True)
+	O.engines = [
+	        ForceResetter(),
+	        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+	        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+	        NewtonIntegrator(gravity=(0, 0, -9.81), damping=.2), reference, plain, packed
+	]
+	O.dt = .5 * PWaveTimeStep()
+	O.run(5 * period, True)
+	first = O.iter
+	# the next exports of each async recorder use the other compression, and another queue limit
+	plain.compress, plain.maxPending = True, 1
+	packed.compress, packed.maxPending = False, 4
+	O.run(5 * period, True)
+	plain.flush()
+	packed.flush()
+
+	exports = sorted(int(f.split('.')[1]) for f in os.listdir(outDir) if f.startswith('sync-spheres.'))
+	if len(exports) < 9 or len([it for it in exports if it >= first]) < 4:
+		raise YadeCheckError("checkVTKAsync: synchronous exports at iterations " + str(exports))
+	for it in exports:
+		ref = readAscii(os.path.join(outDir, 'sync-spheres.%d.vtu' % it))
+		for prefix in ['raw', 'zlib']:
+			fileName = os.path.join(outDir, prefix + '-spheres.%d.vtu' % it)
+			arrays, compressed = readAppended(fileName)
+			if compressed != ((prefix == 'zlib') == (it < first)):
+				raise YadeCheckError("checkVTKAsync: " + fileName + (" compressed" if compressed else " not compressed"))
+			for name in ['Points', 'radii', 'id', 'mask', 'mass', 'clumpId', 'color', 'linVelVec', 'angVelVec', 'normalStress', 'shearStress', 'forceVec',
+			             'torqueVec', 'materialId', 'coordNumber']:
+				if name not in arrays or name not in ref:
+					raise YadeCheckError("checkVTKAsync: no field " + name + " in " + fileName + " or in the synchronous file")
+				a, b = arrays[name], ref[name]
+				scale = max([abs(x) for x in b] + [1e-300])
+				if len(a) != len(b) or any(abs(x - y) > 1e-9 * scale for x, y in zip(a, b)):
+					raise YadeCheckError("checkVTKAsync: field " + name + " of " + fileName + " differs from the synchronous file")
+else:
+	print("skip checkVTKAsync, VTK not available")
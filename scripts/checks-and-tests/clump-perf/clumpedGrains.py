@@ -0,0 +1,42 @@
+# -*- encoding=utf-8 -*-
+# Force gathering and member motion of clumps with many members.
+# Run with: yade-trunk-multi -j1 clumpedGrains.table clumpedGrains.py
+from __future__ import print_function
+import random, time
+from yade import timing
+
+utils.readParamsFromTable(nClumps=2000, nMembers=16, nIter=1000, noTableOk=True)
+
+random.seed(3)
+r = 0.01
+length = nMembers * r  # members overlap by half a radius
+cellSize = (nClumps * (length + 2 * r) * (4 * r)**2 / 0.3)**(1. / 3)
+O.periodic = True
+O.cell.setBox(cellSize, cellSize, cellSize)
+O.materials.append(FrictMat(young=1e7, density=2600, frictionAngle=0.5))
+
+for n in range(nClumps):
+	c = Vector3(random.random(), random.random(), random.random()) * cellSize
+	axis = Vector3(random.random() - .5, random.random() - .5, random.random() - .5).normalized()
+	O.bodies.appendClumped([sphere(c + axis * (k - .5 * (nMembers - 1)) * r, r) for k in range(nMembers)])
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()], verletDist=.2 * r),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        NewtonIntegrator(damping=.2)
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(100, True)  # let the initial overlaps relax
+
+O.timingEnabled = True
+for e in O.engines:
+	e.execTime = 0
+t0 = time.time()
+O.run(nIter, True)
+elapsed = time.time() - t0
+timing.stats()
+print(
+        "%d clumps of %d members, %d iterations: %g s, NewtonIntegrator %g s" %
+        (nClumps, nMembers, nIter, elapsed, O.engines[-1].execTime * 1e-9)
+)
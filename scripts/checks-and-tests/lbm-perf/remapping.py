@@ -0,0 +1,63 @@
+# -*- encoding=utf-8 -*-
+# Cost of the solid mapping of the 2D HydrodynamicsLawLBM: a few spheres settle slowly in a closed box, the nodes being remapped
+# either around all bodies at each call (remapThreshold=0) or only around the spheres which moved (remapThreshold>0), with bounce-back
+# links or partially saturated cells (partialSaturation=True).
+# Run with: yade-trunk-multi -j1 remapping.table remapping.py
+from __future__ import print_function
+from yade import pack, timing
+import time
+
+utils.readParamsFromTable(Nx=400, remapThreshold=0., partialSaturation=False, nIter=2000, noTableOk=True)
+
+L, H = 0.01, 0.005
+O.materials.append(FrictMat(young=50e6, poisson=.5, frictionAngle=0.0, density=3000))
+# walls in the order minX,maxX,minY,maxY,minZ,maxZ
+O.bodies.append(utils.aabbWalls(extrema=((1e-5, 1e-5, -0.002), (L + 1e-5, H + 1e-5, 0.002)), thickness=1e-5, oversizeFactor=1.001))
+sp = pack.SpherePack()
+sp.makeCloud((0.001, 0.001, 0), (L - 0.001, H - 0.001, 0), rMean=0.0003, rRelFuzz=0.2, num=40, seed=1)
+sp.toSimulation()
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        HydrodynamicsLawLBM(
+                WallXm_id=0,
+                WallXp_id=1,
+                WallYm_id=2,
+                WallYp_id=3,
+                WallZm_id=4,
+                WallZp_id=5,
+                useWallXm=1,
+                useWallXp=1,
+                useWallYm=1,
+                useWallYp=1,
+                YmBCType=2,
+                YpBCType=2,
+                XmBCType=2,
+                XpBCType=2,
+                LBMSavedData='',
+                tau=1.1,
+                dP=(0, 0, 0),
+                IterSave=1000000,
+                IterPrint=1000000,
+                Nx=Nx,
+                Rho=1000,
+                Nu=1.0e-6,
+                VbCutOff=0.0,
+                remapThreshold=remapThreshold,
+                partialSaturation=partialSaturation,
+                label="lbm"
+        ),
+        NewtonIntegrator(gravity=(0, -0.1, 0), damping=0),
+]
+O.dt = 5e-5
+O.timingEnabled = True
+remapped, t0 = 0, time.time()
+for i in range(nIter):
+	O.step()
+	remapped += lbm.nRemapped
+print(
+        "Nx=%d, remapThreshold=%g, partialSaturation=%s: %d steps in %g s, %g spheres remapped per step" %
+        (Nx, remapThreshold, partialSaturation, nIter, time.time() - t0, remapped / float(nIter))
+)
+timing.stats()
@@ -0,0 +1,37 @@
+# -*- encoding=utf-8 -*-
+# Throughput of HydrodynamicsLawLBM3D: spheres settling in a box periodic along x and y, the LBM performance being reported in MLUPS.
+# The DEM timestep is much smaller than the LBM one, the engine runs one LBM step every lbmDt/O.dt DEM steps.
+# Run with: yade-trunk-multi -j1 sedimentation.table sedimentation.py
+from __future__ import print_function
+from yade import pack
+import os, time
+
+utils.readParamsFromTable(nCells=64, nSpheres=100, nIter=50, noTableOk=True)
+
+L = 0.01  # box size
+dx = L / nCells
+O.materials.append(FrictMat(density=2650, frictionAngle=radians(20)))
+sp = pack.SpherePack()
+sp.makeCloud(minCorner=(0, 0, 0.1 * L), maxCorner=(L, L, 0.9 * L), rMean=L / 25, rRelFuzz=0.2, num=nSpheres, periodic=False, seed=1)
+sp.toSimulation()
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        HydrodynamicsLawLBM3D(lowerCorner=(0, 0, 0), upperCorner=(L, L, L), dx=dx, periodic=(1, 1, 0), Rho=1000, Nu=1e-6, tau=0.65, label="lbm"),
+        NewtonIntegrator(gravity=(0, 0, -9.81), damping=0),
+]
+O.dt = 0.5 * PWaveTimeStep()
+O.step()  # lattice setup
+O.timingEnabled = True
+t0, iter0, time0 = time.time(), lbm.lbmIter, lbm.updateTime
+while lbm.lbmIter - iter0 < nIter:
+	O.run(100, True)
+print(
+        "%d^3 nodes (%d fluid), %d spheres, OMP_NUM_THREADS=%s: %d LBM steps in %g s, stream-and-collide at %g MLUPS" % (
+                nCells, lbm.nFluid, nSpheres, os.environ.get("OMP_NUM_THREADS", "?"), lbm.lbmIter - iter0, time.time() - t0,
+                lbm.nFluid * (lbm.lbmIter - iter0) / (lbm.updateTime - time0) / 1e6
+        )
+)
+from yade import timing
+timing.stats()
@@ -0,0 +1,66 @@
+# -*- encoding=utf-8 -*-
+# Contact detection of LevelSet bodies: batched evaluation of the surface nodes on the contiguous distance field, in double or single precision (singlePrecisionField).
+# Run with: yade-trunk-multi -j1 discharge.table discharge.py
+from __future__ import print_function
+from yade import pack
+import os, time, numpy
+
+utils.readParamsFromTable(nB=300, nN=500, singlePrecisionField=False, nSettle=2000, nIter=1000, noTableOk=True)
+
+sceneFile = "discharge-%d-%d.xml.bz2" % (nB, nN)
+rcar = 0.01  # longest half-length of the superellipsoids, as in examples/levelSet/discharge.py
+epsVal = numpy.array([[0.1, 0.5], [0.1, 1], [1, 0.5], [1.4, 1.2], [0.4, 1.6]])
+rVal = numpy.array([[0.58, 1, 0.83], [0.42, 1, 0.83], [0.42, 1, 0.83], [0.5, 0.7, 1.], [0.4, 1., 0.8]])
+prec = 20
+if os.path.exists(sceneFile):
+	O.load(sceneFile)
+else:
+	O.materials.append(FrictMat(density=2650, frictionAngle=radians(25)))
+	rSph = rcar * max(numpy.linalg.norm(r) for r in rVal)
+	base = 0.15
+	sp = pack.SpherePack()
+	sp.makeCloud(rMean=rSph, minCorner=(-base / 2., -base / 2., rSph), maxCorner=(base / 2., base / 2., 1.), num=nB, seed=1)
+	grids, distFields = [None] * 5, [None] * 5
+	for shape in range(5):
+		rx, ry, rz = rVal[shape] * rcar
+		lsSe = levelSetBody("superellipsoid", extents=(rx, ry, rz), epsilons=epsVal[shape], spacing=2 * min(rx, ry, rz) / prec, nSurfNodes=2)
+		grids[shape], distFields[shape] = lsSe.shape.lsGrid, lsSe.shape.distField
+	for sph in sp:
+		shape = len(O.bodies) % 5
+		O.bodies.append(levelSetBody(center=sph[0], grid=grids[shape], distField=distFields[shape], nSurfNodes=nN, nodesPath=2))
+	O.bodies.append(utils.wall((0, 0, 0), axis=2, sense=1))
+	for axis in range(2):
+		for pos in (-base / 2., base / 2.):
+			O.bodies.append(utils.wall(pos * Vector3.Unit(axis), axis=axis))
+	O.engines = [
+	        ForceResetter(),
+	        InsertionSortCollider([Bo1_LevelSet_Aabb(), Bo1_Wall_Aabb()], verletDist=0),
+	        InteractionLoop(
+	                [Ig2_LevelSet_LevelSet_ScGeom(), Ig2_Wall_LevelSet_ScGeom()],
+	                [Ip2_FrictMat_FrictMat_FrictPhys(kn=MatchMaker(algo='val', val=1.e5), ks=MatchMaker(algo='val', val=7.e4))],
+	                [Law2_ScGeom_FrictPhys_CundallStrack(sphericalBodies=False)],
+	                label='ILoop'
+	        ),
+	        NewtonIntegrator(damping=0.3, gravity=(0, 0, -9.8))
+	]
+	O.dt = 25e-6
+	O.run(nSettle, True)
+	O.save(sceneFile)
+
+# the distance fields are copied at shape initialization, redone after loading: changing singlePrecisionField now is fine
+for b in O.bodies:
+	if isinstance(b.shape, LevelSet):
+		b.shape.singlePrecisionField = singlePrecisionField
+O.run(1, True)
+contacts = [i for i in O.interactions if i.isReal]
+print("%d bodies with %d surface nodes, %d contacts, sum of overlaps %.12g" % (nB, nN, len(contacts), sum(i.geom.penetrationDepth for i in contacts)))
+
+O.timingEnabled = True
+for e in O.engines:
+	e.execTime = 0
+t0 = time.time()
+O.run(nIter, True)
+elapsed = time.time() - t0
+from yade import timing
+timing.stats()
+print("singlePrecisionField=%d, %d iterations: %g s, InteractionLoop %g s" % (singlePrecisionField, nIter, elapsed, ILoop.execTime * 1e-9))
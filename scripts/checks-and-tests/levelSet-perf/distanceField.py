@@ -0,0 +1,28 @@
+# -*- encoding=utf-8 -*-
+# Distance field of a superellipsoid with the FMM and with the parallel fast sweeping method (FastMarchingMethod.fastSweeping), and the effect of the cache of lsSimpleShape.
+# Run with: OMP_NUM_THREADS=4 yade -n -x distanceField.py
+from __future__ import print_function
+import time
+
+extents, epsilons = Vector3(0.5, 1, 0.8), Vector2(0.4, 1.6)
+for nGPaxis in (30, 60, 90):
+	step = 2 * extents.maxCoeff() / (nGPaxis - 4)
+	grid = RegularGrid(-extents.maxCoeff() - 2 * step, extents.maxCoeff() + 2 * step, nGPaxis)
+	phiIni = distIniSE(extents, epsilons, grid)
+	res = {}
+	for sweeping in (False, True):
+		fmm = FastMarchingMethod(grid=grid, phiIni=phiIni, fastSweeping=sweeping, useCache=False)
+		t0 = time.time()
+		res[sweeping] = fmm.phi()
+		print("%d^3 gridpoints, %s: %g s%s" % (nGPaxis, "fast sweeping" if sweeping else "FMM", time.time() - t0, " (%d sweeps)" % fmm.sweeps if sweeping else ""))
+	print(
+	        "max difference between the two solutions: %g, in grid spacings" % (
+	                max(abs(res[0][i][j][k] - res[1][i][j][k]) for i in range(nGPaxis) for j in range(nGPaxis) for k in range(nGPaxis)) / grid.spacing
+	        )
+	)
+
+lsClearCache()
+for trial in range(2):
+	t0 = time.time()
+	shapes = [lsSimpleShape(3, AlignedBox3(-extents, extents), step=0.05, epsilons=epsilons, fastSweeping=True) for i in range(10)]
+	print("10 identical superellipsoids in %g s (%s cache)" % (time.time() - t0, "empty" if trial == 0 else "filled"))
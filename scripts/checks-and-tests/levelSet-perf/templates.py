@@ -0,0 +1,31 @@
+# -*- encoding=utf-8 -*-
+# Memory and saved size of nB level set grains with their own shape each, or sharing a few shape instances through utils.templateBody.
+# Run with: yade -n -x templates.py
+from __future__ import print_function
+import os, time, resource
+
+nB, nTemplates = 500, 5
+extents = [Vector3(0.5, 0.4, 0.3) * (1 + 0.1 * i) for i in range(nTemplates)]
+
+
+def rssMb():
+	return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024.
+
+
+for shared in (True, False):
+	O.reset()
+	lsClearCache()
+	rss0, t0 = rssMb(), time.time()
+	if shared:
+		templates = [levelSetBody("box", extents=ext, spacing=0.05, nSurfNodes=402).shape for ext in extents]
+		O.bodies.append([templateBody(templates[i % nTemplates], center=(3 * i, 0, 0)) for i in range(nB)])
+	else:
+		O.bodies.append([levelSetBody("box", extents=extents[i % nTemplates], center=(3 * i, 0, 0), spacing=0.05, nSurfNodes=402) for i in range(nB)])
+	O.engines = [ForceResetter(), InsertionSortCollider([Bo1_LevelSet_Aabb()]), NewtonIntegrator()]
+	O.step()  # LevelSet::init() of all the shapes, and their Aabb corners
+	f = "/tmp/templates-%s.xml.bz2" % ("shared" if shared else "copied")
+	O.save(f)
+	print(
+	        "%d bodies, %s shapes: %g s, peak RSS +%.1f MB, saved file %.1f kB" %
+	        (nB, "%d shared" % nTemplates if shared else "individual", time.time() - t0, rssMb() - rss0, os.path.getsize(f) / 1024.)
+	)
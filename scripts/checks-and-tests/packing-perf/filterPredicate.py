@@ -0,0 +1,26 @@
+# -*- encoding=utf-8 -*-
+# Timing of Predicate.filter (parallel, compiled predicates) against sphere-by-sphere evaluation from python,
+# with a boolean combination of an analytical predicate and a triangulated surface.
+# Run with: yade-trunk-multi -j1 filterPredicate.table filterPredicate.py (and yade -jN for the parallel timing)
+from __future__ import print_function
+from yade import pack
+import time, gts
+from numpy import arange
+
+utils.readParamsFromTable(num=100000, order=6, pyLoop=True, noTableOk=True)
+
+# a sphere surface with 20*4^order triangles, minus a cylindrical hole
+surf = gts.sphere(order)
+pred = pack.inGtsSurface(surf) - pack.inCylinder((0, 0, -1), (0, 0, 1), .3)
+# regular packing in the bounding box of the surface
+r = .5 * (1.2**3 / num)**(1. / 3)
+sp = pack.SpherePack([(c, r) for c in [(x, y, z) for x in arange(-.6, .6, 2 * r) for y in arange(-.6, .6, 2 * r) for z in arange(-.6, .6, 2 * r)]])
+print("%d spheres, %d triangles, compiled predicate: %s" % (len(sp), surf.Nfaces(), pred.compiled))
+
+t0 = time.time()
+inside = pred.filter(sp)
+print("filter: %d spheres inside in %g s" % (len(inside), time.time() - t0))
+if pyLoop:
+	t0 = time.time()
+	n = sum(1 for c, rr in sp if pred(c, rr))
+	print("python loop: %d spheres inside in %g s" % (n, time.time() - t0))
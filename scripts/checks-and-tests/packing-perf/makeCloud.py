@@ -0,0 +1,24 @@
+# -*- encoding=utf-8 -*-
+# Timing of SpherePack.makeCloud with a PSD, from 10^4 to 10^7 spheres.
+# Run with: yade-trunk-multi -j1 makeCloud.table makeCloud.py
+from __future__ import print_function
+from yade import pack
+import time
+
+utils.readParamsFromTable(num=10000, periodic=False, parallel=False, porosity=0.7, noTableOk=True)
+
+psdSizes = [0.0005, 0.001, 0.002, 0.004]
+psdCumm = [0., 0.3, 0.8, 1.]
+# box volume such that num spheres with this PSD give about the requested porosity
+meanVol = sum((psdCumm[i + 1] - psdCumm[i]) * 4 / 3. * 3.1416 * (0.25 * (psdSizes[i] + psdSizes[i + 1]))**3 for i in range(len(psdSizes) - 1))
+L = (num * meanVol / (1 - porosity))**(1. / 3)
+
+sp = pack.SpherePack()
+t0 = time.time()
+n = sp.makeCloud((0, 0, 0), (L, L, L), psdSizes=psdSizes, psdCumm=psdCumm, num=num, periodic=periodic, porosity=porosity, seed=1, parallel=parallel)
+elapsed = time.time() - t0
+vol = sum(4 / 3. * 3.1416 * r**3 for c, r in sp)
+print(
+        "num=%d periodic=%d parallel=%d: %d spheres in %g s, porosity %.4f, appliedPsdScaling %.4f" %
+        (num, periodic, parallel, n, elapsed, 1 - vol / L**3, sp.appliedPsdScaling)
+)
@@ -0,0 +1,26 @@
+# -*- encoding=utf-8 -*-
+# Porosity and timing of SpherePack.makeDense, compared with the usual dynamic compaction of pack.randomDensePack.
+# Run with: yade-trunk-multi -j1 makeDense.table makeDense.py
+from __future__ import print_function
+from yade import pack
+import time
+
+utils.readParamsFromTable(num=10000, rRelFuzz=0., porosity=0.37, periodic=True, compare=False, noTableOk=True)
+
+radius = 1e-3
+meanVol = 4 / 3. * 3.1416 * radius**3 * (1 + rRelFuzz**2)
+L = (num * meanVol / (1 - porosity))**(1. / 3)
+
+sp = pack.SpherePack()
+t0 = time.time()
+poro = sp.makeDense((0, 0, 0), (L, L, L), porosity, num, rRelFuzz=rRelFuzz, periodic=periodic, seed=1)
+elapsed = time.time() - t0
+print("makeDense num=%d rRelFuzz=%g periodic=%d: porosity %.4f (target %.4f) in %g s" % (num, rRelFuzz, periodic, poro, porosity, elapsed))
+
+if compare:
+	# the same box filled by compaction of a cloud
+	t0 = time.time()
+	sp2 = pack.randomDensePack(pack.inAlignedBox((0, 0, 0), (L, L, L)), radius, rRelFuzz=rRelFuzz, returnSpherePack=True, spheresInCell=num, seed=1)
+	elapsed = time.time() - t0
+	vol = sum(4 / 3. * 3.1416 * r**3 for c, r in sp2)
+	print("randomDensePack: %d spheres, porosity %.4f in %g s" % (len(sp2), 1 - vol / L**3, elapsed))
@@ -0,0 +1,41 @@
+# -*- encoding=utf-8 -*-
+# Timing of the packing cache: binary save/load against pickled lists (the former memoizeDb blobs), and parallel cellFill.
+# Run with: yade-trunk-multi -j1 packingCache.table packingCache.py (and yade -jN for the parallel timing)
+from __future__ import print_function
+from yade import pack
+import time, pickle, os, tempfile
+
+utils.readParamsFromTable(num=100000, repeat=4, noTableOk=True)
+
+cacheDir = tempfile.mkdtemp()
+
+
+def cloud(num, seed):
+	sp = pack.SpherePack()
+	sp.makeCloud((0, 0, 0), (1, 1, 1), rRelFuzz=.3, num=num, periodic=True, porosity=0.7, seed=seed)
+	return sp
+
+
+for attempt in ('generated', 'cached'):
+	t0 = time.time()
+	sp = pack.cachedSpherePack(cacheDir, cloud, num=num, seed=1)
+	print("%s: %d spheres in %g s" % (attempt, len(sp), time.time() - t0))
+
+t0 = time.time()
+sp.cellRepeat((repeat, repeat, repeat))
+print("cellRepeat %d^3: %d spheres in %g s" % (repeat, len(sp), time.time() - t0))
+
+fileName = os.path.join(cacheDir, 'big.spk')
+t0 = time.time()
+sp.saveBinary(fileName)
+t1 = time.time()
+sp2 = pack.SpherePack()
+sp2.loadBinary(fileName)
+t2 = time.time()
+print("binary: save %g s, load %g s, %d MB" % (t1 - t0, t2 - t1, os.path.getsize(fileName) // 2**20))
+t0 = time.time()
+blob = pickle.dumps(sp.toList(), pickle.HIGHEST_PROTOCOL)
+t1 = time.time()
+sp3 = pack.SpherePack(pickle.loads(blob))
+t2 = time.time()
+print("pickled list: save %g s, load %g s, %d MB" % (t1 - t0, t2 - t1, len(blob) // 2**20))
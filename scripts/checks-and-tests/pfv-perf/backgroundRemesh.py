@@ -0,0 +1,40 @@
+# -*- encoding=utf-8 -*-
+# Main-loop stall of FlowEngine in multithread mode, waiting for the background remesh (maxStaleIters=0) or not (maxStaleIters<0).
+# Run with: yade-trunk-multi -j1 backgroundRemesh.table backgroundRemesh.py
+from __future__ import print_function
+from yade import pack, timing
+import os
+
+utils.readParamsFromTable(nSpheres=20000, maxStaleIters=-1, meshUpdateInterval=10, nIter=200, noTableOk=True)
+
+spheresFile = "packing-%dk.spheres" % (nSpheres / 1000)
+mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+if not os.path.exists(spheresFile):
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, nSpheres, False, 0.95, seed=1)
+	sp.save(spheresFile)
+
+O.bodies.append(aabbWalls([mn, mx], thickness=0))
+sp = pack.SpherePack()
+sp.load(spheresFile)
+sp.toSimulation()
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        FlowEngine(label="flow", multithread=True, useSolver=3, maxStaleIters=maxStaleIters, meshUpdateInterval=meshUpdateInterval, defTolerance=-1),
+        NewtonIntegrator(damping=0.2)
+]
+flow.bndCondIsPressure = [0, 0, 1, 1, 0, 0]
+flow.bndCondValue = [0, 0, 1, 0, 0, 0]
+O.dt = 0.1 * PWaveTimeStep()
+
+O.run(5, True)
+O.timingEnabled = True
+timing.reset()
+stall0 = flow.backgroundStallTime
+O.run(nIter, True)
+timing.stats()
+print("maxStaleIters=%d, FlowEngine per step: %g us, stalled %g s" % (maxStaleIters, flow.execTime / 1000. / nIter, flow.backgroundStallTime - stall0))
+print("last background remesh (snapshot, triangulation, permeability, factorization, cache) [s]:", flow.backgroundStageTimes)
@@ -0,0 +1,43 @@
+# -*- encoding=utf-8 -*-
+# Quasi-static drainage curve of TwoPhaseFlowEngine: loop of invasion() calls vs. the event-driven drainageCurve(), which should give the same saturations.
+# Run with: yade-trunk-multi -j1 drainageCurve.table drainageCurve.py
+from __future__ import print_function
+from yade import pack
+import os, time
+
+utils.readParamsFromTable(nSpheres=20000, eventDriven=True, nSteps=150, noTableOk=True)
+
+spheresFile = "packing-%dk.spheres" % (nSpheres / 1000)
+mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+if not os.path.exists(spheresFile):
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, nSpheres, False, 0.95, seed=1)
+	sp.save(spheresFile)
+
+sp = pack.SpherePack()
+sp.load(spheresFile)
+O.bodies.append(aabbWalls([mn, mx], thickness=0))
+sp.toSimulation()
+meanDiameter = 2 * sum(b.shape.radius for b in O.bodies if isinstance(b.shape, Sphere)) / nSpheres
+
+tpf = TwoPhaseFlowEngine(label="tpf")
+tpf.bndCondIsPressure = [0, 0, 1, 1, 0, 0]
+tpf.bndCondValue = [0, 0, -1e8, 0, 0, 0]
+tpf.isPhaseTrapped = True
+tpf.initialization()
+tpf.surfaceTension = 10
+pcs = [(1e-5 + 0.1 * k) * tpf.surfaceTension / meanDiameter for k in range(nSteps)]
+
+t0 = time.time()
+if eventDriven:
+	saturations = tpf.drainageCurve(pcs)
+else:
+	saturations = []
+	for pc in pcs:
+		tpf.bndCondValue = [0, 0, -pc, 0, 0, 0]
+		tpf.invasion()
+		saturations.append(tpf.getSaturation(False))
+print("eventDriven=%d, %d steps: %g s" % (eventDriven, nSteps, time.time() - t0))
+with open("drainageCurve-%dk-%d.txt" % (nSpheres / 1000, eventDriven), "w") as f:
+	for pc, sw in zip(pcs, saturations):
+		f.write("%g %.12g\n" % (pc, sw))
@@ -0,0 +1,38 @@
+# -*- encoding=utf-8 -*-
+# Per-step cost of FlowEngine with and without the flat (spatially ordered, CSR) copy of the network.
+# Run with: yade-trunk-multi -j1 flatNetwork.table flatNetwork.py
+from __future__ import print_function
+from yade import pack, timing
+import os
+
+utils.readParamsFromTable(nSpheres=20000, flatNetwork=True, nIter=200, noTableOk=True)
+
+spheresFile = "packing-%dk.spheres" % (nSpheres / 1000)
+mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+if not os.path.exists(spheresFile):
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, nSpheres, False, 0.95, seed=1)
+	sp.save(spheresFile)
+
+O.bodies.append(aabbWalls([mn, mx], thickness=0))
+sp = pack.SpherePack()
+sp.load(spheresFile)
+sp.toSimulation()
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        FlowEngine(label="flow", flatNetwork=flatNetwork, meshUpdateInterval=-1, defTolerance=-1),
+        NewtonIntegrator(damping=0.2)
+]
+flow.bndCondIsPressure = [0, 0, 1, 1, 0, 0]
+flow.bndCondValue = [0, 0, 1, 0, 0, 0]
+O.dt = 0.1 * PWaveTimeStep()
+
+O.run(5, True)
+O.timingEnabled = True
+timing.reset()
+O.run(nIter, True)
+timing.stats()
+print("flatNetwork=%s, FlowEngine per step: %g us" % (flatNetwork, flow.execTime / 1000. / nIter))
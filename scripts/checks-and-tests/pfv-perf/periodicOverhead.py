@@ -0,0 +1,49 @@
+# -*- encoding=utf-8 -*-
+# Cost of PeriodicFlowEngine vs. FlowEngine on the same packing (the periodic solver is expected within 20% of the aperiodic one).
+# Run with: yade-trunk-multi -j1 periodicOverhead.table periodicOverhead.py
+from __future__ import print_function
+from yade import pack, timing
+import os, time
+
+utils.readParamsFromTable(nSpheres=20000, periodic=True, nIter=100, noTableOk=True)
+
+spheresFile = "packing-%dk-periodic.spheres" % (nSpheres / 1000)
+mn, mx = Vector3(0, 0, 0), Vector3(1, 1, 1)
+if not os.path.exists(spheresFile):
+	sp = pack.SpherePack()
+	sp.makeCloud(mn, mx, -1, 0.3333, nSpheres, True, 0.95, seed=1)
+	sp.save(spheresFile)
+
+sp = pack.SpherePack()
+sp.load(spheresFile)
+if periodic:
+	O.periodic = True
+	O.cell.hSize = Matrix3(mx[0] - mn[0], 0, 0, 0, mx[1] - mn[1], 0, 0, 0, mx[2] - mn[2])
+else:
+	O.bodies.append(aabbWalls([mn, mx], thickness=0))
+sp.toSimulation()
+
+if periodic:
+	flowEngine = PeriodicFlowEngine(label="flow", useSolver=3, gradP=Vector3(1, 0, 0), defTolerance=-1, meshUpdateInterval=-1)
+else:
+	flowEngine = FlowEngine(label="flow", useSolver=3, defTolerance=-1, meshUpdateInterval=-1)
+	flowEngine.bndCondIsPressure = [1, 1, 0, 0, 0, 0]
+	flowEngine.bndCondValue = [1, 0, 0, 0, 0, 0]
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb(), Bo1_Box_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom(), Ig2_Box_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        flowEngine,
+        NewtonIntegrator(damping=0.2)
+]
+O.dt = 0.1 * PWaveTimeStep()
+
+O.run(1, True)
+O.timingEnabled = True
+timing.reset()
+t0 = time.time()
+flow.updateTriangulation = True  # one remesh (triangulation, permeability, assembly and factorization) in the measured window
+O.run(nIter, True)
+timing.stats()
+print("periodic=%d, remesh+%d steps: %g s, FlowEngine per step: %g us" % (periodic, nIter, time.time() - t0, flow.execTime / 1000. / nIter))
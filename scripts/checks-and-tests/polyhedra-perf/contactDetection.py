@@ -0,0 +1,53 @@
+# -*- encoding=utf-8 -*-
+# Contact detection of polyhedra: flat separating axis test and clipping vs. the former CGAL intersection (cgalIntersection=True).
+# Run with: yade-trunk-multi -j1 contactDetection.table contactDetection.py
+from __future__ import print_function
+from yade import polyhedra_utils
+import os, time
+
+utils.readParamsFromTable(boxSize=0.3, cgalIntersection=False, nSettle=3000, nIter=500, noTableOk=True)
+
+packingFile = "packing-%g.xml.bz2" % boxSize
+if os.path.exists(packingFile):
+	O.load(packingFile)
+else:
+	gravel = PolyhedraMat()
+	gravel.density = 2600  #kg/m^3
+	gravel.young = 1E7  #Pa
+	gravel.poisson = 20000 / 1E7
+	gravel.frictionAngle = 0.5  #rad
+	O.bodies.append(
+	        polyhedra_utils.polyhedra(
+	                gravel,
+	                v=((0, 0, -0.05), (boxSize, 0, -0.05), (boxSize, boxSize, -0.05), (0, boxSize, -0.05), (0, 0, 0), (boxSize, 0, 0), (boxSize, boxSize, 0),
+	                   (0, boxSize, 0)),
+	                fixed=True
+	        )
+	)
+	polyhedra_utils.fillBox((0, 0, 0), (boxSize, boxSize, boxSize), gravel, sizemin=[0.025, 0.025, 0.025], sizemax=[0.05, 0.05, 0.05], seed=4)
+	O.engines = [
+	        ForceResetter(),
+	        InsertionSortCollider([Bo1_Polyhedra_Aabb()]),
+	        InteractionLoop([Ig2_Polyhedra_Polyhedra_PolyhedraGeom(label="ig2")], [Ip2_PolyhedraMat_PolyhedraMat_PolyhedraPhys()],
+	                        [Law2_PolyhedraGeom_PolyhedraPhys_Volumetric()]),
+	        NewtonIntegrator(damping=0.3, gravity=(0, 0, -9.81))
+	]
+	O.dt = 0.0025 * polyhedra_utils.PWaveTimeStep()
+	O.run(nSettle, True)
+	O.save(packingFile)
+
+ig2 = [f for f in O.engines[2].geomDispatcher.functors if isinstance(f, Ig2_Polyhedra_Polyhedra_PolyhedraGeom)][0]
+ig2.cgalIntersection = cgalIntersection
+O.run(1, True)  # geometry of the saved packing recomputed with the chosen method
+contacts = [i for i in O.interactions if i.isReal]
+print("%d polyhedra, %d contacts, sum of penetration volumes %.12g" % (len(O.bodies), len(contacts), sum(i.geom.penetrationVolume for i in contacts)))
+
+O.timingEnabled = True
+for e in O.engines:
+	e.execTime = 0
+t0 = time.time()
+O.run(nIter, True)
+elapsed = time.time() - t0
+from yade import timing
+timing.stats()
+print("cgalIntersection=%d, %d iterations: %g s, InteractionLoop %g s" % (cgalIntersection, nIter, elapsed, O.engines[2].execTime * 1e-9))
@@ -0,0 +1,67 @@
+# -*- encoding=utf-8 -*-
+# Deposition of cubic potential blocks: steps/s with and without warm start and reuse in Ig2_PB_PB_ScGeom.
+# Run with: yade-trunk-multi -j1 blocksDeposit.table blocksDeposit.py
+from __future__ import print_function
+from yade import pack, timing
+import time
+
+utils.readParamsFromTable(warmStart=False, reuseTolerance=0, nBlocks=100, nSettle=20000, nIter=5000, noTableOk=True)
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([PotentialBlock2AABB()], verletDist=0.01, avoidSelfInteractionMask=2),
+        InteractionLoop(
+                [Ig2_PB_PB_ScGeom(calContactArea=True, warmStart=warmStart, reuseTolerance=reuseTolerance)],
+                [Ip2_FrictMat_FrictMat_KnKsPBPhys(kn_i=1e8, ks_i=1e7, Knormal=1e8, Kshear=1e7, useFaceProperties=False, viscousDamping=0.2)],
+                [Law2_SCG_KnKsPBPhys_KnKsPBLaw(neverErase=False, allowViscousAttraction=True)]
+        ),
+        NewtonIntegrator(damping=0.0, exactAsphericalRot=True, gravity=[0, -9.81, 0])
+]
+
+O.materials.append(FrictMat(young=-1, poisson=-1, frictionAngle=radians(0.0), density=2000, label='frictionless'))
+random.seed(1)
+
+
+def block(halfSize, r, pos, isBoundary, mask):
+	b = Body()
+	b.mask = mask
+	b.aspherical = True
+	b.shape = PotentialBlock(
+	        k=0.0,
+	        r=r,
+	        R=0.0,
+	        a=[1, -1, 0, 0, 0, 0],
+	        b=[0, 0, 1, -1, 0, 0],
+	        c=[0, 0, 0, 0, 1, -1],
+	        d=[halfSize[0] - r, halfSize[0] - r, halfSize[1] - r, halfSize[1] - r, halfSize[2] - r, halfSize[2] - r],
+	        isBoundary=isBoundary,
+	        AabbMinMax=True,
+	        minAabb=1.05 * sqrt(3) * halfSize,
+	        maxAabb=1.05 * sqrt(3) * halfSize,
+	        id=len(O.bodies)
+	)
+	utils._commonBodySetup(b, b.shape.volume, b.shape.inertia, material='frictionless', pos=pos, fixed=isBoundary)
+	b.state.pos = pos
+	return O.bodies.append(b)
+
+
+lengthOfBase = 9.0
+sp = pack.SpherePack()
+sp.makeCloud(Vector3(-4.25, 0.5, -4.25), Vector3(4.25, 98, 4.25), sqrt(3.0) * 0.5, 0, nBlocks, False, seed=1)
+for s in sp:
+	i = block(Vector3(0.5, 0.5, 0.5), 0.01, s[0], False, 1)
+	O.bodies[i].state.ori = Quaternion((random.random(), random.random(), random.random()), random.random())
+block(Vector3(lengthOfBase / 2, 0.25, lengthOfBase / 2), 0.025, Vector3(0, 0, 0), True, 3)
+
+O.dt = 0.2 * sqrt(0.3 * O.bodies[0].state.mass / 1.0e8)
+O.run(nSettle, True)
+
+O.timingEnabled = True
+timing.reset()
+t0 = time.time()
+O.run(nIter, True)
+elapsed = time.time() - t0
+timing.stats()
+contacts = [i for i in O.interactions if i.isReal and i.geom.penetrationDepth > 0]
+print("%d contacts, sum of normal forces %.12g" % (len(contacts), sum(i.phys.normalForce.norm() for i in contacts)))
+print("warmStart=%d reuseTolerance=%g: %d iterations in %g s, %g steps/s" % (warmStart, reuseTolerance, nIter, elapsed, nIter / elapsed))
@@ -0,0 +1,53 @@
+# -*- encoding=utf-8 -*-
+# InSituStatsEngine against the separate Shop/utils reductions, on a periodic packing.
+# Run with: yade-trunk-multi -j1 inSituStats.table inSituStats.py (and yade -jN for the parallel timing)
+from __future__ import print_function
+from yade import pack
+import time
+
+utils.readParamsFromTable(num=10000, noTableOk=True)
+from yade.params.table import *
+
+O.periodic = True
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.5 * (0.3 / num)**(1. / 3), rRelFuzz=.3, num=num, periodic=True, seed=1)
+sp.toSimulation()
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        PeriTriaxController(goal=(-1e5, -1e5, -1e5), stressMask=7, maxUnbalanced=1e-2, relStressTol=1e-2, dynCell=True, mass=1e-2),
+        NewtonIntegrator(damping=.4),
+        InSituStatsEngine(reductions=['all'], iterPeriod=1, dead=True, label='stats')
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(2000, True)  # build some contacts
+stats.dead = False
+O.step()  # the engine runs last, the reference below sees the same state
+
+t0 = time.time()
+ref = {
+        'stress': getStress(),
+        'fabric': fabricTensor()[0],
+        'normalStress': normalShearStressTensors()[0],
+        'shearStress': normalShearStressTensors()[1],
+        'coordination': avgNumInteractions(considerClumps=True),
+        'mechanicalCoordination': avgNumInteractions(skipFree=True),
+}
+bodyNumInteractionsHistogram(aabbExtrema())
+interactionAnglesHistogram(2, bins=18)
+tRef = time.time() - t0
+
+print("%d spheres, %d contacts" % (len(O.bodies), stats.contacts))
+print("separate calls: %g s, InSituStatsEngine: %g s" % (tRef, stats.reductionTime))
+
+
+def relDiff(a, b):
+	try:
+		return (a - b).norm() / max(b.norm(), 1e-30)
+	except AttributeError:
+		return abs(a - b) / max(abs(b), 1e-30)
+
+
+for name, value in ref.items():
+	print("%s: relative difference %g" % (name, relDiff(getattr(stats, name), value)))
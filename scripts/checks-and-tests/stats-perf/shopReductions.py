@@ -0,0 +1,62 @@
+# -*- encoding=utf-8 -*-
+# Shop reductions (unbalancedForce, kineticEnergy, getStress, fabricTensor, normalShearStressTensors) called separately, and fused by globalStats.
+# Run with: yade-trunk-multi -j1 shopReductions.table shopReductions.py, and yade -jN for the parallel timing; the printed values must be the
+# same with any number of threads.
+from __future__ import print_function
+from yade import pack
+import time
+
+utils.readParamsFromTable(num=10000, repeat=10, noTableOk=True)
+from yade.params.table import *
+
+O.periodic = True
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.5 * (0.3 / num)**(1. / 3), rRelFuzz=.3, num=num, periodic=True, seed=1)
+sp.toSimulation()
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        PeriTriaxController(goal=(-1e5, -1e5, -1e5), stressMask=7, maxUnbalanced=1e-2, relStressTol=1e-2, dynCell=True, mass=1e-2),
+        NewtonIntegrator(damping=.4)
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(2000, True)  # build some contacts
+
+t0 = time.time()
+for i in range(repeat):
+	ref = {
+	        'unbalancedForce': unbalancedForce(),
+	        'unbalancedForceMax': unbalancedForce(True),
+	        'kineticEnergy': kineticEnergy(),
+	        'stress': getStress(),
+	        'fabric': fabricTensor()[0],
+	        'normalStress': normalShearStressTensors()[0],
+	        'shearStress': normalShearStressTensors()[1],
+	}
+tRef = (time.time() - t0) / repeat
+
+t0 = time.time()
+for i in range(repeat):
+	fused = globalStats(useCache=False)
+tFused = (time.time() - t0) / repeat
+
+t0 = time.time()
+for i in range(repeat):
+	globalStats(['unbalancedForce'])
+	globalStats(['kineticEnergy', 'stress'])
+tCached = (time.time() - t0) / repeat
+
+print("%d spheres, %d interactions" % (len(O.bodies), len(O.interactions)))
+print("separate calls: %g s, globalStats: %g s, cached globalStats: %g s" % (tRef, tFused, tCached))
+
+
+def relDiff(a, b):
+	try:
+		return (a - b).norm() / max(b.norm(), 1e-30)
+	except AttributeError:
+		return abs(a - b) / max(abs(b), 1e-30)
+
+
+for name, value in sorted(ref.items()):
+	print("%s: %s, relative difference %g" % (name, repr(fused[name]), relDiff(fused[name], value)))
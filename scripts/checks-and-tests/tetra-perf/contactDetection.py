@@ -0,0 +1,45 @@
+# -*- encoding=utf-8 -*-
+# Contact detection of tetrahedra: separating axis pre-test and stack-buffer intersection volume.
+# Run with: yade-trunk-multi -j1 contactDetection.table contactDetection.py
+from __future__ import print_function
+import random, time
+from yade import timing
+
+utils.readParamsFromTable(nFrag=2000, simpleGeom=False, nIter=500, noTableOk=True)
+
+random.seed(7)
+O.materials.append(ElastMat(young=1e8, density=2600))
+size = 0.02
+nSide = int(round(nFrag**(1. / 3))) + 1
+ref = (Vector3(1, 1, 1), Vector3(1, -1, -1), Vector3(-1, 1, -1), Vector3(-1, -1, 1))
+
+for n in range(nFrag):
+	i, j, k = n % nSide, (n // nSide) % nSide, n // (nSide * nSide)
+	c = Vector3(i, j, k + 1) * 1.4 * size
+	q = Quaternion(Vector3(random.random() - .5, random.random() - .5, random.random() - .5).normalized(), random.random() * 6.28)
+	v = [c + q * (p * .5 * size * (.8 + .4 * random.random())) for p in ref]
+	O.bodies.append(tetra(v, wire=False))
+# plate
+for i in range(nSide):
+	for j in range(nSide):
+		c = Vector3(i, j, 0) * 1.4 * size
+		O.bodies.append(tetra([c + Vector3(0, 0, 0), c + Vector3(2 * size, 0, 0), c + Vector3(0, 2 * size, 0), c + Vector3(0, 0, -size)], fixed=True))
+
+if simpleGeom:
+	laws = [InteractionLoop([Ig2_Tetra_Tetra_TTetraSimpleGeom()], [Ip2_ElastMat_ElastMat_NormPhys()], [Law2_TTetraSimpleGeom_NormPhys_Simple()])]
+else:
+	laws = [InteractionLoop([Ig2_Tetra_Tetra_TTetraGeom()], [Ip2_ElastMat_ElastMat_NormPhys()], []), TetraVolumetricLaw()]
+O.engines = [ForceResetter(), InsertionSortCollider([Bo1_Tetra_Aabb()], verletDist=.2 * size)] + laws + [NewtonIntegrator(damping=0.3, gravity=(0, 0, -9.81))]
+O.dt = 1e-5
+
+O.timingEnabled = True
+t0 = time.time()
+O.run(nIter, True)
+elapsed = time.time() - t0
+timing.stats()
+real = [i for i in O.interactions if i.isReal]
+print(
+        "simpleGeom=%d, %d tetrahedra, %d interactions (%d real), %d iterations: %g s, InteractionLoop %g s" %
+        (simpleGeom, len(O.bodies), len(O.interactions), len(real), nIter, elapsed, O.engines[2].execTime * 1e-9)
+)
+print("separating axes:", [i.geom.separatingAxis for i in O.interactions if i.geom][:10])
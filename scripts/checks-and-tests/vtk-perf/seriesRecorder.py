@@ -0,0 +1,46 @@
+# -*- encoding=utf-8 -*-
+# Size and read time of SeriesRecorder files, against VTKRecorder and export.textExt files of the same steps.
+# Run with: yade-trunk-multi -j1 seriesRecorder.table seriesRecorder.py
+from __future__ import print_function
+from yade import pack, export
+import time, tempfile, os
+
+utils.readParamsFromTable(num=10000, compress=1, noTableOk=True)
+from yade.params.table import *
+
+period, nSteps = 20, 20
+outDir = tempfile.mkdtemp()
+
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.5 * (0.4 / num)**(1. / 3), rRelFuzz=.3, num=num, seed=1)
+sp.toSimulation()
+
+
+def dirSize(prefix):
+	return sum(os.path.getsize(os.path.join(outDir, f)) for f in os.listdir(outDir) if f.startswith(prefix))
+
+
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        NewtonIntegrator(gravity=(0, 0, -9.81), damping=.2),
+        SeriesRecorder(fileName=os.path.join(outDir, 'run.ser'), recorders=['spheres', 'velocity', 'intr'], compress=bool(compress), iterPeriod=period, label='series'),
+        VTKRecorder(fileName=os.path.join(outDir, 'vtk-'), recorders=['spheres', 'velocity', 'intr'], iterPeriod=period, label='vtk'),
+        PyRunner(command='export.textExt(os.path.join(outDir,"text-%d.txt"%O.iter),"x_y_z_r_attrs",attrs=["b.state.vel"])', iterPeriod=period)
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(period * nSteps, True)
+series.flush()
+
+print("%d spheres, %d steps" % (len(O.bodies), series.steps))
+print("SeriesRecorder: %d MB, VTKRecorder: %d MB, textExt: %d MB" % (dirSize('run') // 2**20, dirSize('vtk') // 2**20, dirSize('text') // 2**20))
+
+t0 = time.time()
+reader = export.SeriesReader(os.path.join(outDir, 'run.ser'))
+vel = reader.field('linVel')
+print("SeriesReader: linVel of all steps in %g s" % (time.time() - t0))
+t0 = time.time()
+import numpy
+textVel = [numpy.loadtxt(os.path.join(outDir, f), usecols=(4, 5, 6)) for f in sorted(os.listdir(outDir)) if f.startswith('text')]
+print("numpy.loadtxt: velocities of all steps in %g s" % (time.time() - t0))
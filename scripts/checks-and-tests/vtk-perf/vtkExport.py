@@ -0,0 +1,46 @@
+# -*- encoding=utf-8 -*-
+# Timing of the spheres export of VTKRecorder, synchronous or with asyncWrite.
+# Run with: yade-trunk-multi -j1 vtkExport.table vtkExport.py
+from __future__ import print_function
+from yade import pack
+import time, tempfile, os
+
+utils.readParamsFromTable(num=100000, asyncWrite=0, compress=0, noTableOk=True)
+from yade.params.table import *
+
+period, nExports = 10, 10
+outDir = tempfile.mkdtemp()
+
+sp = pack.SpherePack()
+sp.makeCloud((0, 0, 0), (1, 1, 1), rMean=0.5 * (0.4 / num)**(1. / 3), rRelFuzz=.3, num=num, seed=1)
+sp.toSimulation()
+
+recorder = VTKRecorder(
+        fileName=os.path.join(outDir, 'export-'),
+        recorders=['spheres', 'velocity', 'force', 'stress', 'id', 'mass'],
+        iterPeriod=period,
+        asyncWrite=bool(asyncWrite),
+        compress=bool(compress),
+        dead=True
+)
+O.engines = [
+        ForceResetter(),
+        InsertionSortCollider([Bo1_Sphere_Aabb()]),
+        InteractionLoop([Ig2_Sphere_Sphere_ScGeom()], [Ip2_FrictMat_FrictMat_FrictPhys()], [Law2_ScGeom_FrictPhys_CundallStrack()]),
+        NewtonIntegrator(gravity=(0, 0, -9.81), damping=.2), recorder
+]
+O.dt = .5 * PWaveTimeStep()
+O.run(period, True)  # collider initialization, not timed
+
+for exporting in (False, True):
+	recorder.dead = not exporting
+	t0 = time.time()
+	O.run(period * nExports, True)
+	recorder.flush()  # the last files are written before the time is taken
+	dt = (time.time() - t0) / (period * nExports)
+	print("%s: %d spheres, %g s per iteration" % ("with export" if exporting else "without export", len(O.bodies), dt))
+	if not exporting: tRef = dt
+
+print("export (asyncWrite=%d, compress=%d): %g s per file" % (asyncWrite, compress, (dt - tRef) * period))
+if asyncWrite: print("last snapshot %g s, cumulated waitTime %g s" % (recorder.snapshotTime, recorder.waitTime))
+print("%d MB written" % (sum(os.path.getsize(os.path.join(outDir, f)) for f in os.listdir(outDir)) // 2**20))